@@ -0,0 +1,221 @@
+//
+//  testcolumndist.cpp
+//  Mothur
+//
+//  Created by agent on 10/18/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "testcolumndist.h"
+#include "ignoregaps.h"
+#include "eachgapdist.h"
+#include "eachgapignore.h"
+#include "onegapdist.h"
+#include "onegapignore.h"
+
+/**************************************************************************************************/
+TestColumnDist::TestColumnDist() {  //setup
+    m = MothurOut::getInstance();
+    mt19937 generator(31415);
+
+    //short alignments hit the partial blocks, long ones are SILVA width
+    int lengths[] = { 1, 5, 63, 64, 65, 130, 1000 };
+    for (int i = 0; i < 7; i++) {
+        for (int j = 0; j < 20; j++) { alignments.push_back(makeAlignedRead(generator, lengths[i], 0, lengths[i])); }
+    }
+
+    string names[] = { "scalar", "sse4.2", "avx2" };
+    for (int i = 0; i < 3; i++) { if (ColumnDist::getKernel(names[i]) != NULL) { kernels.push_back(names[i]); } }
+}
+/**************************************************************************************************/
+//read covers [start, end) of the alignment, the rest is '.'
+string TestColumnDist::makeAlignedRead(mt19937& generator, int alignLength, int start, int end) {
+    uniform_int_distribution<int> pick(0, 99);
+    const char bases[] = { 'A', 'C', 'G', 'T', 'A', 'C', 'G', 'T', 'N', 'R' };
+
+    int readStart = start + pick(generator) % max(1, (end - start) / 4);
+    int readEnd = end - pick(generator) % max(1, (end - start) / 4);
+
+    string read(alignLength, '.');
+    for (int i = readStart; i < readEnd; i++) {
+        int roll = pick(generator);
+        if (roll < 40)      { read[i] = '-';                        }
+        else if (roll < 42) { read[i] = '.';                        } //stray internal '.'
+        else                { read[i] = bases[roll % 10];           }
+    }
+    return read;
+}
+/**************************************************************************************************/
+Dist* TestColumnDist::getReferenceCalculator(string calc, bool countEnds) {
+    if (calc == "nogaps")       { return new ignoreGaps();  }
+    if (calc == "eachgap")      {
+        if (countEnds)  { return new eachGapDist();                 }
+        else            { return new eachGapIgnoreTermGapDist();    }
+    }
+    if (countEnds)  { return new oneGapDist();                  }
+    return new oneGapIgnoreTermGapDist();
+}
+/**************************************************************************************************/
+double TestColumnDist::timeCalculator(Dist* calc, const vector<string>& reads) {
+    clock_t start = clock();
+    double total = 0;
+    for (int i = 0; i < reads.size(); i++) {
+        for (int j = 0; j < i; j++) {
+            calc->calcDist(reads[i].c_str(), reads[j].c_str(), reads[i].length());
+            total += calc->getDist();
+        }
+    }
+    EXPECT_GE(total, 0); //uses total, so the loop isn't optimized away
+    return (clock() - start) / (double) CLOCKS_PER_SEC;
+}
+/**************************************************************************************************/
+TEST_F(TestColumnDist, matchesCalculators) {
+    string calcs[] = { "nogaps", "eachgap", "onegap" };
+
+    for (int k = 0; k < kernels.size(); k++) {
+        for (int c = 0; c < 3; c++) {
+            for (int ends = 0; ends < 2; ends++) {
+                Dist* reference = getReferenceCalculator(calcs[c], ends);
+                ColumnDist columnDist(calcs[c], ends);
+                columnDist.setKernel(ColumnDist::getKernel(kernels[k]));
+
+                for (int i = 0; i < alignments.size(); i++) {
+                    for (int j = 0; j < alignments.size(); j++) {
+                        if (alignments[i].length() != alignments[j].length()) { continue; }
+
+                        reference->calcDist(alignments[i].c_str(), alignments[j].c_str(), alignments[i].length());
+                        columnDist.calcDist(alignments[i].c_str(), alignments[j].c_str(), alignments[i].length());
+
+                        ASSERT_EQ(reference->getDist(), columnDist.getDist()) << kernels[k] << " " << calcs[c] << " countends=" << ends << "\n" << alignments[i] << "\n" << alignments[j];
+                    }
+                }
+                delete reference;
+            }
+        }
+    }
+}
+/**************************************************************************************************/
+TEST_F(TestColumnDist, cutoffPruning) {
+    string calcs[] = { "nogaps", "eachgap", "onegap" };
+    double cutoffs[] = { 0.0, 0.03, 0.25 };
+
+    for (int c = 0; c < 3; c++) {
+        for (int ends = 0; ends < 2; ends++) {
+            for (int k = 0; k < 3; k++) {
+                ColumnDist exact(calcs[c], ends);
+                ColumnDist pruned(calcs[c], ends);
+                pruned.setCutoff(cutoffs[k]);
+
+                for (int i = 0; i < alignments.size(); i++) {
+                    for (int j = 0; j < alignments.size(); j++) {
+                        if (alignments[i].length() != alignments[j].length()) { continue; }
+
+                        exact.calcDist(alignments[i].c_str(), alignments[j].c_str(), alignments[i].length());
+                        pruned.calcDist(alignments[i].c_str(), alignments[j].c_str(), alignments[i].length());
+
+                        if (exact.getDist() <= cutoffs[k]) { ASSERT_EQ(exact.getDist(), pruned.getDist()) << calcs[c] << " countends=" << ends; }
+                        else { ASSERT_GT(pruned.getDist(), cutoffs[k]) << calcs[c] << " countends=" << ends; }
+                    }
+                }
+            }
+        }
+    }
+}
+/**************************************************************************************************/
+//what dist.seqs does - drops the columns that are '-' in every read and computes each pair on the columns it covers
+void TestColumnDist::compareWindowed(const vector<string>& reads) {
+    string calcs[] = { "nogaps", "eachgap", "onegap" };
+    int alignLength = reads[0].length();
+
+    vector<int> keep;
+    for (int k = 0; k < alignLength; k++) {
+        bool allGaps = true;
+        for (int i = 0; i < reads.size(); i++) { if (reads[i][k] != '-') { allGaps = false; break; } }
+        if (!allGaps) { keep.push_back(k); }
+    }
+
+    vector<string> packed(reads.size(), "");
+    vector<int> readStarts(reads.size(), keep.size()), readEnds(reads.size(), -1);
+    for (int i = 0; i < reads.size(); i++) {
+        for (int k = 0; k < keep.size(); k++) {
+            packed[i] += reads[i][keep[k]];
+            if (packed[i][k] != '.') { if (readStarts[i] == keep.size()) { readStarts[i] = k; } readEnds[i] = k; }
+        }
+    }
+
+    for (int c = 0; c < 3; c++) {
+        for (int ends = 0; ends < 2; ends++) {
+            Dist* reference = getReferenceCalculator(calcs[c], ends);
+            ColumnDist columnDist(calcs[c], ends);
+
+            for (int i = 0; i < reads.size(); i++) {
+                for (int j = 0; j < reads.size(); j++) {
+                    reference->calcDist(reads[i].c_str(), reads[j].c_str(), alignLength);
+                    columnDist.calcDist(packed[i].c_str(), packed[j].c_str(), readStarts[i], readEnds[i], readStarts[j], readEnds[j]);
+
+                    ASSERT_EQ(reference->getDist(), columnDist.getDist()) << calcs[c] << " countends=" << ends << "\n" << reads[i] << "\n" << reads[j];
+                }
+            }
+            delete reference;
+        }
+    }
+}
+/**************************************************************************************************/
+TEST_F(TestColumnDist, windowMatchesFullWidth) {
+    mt19937 generator(16180);
+    uniform_int_distribution<int> pick(0, 99);
+    int alignLength = 600;
+
+    //ragged ends, reads that don't overlap, terminal gaps written as '-' and an empty read
+    vector<string> reads;
+    for (int i = 0; i < 60; i++) {
+        int start = pick(generator) * 5, end = min(alignLength, start + 1 + pick(generator) * 4);
+        string read = makeAlignedRead(generator, alignLength, start, end);
+        if (i % 5 == 0) { for (int k = 0; (k < alignLength) && (read[k] == '.'); k++) { read[k] = '-'; } }
+        if (i % 7 == 0) { for (int k = alignLength-1; (k >= 0) && (read[k] == '.'); k--) { read[k] = '-'; } }
+        reads.push_back(read);
+    }
+    reads.push_back(string(alignLength, '.'));
+    compareWindowed(reads);
+
+    //reads that all cover the middle, with the reference's empty columns added the way align.seqs writes them -
+    //'-' inside a read and '.' past its ends, so the ones in the middle are gaps in every read
+    vector<string> aligned;
+    for (int i = 0; i < 40; i++) {
+        string read = makeAlignedRead(generator, alignLength, 0, alignLength);
+        int readStart = pick(generator) * 2, readEnd = alignLength - pick(generator) * 2;
+        for (int k = 0; k < alignLength; k++) { if ((k < readStart) || (k >= readEnd)) { read[k] = '.'; } }
+
+        string withEmpty = "";
+        for (int k = 0; k < alignLength; k++) {
+            if (k % 10 == 0) { withEmpty += ((k < readStart) || (k >= readEnd)) ? '.' : '-'; }
+            withEmpty += read[k];
+        }
+        if (i % 5 == 0) { for (int k = 0; (k < withEmpty.length()) && (withEmpty[k] == '.'); k++) { withEmpty[k] = '-'; } }
+        aligned.push_back(withEmpty);
+    }
+    compareWindowed(aligned);
+}
+/**************************************************************************************************/
+//microbenchmark - V4 length reads in a 50,000 column alignment
+//Disabled, run it with --gtest_also_run_disabled_tests, the times are in the test properties of --gtest_output=xml
+TEST_F(TestColumnDist, DISABLED_benchmark) {
+    mt19937 generator(27182);
+    vector<string> reads;
+    for (int i = 0; i < 200; i++) { reads.push_back(makeAlignedRead(generator, 50000, 13862, 23444)); }
+
+    RecordProperty("kernel", ColumnDist::getKernelName());
+    string calcs[] = { "nogaps", "eachgap", "onegap" };
+    for (int c = 0; c < 3; c++) {
+        Dist* reference = getReferenceCalculator(calcs[c], true);
+        ColumnDist columnDist(calcs[c], true);
+
+        double referenceTime = timeCalculator(reference, reads);
+        double columnTime = timeCalculator(&columnDist, reads);
+        RecordProperty(calcs[c] + "Original", toString(referenceTime));
+        RecordProperty(calcs[c] + "Column", toString(columnTime));
+
+        delete reference;
+    }
+}
+/**************************************************************************************************/
@@ -0,0 +1,33 @@
+//
+//  testcolumndist.h
+//  Mothur
+//
+//  Created by agent on 10/18/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__testcolumndist__
+#define __Mothur__testcolumndist__
+
+#include "columndist.h"
+#include "gtest/gtest.h"
+
+class TestColumnDist : public ::testing::Test {
+    
+public:
+    
+    TestColumnDist();
+    ~TestColumnDist() {}
+    
+protected:
+    MothurOut* m;
+    vector<string> alignments;  //random aligned reads with terminal '.'s, internal gaps and ambiguous bases
+    vector<string> kernels;     //kernels this cpu can run
+    
+    string makeAlignedRead(mt19937&, int, int, int);
+    Dist* getReferenceCalculator(string, bool);
+    double timeCalculator(Dist*, const vector<string>&);
+    void compareWindowed(const vector<string>&);
+};
+
+#endif /* defined(__Mothur__testcolumndist__) */
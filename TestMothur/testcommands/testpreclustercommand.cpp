@@ -0,0 +1,135 @@
+//
+//  testpreclustercommand.cpp
+//  Mothur
+//
+//  Created by agent on 10/18/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "testpreclustercommand.h"
+
+/**************************************************************************************************/
+TestPreClusterCommand::TestPreClusterCommand() {  //setup
+    m = MothurOut::getInstance();
+    command = new PreClusterCommand();
+    mapFile = "testpreclustercommand.map";
+
+    mt19937 generator(27828);
+    uniform_int_distribution<int> pick(0, 999);
+    const char bases[] = { 'A', 'C', 'G', 'T', '-' };
+
+    int length = 253; //not a multiple of 8, so countDiffs has a tail
+    vector<string> centers;
+    for (int i = 0; i < 30; i++) {
+        string center(length, '-');
+        for (int k = 0; k < length; k++) { center[k] = bases[pick(generator) % 5]; }
+        centers.push_back(center);
+    }
+
+    for (int i = 0; i < 600; i++) {
+        string read = centers[pick(generator) % centers.size()];
+        int changes = pick(generator) % 6;
+        for (int c = 0; c < changes; c++) { read[pick(generator) % length] = bases[pick(generator) % 5]; }
+
+        string name = "seq" + toString(i);
+        seqPNode node(1 + ((i * 7919) % 600), Sequence(name, read), name);
+        node.filteredSeq = read;
+        seqs.push_back(node);
+    }
+}
+/**************************************************************************************************/
+TestPreClusterCommand::~TestPreClusterCommand() {
+    delete command;
+    m->mothurRemove(mapFile);
+}
+/**************************************************************************************************/
+void TestPreClusterCommand::setUp(int diffs, bool topdown) {
+    command->diffs = diffs;
+    command->topdown = topdown;
+    command->method = "aligned";
+    command->length = seqs[0].filteredSeq.length();
+    command->alignSeqs = seqs;
+}
+/**************************************************************************************************/
+//the loops process ran before the index, every later seq is a candidate
+void TestPreClusterCommand::fullScan(vector<seqPNode>& nodes) {
+    if (command->topdown) {
+        sort(nodes.begin(), nodes.end(), comparePriorityTopDown);
+        for (int i = 0; i < nodes.size(); i++) {
+            if (!nodes[i].active) { continue; }
+            for (int j = i+1; j < nodes.size(); j++) {
+                if (!nodes[j].active) { continue; }
+                if (command->countDiffs(nodes[i].filteredSeq, nodes[j].filteredSeq) <= command->diffs) {
+                    nodes[i].names += ',' + nodes[j].names;
+                    nodes[i].numIdentical += nodes[j].numIdentical;
+                    nodes[j].active = 0; nodes[j].numIdentical = 0;
+                }
+            }
+            nodes[i].active = 0;
+        }
+    }else {
+        sort(nodes.begin(), nodes.end(), comparePriorityDownTop);
+        vector<int> originalCount;
+        for (int i = 0; i < nodes.size(); i++) { originalCount.push_back(nodes[i].numIdentical); }
+        for (int i = 0; i < nodes.size(); i++) {
+            for (int j = i+1; j < nodes.size(); j++) {
+                if ((originalCount[i] != -1) && (originalCount[j] > originalCount[i]) && (command->countDiffs(nodes[i].filteredSeq, nodes[j].filteredSeq) <= command->diffs)) {
+                    nodes[j].names += ',' + nodes[i].names;
+                    nodes[j].numIdentical += nodes[i].numIdentical;
+                    nodes[i].numIdentical = 0; originalCount[i] = -1;
+                    break;
+                }
+            }
+        }
+    }
+}
+/**************************************************************************************************/
+//a pair within diffs shares a piece, so it is always a candidate
+TEST_F(TestPreClusterCommand, candidatesCoverEveryMerge) {
+    int diffsToTry[] = { 0, 1, 2, 4, 6 };
+    for (int d = 0; d < 5; d++) {
+        setUp(diffsToTry[d], true);
+        sort(getAlignSeqs().begin(), getAlignSeqs().end(), comparePriorityTopDown);
+        indexSegments();
+
+        int numSeqs = getAlignSeqs().size(), numMerges = 0;
+        vector<int> candidates, lastSeen(numSeqs, -1);
+        for (int i = 0; i < numSeqs; i++) {
+            int numCandidates = findCandidates(i, candidates, lastSeen);
+            ASSERT_TRUE(is_sorted(candidates.begin(), candidates.begin() + numCandidates));
+            if (numCandidates != 0) { ASSERT_GT(candidates[0], i); }
+
+            for (int j = i+1; j < numSeqs; j++) {
+                if (countDiffs(getAlignSeqs()[i].filteredSeq, getAlignSeqs()[j].filteredSeq) <= diffsToTry[d]) {
+                    numMerges++;
+                    ASSERT_TRUE(binary_search(candidates.begin(), candidates.begin() + numCandidates, j)) << "diffs=" << diffsToTry[d] << " " << i << " " << j;
+                }
+            }
+        }
+        EXPECT_GT(numMerges, 0);
+    }
+}
+/**************************************************************************************************/
+TEST_F(TestPreClusterCommand, sameMergesAsFullScan) {
+    for (int d = 0; d < 4; d++) {
+        for (int topdown = 0; topdown < 2; topdown++) {
+            setUp(d, topdown);
+            int count = process();
+            EXPECT_TRUE(isIndexCleared());
+
+            vector<seqPNode> expected = seqs;
+            fullScan(expected);
+
+            int numMerged = 0;
+            ASSERT_EQ(expected.size(), getAlignSeqs().size());
+            for (int i = 0; i < expected.size(); i++) {
+                ASSERT_EQ(expected[i].names, getAlignSeqs()[i].names) << "diffs=" << d << " topdown=" << topdown;
+                ASSERT_EQ(expected[i].numIdentical, getAlignSeqs()[i].numIdentical);
+                if (expected[i].numIdentical == 0) { numMerged++; }
+            }
+            EXPECT_EQ(numMerged, count);
+            if (d != 0) { EXPECT_GT(count, 0); }
+        }
+    }
+}
+/**************************************************************************************************/
@@ -0,0 +1,39 @@
+//
+//  testpreclustercommand.h
+//  Mothur
+//
+//  Created by agent on 10/18/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__testpreclustercommand__
+#define __Mothur__testpreclustercommand__
+
+#include "preclustercommand.h"
+#include "gtest/gtest.h"
+
+class TestPreClusterCommand : public ::testing::Test {
+
+public:
+
+    TestPreClusterCommand();
+    ~TestPreClusterCommand();
+
+protected:
+    MothurOut* m;
+    PreClusterCommand* command;
+    vector<seqPNode> seqs;      //clusters of reads a few mismatches from their center, every abundance different
+    string mapFile;
+
+    void setUp(int, bool);     //diffs, topdown
+    void fullScan(vector<seqPNode>&);   //the merges countDiffs makes comparing every pair
+
+    vector<seqPNode>& getAlignSeqs() { return command->alignSeqs; }
+    void indexSegments() { command->indexSegments(); }
+    int findCandidates(int i, vector<int>& candidates, vector<int>& lastSeen) { return command->findCandidates(i, candidates, lastSeen); }
+    int countDiffs(const string& first, const string& second) { return command->countDiffs(first, second); }
+    int process() { return command->process(mapFile); }
+    bool isIndexCleared() { return command->segmentIndex.empty(); }
+};
+
+#endif /* defined(__Mothur__testpreclustercommand__) */
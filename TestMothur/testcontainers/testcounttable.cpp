@@ -0,0 +1,222 @@
+//
+//  testcounttable.cpp
+//  Mothur
+//
+//  Created by agent on 10/18/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "testcounttable.h"
+#include <utime.h>
+
+/**************************************************************************************************/
+TestCountTable::TestCountTable() {  //setup
+    m = MothurOut::getInstance();
+    groupFile = "testcounttable.count_table";
+    noGroupFile = "testcounttable.nogroups.count_table";
+    printedFile = "testcounttable.printed.count_table";
+    largeFile = "testcounttable.large.count_table";
+
+    writeFile(groupFile, "Representative_Sequence\ttotal\tF01\tF02\tF03\nseqC\t6\t1\t0\t5\nseqA\t3\t0\t3\t0\nseqB\t4\t4\t0\t0\nseqD\t10\t2\t7\t1\n", 10);
+    writeFile(noGroupFile, "Representative_Sequence\ttotal\nseqC\t6\nseqA\t3\nseqB\t4\n", 10);
+}
+/**************************************************************************************************/
+TestCountTable::~TestCountTable() {  //teardown
+    m->countCache = false;
+    m->control_pressed = false;
+    m->mothurRemove(groupFile);
+    m->mothurRemove(noGroupFile);
+    m->mothurRemove(printedFile);
+    m->mothurRemove(largeFile);
+    m->mothurRemove(largeFile + ".bin");
+}
+/**************************************************************************************************/
+string TestCountTable::readFile(string file) {
+    ifstream in(file.c_str(), ios::binary);
+    ostringstream contents;
+    contents << in.rdbuf();
+    return contents.str();
+}
+/**************************************************************************************************/
+void TestCountTable::writeFile(string file, string contents, long long age) {
+    ofstream out(file.c_str(), ios::binary | ios::trunc);
+    out << contents;
+    out.close();
+
+    struct utimbuf times;
+    times.actime = times.modtime = time(NULL) - age;
+    utime(file.c_str(), &times);
+}
+/**************************************************************************************************/
+string TestCountTable::getLargeTable(int extra) {
+    string padding(1000, 'x');
+    ostringstream table;
+    table << "Representative_Sequence\ttotal\tF01\tF02\tF03\n";
+    table << "seq0" << padding << '\t' << (3+extra) << "\t2\t" << (1+extra) << "\t0\n";
+    for (int i = 1; i < 17000; i++) { table << "seq" << i << padding << '\t' << (i%7)+1 << '\t' << (i%7)+1 << "\t0\t0\n"; }
+    return table.str();
+}
+/**************************************************************************************************/
+TEST_F(TestCountTable, textRoundTripWithGroups) {
+    CountTable ct;
+    ct.readTable(groupFile, true, false);
+
+    ASSERT_FALSE(m->control_pressed);
+    EXPECT_TRUE(ct.hasGroupInfo());
+    EXPECT_EQ(3, ct.getNumGroups());
+    EXPECT_EQ(4, ct.getNumUniqueSeqs());
+    EXPECT_EQ(23, ct.getNumSeqs());
+    EXPECT_EQ(7, ct.getGroupCount("F01"));
+    EXPECT_EQ(7, ct.getGroupCount("seqD", "F02"));
+    EXPECT_EQ(0, ct.getGroupCount("seqA", "F01"));
+
+    ct.printTable(printedFile);
+    EXPECT_EQ(readFile(groupFile), readFile(printedFile));
+
+    vector<string> names = ct.getNamesOfSeqs();
+    string expected[] = { "seqA", "seqB", "seqC", "seqD" };
+    EXPECT_EQ(vector<string>(expected, expected+4), names);
+}
+/**************************************************************************************************/
+TEST_F(TestCountTable, textRoundTripWithoutGroups) {
+    CountTable ct;
+    ct.readTable(noGroupFile, true, false);
+
+    ASSERT_FALSE(m->control_pressed);
+    EXPECT_FALSE(ct.hasGroupInfo());
+    EXPECT_EQ(13, ct.getNumSeqs());
+    EXPECT_EQ(4, ct.getNumSeqs("seqB"));
+
+    ct.printTable(printedFile);
+    EXPECT_EQ(readFile(noGroupFile), readFile(printedFile));
+
+    CountTable withoutGroups; //groups in the file, but not read
+    withoutGroups.readTable(groupFile, false, false);
+    EXPECT_FALSE(withoutGroups.hasGroupInfo());
+    EXPECT_EQ(23, withoutGroups.getNumSeqs());
+    EXPECT_EQ(10, withoutGroups.getNumSeqs("seqD"));
+}
+/**************************************************************************************************/
+TEST_F(TestCountTable, zeroTotalRows) {
+    writeFile(groupFile, "Representative_Sequence\ttotal\tF01\tF02\nseqA\t3\t1\t2\nseqZ\t0\t0\t0\n", 10);
+
+    CountTable running; //mothur made the table, so rows emptied by earlier commands are allowed
+    running.readTable(groupFile, true, true);
+    EXPECT_FALSE(m->control_pressed);
+    EXPECT_EQ(2, running.getNumUniqueSeqs());
+    EXPECT_EQ(0, running.getNumSeqs("seqZ"));
+    EXPECT_EQ(3, running.getNumSeqs());
+
+    CountTable user;
+    user.readTable(groupFile, true, false);
+    EXPECT_TRUE(m->control_pressed);
+    m->control_pressed = false;
+}
+/**************************************************************************************************/
+TEST_F(TestCountTable, removeGroup) {
+    CountTable ct;
+    ct.readTable(groupFile, true, false);
+    ct.removeGroup("F01");
+
+    ASSERT_FALSE(m->control_pressed);
+    EXPECT_EQ(2, ct.getNumGroups());
+    EXPECT_EQ(3, ct.getNumUniqueSeqs()); //seqB was only in F01
+    EXPECT_EQ(16, ct.getNumSeqs());
+    EXPECT_EQ(0, ct.getNumSeqs("seqB"));
+    EXPECT_EQ(8, ct.getNumSeqs("seqD"));
+    EXPECT_EQ(5, ct.getGroupCount("seqC", "F03"));
+
+    ct.printTable(printedFile);
+    EXPECT_EQ("Representative_Sequence\ttotal\tF02\tF03\nseqC\t5\t0\t5\nseqA\t3\t3\t0\nseqD\t8\t7\t1\n", readFile(printedFile));
+}
+/**************************************************************************************************/
+TEST_F(TestCountTable, mergeCounts) {
+    CountTable ct;
+    ct.readTable(groupFile, true, false);
+    ct.mergeCounts("seqD", "seqC");
+
+    ASSERT_FALSE(m->control_pressed);
+    EXPECT_EQ(3, ct.getNumUniqueSeqs());
+    EXPECT_EQ(23, ct.getNumSeqs());
+    EXPECT_EQ(16, ct.getNumSeqs("seqD"));
+    EXPECT_EQ(3, ct.getGroupCount("seqD", "F01"));
+    EXPECT_EQ(6, ct.getGroupCount("seqD", "F03"));
+
+    ct.printTable(printedFile);
+    EXPECT_EQ("Representative_Sequence\ttotal\tF01\tF02\tF03\nseqA\t3\t0\t3\t0\nseqB\t4\t4\t0\t0\nseqD\t16\t3\t7\t6\n", readFile(printedFile));
+}
+/**************************************************************************************************/
+TEST_F(TestCountTable, renameSeq) {
+    CountTable ct;
+    ct.readTable(groupFile, true, false);
+
+    ct.renameSeq("seqA", "seqE");
+    EXPECT_EQ(3, ct.getNumSeqs("seqE"));
+    EXPECT_EQ(1, ct.get("seqE")); //keeps seqA's row
+    EXPECT_EQ(-1, ct.get("seqA"));
+    m->control_pressed = false;
+
+    ct.renameSeq("seqC", "seqC"); //nothing to do
+    EXPECT_EQ(6, ct.getNumSeqs("seqC"));
+
+    ct.renameSeq("seqB", "seqD"); //seqD already exists, its row goes
+    ASSERT_FALSE(m->control_pressed);
+    EXPECT_EQ(3, ct.getNumUniqueSeqs());
+    EXPECT_EQ(13, ct.getNumSeqs());
+    EXPECT_EQ(4, ct.getNumSeqs("seqD"));
+    EXPECT_EQ(5, ct.getGroupCount("F01"));
+
+    ct.printTable(printedFile);
+    EXPECT_EQ("Representative_Sequence\ttotal\tF01\tF02\tF03\nseqC\t6\t1\t0\t5\nseqE\t3\t0\t3\t0\nseqD\t4\t4\t0\t0\n", readFile(printedFile));
+
+    string expected[] = { "seqC", "seqD", "seqE" };
+    EXPECT_EQ(vector<string>(expected, expected+3), ct.getNamesOfSeqs());
+}
+/**************************************************************************************************/
+TEST_F(TestCountTable, binarySidecar) {
+    m->countCache = true;
+    writeFile(largeFile, getLargeTable(0), 10);
+
+    CountTable ct;
+    ct.readTable(largeFile, true, false);
+    string binName = getBinaryName(ct, largeFile);
+    ifstream binFile(binName.c_str());
+    ASSERT_TRUE(binFile.good());
+    binFile.close();
+
+    CountTable saved;
+    ASSERT_TRUE(readBinaryTable(saved, largeFile));
+    EXPECT_EQ(ct.getNumSeqs(), saved.getNumSeqs());
+
+    CountTable cached; //read from the .bin, F03 is still removed
+    cached.readTable(largeFile, true, false);
+    EXPECT_EQ(2, cached.getNumGroups());
+    EXPECT_EQ(ct.getNumSeqs(), cached.getNumSeqs());
+    EXPECT_EQ(17000, cached.getNumUniqueSeqs());
+    EXPECT_EQ(1, cached.getGroupCount("seq0" + string(1000, 'x'), "F02"));
+    EXPECT_EQ(ct.getGroupCounts("seq16999" + string(1000, 'x')), cached.getGroupCounts("seq16999" + string(1000, 'x')));
+
+    //same size, different counts and modification time
+    writeFile(largeFile, getLargeTable(5), 5);
+    CountTable stale;
+    EXPECT_FALSE(readBinaryTable(stale, largeFile));
+    stale.readTable(largeFile, true, false);
+    EXPECT_EQ(6, stale.getGroupCount("seq0" + string(1000, 'x'), "F02"));
+    EXPECT_EQ(ct.getNumSeqs()+5, stale.getNumSeqs());
+
+    //the read above saved a new .bin, cut it short
+    ASSERT_TRUE(readBinaryTable(stale, largeFile));
+    string contents = readFile(binName);
+    ofstream out(binName.c_str(), ios::binary | ios::trunc);
+    out << contents.substr(0, contents.length() - 100);
+    out.close();
+
+    CountTable truncated;
+    EXPECT_FALSE(readBinaryTable(truncated, largeFile));
+    truncated.readTable(largeFile, true, false);
+    ASSERT_FALSE(m->control_pressed);
+    EXPECT_EQ(17000, truncated.getNumUniqueSeqs());
+    EXPECT_EQ(6, truncated.getGroupCount("seq0" + string(1000, 'x'), "F02"));
+    EXPECT_EQ(stale.getNumSeqs(), truncated.getNumSeqs());
+}
+/**************************************************************************************************/
@@ -0,0 +1,33 @@
+//
+//  testcounttable.h
+//  Mothur
+//
+//  Created by agent on 10/18/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__testcounttable__
+#define __Mothur__testcounttable__
+
+#include "counttable.h"
+#include "gtest/gtest.h"
+
+class TestCountTable : public ::testing::Test {
+    
+public:
+    
+    TestCountTable();
+    ~TestCountTable();
+    
+protected:
+    MothurOut* m;
+    string groupFile, noGroupFile, printedFile, largeFile;
+    
+    string readFile(string);
+    void writeFile(string, string, long long); //file, contents, seconds since it was modified
+    string getLargeTable(int); //count added to the first sequence's F02 - big enough for set.dir(countcache=T) to save a .bin
+    bool readBinaryTable(CountTable& ct, string file) { return ct.readBinaryTable(file, true, true); }
+    string getBinaryName(CountTable& ct, string file) { return ct.getBinaryName(file); }
+};
+
+#endif /* defined(__Mothur__testcounttable__) */
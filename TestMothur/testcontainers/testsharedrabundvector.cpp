@@ -0,0 +1,67 @@
+//
+//  testsharedrabundvector.cpp
+//  Mothur
+//
+//  Created by agent on 10/18/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "testsharedrabundvector.h"
+
+/**************************************************************************************************/
+TestSharedRAbundVector::TestSharedRAbundVector() {  //setup
+    m = MothurOut::getInstance();
+    sharedFile = "testsharedrabundvector.shared";
+    m->clearGroups();
+    
+    //groupA has every otu, groupB only a few
+    ofstream out(sharedFile.c_str());
+    out << "label\tGroup\tnumOtus";
+    for (int i = 0; i < 100; i++) { out << "\tOtu" << (i+1); }
+    out << endl << "0.03\tgroupA\t100";
+    for (int i = 0; i < 100; i++) { out << '\t' << (i+1); }
+    out << endl << "0.03\tgroupB\t100";
+    for (int i = 0; i < 100; i++) { out << '\t' << ((i % 20 == 0) ? 5 : 0); }
+    out << endl;
+    out.close();
+}
+/**************************************************************************************************/
+TestSharedRAbundVector::~TestSharedRAbundVector() {  //teardown
+    m->mothurRemove(sharedFile);
+    m->saveNextLabel = "";
+}
+/**************************************************************************************************/
+TEST_F(TestSharedRAbundVector, readRowsChooseStorage) {
+    m->saveNextLabel = "";
+    ifstream in(sharedFile.c_str());
+    SharedRAbundVector reader(in);
+    in.close();
+    
+    vector<SharedRAbundVector*> lookup = reader.getSharedRAbundVectors();
+    ASSERT_EQ(2, lookup.size());
+    
+    EXPECT_TRUE(isDense(lookup[0]));
+    EXPECT_EQ(100, lookup[0]->getNumBins());
+    EXPECT_EQ(5050, lookup[0]->getNumSeqs());
+    EXPECT_EQ(37, lookup[0]->getAbundance(36));
+    
+    EXPECT_FALSE(isDense(lookup[1]));
+    EXPECT_EQ(100, lookup[1]->getNumBins());
+    EXPECT_EQ(25, lookup[1]->getNumSeqs());
+    EXPECT_EQ(5, lookup[1]->getAbundance(40));
+    EXPECT_EQ(0, lookup[1]->getAbundance(41));
+    EXPECT_EQ(5, lookup[1]->getNonZeroBins().size());
+    
+    for (int i = 0; i < lookup.size(); i++) { delete lookup[i]; }
+}
+/**************************************************************************************************/
+TEST_F(TestSharedRAbundVector, pushBackChoosesStorage) {
+    SharedRAbundVector dense, sparse;
+    for (int i = 0; i < 1000; i++) { dense.push_back(i % 3, "groupA"); sparse.push_back((i % 100 == 0) ? 1 : 0, "groupB"); }
+    
+    EXPECT_TRUE(isDense(&dense));
+    EXPECT_EQ(1000, dense.getAbundances().size());
+    EXPECT_FALSE(isDense(&sparse));
+    EXPECT_EQ(10, sparse.getNumSeqs());
+}
+/**************************************************************************************************/
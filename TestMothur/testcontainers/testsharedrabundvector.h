@@ -0,0 +1,29 @@
+//
+//  testsharedrabundvector.h
+//  Mothur
+//
+//  Created by agent on 10/18/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__testsharedrabundvector__
+#define __Mothur__testsharedrabundvector__
+
+#include "sharedrabundvector.h"
+#include "gtest/gtest.h"
+
+class TestSharedRAbundVector : public ::testing::Test {
+    
+public:
+    
+    TestSharedRAbundVector();
+    ~TestSharedRAbundVector();
+    
+protected:
+    MothurOut* m;
+    string sharedFile;
+    
+    bool isDense(SharedRAbundVector* vector) { return vector->dense; }
+};
+
+#endif /* defined(__Mothur__testsharedrabundvector__) */
@@ -0,0 +1,114 @@
+//
+//  testsparsedistfile.cpp
+//  Mothur
+//
+//  Created by agent on 10/18/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "testsparsedistfile.h"
+
+/**************************************************************************************************/
+TestSparseDistFile::TestSparseDistFile() {  //setup
+    m = MothurOut::getInstance();
+    sparseFile = "testsparsedistfile.sparse.dist";
+    columnFile = "testsparsedistfile.dist";
+    
+    names.push_back("seqA"); names.push_back("seqB"); names.push_back("seqC"); names.push_back("seqD");
+    rows.resize(4);
+    SparseDistCell cell;
+    cell.neighbor = 0; cell.dist = 0.0125; rows[1].push_back(cell);
+    cell.neighbor = 0; cell.dist = 0.02;   rows[3].push_back(cell);   //seqC has no distances
+    cell.neighbor = 2; cell.dist = 0.5;    rows[3].push_back(cell);
+    
+    ofstream out(sparseFile.c_str(), ios::binary);
+    SparseDistFile::writeHeader(out);
+    vector<unsigned int> rowSizes;
+    for (int i = 0; i < rows.size(); i++) {
+        for (int j = 0; j < rows[i].size(); j++) { SparseDistFile::writeCell(out, rows[i][j].neighbor, rows[i][j].dist); }
+        rowSizes.push_back(rows[i].size());
+    }
+    SparseDistFile::writeTables(out, names, rowSizes, 0.5);
+    out.close();
+    
+    ofstream column(columnFile.c_str());
+    column << "seqB seqA 0.0125" << endl;
+    column.close();
+}
+/**************************************************************************************************/
+TestSparseDistFile::~TestSparseDistFile() {  //teardown
+    m->mothurRemove(sparseFile);
+    m->mothurRemove(columnFile);
+}
+/**************************************************************************************************/
+TEST_F(TestSparseDistFile, isSparseDistFile) {
+    EXPECT_TRUE(SparseDistFile::isSparseDistFile(sparseFile));
+    EXPECT_FALSE(SparseDistFile::isSparseDistFile(columnFile));
+    EXPECT_FALSE(SparseDistFile::isSparseDistFile("testsparsedistfile.missing"));
+}
+/**************************************************************************************************/
+TEST_F(TestSparseDistFile, readsRows) {
+    SparseDistFile sparse;
+    ASSERT_TRUE(sparse.open(sparseFile));
+    
+    ASSERT_EQ(4, sparse.getNumSeqs());
+    EXPECT_EQ(3, sparse.getNumCells());
+    EXPECT_FLOAT_EQ(0.5, sparse.getCutoff());
+    
+    for (int i = 0; i < rows.size(); i++) {
+        EXPECT_EQ(names[i], sparse.getName(i));
+        
+        unsigned int size;
+        const SparseDistCell* row = sparse.getRow(i, size);
+        ASSERT_EQ(rows[i].size(), size);
+        for (int j = 0; j < size; j++) {
+            EXPECT_EQ(rows[i][j].neighbor, row[j].neighbor);
+            EXPECT_EQ(rows[i][j].dist, row[j].dist);
+        }
+    }
+}
+/**************************************************************************************************/
+TEST_F(TestSparseDistFile, getNextPair) {
+    SparseDistFile sparse;
+    ASSERT_TRUE(sparse.open(sparseFile));
+    
+    string seqA, seqB; float dist;
+    ASSERT_TRUE(sparse.getNextPair(seqA, seqB, dist));
+    EXPECT_EQ("seqB", seqA); EXPECT_EQ("seqA", seqB); EXPECT_FLOAT_EQ(0.0125, dist);
+    ASSERT_TRUE(sparse.getNextPair(seqA, seqB, dist));
+    EXPECT_EQ("seqD", seqA); EXPECT_EQ("seqA", seqB); EXPECT_FLOAT_EQ(0.02, dist);
+    ASSERT_TRUE(sparse.getNextPair(seqA, seqB, dist));
+    EXPECT_EQ("seqD", seqA); EXPECT_EQ("seqC", seqB); EXPECT_FLOAT_EQ(0.5, dist);
+    EXPECT_FALSE(sparse.getNextPair(seqA, seqB, dist));
+}
+/**************************************************************************************************/
+TEST_F(TestSparseDistFile, rejectsColumnFile) {
+    SparseDistFile sparse;
+    EXPECT_FALSE(sparse.open(columnFile));
+}
+/**************************************************************************************************/
+TEST_F(TestSparseDistFile, rejectsDamagedFile) {
+    string damagedFile = "testsparsedistfile.damaged.sparse.dist";
+    SparseDistFile sparse;
+    
+    //seqB pointing at itself
+    ofstream out(damagedFile.c_str(), ios::binary);
+    SparseDistFile::writeHeader(out);
+    SparseDistFile::writeCell(out, 1, 0.0125);
+    vector<unsigned int> rowSizes(4, 0); rowSizes[1] = 1;
+    SparseDistFile::writeTables(out, names, rowSizes, 0.5);
+    out.close();
+    EXPECT_FALSE(sparse.open(damagedFile));
+    
+    //cut off in the row table
+    ifstream in(sparseFile.c_str(), ios::binary);
+    string contents((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    in.close();
+    out.open(damagedFile.c_str(), ios::binary);
+    out.write(contents.c_str(), 64 + 3 * sizeof(SparseDistCell) + 2 * sizeof(unsigned long long));
+    out.close();
+    EXPECT_FALSE(sparse.open(damagedFile));
+    
+    m->mothurRemove(damagedFile);
+}
+/**************************************************************************************************/
@@ -0,0 +1,29 @@
+//
+//  testsparsedistfile.h
+//  Mothur
+//
+//  Created by agent on 10/18/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__testsparsedistfile__
+#define __Mothur__testsparsedistfile__
+
+#include "sparsedistfile.h"
+#include "gtest/gtest.h"
+
+class TestSparseDistFile : public ::testing::Test {
+    
+public:
+    
+    TestSparseDistFile();
+    ~TestSparseDistFile();
+    
+protected:
+    MothurOut* m;
+    string sparseFile, columnFile;
+    vector<string> names;
+    vector< vector<SparseDistCell> > rows;
+};
+
+#endif /* defined(__Mothur__testsparsedistfile__) */
@@ -0,0 +1,180 @@
+//
+//  testgzipstreambuf.cpp
+//  Mothur
+//
+//  Created by agent on 10/18/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "testgzipstreambuf.h"
+
+#ifdef USE_BOOST
+
+/**************************************************************************************************/
+TestGzipStreamBuf::TestGzipStreamBuf() {  //setup
+    m = MothurOut::getInstance();
+    mt19937 generator(31622);
+    uniform_int_distribution<int> pick(0, 3);
+    const char bases[] = { 'A', 'C', 'G', 'T' };
+
+    for (int i = 0; i < 1500; i++) {
+        text += ">seq" + toString(i) + "\n";
+        for (int j = 0; j < 250; j++) { text += bases[pick(generator)]; }
+        text += "\n";
+    }
+
+    plainFile = "testgzipstreambuf.fasta";
+    gzipFile = "testgzipstreambuf.fasta.gz";
+    bgzfFile = "testgzipstreambuf.bgzf.fasta.gz";
+
+    ofstream out; m->openOutputFile(plainFile, out); out << text; out.close();
+    writeGzip(gzipFile, 100000);
+    writeBGZF(bgzfFile);
+}
+/**************************************************************************************************/
+TestGzipStreamBuf::~TestGzipStreamBuf() {
+    m->mothurRemove(plainFile); m->mothurRemove(gzipFile); m->mothurRemove(bgzfFile);
+}
+/**************************************************************************************************/
+//several gzip members back to back, like cat a.gz b.gz
+void TestGzipStreamBuf::writeGzip(string file, int memberSize) {
+    ofstream out; m->openOutputFileBinary(file, out);
+    vector<char> compressed(compressBound(memberSize) + 32);
+
+    for (int i = 0; i < text.length(); i += memberSize) {
+        z_stream stream; memset(&stream, 0, sizeof(stream));
+        deflateInit2(&stream, 6, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+        stream.next_in = (Bytef*) &text[i]; stream.avail_in = min(memberSize, (int) text.length() - i);
+        stream.next_out = (Bytef*) &compressed[0]; stream.avail_out = compressed.size();
+        deflate(&stream, Z_FINISH);
+        out.write(&compressed[0], compressed.size() - stream.avail_out);
+        deflateEnd(&stream);
+    }
+    out.close();
+}
+/**************************************************************************************************/
+//blocks of 65280 bytes with the BC extra field and an empty block at the end, as bgzip writes them
+void TestGzipStreamBuf::writeBGZF(string file) {
+    ofstream out; m->openOutputFileBinary(file, out);
+    vector<char> compressed(compressBound(65280) + 32);
+
+    vector<int> starts;
+    for (int i = 0; i < text.length(); i += 65280) { starts.push_back(i); }
+    starts.push_back(text.length());
+
+    for (int b = 0; b < starts.size(); b++) {
+        int length = min(65280, (int) text.length() - starts[b]);
+        z_stream stream; memset(&stream, 0, sizeof(stream));
+        deflateInit2(&stream, 6, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+        stream.next_in = (Bytef*) &text[starts[b]]; stream.avail_in = length;
+        stream.next_out = (Bytef*) &compressed[0]; stream.avail_out = compressed.size();
+        deflate(&stream, Z_FINISH);
+        int compressedLength = compressed.size() - stream.avail_out;
+        deflateEnd(&stream);
+
+        int blockSize = compressedLength + 26;
+        unsigned char header[18] = { 0x1f, 0x8b, 8, 4, 0, 0, 0, 0, 0, 255, 6, 0, 'B', 'C', 2, 0, (unsigned char) ((blockSize - 1) & 255), (unsigned char) ((blockSize - 1) >> 8) };
+        unsigned int crc = crc32(0, (Bytef*) &text[starts[b]], length);
+        unsigned char trailer[8] = { (unsigned char) crc, (unsigned char) (crc >> 8), (unsigned char) (crc >> 16), (unsigned char) (crc >> 24),
+                                     (unsigned char) length, (unsigned char) (length >> 8), (unsigned char) (length >> 16), (unsigned char) (length >> 24) };
+        out.write((char*) header, 18); out.write(&compressed[0], compressedLength); out.write((char*) trailer, 8);
+    }
+    out.close();
+}
+/**************************************************************************************************/
+string TestGzipStreamBuf::readAll(string file) {
+    ifstream in; m->openInputFile(file, in);
+    string contents = "";
+    char c;
+    while (in.get(c)) { contents += c; }
+    in.close();
+    return contents;
+}
+/**************************************************************************************************/
+TEST_F(TestGzipStreamBuf, readsCompressedFiles) {
+    EXPECT_EQ(text, readAll(plainFile));
+    EXPECT_EQ(text, readAll(gzipFile));
+    EXPECT_EQ(text, readAll(bgzfFile));
+
+    EXPECT_EQ(text.length(), m->getFileSize(plainFile));
+    EXPECT_EQ(text.length(), m->getFileSize(gzipFile));
+    EXPECT_EQ(text.length(), m->getFileSize(bgzfFile));
+
+    EXPECT_TRUE(m->isSeekable(plainFile));
+    EXPECT_FALSE(m->isSeekable(gzipFile));
+    EXPECT_TRUE(m->isSeekable(bgzfFile));
+    EXPECT_FALSE(m->control_pressed);
+}
+/**************************************************************************************************/
+//a file cut off inside a member is an error, not a shorter file
+TEST_F(TestGzipStreamBuf, reportsTruncatedFile) {
+    string truncatedFile = "testgzipstreambuf.truncated.fasta.gz";
+    ifstream in(gzipFile.c_str(), ios::binary); //the compressed bytes, openInputFileBinary would inflate them
+    string contents((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    in.close();
+
+    ofstream out; m->openOutputFileBinary(truncatedFile, out);
+    out.write(contents.c_str(), contents.length() / 2);
+    out.close();
+
+    string read = readAll(truncatedFile);
+    EXPECT_TRUE(m->control_pressed);
+    EXPECT_LT(read.length(), text.length());
+    EXPECT_EQ(text.substr(0, read.length()), read);
+
+    m->control_pressed = false;
+    m->mothurRemove(truncatedFile);
+}
+/**************************************************************************************************/
+//tellg and seekg are in uncompressed bytes, forwards, backwards, across blocks and members
+TEST_F(TestGzipStreamBuf, seeksUncompressedPositions) {
+    string files[] = { gzipFile, bgzfFile };
+    mt19937 generator(27182);
+    uniform_int_distribution<int> pick(0, text.length() - 1);
+
+    for (int f = 0; f < 2; f++) {
+        ifstream in; m->openInputFile(files[f], in);
+        for (int i = 0; i < 200; i++) {
+            unsigned long long spot = pick(generator);
+            in.clear(); in.seekg(spot);
+            ASSERT_EQ(spot, (unsigned long long) in.tellg()) << files[f];
+
+            int length = min(100, (int) (text.length() - spot));
+            string piece(length, ' ');
+            in.read(&piece[0], length);
+            ASSERT_EQ(text.substr(spot, length), piece) << files[f] << " " << spot;
+            ASSERT_EQ(spot + length, (unsigned long long) in.tellg());
+
+            if (length > 1) { in.unget(); ASSERT_EQ(text[spot + length - 1], in.get()); }
+        }
+
+        in.clear(); in.seekg(0, ios::end);
+        EXPECT_EQ(text.length(), (unsigned long long) in.tellg());
+        EXPECT_EQ(EOF, in.get());
+        in.close();
+    }
+}
+/**************************************************************************************************/
+//BGZF files split at the same sequences as the uncompressed file, plain gzip is left whole
+TEST_F(TestGzipStreamBuf, dividesBGZF) {
+    int plainProcessors = 4, bgzfProcessors = 4, gzipProcessors = 4;
+    vector<unsigned long long> plainPos = m->divideFile(plainFile, plainProcessors, '>');
+    vector<unsigned long long> bgzfPos = m->divideFile(bgzfFile, bgzfProcessors, '>');
+    vector<unsigned long long> gzipPos = m->divideFile(gzipFile, gzipProcessors, '>');
+
+    EXPECT_EQ(4, plainProcessors);
+    EXPECT_EQ(plainProcessors, bgzfProcessors);
+    EXPECT_TRUE(plainPos == bgzfPos);
+    EXPECT_EQ(1, gzipProcessors);
+    EXPECT_EQ(numeric_limits<unsigned long long>::max(), gzipPos[1]); //read to the end without sizing it first
+
+    long long numSeqs = 0;
+    vector<unsigned long long> plainSeqPos = m->setFilePosFasta(plainFile, numSeqs);
+    EXPECT_TRUE(plainSeqPos == m->setFilePosFasta(bgzfFile, numSeqs));
+    EXPECT_TRUE(plainSeqPos == m->setFilePosFasta(gzipFile, numSeqs));
+    EXPECT_EQ(text.length(), plainSeqPos.back());
+    EXPECT_EQ(1500, numSeqs);
+}
+/**************************************************************************************************/
+
+#endif
@@ -0,0 +1,36 @@
+//
+//  testgzipstreambuf.h
+//  Mothur
+//
+//  Created by agent on 10/18/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__testgzipstreambuf__
+#define __Mothur__testgzipstreambuf__
+
+#include "gzipstreambuf.h"
+#include "gtest/gtest.h"
+
+#ifdef USE_BOOST
+
+class TestGzipStreamBuf : public ::testing::Test {
+
+public:
+
+    TestGzipStreamBuf();
+    ~TestGzipStreamBuf();
+
+protected:
+    MothurOut* m;
+    string text;                //a few hundred K of fasta, several BGZF blocks
+    string plainFile, gzipFile, bgzfFile;
+
+    void writeGzip(string, int);    //file, bytes per gzip member
+    void writeBGZF(string);
+    string readAll(string);
+};
+
+#endif
+
+#endif /* defined(__Mothur__testgzipstreambuf__) */
@@ -0,0 +1,210 @@
+//
+//  testneedlemansimd.cpp
+//  Mothur
+//
+//  Created by agent on 10/18/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "testneedlemansimd.h"
+
+/**************************************************************************************************/
+TestNeedlemanSIMD::TestNeedlemanSIMD() {  //setup
+    m = MothurOut::getInstance();
+    mt19937 generator(16180);
+
+    //lengths around the 8 lane boundaries and a few full length reads
+    int lengths[] = { 0, 1, 2, 7, 8, 9, 15, 16, 17, 63, 250, 1500 };
+    for (int i = 0; i < 12; i++) {
+        for (int j = 0; j < 6; j++) { reads.push_back(makeRead(generator, lengths[i])); }
+    }
+
+    NeedlemanSIMD aligner(-1.0, 1.0, -1.0, 10);
+    string names[] = { "scalar", "sse2" };
+    for (int i = 0; i < 2; i++) { if (aligner.setKernel(names[i])) { kernels.push_back(names[i]); } }
+}
+/**************************************************************************************************/
+string TestNeedlemanSIMD::makeRead(mt19937& generator, int length) {
+    uniform_int_distribution<int> pick(0, 99);
+    const char bases[] = { 'A', 'C', 'G', 'T', 'A', 'C', 'G', 'T', 'N', 'R' };
+
+    string read(length, 'A');
+    for (int i = 0; i < length; i++) { read[i] = bases[pick(generator) % 10]; }
+    return read;
+}
+/**************************************************************************************************/
+//substitutions, insertions and deletions at about rate percent
+string TestNeedlemanSIMD::mutate(mt19937& generator, string read, int rate) {
+    uniform_int_distribution<int> pick(0, 99);
+    const char bases[] = { 'A', 'C', 'G', 'T' };
+
+    string mutated = "";
+    for (int i = 0; i < read.length(); i++) {
+        int roll = pick(generator);
+        if (roll >= rate)           { mutated += read[i];               }
+        else if (roll < rate / 3)   { mutated += bases[pick(generator) % 4]; }
+        else if (roll < 2*rate / 3) { mutated += read[i]; mutated += bases[pick(generator) % 4]; }
+    }
+    return mutated;
+}
+/**************************************************************************************************/
+void TestNeedlemanSIMD::compare(Alignment* reference, Alignment* aligner, string A, string B, bool primer) {
+    if (primer) { reference->alignPrimer(A, B); aligner->alignPrimer(A, B); }
+    else        { reference->align(A, B); aligner->align(A, B); }
+
+    ASSERT_EQ(reference->getSeqAAln(), aligner->getSeqAAln()) << A << "\n" << B;
+    ASSERT_EQ(reference->getSeqBAln(), aligner->getSeqBAln()) << A << "\n" << B;
+    ASSERT_EQ(reference->getCandidateStartPos(), aligner->getCandidateStartPos());
+    ASSERT_EQ(reference->getCandidateEndPos(), aligner->getCandidateEndPos());
+    ASSERT_EQ(reference->getTemplateStartPos(), aligner->getTemplateStartPos());
+    ASSERT_EQ(reference->getTemplateEndPos(), aligner->getTemplateEndPos());
+    ASSERT_EQ(reference->getPairwiseLength(), aligner->getPairwiseLength());
+    ASSERT_TRUE(reference->getSeqAAlnBaseMap() == aligner->getSeqAAlnBaseMap());
+    ASSERT_TRUE(reference->getSeqBAlnBaseMap() == aligner->getSeqBAlnBaseMap());
+}
+/**************************************************************************************************/
+//NeedlemanOverlap's score of the last alignment, gaps before and after the overlap are free
+float TestNeedlemanSIMD::overlapScore(Alignment* aligner, float gap, float match, float mismatch) {
+    string A = aligner->getSeqAAln(), B = aligner->getSeqBAln();
+    int start = 0, end = A.length() - 1;
+    while ((start <= end) && ((A[start] == '-') || (B[start] == '-'))) { start++; }
+    while ((end >= start) && ((A[end] == '-') || (B[end] == '-'))) { end--; }
+
+    float score = 0;
+    for (int i = start; i <= end; i++) {
+        if ((A[i] == '-') || (B[i] == '-'))   { score += gap;         }
+        else if (A[i] == B[i])                  { score += match;       }
+        else                                    { score += mismatch;    }
+    }
+    return score;
+}
+/**************************************************************************************************/
+double TestNeedlemanSIMD::timeAligner(Alignment* aligner, const vector<string>& seqsA, const vector<string>& seqsB) {
+    clock_t start = clock();
+    int total = 0;
+    for (int i = 0; i < seqsA.size(); i++) {
+        aligner->align(seqsA[i], seqsB[i]);
+        total += aligner->getPairwiseLength();
+    }
+    double seconds = (clock() - start) / (double) CLOCKS_PER_SEC;
+    return (total < 0) ? -seconds : seconds; //uses total, so the loop isn't optimized away
+}
+/**************************************************************************************************/
+TEST_F(TestNeedlemanSIMD, matchesNeedleman) {
+    //make.contigs, align.seqs and whole number scores too large for int16 / not whole numbers
+    float scores[4][3] = { { -2.0, 1.0, -1.0 }, { -5.0, 1.0, -1.0 }, { -20.0, 10.0, -10.0 }, { -1.5, 1.0, -0.5 } };
+    mt19937 generator(14142);
+
+    for (int k = 0; k < kernels.size(); k++) {
+        for (int s = 0; s < 4; s++) {
+            NeedlemanOverlap reference(scores[s][0], scores[s][1], scores[s][2], 1600);
+            NeedlemanSIMD aligner(scores[s][0], scores[s][1], scores[s][2], 1600);
+            aligner.setKernel(kernels[k]);
+
+            for (int i = 0; i < reads.size(); i++) {
+                for (int j = 0; j < reads.size(); j += 7) {
+                    compare(&reference, &aligner, reads[i], reads[j], false);
+                }
+                string similar = mutate(generator, reads[i], 10);
+                compare(&reference, &aligner, reads[i], similar, false);
+                compare(&reference, &aligner, similar, reads[i], false);
+            }
+        }
+    }
+}
+/**************************************************************************************************/
+TEST_F(TestNeedlemanSIMD, matchesNeedlemanPrimers) {
+    string primers[] = { "GTGCCAGCMGCCGCGGTAA", "GGACTACHVGGGTWTCTAAT", "NNNNACGT", "A" };
+    mt19937 generator(17320);
+
+    for (int k = 0; k < kernels.size(); k++) {
+        NeedlemanOverlap reference(-1.0, 1.0, -1.0, 40);
+        NeedlemanSIMD aligner(-1.0, 1.0, -1.0, 40);
+        aligner.setKernel(kernels[k]);
+
+        for (int p = 0; p < 4; p++) {
+            for (int i = 0; i < 50; i++) {
+                string read = mutate(generator, primers[p], 15) + makeRead(generator, 5);
+                compare(&reference, &aligner, primers[p], read, true);
+            }
+        }
+    }
+}
+/**************************************************************************************************/
+//read pairs overlapping by 10 to 290 bases, with and without errors, and the unrelated reads that fall back to full DP.
+//Reads like these give the same alignments, bandedCanMissTheBestOverlap is a pair that does not
+TEST_F(TestNeedlemanSIMD, matchesNeedlemanBanded) {
+    mt19937 generator(24494);
+    NeedlemanOverlap reference(-2.0, 1.0, -1.0, 1600);
+    NeedlemanBanded aligner(-2.0, 1.0, -1.0, 1600);
+
+    int usedBand = 0;
+    for (int readLength = 250; readLength <= 300; readLength += 50) {
+        for (int i = 0; i < 200; i++) {
+            int fragmentLength = 260 + (i * 7) % 300;
+            string fragment = makeRead(generator, fragmentLength);
+            string forward = mutate(generator, fragment.substr(0, min(readLength, fragmentLength)), (i % 4) * 2);
+            string reverse = mutate(generator, fragment.substr(max(0, fragmentLength - readLength)), (i % 4) * 2);
+
+            compare(&reference, &aligner, forward, reverse, false);
+            if (aligner.getUsedBand()) { usedBand++; }
+            compare(&reference, &aligner, reverse, forward, false);
+        }
+    }
+    EXPECT_GT(usedBand, 200);
+
+    for (int i = 0; i < reads.size(); i++) {
+        for (int j = 0; j < reads.size(); j += 7) { compare(&reference, &aligner, reads[i], reads[j], false); }
+    }
+}
+/**************************************************************************************************/
+//the band is a heuristic. Here a 14 base repeat gets the kmer votes, while the real 60 base overlap has a mismatch
+//every 6 bases and shares no 8mer, so the band finds a worse alignment that never touches its edge
+TEST_F(TestNeedlemanSIMD, bandedCanMissTheBestOverlap) {
+    string A = "ATGCGAAGCTGCCGATGAGAAGCGTCGAGCCAGTTCAATGTGGCCCTAAACCTACTCAAGAAGTATCCCGAGGGCTGTAACTAAACACCGCTGTCCGGACTAAGGTCCGCATATTGTTCAGGTTTTATACAATG";
+    string B = "CTGAAACTACACACCACTGTCAGGACTCAGGTCAGCATAATGTTCCGGTTTAATACACTGATTCCGAGTCCGTGGATGGGTCCTCCTTCTTAGCGAATTACCGTCCATTTGCATGACGGAAGCGTCGAGCCAGTGTTAGTTGAC";
+    NeedlemanOverlap reference(-2.0, 1.0, -1.0, 200);
+    NeedlemanBanded aligner(-2.0, 1.0, -1.0, 200);
+
+    reference.align(A, B);
+    aligner.align(A, B);
+
+    EXPECT_TRUE(aligner.getUsedBand());
+    EXPECT_GT(overlapScore(&reference, -2.0, 1.0, -1.0), overlapScore(&aligner, -2.0, 1.0, -1.0));
+    EXPECT_NE(reference.getSeqAAln(), aligner.getSeqAAln());
+}
+/**************************************************************************************************/
+//microbenchmark - make.contigs sized read pairs that overlap at the ends, and align.seqs sized reads against templates.
+//Disabled, run it with --gtest_also_run_disabled_tests, the times are in the test properties of --gtest_output=xml
+TEST_F(TestNeedlemanSIMD, DISABLED_benchmark) {
+    mt19937 generator(22360);
+    vector<string> forward, reverse, candidates, templates;
+    for (int i = 0; i < 500; i++) {
+        string fragment = makeRead(generator, 300);
+        forward.push_back(mutate(generator, fragment.substr(0, 250), 2));
+        reverse.push_back(mutate(generator, fragment.substr(50), 2));
+    }
+    for (int i = 0; i < 20; i++) {
+        string full = makeRead(generator, 1500);
+        templates.push_back(full);
+        candidates.push_back(mutate(generator, full.substr(500, 250), 5));
+    }
+
+    NeedlemanOverlap needleman(-2.0, 1.0, -1.0, 1600);
+    NeedlemanSIMD aligner(-2.0, 1.0, -1.0, 1600);
+    NeedlemanBanded banded(-2.0, 1.0, -1.0, 1600);
+
+    double contigTime = timeAligner(&needleman, forward, reverse);
+    double contigSIMDTime = timeAligner(&aligner, forward, reverse);
+    double contigBandedTime = timeAligner(&banded, forward, reverse);
+    RecordProperty("kernel", NeedlemanSIMD::getKernelName());
+    RecordProperty("contigNeedleman", toString(contigTime));
+    RecordProperty("contigSIMD", toString(contigSIMDTime));
+    RecordProperty("contigBanded", toString(contigBandedTime));
+
+    double alignTime = timeAligner(&needleman, candidates, templates);
+    double alignSIMDTime = timeAligner(&aligner, candidates, templates);
+    RecordProperty("alignNeedleman", toString(alignTime));
+    RecordProperty("alignSIMD", toString(alignSIMDTime));
+}
+/**************************************************************************************************/
@@ -0,0 +1,36 @@
+//
+//  testneedlemansimd.h
+//  Mothur
+//
+//  Created by agent on 10/18/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__testneedlemansimd__
+#define __Mothur__testneedlemansimd__
+
+#include "needlemansimd.hpp"
+#include "needlemanbanded.hpp"
+#include "needlemanoverlap.hpp"
+#include "gtest/gtest.h"
+
+class TestNeedlemanSIMD : public ::testing::Test {
+
+public:
+
+    TestNeedlemanSIMD();
+    ~TestNeedlemanSIMD() {}
+
+protected:
+    MothurOut* m;
+    vector<string> reads;       //random reads with ambiguous bases, empty and single base reads
+    vector<string> kernels;     //kernels this cpu can run
+
+    string makeRead(mt19937&, int);
+    string mutate(mt19937&, string, int);
+    void compare(Alignment*, Alignment*, string, string, bool);
+    float overlapScore(Alignment*, float, float, float);     //gap, match, mismatch
+    double timeAligner(Alignment*, const vector<string>&, const vector<string>&);
+};
+
+#endif /* defined(__Mothur__testneedlemansimd__) */
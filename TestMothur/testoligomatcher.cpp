@@ -0,0 +1,189 @@
+//
+//  testoligomatcher.cpp
+//  Mothur
+//
+//  Created by agent on 10/18/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "testoligomatcher.h"
+
+/**************************************************************************************************/
+TestOligoMatcher::TestOligoMatcher() {  //setup
+    m = MothurOut::getInstance();
+    mt19937 generator(48112);
+
+    int lengths[] = { 6, 8, 10, 12, 19, 20 };
+    for (int i = 0; i < 150; i++) { oligos.push_back(makeOligo(generator, lengths[i % 6], (i % 3) == 0)); }
+    oligos.push_back("GTGCCAGCMGCCGCGGTAA"); oligos.push_back("GGACTACHVGGGTWTCTAAT"); oligos.push_back("NNNNACGT");
+    sort(oligos.begin(), oligos.end());
+    oligos.erase(unique(oligos.begin(), oligos.end()), oligos.end());
+}
+/**************************************************************************************************/
+string TestOligoMatcher::makeOligo(mt19937& generator, int length, bool ambiguous) {
+    uniform_int_distribution<int> pick(0, 99);
+    const char bases[] = { 'A', 'C', 'G', 'T' };
+    const char codes[] = { 'R', 'Y', 'M', 'K', 'W', 'S', 'B', 'D', 'H', 'V', 'N', 'I' };
+
+    string oligo(length, 'A');
+    for (int i = 0; i < length; i++) {
+        if (ambiguous && (pick(generator) < 15))    { oligo[i] = codes[pick(generator) % 12]; }
+        else                                        { oligo[i] = bases[pick(generator) % 4]; }
+    }
+    return oligo;
+}
+/**************************************************************************************************/
+//substitutions, insertions and deletions, and the odd N
+string TestOligoMatcher::mutate(mt19937& generator, string read, int changes) {
+    uniform_int_distribution<int> pick(0, 99);
+    const char bases[] = { 'A', 'C', 'G', 'T', 'N' };
+
+    for (int i = 0; i < changes; i++) {
+        if (read.length() == 0) { break; }
+        int spot = pick(generator) % read.length();
+        int roll = pick(generator);
+        if (roll < 50)      { read[spot] = bases[pick(generator) % 5];              }
+        else if (roll < 75) { read.erase(spot, 1);                                  }
+        else                { read.insert(spot, 1, bases[pick(generator) % 4]);     }
+    }
+    return read;
+}
+/**************************************************************************************************/
+//the search TrimOligos did before the matcher, one oligo at a time in map order
+int TestOligoMatcher::findExact(vector<string>& oligoSet, string& read) {
+    for (int i = 0; i < oligoSet.size(); i++) {
+        if (read.length() < oligoSet[i].length()) { return i; }
+
+        bool match = true;
+        for (int p = 0; p < oligoSet[i].length(); p++) { if (!OligoMatcher::isMatch(oligoSet[i][p], read[p])) { match = false; break; } }
+        if (match) { return i; }
+    }
+    return -1;
+}
+/**************************************************************************************************/
+//numDiff from the stripBarcode and stripForward alignment loops
+int TestOligoMatcher::alignDiffs(Alignment* alignment, string oligo, string read, int diffs) {
+    alignment->alignPrimer(oligo, read.substr(0, oligo.length() + diffs));
+    string oligoAln = alignment->getSeqAAln();
+    string readAln = alignment->getSeqBAln();
+
+    int alnLength = oligoAln.length();
+    for (int i = oligoAln.length() - 1; i >= 0; i--) { if (oligoAln[i] != '-') { alnLength = i + 1; break; } }
+
+    int numDiff = 0;
+    for (int i = 0; i < alnLength; i++) {
+        if (oligoAln[i] == readAln[i]) { continue; }
+        if ((oligoAln[i] == '-') || (oligoAln[i] == '.') || !OligoMatcher::isMatch(oligoAln[i], readAln[i])) { numDiff++; }
+    }
+    return numDiff;
+}
+/**************************************************************************************************/
+//smallest edit distance between the oligo and a prefix of the window
+int TestOligoMatcher::editDistance(string oligo, string window) {
+    vector< vector<int> > distance(oligo.length() + 1, vector<int>(window.length() + 1, 0));
+    for (int i = 0; i <= oligo.length(); i++) { distance[i][0] = i; }
+    for (int j = 0; j <= window.length(); j++) { distance[0][j] = j; }
+
+    for (int i = 1; i <= oligo.length(); i++) {
+        for (int j = 1; j <= window.length(); j++) {
+            int substitution = distance[i-1][j-1] + (OligoMatcher::isMatch(oligo[i-1], window[j-1]) ? 0 : 1);
+            distance[i][j] = min(substitution, min(distance[i-1][j], distance[i][j-1]) + 1);
+        }
+    }
+    return *min_element(distance[oligo.length()].begin(), distance[oligo.length()].end());
+}
+/**************************************************************************************************/
+TEST_F(TestOligoMatcher, matchesAmbiguityCodes) {
+    EXPECT_TRUE(OligoMatcher::isMatch('A', 'A'));
+    EXPECT_FALSE(OligoMatcher::isMatch('A', 'N'));
+    EXPECT_TRUE(OligoMatcher::isMatch('N', 'G'));
+    EXPECT_TRUE(OligoMatcher::isMatch('N', 'N'));
+    EXPECT_FALSE(OligoMatcher::isMatch('I', 'N'));
+    EXPECT_TRUE(OligoMatcher::isMatch('N', '-'));
+    EXPECT_TRUE(OligoMatcher::isMatch('R', 'G'));
+    EXPECT_FALSE(OligoMatcher::isMatch('R', 'C'));
+    EXPECT_TRUE(OligoMatcher::isMatch('H', 'T'));
+    EXPECT_FALSE(OligoMatcher::isMatch('H', 'G'));
+    EXPECT_FALSE(OligoMatcher::isMatch('V', '-'));
+}
+/**************************************************************************************************/
+TEST_F(TestOligoMatcher, findsWhereTheScanStops) {
+    mt19937 generator(27315);
+    uniform_int_distribution<int> pick(0, 99);
+    OligoMatcher matcher(oligos);
+
+    for (int i = 0; i < 5000; i++) {
+        string read = makeOligo(generator, 30, false);
+        if (pick(generator) < 70)   { string oligo = oligos[pick(generator) % oligos.size()]; read = mutate(generator, oligo, pick(generator) % 3) + read; }
+        if (pick(generator) < 10)   { read = read.substr(0, pick(generator) % 15); }
+        if ((pick(generator) < 5) && (read.length() > 0)) { read[0] = 'x'; }
+
+        ASSERT_EQ(findExact(oligos, read), matcher.findExact(read)) << read;
+    }
+
+    vector<string> none;
+    OligoMatcher empty(none);
+    string read = "ACGT";
+    EXPECT_EQ(-1, empty.findExact(read));
+}
+/**************************************************************************************************/
+TEST_F(TestOligoMatcher, findsPairs) {
+    mt19937 generator(31415);
+    uniform_int_distribution<int> pick(0, 99);
+
+    vector<string> forward, reverse;
+    for (int i = 0; i < 100; i++) {
+        forward.push_back((i % 17 == 0) ? "NONE" : oligos[pick(generator) % oligos.size()]);
+        reverse.push_back((i % 13 == 0) ? "NONE" : oligos[pick(generator) % oligos.size()]);
+    }
+    OligoMatcher forwardMatcher(forward), reverseMatcher(reverse);
+
+    for (int i = 0; i < 5000; i++) {
+        int pair = pick(generator);
+        string forwardRead = mutate(generator, forward[pair], pick(generator) % 2) + makeOligo(generator, 20, false);
+        string reverseRead = mutate(generator, reverse[pair], pick(generator) % 2) + makeOligo(generator, 20, false);
+        if (pick(generator) < 10) { reverseRead = reverseRead.substr(0, pick(generator) % 10); }
+
+        //the ipbarcodes loop of stripBarcode
+        int expected = -1;
+        for (int j = 0; j < forward.size(); j++) {
+            if ((forwardRead.length() < forward[j].length()) || (reverseRead.length() < reverse[j].length())) { expected = j; break; }
+
+            vector<string> f(1, forward[j]), r(1, reverse[j]);
+            bool forwardMatch = (findExact(f, forwardRead) == 0), reverseMatch = (findExact(r, reverseRead) == 0);
+            if (forward[j] == "NONE")       { if (reverseMatch) { expected = j; break; } }
+            else if (reverse[j] == "NONE")  { if (forwardMatch) { expected = j; break; } }
+            else if (forwardMatch && reverseMatch) { expected = j; break; }
+        }
+
+        ASSERT_EQ(expected, OligoMatcher::findExact(forwardMatcher, reverseMatcher, forwardRead, reverseRead)) << forwardRead << " " << reverseRead;
+    }
+}
+/**************************************************************************************************/
+//the bounds TrimOligos skips alignments with must never be above the diffs the alignment finds
+TEST_F(TestOligoMatcher, boundsAlignmentDiffs) {
+    mt19937 generator(16180);
+    uniform_int_distribution<int> pick(0, 99);
+    OligoMatcher matcher(oligos);
+    NeedlemanOverlap alignment(-1.0, 1.0, -1.0, 64);
+
+    int exact = 0, total = 0;
+    for (int i = 0; i < 300; i++) {
+        int source = pick(generator) % oligos.size();
+        string read = mutate(generator, oligos[source], pick(generator) % 4) + makeOligo(generator, 10, false);
+        int diffs = 1 + pick(generator) % 3;
+
+        vector<int> bounds = matcher.getLowerBounds(read, diffs);
+        for (int j = 0; j < oligos.size(); j++) {
+            int numDiff = alignDiffs(&alignment, oligos[j], read, diffs);
+            ASSERT_LE(bounds[j], numDiff) << oligos[j] << " " << read;
+            if (j == source) { total++; if (bounds[j] == numDiff) { exact++; } }
+
+            if (oligos[j].find_first_of("NI") == string::npos) {
+                ASSERT_EQ(editDistance(oligos[j], read.substr(0, oligos[j].length() + diffs)), bounds[j]) << oligos[j] << " " << read;
+            }
+        }
+    }
+    EXPECT_GT(exact, total / 2); //tight for the oligo the read came from
+}
+/**************************************************************************************************/
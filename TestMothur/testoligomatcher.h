@@ -0,0 +1,34 @@
+//
+//  testoligomatcher.h
+//  Mothur
+//
+//  Created by agent on 10/18/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__testoligomatcher__
+#define __Mothur__testoligomatcher__
+
+#include "oligomatcher.h"
+#include "needlemanoverlap.hpp"
+#include "gtest/gtest.h"
+
+class TestOligoMatcher : public ::testing::Test {
+
+public:
+
+    TestOligoMatcher();
+    ~TestOligoMatcher() {}
+
+protected:
+    MothurOut* m;
+    vector<string> oligos;      //barcodes and primers of several lengths, some ambiguous, more than one word of them
+
+    string makeOligo(mt19937&, int, bool);  //length, ambiguous
+    string mutate(mt19937&, string, int);   //read, number of changes
+    int findExact(vector<string>&, string&);
+    int alignDiffs(Alignment*, string, string, int);
+    int editDistance(string, string);
+};
+
+#endif /* defined(__Mothur__testoligomatcher__) */
@@ -0,0 +1,111 @@
+//
+//  testpermutationtest.cpp
+//  Mothur
+//
+//  Created by agent on 10/18/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "testpermutationtest.h"
+
+/**************************************************************************************************/
+TestPermutationTest::TestPermutationTest() {  //setup
+    m = MothurOut::getInstance();
+    mt19937 generator(17320);
+    normal_distribution<double> noise(0.0, 1.0);
+    for (int i = 0; i < 40; i++) { values.push_back(noise(generator) + ((i < 20) ? 0.0 : 0.5)); }
+}
+/**************************************************************************************************/
+bool TestPermutationTest::meanDifference(mt19937_64& rng) {
+    vector<double> shuffled = values;
+    for (int i = shuffled.size()-1; i > 0; i--) { swap(shuffled[i], shuffled[uniform_int_distribution<int>(0, i)(rng)]); }
+
+    double observed = 0, permuted = 0;
+    for (int i = 0; i < values.size(); i++) {
+        double sign = (i < (values.size() / 2)) ? 1.0 : -1.0;
+        observed += sign * values[i];
+        permuted += sign * shuffled[i];
+    }
+    return (fabs(permuted) >= fabs(observed));
+}
+/**************************************************************************************************/
+//what run does with one thread, permutation i draws from the stream for i
+vector<bool> TestPermutationTest::getOutcomes(unsigned seed, int iters, PermutationTest::Permutation permute) {
+    m->setRandomSeed(seed);
+    unsigned long long baseSeed = (unsigned long long) m->getRandomNumber();
+
+    vector<bool> outcomes;
+    for (int i = 0; i < iters; i++) {
+        mt19937_64 rng(getStreamSeed(baseSeed, i));
+        outcomes.push_back(permute(rng));
+    }
+    return outcomes;
+}
+/**************************************************************************************************/
+bool TestPermutationTest::excludesAlpha(long long count, long long numRun, double alpha) {
+    double n = numRun, p = count / n, z = 3.2905, z2 = z * z;
+    double center = (p + z2 / (2.0 * n)) / (1.0 + z2 / n);
+    double halfWidth = z * sqrt(p * (1.0 - p) / n + z2 / (4.0 * n * n)) / (1.0 + z2 / n);
+    return ((center + halfWidth) < alpha) || ((center - halfWidth) > alpha);
+}
+/**************************************************************************************************/
+TEST_F(TestPermutationTest, sameWithAnyProcessors) {
+    PermutationTest::Permutation permute = [&](mt19937_64& rng) { return meanDifference(rng); };
+    vector<bool> outcomes = getOutcomes(12345, 2500, permute);
+    long long expected = count(outcomes.begin(), outcomes.end(), true);
+
+    int processorsToTry[] = { 1, 4, 3 };
+    for (int p = 0; p < 3; p++) {
+        m->setRandomSeed(12345);
+        PermutationTest test(2500, processorsToTry[p]);
+        EXPECT_EQ(expected, test.run(permute)) << processorsToTry[p];
+        EXPECT_EQ(2500, test.getNumRun());
+        EXPECT_EQ(expected / 2500.0, test.getPValue());
+    }
+    EXPECT_GT(expected, 0);
+    EXPECT_LT(expected, 2500);
+
+    //a different seed gives different permutations
+    m->setRandomSeed(54321);
+    PermutationTest test(2500, 4);
+    EXPECT_NE(expected, test.run(permute));
+}
+/**************************************************************************************************/
+//the test only stops at the first block boundary where the interval excludes alpha, and never without earlystop
+TEST_F(TestPermutationTest, stopsOnlyOnceDecided) {
+    int iters = 10000;
+    double alpha = 0.05;
+
+    //far below alpha, close to alpha, far above it
+    double rates[] = { 0.01, 0.05, 0.3 };
+    for (int r = 0; r < 3; r++) {
+        double rate = rates[r];
+        PermutationTest::Permutation permute = [rate](mt19937_64& rng) { return (uniform_real_distribution<double>(0.0, 1.0)(rng) < rate); };
+        vector<bool> outcomes = getOutcomes(7, iters, permute);
+
+        int expectedRun = iters;
+        long long running = 0;
+        for (int i = 0; i < iters; i++) {
+            if (outcomes[i]) { running++; }
+            if (((i+1) % 1000 == 0) && ((i+1) < iters) && excludesAlpha(running, i+1, alpha)) { expectedRun = i+1; break; }
+        }
+        long long expectedCount = count(outcomes.begin(), outcomes.begin() + expectedRun, true);
+
+        for (int processors = 1; processors <= 4; processors += 3) {
+            m->setRandomSeed(7);
+            PermutationTest early(iters, processors);
+            early.setAlpha(alpha);
+            EXPECT_EQ(expectedCount, early.run(permute)) << rate;
+            EXPECT_EQ(expectedRun, early.getNumRun()) << rate;
+
+            m->setRandomSeed(7);
+            PermutationTest full(iters, processors);
+            EXPECT_EQ(count(outcomes.begin(), outcomes.end(), true), full.run(permute)) << rate;
+            EXPECT_EQ(iters, full.getNumRun()) << rate;
+        }
+
+        if (rate != alpha) { EXPECT_LT(expectedRun, iters) << rate; }
+        else { EXPECT_EQ(iters, expectedRun); }
+    }
+}
+/**************************************************************************************************/
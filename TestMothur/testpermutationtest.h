@@ -0,0 +1,31 @@
+//
+//  testpermutationtest.h
+//  Mothur
+//
+//  Created by agent on 10/18/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__testpermutationtest__
+#define __Mothur__testpermutationtest__
+
+#include "permutationtest.h"
+#include "gtest/gtest.h"
+
+class TestPermutationTest : public ::testing::Test {
+
+public:
+
+    TestPermutationTest();
+    ~TestPermutationTest() {}
+
+protected:
+    MothurOut* m;
+    vector<double> values;      //two groups, the second shifted a little
+
+    bool meanDifference(mt19937_64&);   //shuffles the groups, true if the difference is at least the observed one
+    vector<bool> getOutcomes(unsigned, int, PermutationTest::Permutation); //seed, iters - each permutation's result, run in order
+    bool excludesAlpha(long long, long long, double); //count, numRun, alpha - the Wilson interval doesn't contain alpha
+};
+
+#endif /* defined(__Mothur__testpermutationtest__) */
@@ -0,0 +1,131 @@
+//
+//  testsubsample.cpp
+//  Mothur
+//
+//  Created by agent on 10/18/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "testsubsample.h"
+
+/**************************************************************************************************/
+TestSubSample::TestSubSample() {  //setup
+    m = MothurOut::getInstance();
+    int bins[] = { 5000, 1200, 0, 300, 75, 1, 1, 0, 2, 40, 3, 1, 0, 600, 9, 1 };
+    abunds.assign(bins, bins+16);
+}
+/**************************************************************************************************/
+double TestSubSample::getExpectedError(long long population, long long successes, long long draws, int numDraws) {
+    double p = successes / (double) population;
+    double variance = draws * p * (1.0 - p) * (population - draws) / (double) (population - 1);
+    return sqrt(variance / numDraws);
+}
+/**************************************************************************************************/
+TEST_F(TestSubSample, sampleSumsToSize) {
+    mt19937_64 rng(71);
+    int total = accumulate(abunds.begin(), abunds.end(), 0);
+    int sizes[] = { 1, 10, 500, 3000, total-1, total, total+50 };
+
+    for (int s = 0; s < 7; s++) {
+        for (int i = 0; i < 50; i++) {
+            vector<int> sample = (i % 2) ? this->sample.getSample(abunds, sizes[s], &rng) : this->sample.getSample(abunds, sizes[s]);
+
+            ASSERT_EQ(sample.size(), abunds.size());
+            EXPECT_EQ(accumulate(sample.begin(), sample.end(), 0), min(sizes[s], total));
+            for (int j = 0; j < abunds.size(); j++) {
+                EXPECT_GE(sample[j], 0);
+                EXPECT_LE(sample[j], abunds[j]);
+            }
+        }
+    }
+}
+/**************************************************************************************************/
+TEST_F(TestSubSample, sampleMeanMatchesAbundance) {
+    mt19937_64 rng(1009);
+    long long total = accumulate(abunds.begin(), abunds.end(), 0);
+    int size = 800, numDraws = 4000;
+
+    vector<double> sums(abunds.size(), 0);
+    for (int i = 0; i < numDraws; i++) {
+        vector<int> sample = this->sample.getSample(abunds, size, &rng);
+        for (int j = 0; j < sample.size(); j++) { sums[j] += sample[j]; }
+    }
+
+    for (int j = 0; j < abunds.size(); j++) {
+        double expected = size * abunds[j] / (double) total;
+        double error = getExpectedError(total, abunds[j], size, numDraws);
+        EXPECT_NEAR(sums[j] / numDraws, expected, 5.0 * error + 1e-9) << "bin " << j;
+    }
+}
+/**************************************************************************************************/
+TEST_F(TestSubSample, sameStreamSameSample) {
+    mt19937_64 first(5), second(5);
+    for (int i = 0; i < 20; i++) { EXPECT_EQ(sample.getSample(abunds, 250, &first), sample.getSample(abunds, 250, &second)); }
+}
+/**************************************************************************************************/
+TEST_F(TestSubSample, hypergeometricBounds) {
+    mt19937_64 rng(3);
+
+    EXPECT_EQ(getHypergeometric(100, 30, 100, &rng), 30);   //every read drawn
+    EXPECT_EQ(getHypergeometric(100, 0, 40, &rng), 0);      //no successes
+    EXPECT_EQ(getHypergeometric(100, 100, 40, &rng), 40);   //only successes
+    EXPECT_EQ(getHypergeometric(100, 30, 0, &rng), 0);      //nothing drawn
+
+    for (int i = 0; i < 1000; i++) {
+        int count = getHypergeometric(100, 90, 95, &rng);   //more draws than failures, 85 to 90 possible
+        EXPECT_GE(count, 85);
+        EXPECT_LE(count, 90);
+
+        count = getHypergeometric(1000000, 7, 500000, &rng);
+        EXPECT_GE(count, 0);
+        EXPECT_LE(count, 7);
+    }
+}
+/**************************************************************************************************/
+TEST_F(TestSubSample, hypergeometricMean) {
+    mt19937_64 rng(11);
+    long long params[][3] = { { 50, 10, 5 }, { 10000, 4000, 30 }, { 10000, 3, 9000 }, { 2000000, 150000, 100000 } };
+    int numDraws = 5000;
+
+    for (int p = 0; p < 4; p++) {
+        double sum = 0;
+        for (int i = 0; i < numDraws; i++) { sum += getHypergeometric(params[p][0], params[p][1], params[p][2], &rng); }
+
+        double expected = params[p][2] * params[p][1] / (double) params[p][0];
+        EXPECT_NEAR(sum / numDraws, expected, 5.0 * getExpectedError(params[p][0], params[p][1], params[p][2], numDraws)) << "population " << params[p][0];
+    }
+}
+/**************************************************************************************************/
+TEST_F(TestSubSample, samplePreserveLeavesLookup) {
+    vector<SharedRAbundVector*> lookup;
+    for (int i = 0; i < 3; i++) {
+        SharedRAbundVector* temp = new SharedRAbundVector();
+        temp->setLabel("0.03"); temp->setGroup("G" + toString(i));
+        for (int j = 0; j < abunds.size(); j++) { temp->push_back((j % 3 == i) ? abunds[j] : 0, temp->getGroup()); }
+        lookup.push_back(temp);
+    }
+    int size = lookup[0]->getNumSeqs();
+    for (int i = 1; i < lookup.size(); i++) { size = min(size, lookup[i]->getNumSeqs()); }
+    vector<string> binLabels = m->currentSharedBinLabels;
+
+    mt19937_64 rng(23), again(23);
+    vector<SharedRAbundVector*> sampled = sample.getSamplePreserve(lookup, size, rng);
+    vector<SharedRAbundVector*> repeated = sample.getSamplePreserve(lookup, size, again);
+
+    ASSERT_EQ(sampled.size(), lookup.size());
+    for (int i = 0; i < sampled.size(); i++) {
+        EXPECT_EQ(sampled[i]->getGroup(), lookup[i]->getGroup());
+        EXPECT_EQ(sampled[i]->getNumSeqs(), size);
+        EXPECT_EQ(sampled[i]->getAbundances(), repeated[i]->getAbundances());
+        for (int j = 0; j < abunds.size(); j++) { EXPECT_EQ(lookup[i]->getAbundance(j), (j % 3 == i) ? abunds[j] : 0); }
+    }
+    for (int j = 0; j < sampled[0]->getNumBins(); j++) {  //empty otus are removed
+        int binTotal = 0;
+        for (int i = 0; i < sampled.size(); i++) { binTotal += sampled[i]->getAbundance(j); }
+        EXPECT_GT(binTotal, 0);
+    }
+    EXPECT_EQ(m->currentSharedBinLabels, binLabels);
+
+    for (int i = 0; i < lookup.size(); i++) { delete lookup[i]; delete sampled[i]; delete repeated[i]; }
+}
+/**************************************************************************************************/
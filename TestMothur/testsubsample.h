@@ -0,0 +1,31 @@
+//
+//  testsubsample.h
+//  Mothur
+//
+//  Created by agent on 10/18/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__testsubsample__
+#define __Mothur__testsubsample__
+
+#include "subsample.h"
+#include "gtest/gtest.h"
+
+class TestSubSample : public ::testing::Test {
+
+public:
+
+    TestSubSample();
+    ~TestSubSample() {}
+
+protected:
+    MothurOut* m;
+    SubSample sample;
+    vector<int> abunds;     //a few large bins, many small ones and some empty ones
+
+    int getHypergeometric(long long population, long long successes, long long draws, mt19937_64* rng) { return sample.getHypergeometric(population, successes, draws, rng); }
+    double getExpectedError(long long, long long, long long, int); //population, successes, draws, numDraws - standard error of the mean count
+};
+
+#endif /* defined(__Mothur__testsubsample__) */
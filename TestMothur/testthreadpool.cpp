@@ -0,0 +1,90 @@
+//
+//  testthreadpool.cpp
+//  Mothur
+//
+//  Created by agent on 10/18/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "testthreadpool.h"
+
+/**************************************************************************************************/
+TestThreadPool::TestThreadPool() {  //setup
+    m = MothurOut::getInstance();
+    pool = ThreadPool::getInstance();
+}
+/**************************************************************************************************/
+//the first slice is slow, so the other threads run out early and have to steal from it
+TEST_F(TestThreadPool, stealingRunsEveryIndexOnce) {
+    int numIndexes = 400;
+    vector< atomic<int> > runs(numIndexes);
+    vector<int> ranOn(numIndexes, -1);
+    for (int i = 0; i < numIndexes; i++) { runs[i] = 0; }
+
+    pool->parallelFor(0, numIndexes, 4, [&](long long start, long long end, int threadID) {
+        for (long long i = start; i < end; i++) {
+            if (i < (numIndexes / 4)) { this_thread::sleep_for(chrono::milliseconds(1)); }
+            runs[i]++;
+            ranOn[i] = threadID;
+        }
+    });
+
+    int stolen = 0;
+    for (int i = 0; i < numIndexes; i++) {
+        ASSERT_EQ(1, runs[i].load()) << i;
+        if ((i < (numIndexes / 4)) && (ranOn[i] != 0)) { stolen++; }
+    }
+    EXPECT_GT(stolen, 0);
+
+    //with a grain, and more threads than indexes
+    for (int i = 0; i < numIndexes; i++) { runs[i] = 0; }
+    pool->parallelFor(0, numIndexes, 4, [&](long long start, long long end, int threadID) {
+        for (long long i = start; i < end; i++) { runs[i]++; }
+    }, 7);
+    pool->parallelFor(0, 3, 8, [&](long long start, long long end, int threadID) {
+        for (long long i = start; i < end; i++) { runs[i]++; }
+    });
+    for (int i = 0; i < numIndexes; i++) { ASSERT_EQ((i < 3) ? 2 : 1, runs[i].load()) << i; }
+}
+/**************************************************************************************************/
+//chunks finish out of order, the output is still written in index order
+TEST_F(TestThreadPool, orderedOutputKeepsIndexOrder) {
+    int numIndexes = 300;
+    string expected = "";
+    for (int i = 0; i < numIndexes; i++) { expected += toString(i) + "\n"; }
+
+    ostringstream out;
+    OrderedOutput output(out, 0);
+    pool->parallelForOrdered(0, numIndexes, 4, [&](long long start, long long end, int threadID) {
+        if ((start / 5) % 3 == 0) { this_thread::sleep_for(chrono::milliseconds(2)); }
+        string block = "";
+        for (long long i = start; i < end; i++) { block += toString(i) + "\n"; }
+        output.commit(start, end, block);
+    }, 5);
+
+    EXPECT_EQ(numIndexes, output.getNext());
+    EXPECT_EQ(expected, out.str());
+}
+/**************************************************************************************************/
+//a task that asks the pool for more threads gets them run inline on its own thread
+TEST_F(TestThreadPool, nestedRunOnEachRunsInline) {
+    atomic<int> outer(0), inner(0), wrongThread(0);
+
+    pool->runOnEach(4, [&](int threadID) {
+        thread::id mine = this_thread::get_id();
+        outer++;
+        pool->runOnEach(3, [&](int nestedID) {
+            inner++;
+            if (this_thread::get_id() != mine) { wrongThread++; }
+        });
+        pool->parallelFor(0, 10, 4, [&](long long start, long long end, int nestedID) {
+            inner += (end - start);
+            if ((nestedID != 0) || (this_thread::get_id() != mine)) { wrongThread++; }
+        });
+    });
+
+    EXPECT_EQ(4, outer.load());
+    EXPECT_EQ(4 * (3 + 10), inner.load());
+    EXPECT_EQ(0, wrongThread.load());
+}
+/**************************************************************************************************/
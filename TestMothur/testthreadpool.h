@@ -0,0 +1,27 @@
+//
+//  testthreadpool.h
+//  Mothur
+//
+//  Created by agent on 10/18/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__testthreadpool__
+#define __Mothur__testthreadpool__
+
+#include "threadpool.h"
+#include "gtest/gtest.h"
+
+class TestThreadPool : public ::testing::Test {
+
+public:
+
+    TestThreadPool();
+    ~TestThreadPool() {}
+
+protected:
+    MothurOut* m;
+    ThreadPool* pool;
+};
+
+#endif /* defined(__Mothur__testthreadpool__) */
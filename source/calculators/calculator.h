@@ -35,6 +35,7 @@ public:
 	virtual int getCols()		{	return cols;	}
 	virtual bool getMultiple()  {   return multiple;   }
 	virtual bool getNeedsAll()  {   return needsAll;   }
+	virtual bool getIgnoresEmptyOtus()  {   return false;   } //true if otus that are zero in every group compared do not change the result
 	virtual string getCitation() = 0;
 	void citation() { m->mothurOut(getCitation()); m->mothurOutEndLine(); }
 protected:
@@ -0,0 +1,420 @@
+/*
+ *  columndist.cpp
+ *  Mothur
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 Schloss Lab. All rights reserved.
+ *
+ */
+
+#include "columndist.h"
+
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+	#define COLUMNDIST_X86
+	#include <immintrin.h>
+#endif
+
+typedef unsigned long long ColumnBits;
+
+/**************************************************************************************************/
+static inline int popCount(ColumnBits x) {
+#ifdef __GNUC__
+	return __builtin_popcountll(x);
+#else
+	int count = 0;
+	while (x) { x &= x-1; count++; }
+	return count;
+#endif
+}
+/**************************************************************************************************/
+static inline int lowestBit(ColumnBits x) { //x != 0
+#ifdef __GNUC__
+	return __builtin_ctzll(x);
+#else
+	int pos = 0;
+	while (!(x & 1)) { x >>= 1; pos++; }
+	return pos;
+#endif
+}
+/**************************************************************************************************/
+static inline int highestBit(ColumnBits x) { //x != 0
+#ifdef __GNUC__
+	return 63 - __builtin_clzll(x);
+#else
+	int pos = 63;
+	while (!(x >> pos)) { pos--; }
+	return pos;
+#endif
+}
+/**************************************************************************************************/
+//columns pos and up / columns below pos, pos may fall outside the block
+static inline ColumnBits bitsFrom(int pos) { if (pos <= 0) { return ~0ULL; } if (pos >= 64) { return 0; } return ~0ULL << pos; }
+static inline ColumnBits bitsBelow(int pos) { if (pos <= 0) { return 0; } if (pos >= 64) { return ~0ULL; } return ~0ULL >> (64 - pos); }
+
+/**************************************************************************************************/
+static void scalarColumnMasks(const char* seqA, const char* seqB, int numColumns, ColumnMasks& masks) {
+	masks.dotA = 0; masks.gapA = 0; masks.dotB = 0; masks.gapB = 0; masks.diff = 0;
+	masks.valid = bitsBelow(numColumns);
+
+	for (int i = 0; i < numColumns; i++) {
+		ColumnBits bit = 1ULL << i;
+		if (seqA[i] == '.')			{ masks.dotA |= bit; }
+		else if (seqA[i] == '-')	{ masks.gapA |= bit; }
+		if (seqB[i] == '.')			{ masks.dotB |= bit; }
+		else if (seqB[i] == '-')	{ masks.gapB |= bit; }
+		if (seqA[i] != seqB[i])		{ masks.diff |= bit; }
+	}
+}
+/**************************************************************************************************/
+#ifdef COLUMNDIST_X86
+__attribute__((target("sse4.2")))
+static void sseColumnMasks(const char* seqA, const char* seqB, int numColumns, ColumnMasks& masks) {
+	if (numColumns < 64) { scalarColumnMasks(seqA, seqB, numColumns, masks); return; } //don't read past the end of the alignment
+
+	const __m128i dot = _mm_set1_epi8('.');
+	const __m128i gap = _mm_set1_epi8('-');
+
+	masks.dotA = 0; masks.gapA = 0; masks.dotB = 0; masks.gapB = 0; masks.diff = 0;
+	masks.valid = ~0ULL;
+
+	for (int k = 0; k < 64; k += 16) {
+		__m128i a = _mm_loadu_si128((const __m128i*)(seqA + k));
+		__m128i b = _mm_loadu_si128((const __m128i*)(seqB + k));
+
+		masks.dotA |= (ColumnBits)(unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(a, dot)) << k;
+		masks.gapA |= (ColumnBits)(unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(a, gap)) << k;
+		masks.dotB |= (ColumnBits)(unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(b, dot)) << k;
+		masks.gapB |= (ColumnBits)(unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(b, gap)) << k;
+		masks.diff |= (ColumnBits)((~(unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(a, b))) & 0xFFFF) << k;
+	}
+}
+/**************************************************************************************************/
+__attribute__((target("avx2")))
+static void avx2ColumnMasks(const char* seqA, const char* seqB, int numColumns, ColumnMasks& masks) {
+	if (numColumns < 64) { scalarColumnMasks(seqA, seqB, numColumns, masks); return; }
+
+	const __m256i dot = _mm256_set1_epi8('.');
+	const __m256i gap = _mm256_set1_epi8('-');
+
+	masks.dotA = 0; masks.gapA = 0; masks.dotB = 0; masks.gapB = 0; masks.diff = 0;
+	masks.valid = ~0ULL;
+
+	for (int k = 0; k < 64; k += 32) {
+		__m256i a = _mm256_loadu_si256((const __m256i*)(seqA + k));
+		__m256i b = _mm256_loadu_si256((const __m256i*)(seqB + k));
+
+		masks.dotA |= (ColumnBits)(unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, dot)) << k;
+		masks.gapA |= (ColumnBits)(unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, gap)) << k;
+		masks.dotB |= (ColumnBits)(unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(b, dot)) << k;
+		masks.gapB |= (ColumnBits)(unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(b, gap)) << k;
+		masks.diff |= (ColumnBits)(~(unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b))) << k;
+	}
+}
+#endif
+/**************************************************************************************************/
+static ColumnMaskFunction selectKernel() {
+#ifdef COLUMNDIST_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))		{ return avx2ColumnMasks;	}
+	if (__builtin_cpu_supports("sse4.2"))	{ return sseColumnMasks;	}
+#endif
+	return scalarColumnMasks;
+}
+static const ColumnMaskFunction bestKernel = selectKernel();
+
+/**************************************************************************************************/
+string ColumnDist::getKernelName() {
+#ifdef COLUMNDIST_X86
+	if (bestKernel == avx2ColumnMasks)	{ return "avx2";	}
+	if (bestKernel == sseColumnMasks)	{ return "sse4.2";	}
+#endif
+	return "scalar";
+}
+/**************************************************************************************************/
+ColumnMaskFunction ColumnDist::getKernel(string name) {
+	if (name == "scalar") { return scalarColumnMasks; }
+#ifdef COLUMNDIST_X86
+	__builtin_cpu_init();
+	if ((name == "sse4.2") && __builtin_cpu_supports("sse4.2"))	{ return sseColumnMasks;	}
+	if ((name == "avx2") && __builtin_cpu_supports("avx2"))		{ return avx2ColumnMasks;	}
+#endif
+	return NULL;
+}
+/**************************************************************************************************/
+ColumnDist::ColumnDist(string calc, bool ends) : Dist() {
+	if (calc == "nogaps")		{ method = NOGAPS;	}
+	else if (calc == "eachgap")	{ method = EACHGAP;	}
+	else						{ method = ONEGAP;	}
+	countEnds = ends;
+	getMasks = bestKernel;
+	cutoff = -1;
+}
+/**************************************************************************************************/
+//every column left can add at most one to the length, so if the differences so far are too many even if all of them
+//counted without a difference, the pair is over the cutoff. dist is set to that lower bound, which is above the cutoff.
+bool ColumnDist::aboveCutoff(int diff, int length, int columnsLeft) {
+	if ((cutoff < 0) || (diff == 0)) { return false; }
+	if (columnsLeft < 0) { columnsLeft = 0; }
+
+	double lowestDist = (double)diff / (double)(length + columnsLeft);
+	if (lowestDist > cutoff) { dist = lowestDist; return true; }
+
+	return false;
+}
+/**************************************************************************************************/
+void ColumnDist::calcDist(const char* seqA, const char* seqB, int alignLength) {
+	try {
+		if (method == NOGAPS)		{ noGaps(seqA, seqB, alignLength); } //nogaps ignores countends
+		else if (method == EACHGAP) {
+			if (countEnds)	{ eachGap(seqA, seqB, alignLength);					}
+			else			{ eachGapIgnoreTermGaps(seqA, seqB, alignLength);	}
+		}else {
+			if (countEnds)	{ oneGap(seqA, seqB, alignLength);					}
+			else			{ oneGapIgnoreTermGaps(seqA, seqB, alignLength);	}
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ColumnDist", "calcDist");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//startA/endA and startB/endB are the first and last columns of each sequence that aren't '.'. With countends the overhang
+//of the longer read counts, so a pair needs both spans, otherwise only where they overlap. Outside that window both reads
+//are all '.', which every calculator skips or stops at.
+void ColumnDist::calcDist(const char* seqA, const char* seqB, int startA, int endA, int startB, int endB) {
+	try {
+		int start, end;
+		if (countsTerminalGaps())	{ start = min(startA, startB); end = max(endA, endB); }
+		else						{ start = max(startA, startB); end = min(endA, endB); }
+		if (end < start) { start = 0; end = -1; }
+		calcDist(seqA + start, seqB + start, end - start + 1);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ColumnDist", "calcDist");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//same as ignoreGaps - starts at the first column where neither sequence is '.', stops at the next column where either one is
+void ColumnDist::noGaps(const char* seqA, const char* seqB, int alignLength) {
+	int diff = 0;
+	int length = 0;
+	bool overlap = false;
+	ColumnMasks masks;
+
+	for (int pos = 0; pos < alignLength; pos += 64) {
+		getMasks(seqA+pos, seqB+pos, min(64, alignLength-pos), masks);
+
+		ColumnBits anyDot = masks.dotA | masks.dotB;
+		ColumnBits window = masks.valid;
+		if (!overlap) {
+			ColumnBits begin = masks.valid & ~anyDot;
+			if (begin == 0) { continue; }
+			overlap = true;
+			window &= bitsFrom(lowestBit(begin));
+		}
+
+		ColumnBits stop = anyDot & window;
+		if (stop) { window &= bitsBelow(lowestBit(stop)); }
+
+		ColumnBits counted = window & ~(masks.gapA | masks.gapB);
+		length += popCount(counted);
+		diff += popCount(counted & masks.diff);
+
+		if (stop) { break; }
+		if (aboveCutoff(diff, length, alignLength - (pos+64))) { return; }
+	}
+
+	if(length == 0)		{	dist = 1.0000;								}
+	else				{	dist = ((double)diff  / (double)length);	}
+}
+/**************************************************************************************************/
+//same as eachGapDist - starts at the first column that isn't '.' in both, stops at the next column that is
+void ColumnDist::eachGap(const char* seqA, const char* seqB, int alignLength) {
+	int diff = 0;
+	int length = 0;
+	bool started = false;
+	ColumnMasks masks;
+
+	for (int pos = 0; pos < alignLength; pos += 64) {
+		getMasks(seqA+pos, seqB+pos, min(64, alignLength-pos), masks);
+
+		ColumnBits bothDot = masks.dotA & masks.dotB;
+		ColumnBits window = masks.valid;
+		if (!started) {
+			ColumnBits begin = masks.valid & ~bothDot;
+			if (begin == 0) { continue; }
+			started = true;
+			window &= bitsFrom(lowestBit(begin));
+		}
+
+		ColumnBits stop = bothDot & window;
+		if (stop) { window &= bitsBelow(lowestBit(stop)); }
+
+		//a gap or '.' against a gap or '.' doesn't count
+		ColumnBits counted = window & ~((masks.dotA | masks.gapA) & (masks.dotB | masks.gapB));
+		length += popCount(counted);
+		diff += popCount(counted & masks.diff);
+
+		if (stop) { break; }
+		if (aboveCutoff(diff, length, alignLength - (pos+64))) { return; }
+	}
+
+	if(length == 0)	{	dist = 1.0000;								}
+	else			{	dist = ((double)diff  / (double)length);	}
+}
+/**************************************************************************************************/
+//finds the first and last columns where both sequences have a base
+bool ColumnDist::findOverlap(const char* seqA, const char* seqB, int alignLength, int& start, int& end) {
+	ColumnMasks masks;
+	start = -1; end = -1;
+
+	for (int pos = 0; pos < alignLength; pos += 64) {
+		getMasks(seqA+pos, seqB+pos, min(64, alignLength-pos), masks);
+		ColumnBits bothBase = masks.valid & ~(masks.dotA | masks.gapA | masks.dotB | masks.gapB);
+		if (bothBase) { start = pos + lowestBit(bothBase); break; }
+	}
+	if (start == -1) { return false; }
+
+	for (int pos = ((alignLength-1) / 64) * 64; pos >= (start / 64) * 64; pos -= 64) {
+		getMasks(seqA+pos, seqB+pos, min(64, alignLength-pos), masks);
+		ColumnBits bothBase = masks.valid & ~(masks.dotA | masks.gapA | masks.dotB | masks.gapB);
+		if (bothBase) { end = pos + highestBit(bothBase); break; }
+	}
+
+	return true;
+}
+/**************************************************************************************************/
+//same as eachGapIgnoreTermGapDist - counts from the first to the last column where both have a base, stops early at a '.'
+void ColumnDist::eachGapIgnoreTermGaps(const char* seqA, const char* seqB, int alignLength) {
+	int diff = 0;
+	int length = 0;
+	int start, end;
+	ColumnMasks masks;
+
+	if (findOverlap(seqA, seqB, alignLength, start, end)) {
+		for (int pos = (start / 64) * 64; pos <= end; pos += 64) {
+			getMasks(seqA+pos, seqB+pos, min(64, alignLength-pos), masks);
+
+			ColumnBits window = masks.valid & bitsFrom(start-pos) & bitsBelow(end-pos+1);
+
+			ColumnBits stop = (masks.dotA | masks.dotB) & window;
+			if (stop) { window &= bitsBelow(lowestBit(stop)); }
+
+			ColumnBits counted = window & ~(masks.gapA & masks.gapB);
+			length += popCount(counted);
+			diff += popCount(counted & masks.diff);
+
+			if (stop) { break; }
+			if (aboveCutoff(diff, length, end - (pos+63))) { return; }
+		}
+	}
+
+	if(length == 0)	{	dist = 1.0000;								}
+	else			{	dist = ((double)diff  / (double)length);	}
+}
+/**************************************************************************************************/
+enum ColumnEvent { NOEVENT, GAPINA, GAPINB, BOTHBASES };
+
+//a run of gap columns in one sequence counts as a single difference. Columns where both are gaps don't end the run,
+//so a gap column opens a new gap when the last column that wasn't skipped was not a gap in the same sequence.
+static int countGapOpenings(ColumnBits gapsA, ColumnBits gapsB, ColumnBits bases, ColumnEvent& last) {
+	ColumnBits events = gapsA | gapsB | bases;
+	if (events == 0) { return 0; }
+
+	int openings = 0;
+	ColumnBits gaps[2] = { gapsA, gapsB };
+	ColumnEvent types[2] = { GAPINA, GAPINB };
+
+	for (int k = 0; k < 2; k++) {
+		//columns right after a gap column of the same kind just continue it
+		ColumnBits carry = (last == types[k]) ? 1ULL : 0ULL;
+		ColumnBits candidates = gaps[k] & ~((gaps[k] << 1) | carry);
+
+		while (candidates) {
+			int pos = lowestBit(candidates);
+			candidates &= candidates - 1;
+
+			ColumnBits before = events & bitsBelow(pos);
+			bool continues;
+			if (before)	{ continues = (gaps[k] >> highestBit(before)) & 1ULL;	}
+			else		{ continues = (last == types[k]);						}
+			if (!continues) { openings++; }
+		}
+	}
+
+	int top = highestBit(events);
+	if ((gapsA >> top) & 1ULL)		{ last = GAPINA;	}
+	else if ((gapsB >> top) & 1ULL)	{ last = GAPINB;	}
+	else							{ last = BOTHBASES;	}
+
+	return openings;
+}
+/**************************************************************************************************/
+//same as oneGapDist - starts at the first column that isn't '.' in both, stops at the next column that is
+void ColumnDist::oneGap(const char* seqA, const char* seqB, int alignLength) {
+	int difference = 0;
+	int minLength = 0;
+	bool started = false;
+	ColumnEvent last = NOEVENT;
+	ColumnMasks masks;
+
+	for (int pos = 0; pos < alignLength; pos += 64) {
+		getMasks(seqA+pos, seqB+pos, min(64, alignLength-pos), masks);
+
+		ColumnBits bothDot = masks.dotA & masks.dotB;
+		ColumnBits window = masks.valid;
+		if (!started) {
+			ColumnBits begin = masks.valid & ~bothDot;
+			if (begin == 0) { continue; }
+			started = true;
+			window &= bitsFrom(lowestBit(begin));
+		}
+
+		ColumnBits stop = bothDot & window;
+		if (stop) { window &= bitsBelow(lowestBit(stop)); }
+
+		ColumnBits notBaseA = masks.dotA | masks.gapA;
+		ColumnBits notBaseB = masks.dotB | masks.gapB;
+		ColumnBits bases = window & ~notBaseA & ~notBaseB;
+
+		int openings = countGapOpenings(window & notBaseA & ~notBaseB, window & ~notBaseA & notBaseB, bases, last);
+		difference += openings + popCount(bases & masks.diff);
+		minLength += openings + popCount(bases);
+
+		if (stop) { break; }
+		if (aboveCutoff(difference, minLength, alignLength - (pos+64))) { return; }
+	}
+
+	if(minLength == 0)	{	dist = 1.0000;							}
+	else				{	dist = (double)difference / minLength;	}
+}
+/**************************************************************************************************/
+//same as oneGapIgnoreTermGapDist - from the first to the last column where both have a base, only '-' is a gap
+void ColumnDist::oneGapIgnoreTermGaps(const char* seqA, const char* seqB, int alignLength) {
+	int difference = 0;
+	int minLength = 0;
+	int start, end;
+	ColumnEvent last = NOEVENT;
+	ColumnMasks masks;
+
+	if (findOverlap(seqA, seqB, alignLength, start, end)) {
+		for (int pos = (start / 64) * 64; pos <= end; pos += 64) {
+			getMasks(seqA+pos, seqB+pos, min(64, alignLength-pos), masks);
+
+			ColumnBits window = masks.valid & bitsFrom(start-pos) & bitsBelow(end-pos+1);
+			ColumnBits bases = window & ~masks.gapA & ~masks.gapB;
+
+			int openings = countGapOpenings(window & masks.gapA & ~masks.gapB, window & ~masks.gapA & masks.gapB, bases, last);
+			difference += openings + popCount(bases & masks.diff);
+			minLength += openings + popCount(bases);
+
+			if (aboveCutoff(difference, minLength, end - (pos+63))) { return; }
+		}
+	}
+
+	if(minLength == 0)	{	dist = 1.0000;							}
+	else				{	dist = (double)difference / minLength;	}
+}
+/**************************************************************************************************/
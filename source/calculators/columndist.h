@@ -0,0 +1,64 @@
+#ifndef COLUMNDIST_H
+#define COLUMNDIST_H
+/*
+ *  columndist.h
+ *  Mothur
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 Schloss Lab. All rights reserved.
+ *
+ *	Calculates the nogaps, eachgap and onegap distances (with or without terminal gaps) for aligned sequences 64 columns at a time.
+ *	Each block of columns is turned into bitmasks ('.', '-' and mismatch for each sequence) with SSE4.2 or AVX2 byte compares,
+ *	chosen at runtime with a scalar fallback, and the distance is counted from the masks. Results match ignoreGaps, eachGapDist,
+ *	oneGapDist, eachGapIgnoreTermGapDist and oneGapIgnoreTermGapDist exactly.
+ *
+ */
+
+#include "dist.h"
+
+/**************************************************************************************************/
+//bit k is column k of the block
+struct ColumnMasks {
+	unsigned long long dotA, gapA, dotB, gapB, diff, valid;
+};
+
+typedef void (*ColumnMaskFunction)(const char*, const char*, int, ColumnMasks&);
+
+/**************************************************************************************************/
+
+class ColumnDist : public Dist {
+
+public:
+	ColumnDist(string, bool);  //calc - nogaps, eachgap or onegap, countends
+	~ColumnDist() {}
+
+	void calcDist(const char*, const char*, int);
+	void calcDist(const char*, const char*, int, int, int, int);	//only the columns the pair covers - startA, endA, startB, endB
+
+	static string getKernelName();  //avx2, sse4.2 or scalar
+	static ColumnMaskFunction getKernel(string);   //for testing a specific kernel, returns NULL if this cpu can't run it
+	void setKernel(ColumnMaskFunction f) { getMasks = f; }
+	bool countsTerminalGaps() { return ((method != NOGAPS) && countEnds); }
+	
+	//stop scanning a pair once its distance must be above the cutoff, distances at or below it are exact. -1 turns it off.
+	void setCutoff(double c) { cutoff = c; }
+
+private:
+	enum Method { NOGAPS, EACHGAP, ONEGAP };
+	Method method;
+	bool countEnds;
+	ColumnMaskFunction getMasks;
+	double cutoff;
+
+	void noGaps(const char*, const char*, int);
+	void eachGap(const char*, const char*, int);
+	void eachGapIgnoreTermGaps(const char*, const char*, int);
+	void oneGap(const char*, const char*, int);
+	void oneGapIgnoreTermGaps(const char*, const char*, int);
+	bool findOverlap(const char*, const char*, int, int&, int&);
+	bool aboveCutoff(int, int, int);
+};
+
+/**************************************************************************************************/
+
+#endif
@@ -20,7 +20,12 @@ public:
 	Dist(){ dist = 0; m = MothurOut::getInstance(); }
 	Dist(const Dist& d) : dist(d.dist) { m = MothurOut::getInstance(); }
 	virtual ~Dist() {}
-	virtual void calcDist(Sequence, Sequence) = 0;
+	
+	//reads the aligned strings in place, nothing is copied per pair
+	void calcDist(const Sequence& A, const Sequence& B) { const string& seqA = A.getAligned(); calcDist(seqA.c_str(), B.getAligned().c_str(), seqA.length()); }
+	
+	//seqA and seqB point at alignLength columns of aligned sequence, so callers can pack their alignment once and borrow from it
+	virtual void calcDist(const char*, const char*, int) = 0;
 	double getDist()	{	return dist;	}
 
 protected:
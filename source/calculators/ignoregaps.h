@@ -22,16 +22,12 @@ public:
 	
 	ignoreGaps() {}
 	
-	void calcDist(Sequence A, Sequence B){		
+	void calcDist(const char* seqA, const char* seqB, int alignLength){		
 		int diff = 0;
 		int length = 0;
 		int start = 0;
 		bool overlap = false;
 		
-		string seqA = A.getAligned();
-		string seqB = B.getAligned();
-		int alignLength = seqA.length();
-		
 		for(int i=0;i<alignLength;i++){
 			if(seqA[i] != '.' && seqB[i] != '.'){
 				start = i;
@@ -20,7 +20,7 @@ public:
 	
 	oneGapIgnoreTermGapDist() {}
 	
-	void calcDist(Sequence A, Sequence B){
+	void calcDist(const char* seqA, const char* seqB, int alignLength){
 		
 		int difference = 0;
 		int openGapA = 0;
@@ -29,10 +29,6 @@ public:
 		int start = 0;
 		int end = 0;
 		bool overlap = false;
-		
-		string seqA = A.getAligned();
-		string seqB = B.getAligned();
-		int alignLength = seqA.length();
 
 		// this assumes that sequences start and end with '.'s instead of'-'s.
 		for(int i=0;i<alignLength;i++){
@@ -22,6 +22,7 @@ public:
 	SharedAce(int n=10) : abund(n),  Calculator("sharedace", 1, false) {};
 	EstOutput getValues(SAbundVector*) {return data;};
 	EstOutput getValues(vector<SharedRAbundVector*>);
+	bool getIgnoresEmptyOtus() { return true; }
 	string getCitation() { return "http://www.mothur.org/wiki/SharedAce"; }
 private:
 	int abund;
@@ -19,6 +19,7 @@ class Anderberg : public Calculator  {
 		Anderberg() :  Calculator("anderberg", 1, false) {};
 		EstOutput getValues(SAbundVector*) {return data;};
 		EstOutput getValues(vector<SharedRAbundVector*>);
+		bool getIgnoresEmptyOtus() { return true; }
 		string getCitation() { return "http://www.mothur.org/wiki/Anderberg"; }
 	private:
 
@@ -23,6 +23,7 @@ public:
 	JAbund() :  Calculator("jabund", 1, false) {};
 	EstOutput getValues(SAbundVector*) {return data;};
 	EstOutput getValues(vector<SharedRAbundVector*>);
+	bool getIgnoresEmptyOtus() { return true; }
 	string getCitation() { return "http://www.mothur.org/wiki/Jabund"; }
 private:
 	UVEst* uv;
@@ -22,6 +22,7 @@ public:
 	Jclass() :  Calculator("jclass", 1, false) {};
 	EstOutput getValues(SAbundVector*) {return data;};
 	EstOutput getValues(vector<SharedRAbundVector*>);
+	bool getIgnoresEmptyOtus() { return true; }
 	string getCitation() { return "http://www.mothur.org/wiki/Jclass"; }
 private:
 	
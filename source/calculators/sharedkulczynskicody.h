@@ -21,6 +21,7 @@ public:
 	KulczynskiCody() :  Calculator("kulczynskicody", 1, false) {};
 	EstOutput getValues(SAbundVector*) {return data;};
 	EstOutput getValues(vector<SharedRAbundVector*>);
+	bool getIgnoresEmptyOtus() { return true; }
 	string getCitation() { return "http://www.mothur.org/wiki/Kulczynskicody"; }
 private:
 	
@@ -21,6 +21,7 @@ public:
 	Lennon() :  Calculator("lennon", 1, false) {};
 	EstOutput getValues(SAbundVector*) {return data;};
 	EstOutput getValues(vector<SharedRAbundVector*>);
+	bool getIgnoresEmptyOtus() { return true; }
 	string getCitation() { return "http://www.mothur.org/wiki/Lennon"; }
 private:
 	
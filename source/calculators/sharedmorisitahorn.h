@@ -20,6 +20,7 @@ public:
 	MorHorn() :  Calculator("morisitahorn", 1, false) {};
 	EstOutput getValues(SAbundVector*) {return data;};
 	EstOutput getValues(vector<SharedRAbundVector*>);
+	bool getIgnoresEmptyOtus() { return true; }
 	string getCitation() { return "http://www.mothur.org/wiki/Morisitahorn"; }
 private:
 	
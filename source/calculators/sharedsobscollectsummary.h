@@ -21,6 +21,7 @@ public:
 	SharedSobsCS() : Calculator("sharedsobs", 1, true) {};
 	EstOutput getValues(SAbundVector* rank){ return data; };
 	EstOutput getValues(vector<SharedRAbundVector*>);
+	bool getIgnoresEmptyOtus() { return true; }
     EstOutput getValues(vector<SharedRAbundVector*>, vector<string>&);
 	string getCitation() { return "http://www.mothur.org/wiki/Sharedsobs"; }
 };
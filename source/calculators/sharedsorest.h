@@ -23,6 +23,7 @@ public:
 	SorEst() :  Calculator("sorest", 1, false) {};
 	EstOutput getValues(SAbundVector*) {return data;};
 	EstOutput getValues(vector<SharedRAbundVector*>);
+	bool getIgnoresEmptyOtus() { return true; }
 	string getCitation() { return "http://www.mothur.org/wiki/Sorest"; }
 private:
 	
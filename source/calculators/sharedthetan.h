@@ -23,6 +23,7 @@ public:
 	ThetaN() :  Calculator("thetan", 1, false) {};
 	EstOutput getValues(SAbundVector*) {return data;};
 	EstOutput getValues(vector<SharedRAbundVector*>);
+	bool getIgnoresEmptyOtus() { return true; }
 	string getCitation() { return "http://www.mothur.org/wiki/Thetan"; }
 private:
 	
@@ -23,6 +23,7 @@ public:
 	ThetaYC() :  Calculator("thetayc", 3, false) {};
 	EstOutput getValues(SAbundVector*) {return data;};
 	EstOutput getValues(vector<SharedRAbundVector*>);
+	bool getIgnoresEmptyOtus() { return true; }
 	string getCitation() { return "http://www.mothur.org/wiki/Thetayc"; }
 private:
 	
@@ -11,6 +11,16 @@
 #include "kmer.hpp"
 #include "phylosummary.h"
 
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+static const char probFileMagic[8] = { 'M', 'O', 'T', 'H', 'U', 'R', 'B', 'Y' };
+static const unsigned int probFileVersion = 1;
+
 /**************************************************************************************************/
 Bayesian::Bayesian(string tfile, string tempFile, string method, int ksize, int cutoff, int i, int tid, bool f, bool sh) : 
 Classify(), kmerSize(ksize), confidenceThreshold(cutoff), iters(i) {
@@ -29,48 +39,76 @@ Classify(), kmerSize(ksize), confidenceThreshold(cutoff), iters(i) {
 		string phyloTreeSumName = tfileroot + "tree.sum";
 		string probFileName = tfileroot + tempfileroot + char('0'+ kmerSize) + "mer.prob";
 		string probFileName2 = tfileroot + tempfileroot + char('0'+ kmerSize) + "mer.numNonZero";
-		
-		ofstream out;
-		ofstream out2;
+		string probFileNameBin = tfileroot + tempfileroot + char('0'+ kmerSize) + "mer.prob.bin";
 		
 		ifstream phyloTreeTest(phyloTreeName.c_str());
 		ifstream probFileTest2(probFileName2.c_str());
 		ifstream probFileTest(probFileName.c_str());
 		ifstream probFileTest3(phyloTreeSumName.c_str());
+		ifstream probFileTestBin(probFileNameBin.c_str());
 		
 		int start = time(NULL);
 		
+		probMatrix = NULL; mapData = NULL; mapSize = 0; mapped = false;
+		bool loaded = false;
+		
 		//if they are there make sure they were created after this release date
 		bool FilesGood = false;
-		if(probFileTest && probFileTest2 && phyloTreeTest && probFileTest3){
+		if(probFileTestBin && phyloTreeTest && probFileTest3){
+			string version = m->getVersion();
+			FilesGood = m->checkReleaseVersion(probFileTestBin, version) && m->checkReleaseVersion(phyloTreeTest, version) && m->checkReleaseVersion(probFileTest3, version);
+			probFileTestBin.close();
+			
+			if (FilesGood) {
+				m->mothurOut("Reading template taxonomy...     "); cout.flush();
+				
+				phyloTree = new PhyloTree(phyloTreeTest, phyloTreeName);
+				maxLevel = phyloTree->getMaxLevel();
+				
+				m->mothurOut("DONE."); m->mothurOutEndLine();
+				
+				genusNodes = phyloTree->getGenusNodes(); 
+				genusTotals = phyloTree->getGenusTotals();
+				numGenera = genusNodes.size();
+				
+				m->mothurOut("Reading template probabilities...     "); cout.flush();
+				loaded = readProbBinaryFile(probFileNameBin);
+				
+				if (!loaded) { delete phyloTree; phyloTree = NULL; m->mothurOut("\n"); }
+			}
+		}else if(probFileTest && probFileTest2 && phyloTreeTest && probFileTest3){
 			FilesGood = checkReleaseDate(probFileTest, probFileTest2, phyloTreeTest, probFileTest3);
+			
+			if (FilesGood) {
+				m->mothurOut("Reading template taxonomy...     "); cout.flush();
+				
+				phyloTree = new PhyloTree(phyloTreeTest, phyloTreeName);
+				maxLevel = phyloTree->getMaxLevel();
+				
+				m->mothurOut("DONE."); m->mothurOutEndLine();
+				
+				genusNodes = phyloTree->getGenusNodes(); 
+				genusTotals = phyloTree->getGenusTotals();
+				numGenera = genusNodes.size();
+				
+				m->mothurOut("Reading template probabilities...     "); cout.flush();
+				readProbFile(probFileTest, probFileTest2, probFileName, probFileName2);
+				probMatrix = &wordGenusProb[0];
+				loaded = true;
+			}
 		}
 
-		if(probFileTest && probFileTest2 && phyloTreeTest && probFileTest3 && FilesGood){
-			
-			m->mothurOut("Reading template taxonomy...     "); cout.flush();
-			
-			phyloTree = new PhyloTree(phyloTreeTest, phyloTreeName);
-            maxLevel = phyloTree->getMaxLevel();
-			
-			m->mothurOut("DONE."); m->mothurOutEndLine();
-			
-			genusNodes = phyloTree->getGenusNodes(); 
-			genusTotals = phyloTree->getGenusTotals();
-			
-            m->mothurOut("Reading template probabilities...     "); cout.flush();
-            readProbFile(probFileTest, probFileTest2, probFileName, probFileName2);
-			
-        }else{
+		if (!loaded) {
 		
 			//create search database and names vector
 			generateDatabaseAndNames(tfile, tempFile, method, ksize, 0.0, 0.0, 0.0, 0.0);
 			
 			//prevents errors caused by creating shortcut files if you had an error in the sanity check.
-			if (m->control_pressed) {  m->mothurRemove(phyloTreeName);  m->mothurRemove(probFileName); m->mothurRemove(probFileName2); }
+			if (m->control_pressed) {  m->mothurRemove(phyloTreeName);  m->mothurRemove(probFileNameBin); }
 			else{ 
 				genusNodes = phyloTree->getGenusNodes(); 
 				genusTotals = phyloTree->getGenusTotals();
+				numGenera = genusNodes.size();
 				
 				m->mothurOut("Calculating template taxonomy tree...     "); cout.flush();
 				
@@ -83,36 +121,14 @@ Classify(), kmerSize(ksize), confidenceThreshold(cutoff), iters(i) {
 				numKmers = database->getMaxKmer() + 1;
 			
 				//initialze probabilities
-				wordGenusProb.resize(numKmers);
+				wordGenusProb.resize(numKmers * (long long) numGenera);
                 for (int j = 0; j < numKmers; j++) {  diffPair tempDiffPair; WordPairDiffArr.push_back(tempDiffPair); }
-			
-				for (int j = 0; j < wordGenusProb.size(); j++) {	wordGenusProb[j].resize(genusNodes.size());		}
-                ofstream out;
-				ofstream out2;
-
-                if (shortcuts) { 
-                    m->openOutputFile(probFileName, out); 
-				
-                    //output mothur version
-                    out << "#" << m->getVersion() << endl;
-				
-                    out << numKmers << endl;
-				
-                    m->openOutputFile(probFileName2, out2);
-				
-                    //output mothur version
-                    out2 << "#" << m->getVersion() << endl;
-                }
-				
-				
 
 				//for each word
 				for (int i = 0; i < numKmers; i++) {
                     //m->mothurOut("[DEBUG]: kmer = " + toString(i) + "\n");
                     
 					if (m->control_pressed) {  break; }
-
-                    if (shortcuts) {  out << i << '\t'; }
 					
 					vector<int> seqsWithWordi = database->getSequencesWithKmer(i);
 					
@@ -128,30 +144,15 @@ Classify(), kmerSize(ksize), confidenceThreshold(cutoff), iters(i) {
 					diffPair tempProb(log(probabilityInTemplate), 0.0);
 					WordPairDiffArr[i] = tempProb;
 						
-					int numNotZero = 0;
-					for (int k = 0; k < genusNodes.size(); k++) {
+					float* wordProbs = &wordGenusProb[i * (long long) numGenera];
+					for (int k = 0; k < numGenera; k++) {
 						//probabilityInThisTaxonomy = (# of seqs with that word in this taxonomy + probabilityInTemplate) / (total number of seqs in this taxonomy + 1);
-						
-						
-						wordGenusProb[i][k] = log((count[k] + probabilityInTemplate) / (float) (genusTotals[k] + 1));  
-									
-						if (count[k] != 0) {
-                            if (shortcuts) { out << k << '\t' << wordGenusProb[i][k] << '\t' ; }
-							numNotZero++;
-						}
+						wordProbs[k] = log((count[k] + probabilityInTemplate) / (float) (genusTotals[k] + 1));  
 					}
-					
-                    
-                    if (shortcuts) {
-                        out << endl;
-                        out2 << probabilityInTemplate << '\t' << numNotZero << '\t' << log(probabilityInTemplate) << endl;
-                    }
-                    
 				}
-                if (shortcuts) {
-                    out.close();
-                    out2.close();
-                }
+				probMatrix = &wordGenusProb[0];
+				
+                if (shortcuts && !m->control_pressed) { writeProbBinaryFile(probFileNameBin); }
 				
 				//read in new phylotree with less info. - its faster
 				ifstream phyloTreeTest(phyloTreeName.c_str());
@@ -179,6 +180,7 @@ Bayesian::~Bayesian() {
 	try {
         if (phyloTree != NULL) { delete phyloTree; }
         if (database != NULL) {  delete database; }
+        unmapProbFile();
 	}
 	catch(exception& e) {
 		m->errorOut(e, "Bayesian", "~Bayesian");
@@ -189,38 +191,51 @@ Bayesian::~Bayesian() {
 /**************************************************************************************************/
 string Bayesian::getTaxonomy(Sequence* seq) {
 	try {
-		string tax = "";
-		Kmer kmer(kmerSize);
 		flipped = false;
+		return classifySeq(seq, simpleTax, flipped, NULL, NULL);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Bayesian", "getTaxonomy");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//safe to call from several threads at once, seed starts this sequence's own random numbers for the bootstrap
+string Bayesian::getSharedTaxonomy(Sequence* seq, string& simple, bool& seqFlipped, string& messages, unsigned long long seed) {
+	try {
+		mt19937_64 rng(seed);
+		seqFlipped = false;
+		messages = "";
+		return classifySeq(seq, simple, seqFlipped, &rng, &messages);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Bayesian", "getSharedTaxonomy");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//rng is NULL when there is only one caller, then mothur's random numbers are used. messages is NULL when they can be
+//printed as they come
+string Bayesian::classifySeq(Sequence* seq, string& simple, bool& seqFlipped, mt19937_64* rng, string* messages) {
+	try {
+		string tax = "";
 		
 		//get words contained in query
-		//getKmerString returns a string where the index in the string is hte kmer number 
-		//and the character at that index can be converted to be the number of times that kmer was seen
-		string queryKmerString = kmer.getKmerString(seq->getUnaligned()); 
-		
-		vector<int> queryKmers;
-		for (int i = 0; i < queryKmerString.length()-1; i++) {	// the -1 is to ignore any kmer with an N in it
-			if (queryKmerString[i] != '!') { //this kmer is in the query
-				queryKmers.push_back(i);
-			}
-		}
+		vector<int> queryKmers = createWordIndexArr(seq);
 		
 		//if user wants to test reverse compliment and its reversed use that instead
 		if (flip) {	
 			if (isReversed(queryKmers)) { 
-				flipped = true;
+				seqFlipped = true;
 				seq->reverseComplement(); 
-				queryKmerString = kmer.getKmerString(seq->getUnaligned()); 
-				queryKmers.clear();
-				for (int i = 0; i < queryKmerString.length()-1; i++) {	// the -1 is to ignore any kmer with an N in it
-					if (queryKmerString[i] != '!') { //this kmer is in the query
-						queryKmers.push_back(i);
-					}
-				}
+				queryKmers = createWordIndexArr(seq);
 			}  
 		}
 		
-		if (queryKmers.size() == 0) {  m->mothurOut(seq->getName() + " is bad. It has no kmers of length " + toString(kmerSize) + "."); m->mothurOutEndLine(); simpleTax = "unknown;";  return "unknown;"; }
+		if (queryKmers.size() == 0) {  
+			output(seq->getName() + " is bad. It has no kmers of length " + toString(kmerSize) + ".\n", messages);
+			simple = "unknown;";  return "unknown;"; 
+		}
 		
 		
 		int index = getMostProbableTaxonomy(queryKmers);
@@ -230,21 +245,55 @@ string Bayesian::getTaxonomy(Sequence* seq) {
 		//bootstrap - to set confidenceScore
 		int numToSelect = queryKmers.size() / 8;
 	
-        if (m->debug) {  m->mothurOut(seq->getName() + "\t"); }
+        if (m->debug) {  output(seq->getName() + "\t", messages); }
         
-		tax = bootstrapResults(queryKmers, index, numToSelect);
+		tax = bootstrapResults(queryKmers, index, numToSelect, simple, rng, messages);
         
-        if (m->debug) {  m->mothurOut("\n"); }
+        if (m->debug) {  output("\n", messages); }
 		
 		return tax;	
 	}
 	catch(exception& e) {
-		m->errorOut(e, "Bayesian", "getTaxonomy");
+		m->errorOut(e, "Bayesian", "classifySeq");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//prints message, or saves it for the caller when the sequence is one of several classified at once
+void Bayesian::output(string message, string* messages) {
+	try {
+		if (messages == NULL) { m->mothurOut(message); }
+		else { *messages += message; }
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Bayesian", "output");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//returns the kmers in the sequence, each once and in order, without the kmers with an N in them
+vector<int> Bayesian::createWordIndexArr(Sequence* seq) {
+	try {
+		Kmer kmer(kmerSize);
+		vector<int> queryKmers;
+		kmer.getKmerNumbers(seq->getUnaligned(), queryKmers);
+		
+		sort(queryKmers.begin(), queryKmers.end());
+		queryKmers.erase(unique(queryKmers.begin(), queryKmers.end()), queryKmers.end());
+		if ((queryKmers.size() != 0) && (queryKmers.back() == (numKmers-1))) { queryKmers.pop_back(); }  //numKmers-1 is the kmer with an N in it
+		
+		return queryKmers;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Bayesian", "createWordIndexArr");
 		exit(1);
 	}
 }
 /**************************************************************************************************/
-string Bayesian::bootstrapResults(vector<int> kmers, int tax, int numToSelect) {
+//each replicate adds up the genus rows of the words it picked in the order it picked them, the order the sums have
+//always been taken in, so the confidences are the same as scoring the replicates one word vector at a time.
+//scoring the replicates together in that order was slower than one at a time, since a replicate's sums stay in cache.
+string Bayesian::bootstrapResults(const vector<int>& kmers, int tax, int numToSelect, string& simple, mt19937_64* rng, string* messages) {
 	try {
 				
 		map<int, int> confidenceScores; 
@@ -263,39 +312,45 @@ string Bayesian::bootstrapResults(vector<int> kmers, int tax, int numToSelect) {
 		map<int, int>::iterator itBoot;
 		map<int, int>::iterator itBoot2;
 		map<int, int>::iterator itConvert;
-			
+		
+		//get taxonomy of each replicate
+		map<int, int> replicateTaxs; //genus -> number of replicates assigned to it
+		vector<double> probs(numGenera);
 		for (int i = 0; i < iters; i++) {
 			if (m->control_pressed) { return "control"; }
 			
-			vector<int> temp;
+			fill(probs.begin(), probs.end(), 0.0);
 			for (int j = 0; j < numToSelect; j++) {
-				int index = m->getRandomIndex(kmers.size()-1);
-				
-				//add word to temp
-				temp.push_back(kmers[index]);
+				int index = getRandomIndex(kmers.size()-1, rng);
+				const float* wordProbs = &probMatrix[kmers[index] * (long long) numGenera];
+				for (int k = 0; k < numGenera; k++) { probs[k] += wordProbs[k]; }
 			}
 			
-			//get taxonomy
-			int newTax = getMostProbableTaxonomy(temp);
-			//int newTax = 1;
+			int newTax = 0;
+			int genus = getMostProbableGenus(&probs[0]);
+			if (genus != -1) { newTax = genusNodes[genus]; }
+			replicateTaxs[newTax]++;
+		}
+		
+		//add to confidence results
+		for (map<int, int>::iterator it = replicateTaxs.begin(); it != replicateTaxs.end(); it++) {
+			int newTax = it->first;
 			TaxNode taxonomyTemp = phyloTree->get(newTax);
 			
-			//add to confidence results
 			while (taxonomyTemp.level != 0) { //while you are not at the root
 				itBoot2 = confidenceScores.find(newTax); //is this a classification we already have a count on
 				
 				if (itBoot2 != confidenceScores.end()) { //this is a classification we need a confidence for
-					(itBoot2->second)++;
+					(itBoot2->second) += it->second;
 				}
 				
 				newTax = taxonomyTemp.parent;
 				taxonomyTemp = phyloTree->get(newTax);
 			}
-	
 		}
 		
 		string confidenceTax = "";
-		simpleTax = "";
+		simple = "";
 		
 		int seqTaxIndex = tax;
 		TaxNode seqTax = phyloTree->get(tax);
@@ -310,18 +365,18 @@ string Bayesian::bootstrapResults(vector<int> kmers, int tax, int numToSelect) {
 					confidence = itBoot2->second;
 				}
 				
-                if (m->debug) { m->mothurOut(seqTax.name + "(" + toString(((confidence/(float)iters) * 100)) + ");"); }
+                if (m->debug) { output(seqTax.name + "(" + toString(((confidence/(float)iters) * 100)) + ");", messages); }
             
 				if (((confidence/(float)iters) * 100) >= confidenceThreshold) {
 					confidenceTax = seqTax.name + "(" + toString(((confidence/(float)iters) * 100)) + ");" + confidenceTax;
-					simpleTax = seqTax.name + ";" + simpleTax;
+					simple = seqTax.name + ";" + simple;
 				}
             
 				seqTaxIndex = seqTax.parent;
 				seqTax = phyloTree->get(seqTax.parent);
 		}
 		
-		if (confidenceTax == "") { confidenceTax = "unknown;"; simpleTax = "unknown;";  }
+		if (confidenceTax == "") { confidenceTax = "unknown;"; simple = "unknown;";  }
 	
 		return confidenceTax;
 		
@@ -332,34 +387,34 @@ string Bayesian::bootstrapResults(vector<int> kmers, int tax, int numToSelect) {
 	}
 }
 /**************************************************************************************************/
-int Bayesian::getMostProbableTaxonomy(vector<int> queryKmer) {
+int Bayesian::getRandomIndex(int highest, mt19937_64* rng) {
 	try {
-		int indexofGenus = 0;
-		
-		double maxProbability = -1000000.0;
-		//find taxonomy with highest probability that this sequence is from it
-		
-		
-//		cout << genusNodes.size() << endl;
+		if (rng == NULL) { return m->getRandomIndex(highest); }
+		if (highest == 0) { return 0; }
 		
+		uniform_int_distribution<int> dis(0, highest);
+		return dis(*rng);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Bayesian", "getRandomIndex");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+int Bayesian::getMostProbableTaxonomy(const vector<int>& queryKmer) {
+	try {
+		int indexofGenus = 0;
 		
-		for (int k = 0; k < genusNodes.size(); k++) {
-			//for each taxonomy calc its probability
-			
-			double prob = 0.0000;
-			for (int i = 0; i < queryKmer.size(); i++) {
-				prob += wordGenusProb[queryKmer[i]][k];
-			}
-			
-//			cout << phyloTree->get(genusNodes[k]).name << '\t' << prob << endl;
-
-			//is this the taxonomy with the greatest probability?
-			if (prob > maxProbability) { 
-				indexofGenus = genusNodes[k];
-				maxProbability = prob;
-			}
+		//for each taxonomy calc its probability, adding the query's words a row at a time
+		vector<double> probs(numGenera, 0.0);
+		for (int i = 0; i < queryKmer.size(); i++) {
+			const float* wordProbs = &probMatrix[queryKmer[i] * (long long) numGenera];
+			for (int k = 0; k < numGenera; k++) { probs[k] += wordProbs[k]; }
 		}
 		
+		//find taxonomy with highest probability that this sequence is from it
+		int genus = getMostProbableGenus(&probs[0]);
+		if (genus != -1) { indexofGenus = genusNodes[genus]; }
 			
 		return indexofGenus;
 	}
@@ -368,6 +423,27 @@ int Bayesian::getMostProbableTaxonomy(vector<int> queryKmer) {
 		exit(1);
 	}
 }
+/**************************************************************************************************/
+//returns the genus with the greatest probability, the first one if there is a tie
+int Bayesian::getMostProbableGenus(const double* probs) {
+	try {
+		int genus = -1;
+		double maxProbability = -1000000.0;
+		
+		for (int k = 0; k < numGenera; k++) {
+			if (probs[k] > maxProbability) { 
+				genus = k;
+				maxProbability = probs[k];
+			}
+		}
+		
+		return genus;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Bayesian", "getMostProbableGenus");
+		exit(1);
+	}
+}
 //********************************************************************************************************************
 //if it is more probable that the reverse compliment kmers are in the template, then we assume the sequence is reversed.
 bool Bayesian::isReversed(vector<int>& queryKmers){
@@ -417,9 +493,7 @@ void Bayesian::readProbFile(ifstream& in, ifstream& inNum, string inName, string
         
         in >> numKmers; m->gobble(in);
         //initialze probabilities
-        wordGenusProb.resize(numKmers);
-        
-        for (int j = 0; j < wordGenusProb.size(); j++) {	wordGenusProb[j].resize(genusNodes.size());		}
+        wordGenusProb.resize(numKmers * (long long) numGenera);
         
         int kmer, name, count;  count = 0;
         vector<int> num; num.resize(numKmers);
@@ -444,14 +518,15 @@ void Bayesian::readProbFile(ifstream& in, ifstream& inNum, string inName, string
             in >> kmer;
             
             //set them all to zero value
-            for (int i = 0; i < genusNodes.size(); i++) {
-                wordGenusProb[kmer][i] = log(zeroCountProb[kmer] / (float) (genusTotals[i]+1));
+            float* wordProbs = &wordGenusProb[kmer * (long long) numGenera];
+            for (int i = 0; i < numGenera; i++) {
+                wordProbs[i] = log(zeroCountProb[kmer] / (float) (genusTotals[i]+1));
             }
            
             //get probs for nonzero values
             for (int i = 0; i < num[kmer]; i++) {
                 in >> name >> prob;
-                wordGenusProb[kmer][name] = prob;
+                wordProbs[name] = prob;
             }
             
             m->gobble(in);
@@ -521,9 +596,128 @@ bool Bayesian::checkReleaseDate(ifstream& file1, ifstream& file2, ifstream& file
 	}
 }
 /**************************************************************************************************/
-
-
-
-
-
-
+/**************************************************************************************************/
+//binary shortcut file, the arrays are written as they are in memory after the version line:
+//	"#version\n", padded with zeros to a multiple of 8 bytes
+//	header			magic, format version, kmer size, number of kmers, number of genera
+//	genusNodes		numGenera ints, checked against the tree so a file from another taxonomy is not used
+//	genusTotals		numGenera ints
+//	wordProbs		numKmers floats, log of the probability of each word in the template
+//	wordGenusProb	numKmers rows of numGenera floats
+void Bayesian::writeProbBinaryFile(string fileName) {
+	try {
+		ofstream out;
+		m->openOutputFileBinary(fileName, out);
+		
+		string versionLine = "#" + m->getVersion() + "\n";
+		out.write(versionLine.c_str(), versionLine.length());
+		for (int i = versionLine.length(); (i % 8) != 0; i++) { out.put('\0'); }
+		
+		ProbFileHeader header;
+		memset(&header, 0, sizeof(ProbFileHeader));
+		memcpy(header.magic, probFileMagic, 8);
+		header.version = probFileVersion;
+		header.kmerSize = kmerSize;
+		header.numKmers = numKmers;
+		header.numGenera = numGenera;
+		out.write((const char*)&header, sizeof(ProbFileHeader));
+		
+		out.write((const char*)&genusNodes[0], numGenera * sizeof(int));
+		out.write((const char*)&genusTotals[0], numGenera * sizeof(int));
+		
+		vector<float> wordProbs(numKmers);
+		for (int i = 0; i < numKmers; i++) { wordProbs[i] = WordPairDiffArr[i].prob; }
+		out.write((const char*)&wordProbs[0], numKmers * sizeof(float));
+		
+		out.write((const char*)probMatrix, numKmers * (long long) numGenera * sizeof(float));
+		out.close();
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Bayesian", "writeProbBinaryFile");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//maps the file so the probabilities are used in place, returns false if the file can't be used and needs to be remade
+bool Bayesian::readProbBinaryFile(string fileName) {
+	try {
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+		int fd = ::open(fileName.c_str(), O_RDONLY);
+		if (fd == -1) { return false; }
+		
+		struct stat info;
+		if (fstat(fd, &info) == -1) { ::close(fd); return false; }
+		mapSize = info.st_size;
+		
+		void* region = mmap(NULL, mapSize, PROT_READ, MAP_SHARED, fd, 0);
+		::close(fd);
+		if (region == MAP_FAILED) { mapSize = 0; return false; }
+		mapData = (char*)region; mapped = true;
+#else
+		ifstream in(fileName.c_str(), ios::binary);
+		if (!in) { return false; }
+		in.seekg(0, ios::end);
+		mapSize = in.tellg();
+		in.seekg(0, ios::beg);
+		
+		mapData = new char[mapSize];
+		in.read(mapData, mapSize);
+		mapped = false;
+#endif
+		
+		//the header starts at the first multiple of 8 after the version line
+		const char* lineEnd = (const char*)memchr(mapData, '\n', mapSize);
+		unsigned long long headerStart = 0;
+		if (lineEnd != NULL) { headerStart = ((lineEnd - mapData) + 8) / 8 * 8; }
+		
+		ProbFileHeader header;
+		if ((lineEnd == NULL) || ((headerStart + sizeof(ProbFileHeader)) > mapSize)) { unmapProbFile(); return false; }
+		memcpy(&header, mapData + headerStart, sizeof(ProbFileHeader));
+		
+		unsigned long long nodesOffset = headerStart + sizeof(ProbFileHeader);
+		unsigned long long wordProbsOffset = nodesOffset + 2 * header.numGenera * sizeof(int);
+		unsigned long long matrixOffset = wordProbsOffset + header.numKmers * sizeof(float);
+		
+		bool valid = (memcmp(header.magic, probFileMagic, 8) == 0) && (header.version == probFileVersion) && (header.kmerSize == kmerSize) && (header.numGenera == numGenera);
+		valid = valid && (mapSize == (matrixOffset + header.numKmers * (unsigned long long) header.numGenera * sizeof(float)));
+		if (valid) {
+			valid = (memcmp(mapData + nodesOffset, &genusNodes[0], numGenera * sizeof(int)) == 0);
+			valid = valid && (memcmp(mapData + nodesOffset + numGenera * sizeof(int), &genusTotals[0], numGenera * sizeof(int)) == 0);
+		}
+		if (!valid) { unmapProbFile(); return false; }
+		
+		numKmers = header.numKmers;
+		
+		const float* wordProbs = (const float*)(mapData + wordProbsOffset);
+		WordPairDiffArr.resize(numKmers);
+		for (int i = 0; i < numKmers; i++) { WordPairDiffArr[i].prob = wordProbs[i]; }
+		
+		probMatrix = (const float*)(mapData + matrixOffset);
+		
+		return true;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Bayesian", "readProbBinaryFile");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+void Bayesian::unmapProbFile() {
+	try {
+		if (mapData != NULL) {
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+			if (mapped) { munmap(mapData, mapSize); }
+			else { delete[] mapData; }
+#else
+			delete[] mapData;
+#endif
+			probMatrix = NULL;
+		}
+		mapData = NULL; mapSize = 0; mapped = false;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Bayesian", "unmapProbFile");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
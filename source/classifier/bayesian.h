@@ -22,21 +22,39 @@ public:
 	~Bayesian();
 	
 	string getTaxonomy(Sequence*);
+	bool isThreadSafe() { return true; }
+	string getSharedTaxonomy(Sequence*, string&, bool&, string&, unsigned long long);
 	
 private:
-	vector< vector<float> > wordGenusProb;	//vector of maps from genus to probability
-										//wordGenusProb[0][392] = probability that a sequence within genus that's index in the tree is 392 would contain kmer 0;
+	vector<float> wordGenusProb;	//one row of numGenera probabilities for each kmer, so a query kmer's row is contiguous
+									//wordGenusProb[0*numGenera+392] = probability that a sequence within genus that's index in the tree is 392 would contain kmer 0;
+	const float* probMatrix;		//wordGenusProb, or the same matrix in the mapped .prob.bin shortcut file
+	
+	struct ProbFileHeader {
+		char magic[8];
+		unsigned int version, kmerSize, numKmers, numGenera;
+	};
+	char* mapData;
+	unsigned long long mapSize;
+	bool mapped;
 	
 	vector<int> genusTotals;
 	vector<int> genusNodes;  //indexes in phyloTree where genus' are located
 	
 	vector<diffPair> WordPairDiffArr; 
 	
-	int kmerSize, numKmers, confidenceThreshold, iters;
+	int kmerSize, numKmers, numGenera, confidenceThreshold, iters;
 	
-	string bootstrapResults(vector<int>, int, int);
-	int getMostProbableTaxonomy(vector<int>);
+	string classifySeq(Sequence*, string&, bool&, mt19937_64*, string*);
+	string bootstrapResults(const vector<int>&, int, int, string&, mt19937_64*, string*);
+	void output(string, string*);
+	int getRandomIndex(int, mt19937_64*);
+	int getMostProbableTaxonomy(const vector<int>&);
+	int getMostProbableGenus(const double*);
 	void readProbFile(ifstream&, ifstream&, string, string);
+	bool readProbBinaryFile(string);
+	void writeProbBinaryFile(string);
+	void unmapProbFile();
 	bool checkReleaseDate(ifstream&, ifstream&, ifstream&, ifstream&);
 	bool isReversed(vector<int>&);
 	vector<int> createWordIndexArr(Sequence*);
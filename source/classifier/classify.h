@@ -30,6 +30,11 @@ public:
 	virtual string getSimpleTax()  { return simpleTax;	}
 	virtual bool getFlipped()  { return flipped;	}
 	virtual void generateDatabaseAndNames(string, string, string, int, float, float, float, float);
+	//classifiers that return true can be shared by threads through getSharedTaxonomy, which returns the simple taxonomy,
+	//whether the sequence was flipped and the messages about it through its arguments, so the caller can print them in
+	//file order. seed starts the sequence's own random numbers.
+	virtual bool isThreadSafe() { return false; }
+	virtual string getSharedTaxonomy(Sequence* seq, string& simple, bool& seqFlipped, string& messages, unsigned long long seed) { string tax = getTaxonomy(seq); simple = simpleTax; seqFlipped = flipped; return tax; }
 	virtual void setDistName(string s) {} //for knn, so if distance method is selected with knn you can create the smallest distance file in the right place.
     int getMaxLevel() { return maxLevel; }
 	
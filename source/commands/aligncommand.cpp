@@ -24,7 +24,7 @@ vector<string> AlignCommand::setParameters(){
 		CommandParameter psearch("search", "Multiple", "kmer-blast-suffix", "kmer", "", "", "","",false,false,true); parameters.push_back(psearch);
 		CommandParameter pksize("ksize", "Number", "", "8", "", "", "","",false,false); parameters.push_back(pksize);
 		CommandParameter pmatch("match", "Number", "", "1.0", "", "", "","",false,false); parameters.push_back(pmatch);
-		CommandParameter palign("align", "Multiple", "needleman-gotoh-blast-noalign", "needleman", "", "", "","",false,false,true); parameters.push_back(palign);
+		CommandParameter palign("align", "Multiple", "needleman-gotoh-blast-noalign-simd", "needleman", "", "", "","",false,false,true); parameters.push_back(palign);
 		CommandParameter pmismatch("mismatch", "Number", "", "-1.0", "", "", "","",false,false); parameters.push_back(pmismatch);
 		CommandParameter pgapopen("gapopen", "Number", "", "-5.0", "", "", "","",false,false); parameters.push_back(pgapopen);
 		CommandParameter pgapextend("gapextend", "Number", "", "-2.0", "", "", "","",false,false); parameters.push_back(pgapextend);
@@ -52,7 +52,7 @@ string AlignCommand::getHelpString(){
 		helpString += "The align.seqs command parameters are reference, fasta, search, ksize, align, match, mismatch, gapopen, gapextend and processors.";
 		helpString += "The reference and fasta parameters are required. You may leave fasta blank if you have a valid fasta file. You may enter multiple fasta files by separating their names with dashes. ie. fasta=abrecovery.fasta-amzon.fasta.";
 		helpString += "The search parameter allows you to specify the method to find most similar template.  Your options are: suffix, kmer and blast. The default is kmer.";
-		helpString += "The align parameter allows you to specify the alignment method to use.  Your options are: gotoh, needleman, blast and noalign. The default is needleman.";
+		helpString += "The align parameter allows you to specify the alignment method to use.  Your options are: gotoh, needleman, blast, noalign and simd. simd gives the same alignments as needleman using SSE2. The default is needleman.";
 		helpString += "The ksize parameter allows you to specify the kmer size for finding most similar template to candidate.  The default is 8.";
 		helpString += "The match parameter allows you to specify the bonus for having the same base. The default is 1.0.";
 		helpString += "The mistmatch parameter allows you to specify the penalty for having different bases.  The default is -1.0.";
@@ -271,7 +271,7 @@ AlignCommand::AlignCommand(string option)  {
 			if ((search != "suffix") && (search != "kmer") && (search != "blast")) { m->mothurOut("invalid search option: choices are kmer, suffix or blast."); m->mothurOutEndLine(); abort=true; }
 			
 			align = validParameter.validFile(parameters, "align", false);		if (align == "not found"){	align = "needleman";	}
-			if ((align != "needleman") && (align != "gotoh") && (align != "blast") && (align != "noalign")) { m->mothurOut("invalid align option: choices are needleman, gotoh, blast or noalign."); m->mothurOutEndLine(); abort=true; }
+			if ((align != "needleman") && (align != "gotoh") && (align != "blast") && (align != "noalign") && (align != "simd")) { m->mothurOut("invalid align option: choices are needleman, gotoh, blast, noalign or simd."); m->mothurOutEndLine(); abort=true; }
 
 		}
 		
@@ -408,6 +408,7 @@ int AlignCommand::driver(linePair* filePos, string alignFName, string reportFNam
         if (m->debug) { m->mothurOut("[DEBUG]: template longest base = "  + toString(templateDB->getLongestBase()) + " \n"); }
 		if(align == "gotoh")			{	alignment = new GotohOverlap(gapOpen, gapExtend, match, misMatch, longestBase);			}
 		else if(align == "needleman")	{	alignment = new NeedlemanOverlap(gapOpen, match, misMatch, longestBase);				}
+		else if(align == "simd")		{	alignment = new NeedlemanSIMD(gapOpen, match, misMatch, longestBase);					}
 		else if(align == "blast")		{	alignment = new BlastAlignment(gapOpen, gapExtend, match, misMatch);		}
 		else if(align == "noalign")		{	alignment = new NoAlign();													}
 		else {
@@ -17,6 +17,7 @@
 
 #include "gotohoverlap.hpp"
 #include "needlemanoverlap.hpp"
+#include "needlemansimd.hpp"
 #include "blastalign.hpp"
 #include "noalign.hpp"
 
@@ -142,6 +143,7 @@ static DWORD WINAPI MyAlignThreadFunction(LPVOID lpParam){
 		int longestBase = templateDB->getLongestBase();
 		if(pDataArray->align == "gotoh")			{	alignment = new GotohOverlap(pDataArray->gapOpen, pDataArray->gapExtend, pDataArray->match, pDataArray->misMatch, longestBase);			}
 		else if(pDataArray->align == "needleman")	{	alignment = new NeedlemanOverlap(pDataArray->gapOpen, pDataArray->match, pDataArray->misMatch, longestBase);				}
+		else if(pDataArray->align == "simd")		{	alignment = new NeedlemanSIMD(pDataArray->gapOpen, pDataArray->match, pDataArray->misMatch, longestBase);					}
 		else if(pDataArray->align == "blast")		{	alignment = new BlastAlignment(pDataArray->gapOpen, pDataArray->gapExtend, pDataArray->match, pDataArray->misMatch);		}
 		else if(pDataArray->align == "noalign")		{	alignment = new NoAlign();													}
 		else {
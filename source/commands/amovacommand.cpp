@@ -11,6 +11,7 @@
 #include "readphylipvector.h"
 #include "designmap.h"
 #include "sharedutilities.h"
+#include "permutationtest.h"
 
 
 //**********************************************************************************************************************
@@ -21,6 +22,8 @@ vector<string> AmovaCommand::setParameters(){
 		CommandParameter pphylip("phylip", "InputTypes", "", "", "none", "none", "none","amova",false,true,true); parameters.push_back(pphylip);
 		CommandParameter piters("iters", "Number", "", "1000", "", "", "","",false,false); parameters.push_back(piters);
 		CommandParameter palpha("alpha", "Number", "", "0.05", "", "", "","",false,false); parameters.push_back(palpha);
+		CommandParameter pearlystop("earlystop", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(pearlystop);
+		CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
 		CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
@@ -40,11 +43,13 @@ string AmovaCommand::getHelpString(){
 		string helpString = "";
 		helpString += "Referenced: Anderson MJ (2001). A new method for non-parametric multivariate analysis of variance. Austral Ecol 26: 32-46.";
 		helpString += "The amova command outputs a .amova file.";
-		helpString += "The amova command parameters are phylip, iters, sets and alpha.  The phylip and design parameters are required, unless you have valid current files.";
+		helpString += "The amova command parameters are phylip, iters, sets, alpha, earlystop and processors.  The phylip and design parameters are required, unless you have valid current files.";
 		helpString += "The design parameter allows you to assign your samples to groups when you are running amova. It is required.";
 		helpString += "The design file looks like the group file.  It is a 2 column tab delimited file, where the first column is the sample name and the second column is the group the sample belongs to.";
         helpString += "The sets parameter allows you to specify which of the sets in your designfile you would like to analyze. The set names are separated by dashes. THe default is all sets in the designfile.\n";
 		helpString += "The iters parameter allows you to set number of randomization for the P value.  The default is 1000.";
+		helpString += "The processors parameter allows you to specify the number of processors to use for the randomizations. The default is 1.";
+		helpString += "The earlystop parameter allows you to stop the randomizations once the P value is clearly above or below the alpha of a comparison, in steps of 1000, and report how many were run. The default is F.";
 		helpString += "The amova command should be in the following format: amova(phylip=file.dist, design=file.design).";
 		helpString += "Note: No spaces between parameter labels (i.e. iters), '=' and parameters (i.e. 1000).";
 		return helpString;
@@ -160,6 +165,14 @@ AmovaCommand::AmovaCommand(string option) {
 			temp = validParameter.validFile(parameters, "alpha", false);
 			if (temp == "not found") { temp = "0.05"; }
 			m->mothurConvert(temp, experimentwiseAlpha); 
+			
+			temp = validParameter.validFile(parameters, "earlystop", false);
+			if (temp == "not found") { temp = "F"; }
+			earlyStop = m->isTrue(temp);
+			
+			temp = validParameter.validFile(parameters, "processors", false);	if (temp == "not found"){	temp = m->getProcessors();	}
+			m->setProcessors(temp);
+			m->mothurConvert(temp, processors);
             
             string sets = validParameter.validFile(parameters, "sets", false);			
 			if (sets == "not found") { sets = ""; }
@@ -303,17 +316,16 @@ double AmovaCommand::runAMOVA(ofstream& AMOVAFile, map<string, vector<int> > gro
 		double ssWithinOrig = calcSSWithin(groupSampleMap);
 		double ssAmongOrig = ssTotalOrig - ssWithinOrig;
 		
-		double counter = 0;
-		for(int i=0;i<iters;i++){
-			map<string, vector<int> > randomizedGroup = getRandomizedGroups(groupSampleMap);
+		PermutationTest test(iters, processors);
+		if (earlyStop) { test.setAlpha(alpha); }
+		test.run([&](mt19937_64& rng) {
+			map<string, vector<int> > randomizedGroup = getRandomizedGroups(groupSampleMap, rng);
 			double ssWithinRand = calcSSWithin(randomizedGroup);
-			if(ssWithinRand <= ssWithinOrig){	counter++;	}
-		}
+			return (ssWithinRand <= ssWithinOrig);
+		});
 		
-		double pValue = (double)counter / (double) iters;
-		string pString = "";
-		if(pValue < 1/(double)iters){	pString = '<' + toString(1/(double)iters);	}
-		else						{	pString = toString(pValue);					}
+		double pValue = test.getPValue();
+		string pString = test.getPString();
 		
 		
 		//print anova table
@@ -352,8 +364,15 @@ double AmovaCommand::runAMOVA(ofstream& AMOVAFile, map<string, vector<int> > gro
 			AMOVAFile << "*";
 			m->mothurOut("*");
 		}
-		AMOVAFile << endl << endl;
-		m->mothurOutEndLine();m->mothurOutEndLine();
+		AMOVAFile << endl;
+		m->mothurOutEndLine();
+		
+		if (earlyStop) {
+			AMOVAFile << "permutations: " << test.getNumRun() << endl;
+			m->mothurOut("permutations: " + toString(test.getNumRun()) + '\n');
+		}
+		AMOVAFile << endl;
+		m->mothurOutEndLine();
 
 		return pValue;
 	}
@@ -365,7 +384,7 @@ double AmovaCommand::runAMOVA(ofstream& AMOVAFile, map<string, vector<int> > gro
 
 //**********************************************************************************************************************
 
-map<string, vector<int> > AmovaCommand::getRandomizedGroups(map<string, vector<int> > origMapping){
+map<string, vector<int> > AmovaCommand::getRandomizedGroups(map<string, vector<int> >& origMapping, mt19937_64& rng){
 	try{
 		vector<int> sampleIndices;
 		vector<int> samplesPerGroup;
@@ -377,7 +396,7 @@ map<string, vector<int> > AmovaCommand::getRandomizedGroups(map<string, vector<i
 			sampleIndices.insert(sampleIndices.end(), indices.begin(), indices.end());
 		}
 		
-		m->mothurRandomShuffle(sampleIndices);
+		shuffle(sampleIndices.begin(), sampleIndices.end(), rng);
 		
 		int index = 0;
 		map<string, vector<int> > randomizedGroups = origMapping;
@@ -36,7 +36,7 @@ private:
 	double runAMOVA(ofstream&, map<string, vector<int> >, double);
 	double calcSSWithin(map<string, vector<int> >&);
 	double calcSSTotal(map<string, vector<int> >&);
-	map<string, vector<int> > getRandomizedGroups(map<string, vector<int> >);
+	map<string, vector<int> > getRandomizedGroups(map<string, vector<int> >&, mt19937_64&);
 
 	bool abort;
 	vector<string> outputNames, Sets;
@@ -44,8 +44,9 @@ private:
 	string outputDir, inputDir, designFileName, phylipFileName;
 	DesignMap* designMap;
 	vector< vector<double> > distanceMatrix;
-	int iters;
+	int iters, processors;
 	double experimentwiseAlpha;
+	bool earlyStop;
 };
 
 #endif
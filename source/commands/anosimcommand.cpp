@@ -11,6 +11,7 @@
 #include "inputdata.h"
 #include "readphylipvector.h"
 #include "designmap.h"
+#include "permutationtest.h"
 
 //**********************************************************************************************************************
 vector<string> AnosimCommand::setParameters(){	
@@ -19,6 +20,8 @@ vector<string> AnosimCommand::setParameters(){
 		CommandParameter pphylip("phylip", "InputTypes", "", "", "none", "none", "none","anosim",false,true,true); parameters.push_back(pphylip);
 		CommandParameter piters("iters", "Number", "", "1000", "", "", "","",false,false); parameters.push_back(piters);
 		CommandParameter palpha("alpha", "Number", "", "0.05", "", "", "","",false,false); parameters.push_back(palpha);
+		CommandParameter pearlystop("earlystop", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(pearlystop);
+		CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
 		CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
@@ -38,10 +41,12 @@ string AnosimCommand::getHelpString(){
 		string helpString = "";
 		helpString += "Referenced: Clarke, K. R. (1993). Non-parametric multivariate analysis of changes in community structure.   _Australian Journal of Ecology_ 18, 117-143.\n";
 		helpString += "The anosim command outputs a .anosim file. \n";
-		helpString += "The anosim command parameters are phylip, iters, and alpha.  The phylip and design parameters are required, unless you have valid current files.\n";
+		helpString += "The anosim command parameters are phylip, iters, alpha, earlystop and processors.  The phylip and design parameters are required, unless you have valid current files.\n";
 		helpString += "The design parameter allows you to assign your samples to groups when you are running anosim. It is required. \n";
 		helpString += "The design file looks like the group file.  It is a 2 column tab delimited file, where the first column is the sample name and the second column is the group the sample belongs to.\n";
 		helpString += "The iters parameter allows you to set number of randomization for the P value.  The default is 1000. \n";
+		helpString += "The processors parameter allows you to specify the number of processors to use for the randomizations. The default is 1.\n";
+		helpString += "The earlystop parameter allows you to stop the randomizations once the P value is clearly above or below the alpha of a comparison, in steps of 1000, and report how many were run. The default is F.\n";
 		helpString += "The anosim command should be in the following format: anosim(phylip=file.dist, design=file.design).\n";
 		helpString += "Note: No spaces between parameter labels (i.e. iters), '=' and parameters (i.e. 1000).\n";
 		return helpString;
@@ -159,6 +164,14 @@ AnosimCommand::AnosimCommand(string option) {
 			temp = validParameter.validFile(parameters, "alpha", false);
 			if (temp == "not found") { temp = "0.05"; }
 			m->mothurConvert(temp, experimentwiseAlpha); 
+			
+			temp = validParameter.validFile(parameters, "earlystop", false);
+			if (temp == "not found") { temp = "F"; }
+			earlyStop = m->isTrue(temp);
+			
+			temp = validParameter.validFile(parameters, "processors", false);	if (temp == "not found"){	temp = m->getProcessors();	}
+			m->setProcessors(temp);
+			m->mothurConvert(temp, processors);
 		}
 		
 	}
@@ -208,8 +221,10 @@ int AnosimCommand::execute(){
         
 		m->openOutputFile(ANOSIMFileName, ANOSIMFile);
 		outputNames.push_back(ANOSIMFileName); outputTypes["anosim"].push_back(ANOSIMFileName);
-		m->mothurOut("\ncomparison\tR-value\tP-value\n");
-		ANOSIMFile << "comparison\tR-value\tP-value\n";
+		string header = "comparison\tR-value\tP-value";
+		if (earlyStop) { header += "\tpermutations"; }
+		m->mothurOut("\n" + header + "\n");
+		ANOSIMFile << header << endl;
 		
 		
 		double fullANOSIMPValue = runANOSIM(ANOSIMFile, distanceMatrix, origGroupSampleMap, experimentwiseAlpha);
@@ -287,17 +302,16 @@ double AnosimCommand::runANOSIM(ofstream& ANOSIMFile, vector<vector<double> > dM
 		vector<vector<double> > rankMatrix = convertToRanks(dMatrix);
 		double RValue = calcR(rankMatrix, groupSampleMap);
 		
-		int pCount = 0;
-		for(int i=0;i<iters;i++){
-			map<string, vector<int> > randGroupSampleMap = getRandomizedGroups(groupSampleMap);
+		PermutationTest test(iters, processors);
+		if (earlyStop) { test.setAlpha(alpha); }
+		test.run([&](mt19937_64& rng) {
+			map<string, vector<int> > randGroupSampleMap = getRandomizedGroups(groupSampleMap, rng);
 			double RValueRand = calcR(rankMatrix, randGroupSampleMap);
-			if(RValue <= RValueRand){	pCount++;	}
-		}
+			return (RValue <= RValueRand);
+		});
 
-		double pValue = (double)pCount / (double) iters;
-		string pString = "";
-		if(pValue < 1/(double)iters){	pString = '<' + toString(1/(double)iters);	}
-		else						{	pString = toString(pValue);					}
+		double pValue = test.getPValue();
+		string pString = test.getPString();
 		
 		
 		map<string, vector<int> >::iterator it=groupSampleMap.begin();
@@ -316,6 +330,10 @@ double AnosimCommand::runANOSIM(ofstream& ANOSIMFile, vector<vector<double> > dM
 			ANOSIMFile << "*";
 			m->mothurOut("*");
 		}
+		if (earlyStop) {
+			ANOSIMFile << '\t' << test.getNumRun();
+			m->mothurOut('\t' + toString(test.getNumRun()));
+		}
 		ANOSIMFile << endl;
 		m->mothurOutEndLine();
 		
@@ -329,7 +347,7 @@ double AnosimCommand::runANOSIM(ofstream& ANOSIMFile, vector<vector<double> > dM
 
 //**********************************************************************************************************************
 
-double AnosimCommand::calcR(vector<vector<double> > rankMatrix, map<string, vector<int> > groupSampleMap){
+double AnosimCommand::calcR(vector<vector<double> >& rankMatrix, map<string, vector<int> >& groupSampleMap){
 	try {
 
 		int numSamples = 0;
@@ -448,7 +466,7 @@ vector<vector<double> > AnosimCommand::convertToRanks(vector<vector<double> > di
 
 //**********************************************************************************************************************
 
-map<string, vector<int> > AnosimCommand::getRandomizedGroups(map<string, vector<int> > origMapping){
+map<string, vector<int> > AnosimCommand::getRandomizedGroups(map<string, vector<int> >& origMapping, mt19937_64& rng){
 	try{
 		vector<int> sampleIndices;
 		vector<int> samplesPerGroup;
@@ -460,7 +478,7 @@ map<string, vector<int> > AnosimCommand::getRandomizedGroups(map<string, vector<
 			sampleIndices.insert(sampleIndices.end(), indices.begin(), indices.end());
 		}
 		
-		m->mothurRandomShuffle(sampleIndices);
+		shuffle(sampleIndices.begin(), sampleIndices.end(), rng);
 		
 		int index = 0;
 		map<string, vector<int> > randomizedGroups = origMapping;
@@ -40,14 +40,15 @@ private:
 	string outputDir, inputDir, designFileName, phylipFileName;
 	
 	vector<vector<double> > convertToRanks(vector<vector<double> >);
-	double calcR(vector<vector<double> >, map<string, vector<int> >);
-	map<string, vector<int> > getRandomizedGroups(map<string, vector<int> >);
+	double calcR(vector<vector<double> >&, map<string, vector<int> >&);
+	map<string, vector<int> > getRandomizedGroups(map<string, vector<int> >&, mt19937_64&);
 	double runANOSIM(ofstream&, vector<vector<double> >, map<string, vector<int> >, double);
 	
 	vector< vector<double> > distanceMatrix;
 	vector<string> outputNames;
-	int iters;
+	int iters, processors;
 	double experimentwiseAlpha;
+	bool earlyStop;
 	vector< vector<string> > namesOfGroupCombos;
 	
 	
@@ -647,31 +647,35 @@ int ClassifySeqsCommand::execute(){
 			int start = time(NULL);
 			int numFastaSeqs = 0;
 			for (int i = 0; i < lines.size(); i++) {  delete lines[i];  }  lines.clear();
-		
-			vector<unsigned long long> positions; 
+			
+			if (classify->isThreadSafe()) {
+				numFastaSeqs = driverShared(newTaxonomyFile, tempTaxonomyFile, newaccnosFile, fastaFileNames[s]);
+			}else {
+				vector<unsigned long long> positions; 
 #if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-			positions = m->divideFile(fastaFileNames[s], processors);
-			for (int i = 0; i < (positions.size()-1); i++) {	lines.push_back(new linePair(positions[i], positions[(i+1)]));	}
+				positions = m->divideFile(fastaFileNames[s], processors);
+				for (int i = 0; i < (positions.size()-1); i++) {	lines.push_back(new linePair(positions[i], positions[(i+1)]));	}
 #else
-			if (processors == 1) {
-				lines.push_back(new linePair(0, 1000));
-			}else {
-				positions = m->setFilePosFasta(fastaFileNames[s], numFastaSeqs); 
-                if (numFastaSeqs < processors) { processors = numFastaSeqs; }
+				if (processors == 1) {
+					lines.push_back(new linePair(0, 1000));
+				}else {
+					positions = m->setFilePosFasta(fastaFileNames[s], numFastaSeqs); 
+	                if (numFastaSeqs < processors) { processors = numFastaSeqs; }
 				
-				//figure out how many sequences you have to process
-				int numSeqsPerProcessor = numFastaSeqs / processors;
-				for (int i = 0; i < processors; i++) {
-					int startIndex =  i * numSeqsPerProcessor;
-					if(i == (processors - 1)){	numSeqsPerProcessor = numFastaSeqs - i * numSeqsPerProcessor; 	}
-					lines.push_back(new linePair(positions[startIndex], numSeqsPerProcessor));
+					//figure out how many sequences you have to process
+					int numSeqsPerProcessor = numFastaSeqs / processors;
+					for (int i = 0; i < processors; i++) {
+						int startIndex =  i * numSeqsPerProcessor;
+						if(i == (processors - 1)){	numSeqsPerProcessor = numFastaSeqs - i * numSeqsPerProcessor; 	}
+						lines.push_back(new linePair(positions[startIndex], numSeqsPerProcessor));
+					}
 				}
-			}
 #endif
-			if(processors == 1){
-				numFastaSeqs = driver(lines[0], newTaxonomyFile, tempTaxonomyFile, newaccnosFile, fastaFileNames[s]);
-			}else{
-				numFastaSeqs = createProcesses(newTaxonomyFile, tempTaxonomyFile, newaccnosFile, fastaFileNames[s]); 
+				if(processors == 1){
+					numFastaSeqs = driver(lines[0], newTaxonomyFile, tempTaxonomyFile, newaccnosFile, fastaFileNames[s]);
+				}else{
+					numFastaSeqs = createProcesses(newTaxonomyFile, tempTaxonomyFile, newaccnosFile, fastaFileNames[s]); 
+				}
 			}
 			
 			if (!m->isBlank(newaccnosFile)) { m->mothurOutEndLine(); m->mothurOut("[WARNING]: mothur reversed some your sequences for a better classification.  If you would like to take a closer look, please check " + newaccnosFile + " for the list of the sequences."); m->mothurOutEndLine(); 
@@ -1054,3 +1058,90 @@ int ClassifySeqsCommand::driver(linePair* filePos, string taxFName, string tempT
 	}
 }
 /**************************************************************************************************/
+//one classifier is shared by all the threads. The sequences are read in batches, classified in parallel and written in
+//file order, so memory does not grow with processors and the results are the same for any number of processors.
+int ClassifySeqsCommand::driverShared(string taxFName, string tempTFName, string accnos, string filename){
+	try {
+		ofstream outTax;
+		m->openOutputFile(taxFName, outTax);
+		
+		ofstream outTaxSimple;
+		m->openOutputFile(tempTFName, outTaxSimple);
+		
+		ofstream outAcc;
+		m->openOutputFile(accnos, outAcc);
+	
+		ifstream inFASTA;
+		m->openInputFile(filename, inFASTA);
+		
+		//each sequence's random numbers start from its place in the file
+		unsigned long long seed = m->getRandomNumber();
+		int batchSize = processors * 100;
+		int count = 0;
+		
+		while (!inFASTA.eof()) {
+			if (m->control_pressed) { break; }
+			
+			vector<Sequence*> batch;
+			while ((batch.size() < batchSize) && (!inFASTA.eof())) {
+				Sequence* candidateSeq = new Sequence(inFASTA); m->gobble(inFASTA);
+				
+				if (candidateSeq->getName() != "") { batch.push_back(candidateSeq); }
+				else { delete candidateSeq; }
+			}
+			
+			vector<string> taxonomies(batch.size()), simpleTaxs(batch.size()), messages(batch.size());
+			vector<char> flips(batch.size(), 0);
+			
+			ThreadPool::getInstance()->parallelFor(0, batch.size(), processors, [&](long long start, long long end, int threadID) {
+				for (long long i = start; i < end; i++) {
+					if (m->control_pressed) { break; }
+					
+					bool seqFlipped = false;
+					taxonomies[i] = classify->getSharedTaxonomy(batch[i], simpleTaxs[i], seqFlipped, messages[i], seed + count + i);
+					flips[i] = seqFlipped;
+				}
+			});
+			
+			for (int i = 0; i < batch.size(); i++) {
+				if (!m->control_pressed) {
+					if (messages[i] != "") { m->mothurOut(messages[i]); } //the classifier's warnings and debug lines, in file order
+					if (taxonomies[i] == "unknown;") { m->mothurOut("[WARNING]: " + batch[i]->getName() + " could not be classified. You can use the remove.lineage command with taxon=unknown; to remove such sequences."); m->mothurOutEndLine(); }
+					
+					//output confidence scores or not
+					if (probs) {
+						outTax << batch[i]->getName() << '\t' << taxonomies[i] << endl;
+					}else{
+						outTax << batch[i]->getName() << '\t' << simpleTaxs[i] << endl;
+					}
+					
+					if (flips[i]) { outAcc << batch[i]->getName() << endl; }
+					
+					outTaxSimple << batch[i]->getName() << '\t' << simpleTaxs[i] << endl;
+				}
+				delete batch[i];
+			}
+			
+			if (m->control_pressed) { break; }
+			
+			count += batch.size();
+			
+			//report progress
+			m->mothurOutJustToScreen("Processing sequence: " + toString(count) +"\n");
+		}
+		
+		inFASTA.close();
+		outTax.close();
+		outTaxSimple.close();
+		outAcc.close();
+		
+		if (m->control_pressed) { return 0; }
+		
+		return count;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ClassifySeqsCommand", "driverShared");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
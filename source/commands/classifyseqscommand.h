@@ -20,6 +20,7 @@
 #include "knn.h"
 #include "kmertree.h"
 #include "aligntree.h"
+#include "threadpool.h"
 
 
 //KNN and Wang methods modeled from algorithms in
@@ -73,6 +74,7 @@ private:
 	bool abort, probs, save, flip, hasName, hasCount, writeShortcuts, relabund;
 	
 	int driver(linePair*, string, string, string, string);
+	int driverShared(string, string, string, string);
 	int createProcesses(string, string, string, string); 
 };
 
@@ -14,6 +14,7 @@
 #include "sequence.hpp"
 #include "systemcommand.h"
 #include "sensspeccommand.h"
+#include "inputdata.h"
 
 //**********************************************************************************************************************
 vector<string> ClusterCommand::setParameters(){	
@@ -23,6 +24,7 @@ vector<string> ClusterCommand::setParameters(){
         CommandParameter pname("name", "InputTypes", "", "", "NameCount", "none", "ColumnName-FastaTaxName","rabund-sabund",false,false,true); parameters.push_back(pname);
         CommandParameter pcount("count", "InputTypes", "", "", "NameCount", "none", "","",false,false,true); parameters.push_back(pcount);
         CommandParameter pcolumn("column", "InputTypes", "", "", "PhylipColumnFasta", "PhylipColumnFasta", "ColumnName","list",false,false,true); parameters.push_back(pcolumn);
+        CommandParameter plist("list", "InputTypes", "", "", "none", "none", "none","",false,false); parameters.push_back(plist);
 		CommandParameter pcutoff("cutoff", "Number", "", "0.03", "", "", "","",false,false,true); parameters.push_back(pcutoff);
 		CommandParameter pprecision("precision", "Number", "", "100", "", "", "","",false,false); parameters.push_back(pprecision);
 		CommandParameter pmethod("method", "Multiple", "furthest-nearest-average-weighted-agc-dgc-opti-unique", "opti", "", "", "","",false,false,true); parameters.push_back(pmethod);
@@ -52,18 +54,20 @@ vector<string> ClusterCommand::setParameters(){
 string ClusterCommand::getHelpString(){	
 	try {
 		string helpString = "";
-		helpString += "The cluster command parameter options are phylip, column, name, count, method, cutoff, precision, sim, showabund, timing, metric, iters, initialize. Fasta or Phylip or column and name are required.\n";
+		helpString += "The cluster command parameter options are phylip, column, name, count, list, method, cutoff, precision, sim, showabund, timing, metric, iters, initialize. Fasta or Phylip or column and name are required.\n";
 		//helpString += "The adjust parameter is used to handle missing distances.  If you set a cutoff, adjust=f by default.  If not, adjust=t by default. Adjust=f, means ignore missing distances and adjust cutoff as needed with the average neighbor method.  Adjust=t, will treat missing distances as 1.0. You can also set the value the missing distances should be set to, adjust=0.5 would give missing distances a value of 0.5.\n";
         helpString += "The phylip and column parameter allow you to enter your distance file. \n";
+        helpString += "The column parameter also takes the sparse distance file made by dist.seqs with output=sparse.\n";
         helpString += "The fasta parameter allows you to enter your fasta file for use with the agc or dgc methods. \n";
         helpString += "The name parameter allows you to enter your name file. \n";
         helpString += "The count parameter allows you to enter your count file. \n A count or name file is required if your distance file is in column format.\n";
+        helpString += "The list parameter allows you to add new sequences to the OTUs in a list file with the opti method. The distance file only needs the distances involving the new sequences and the name or count file must include all the sequences. The sequences in the list file keep their OTUs, the new sequences are placed into them or form new OTUs, and iters limits the refinement passes. The first label in the list file is used.\n";
         helpString += "The iters parameter allow you to set the maxiters for the opticluster method. \n";
         helpString += "The metric parameter allows to select the metric in the opticluster method. Options are Matthews correlation coefficient (mcc), sensitivity (sens), specificity (spec), true positives + true negatives (tptn), false positives + false negatives (fpfn), true positives (tp), true negative (tn), false positive (fp), false negative (fn), f1score (f1score), accuracy (accuracy), positive predictive value (ppv), negative predictive value (npv), false discovery rate (fdr). Default=mcc.\n";
         helpString += "The initialize parameter allows to select the initial randomization for the opticluster method. Options are singleton, meaning each sequence is randomly assigned to its own OTU, or oneotu meaning all sequences are assigned to one otu. Default=singleton.\n";
         helpString += "The delta parameter allows to set the stable value for the metric in the opticluster method (delta=0.0001). \n";
         helpString += "The method parameter allows you to enter your clustering mothod. Options are furthest, nearest, average, weighted, agc, dgc, unique and opti. Default=opti.  The agc and dgc methods require a fasta file.";
-        helpString += "The processors parameter allows you to specify the number of processors to use. The default is 1.\n";
+        helpString += "The processors parameter allows you to specify the number of processors to use with the agc, dgc and opti methods. The opti method gives the same OTUs with any number of processors. The default is 1.\n";
        helpString += "The cluster command should be in the following format: \n";
 		helpString += "cluster(method=yourMethod, cutoff=yourCutoff, precision=yourPrecision) \n";
 		helpString += "The acceptable cluster methods are furthest, nearest, average and weighted.  If no method is provided then average is assumed.\n";	
@@ -190,6 +194,14 @@ ClusterCommand::ClusterCommand(string option)  {
                     //if the user has not given a path then, add inputdir. else leave path alone.
                     if (path == "") {	parameters["fasta"] = inputDir + it->second;		}
                 }
+                
+                it = parameters.find("list");
+                //user has given a template file
+                if(it != parameters.end()){
+                    path = m->hasPath(it->second);
+                    //if the user has not given a path then, add inputdir. else leave path alone.
+                    if (path == "") {	parameters["list"] = inputDir + it->second;		}
+                }
 			}
 			
 			//check for required parameters
@@ -217,6 +229,10 @@ ClusterCommand::ClusterCommand(string option)  {
 			if (countfile == "not open") { abort = true; countfile = ""; }	
 			else if (countfile == "not found") { countfile = ""; }
 			else { m->setCountTableFile(countfile); }
+            
+            listfile = validParameter.validFile(parameters, "list", true);
+			if (listfile == "not open") { abort = true; listfile = ""; }
+			else if (listfile == "not found") { listfile = ""; }
 			
             method = validParameter.validFile(parameters, "method", false);
             if (method == "not found") {
@@ -281,6 +297,8 @@ ClusterCommand::ClusterCommand(string option)  {
             }
             if ((countfile != "") && (namefile != "")) { m->mothurOut("When executing a cluster command you must enter ONLY ONE of the following: count or name."); m->mothurOutEndLine(); abort = true; }
             
+            if ((listfile != "") && ((method != "opti") || (format == "fasta"))) { m->mothurOut("[ERROR]: The list parameter can only be used with the opti method and a phylip or column file."); m->mothurOutEndLine(); abort = true; }
+            
 			//check for optional parameter and set defaults
 			// ...at some point should added some additional type checking...
 			//get user cutoff and precision or use defaults
@@ -319,8 +337,8 @@ ClusterCommand::ClusterCommand(string option)  {
             
             if ((method == "agc") || (method == "dgc")) {
                 if (fastafile == "") { m->mothurOut("[ERROR]: You must provide a fasta file when using the agc or dgc clustering methods, aborting\n."); abort = true;}
-            }else if (setProcessors) {
-                m->mothurOut("[WARNING]: You can only use the processors option when using the agc or dgc clustering methods. Using 1 processor.\n.");
+            }else if ((method != "opti") && setProcessors) {
+                m->mothurOut("[WARNING]: You can only use the processors option when using the agc, dgc or opti clustering methods. Using 1 processor.\n.");
             }
             
             cutOffSet = false;
@@ -868,8 +886,18 @@ int ClusterCommand::runOptiCluster(){
         //m->mothurOut("It took " + toString(time(NULL) - rstart) + " seconds to read and process matrix"); m->mothurOutEndLine();
         
         OptiCluster cluster(&matrix, metric, 0);
+        cluster.setProcessors(processors);
         tag = cluster.getTag();
         
+        //read before the output files are opened in case the list is named like the output
+        ListVector* prior = NULL;
+        if (listfile != "") {
+            InputData input(listfile, "list");
+            prior = input.getListVector();
+            if (prior == NULL) { m->mothurOut("[ERROR]: " + listfile + " is empty, aborting.\n"); return 0; }
+            m->mothurOut("\nAdding sequences to the OTUs in " + listfile + " at label " + prior->getLabel() + ".\n");
+        }
+        
         m->mothurOutEndLine(); m->mothurOut("Clustering " + distfile); m->mothurOutEndLine();
         
         if (outputDir == "") { outputDir += m->hasPath(distfile); }
@@ -893,7 +921,10 @@ int ClusterCommand::runOptiCluster(){
         double listVectorMetric = 0; //worst state
         double delta = 1;
         
-        cluster.initialize(listVectorMetric, true, initialize);
+        if (listfile != "") { cluster.initialize(listVectorMetric, true, prior); delete prior; }
+        else { cluster.initialize(listVectorMetric, true, initialize); }
+        
+        if (m->control_pressed) { listFile.close(); outStep.close(); for (int i = 0; i < outputNames.size(); i++) { m->mothurRemove(outputNames[i]); } return 0; }
         
         long long numBins = cluster.getNumBins();
         m->mothurOut("\n\niter\ttime\tlabel\tnum_otus\tcutoff\ttp\ttn\tfp\tfn\tsensitivity\tspecificity\tppv\tnpv\tfdr\taccuracy\tmcc\tf1score\n");
@@ -10,6 +10,7 @@
 #include "clustersplitcommand.h"
 #include "systemcommand.h"
 #include "sensspeccommand.h"
+#include "sparsedistfile.h"
 
 //**********************************************************************************************************************
 vector<string> ClusterSplitCommand::setParameters(){	
@@ -65,6 +66,7 @@ string ClusterSplitCommand::getHelpString(){
 		helpString += "You will also need to set the taxlevel you want to split by. mothur will split the sequence into distinct taxonomy groups, and create distance files for each grouping. \n";
         helpString += "The file option allows you to enter your file containing your list of column and names/count files as well as the singleton file.  This file is mothur generated, when you run cluster.split() with the cluster=f parameter.  This can be helpful when you have a large dataset that you may be able to use all your processors for the splitting step, but have to reduce them for the cluster step due to RAM constraints. For example: cluster.split(fasta=yourFasta, taxonomy=yourTax, count=yourCount, taxlevel=3, cluster=f, processors=8) then cluster.split(file=yourFile, processors=4).  This allows your to maximize your processors during the splitting step.  Also, if you are unsure if the cluster step will have RAM issue with multiple processors, you can avoid running the first part of the command multiple times.\n";
 		helpString += "The phylip and column parameter allow you to enter your distance file. \n";
+        helpString += "The column parameter also takes the sparse distance file made by dist.seqs with output=sparse.\n";
 		helpString += "The fasta parameter allows you to enter your aligned fasta file. \n";
 		helpString += "The name parameter allows you to enter your name file. \n";
         helpString += "The count parameter allows you to enter your count file. \n A count or name file is required if your distance file is in column format";
@@ -1668,6 +1670,8 @@ int ClusterSplitCommand::runSensSpec() {
         }else if (columnfile != "") { columnFile = columnfile; }
         else { phylipFile = phylipfile; }
     
+        if ((columnFile != "") && SparseDistFile::isSparseDistFile(columnFile)) { m->mothurOut("[WARNING]: sens.spec reads column files, not sparse distance files, skipping.\n"); return 0; }
+    
         string inputString = "cutoff=" + toString(cutoff) + ", list=" + listFile;
         if (columnFile != "") { inputString += ", column=" + columnFile;  }
         else if (phylipfile != "")   { inputString += ", phylip=" + phylipfile; }
@@ -15,7 +15,7 @@ vector<string> DistanceCommand::setParameters(){
 		CommandParameter pcolumn("column", "InputTypes", "", "", "none", "none", "OldFastaColumn","column",false,false); parameters.push_back(pcolumn);
 		CommandParameter poldfasta("oldfasta", "InputTypes", "", "", "none", "none", "OldFastaColumn","",false,false); parameters.push_back(poldfasta);
 		CommandParameter pfasta("fasta", "InputTypes", "", "", "none", "none", "none","phylip-column",false,true, true); parameters.push_back(pfasta);
-		CommandParameter poutput("output", "Multiple", "column-lt-square-phylip", "column", "", "", "","phylip-column",false,false, true); parameters.push_back(poutput);
+		CommandParameter poutput("output", "Multiple", "column-lt-square-phylip-sparse", "column", "", "", "","phylip-column-sparse",false,false, true); parameters.push_back(poutput);
 		CommandParameter pcalc("calc", "Multiple", "nogaps-eachgap-onegap", "onegap", "", "", "","",false,false); parameters.push_back(pcalc);
 		CommandParameter pcountends("countends", "Boolean", "", "T", "", "", "","",false,false); parameters.push_back(pcountends);
 		CommandParameter pcompress("compress", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(pcompress);
@@ -45,7 +45,8 @@ string DistanceCommand::getHelpString(){
 		helpString += "The calc parameter allows you to specify the method of calculating the distances.  Your options are: nogaps, onegap or eachgap. The default is onegap.\n";
 		helpString += "The countends parameter allows you to specify whether to include terminal gaps in distance.  Your options are: T or F. The default is T.\n";
 		helpString += "The cutoff parameter allows you to specify maximum distance to keep. The default is 1.0.\n";
-		helpString += "The output parameter allows you to specify format of your distance matrix. Options are column, lt, and square. The default is column.\n";
+		helpString += "The output parameter allows you to specify format of your distance matrix. Options are column, lt, square and sparse. The default is column.\n";
+		helpString += "The sparse output holds the same distances as column in a binary file that cluster, cluster.split and the opti method read much faster. Give it to them with the column parameter, it is not set as the current column file.\n";
 		helpString += "The processors parameter allows you to specify number of processors to use.  The default is 1.\n";
 		helpString += "The compress parameter allows you to indicate that you want the resulting distance file compressed.  The default is false.\n";
 		helpString += "The dist.seqs command should be in the following format: \n";
@@ -66,6 +67,7 @@ string DistanceCommand::getOutputPattern(string type) {
         
         if (type == "phylip") {  pattern = "[filename],[outputtag],dist"; } 
         else if (type == "column") { pattern = "[filename],dist"; }
+        else if (type == "sparse") { pattern = "[filename],sparse.dist"; }
         else { m->mothurOut("[ERROR]: No definition for type " + type + " output pattern.\n"); m->control_pressed = true;  }
         
         return pattern;
@@ -83,6 +85,7 @@ DistanceCommand::DistanceCommand(){
 		vector<string> tempOutNames;
 		outputTypes["phylip"] = tempOutNames;
 		outputTypes["column"] = tempOutNames;
+		outputTypes["sparse"] = tempOutNames;
 	}
 	catch(exception& e) {
 		m->errorOut(e, "DistanceCommand", "DistanceCommand");
@@ -117,6 +120,7 @@ DistanceCommand::DistanceCommand(string option) {
 			vector<string> tempOutNames;
 			outputTypes["phylip"] = tempOutNames;
 			outputTypes["column"] = tempOutNames;
+			outputTypes["sparse"] = tempOutNames;
 		
 			//if the user changes the input directory command factory will send this info to us in the output parameter 
 			string inputDir = validParameter.validFile(parameters, "inputdir", false);		
@@ -212,7 +216,9 @@ DistanceCommand::DistanceCommand(string option) {
 			
 			if ((column != "") && (oldfastafile != "") && (output != "column")) { m->mothurOut("You have provided column and oldfasta, indicating you want to append distances to your column file. Your output must be in column format to do so."); m->mothurOutEndLine(); abort=true; }
 			
-			if ((output != "column") && (output != "lt") && (output != "square")) { m->mothurOut(output + " is not a valid output form. Options are column, lt and square. I will use column."); m->mothurOutEndLine(); output = "column"; }
+			if ((output != "column") && (output != "lt") && (output != "square") && (output != "sparse")) { m->mothurOut(output + " is not a valid output form. Options are column, lt, square and sparse. I will use column."); m->mothurOutEndLine(); output = "column"; }
+			
+			if ((output == "sparse") && m->isTrue(compress)) { m->mothurOut("[WARNING]: sparse distance files are read in place and can't be compressed, ignoring compress."); m->mothurOutEndLine(); compress = "F"; }
 
 		}
 				
@@ -229,7 +235,7 @@ int DistanceCommand::execute(){
 		
 		if (abort == true) { if (calledHelp) { return 0; }  return 2;	}
 		
-		int startTime = time(NULL);
+		startTime = time(NULL);
 		
 		//save number of new sequence
 		numNewFasta = alignDB.getNumSeqs();
@@ -244,6 +250,8 @@ int DistanceCommand::execute(){
 		
 		if (!alignDB.sameLength()) {  m->mothurOut("[ERROR]: your sequences are not the same length, aborting."); m->mothurOutEndLine(); return 0; }
 		
+		packAlignment();
+		
 		string outputFile;
         
         map<string, string> variables; 
@@ -265,6 +273,10 @@ int DistanceCommand::execute(){
 			}
 			
 			m->mothurRemove(outputFile);
+		}else if (output == "sparse") { //column distances in the binary format, not made the current column file since only some commands read it
+			outputFile = getOutputFileName("sparse", variables);
+			m->mothurRemove(outputFile);
+			outputTypes["sparse"].push_back(outputFile);
 		}else { //assume square
 			variables["[outputtag]"] = "square";
 			outputFile = getOutputFileName("phylip", variables);
@@ -272,19 +284,38 @@ int DistanceCommand::execute(){
 			outputTypes["phylip"].push_back(outputFile);
 		}
 
-		//if you don't need to fork anything
+		ofstream outFile;
+		if (output == "sparse") {
+			m->openOutputFileBinary(outputFile, outFile);
+			SparseDistFile::writeHeader(outFile);
+			sparseRowSizes.assign(numSeqs, 0);
+		}else {
+			m->openOutputFile(outputFile, outFile);
+		}
+		outFile.setf(ios::fixed, ios::showpoint);
+		outFile << setprecision(4);
+		
+		//phylip formatted files start with the number of sequences
+		if ((output == "lt") || (output == "square")) { outFile << numSeqs << endl; }
+		
 		if(processors == 1){
-			if (output != "square") {  driver(0, numSeqs, outputFile, cutoff); }
-			else { driver(0, numSeqs, outputFile, "square");  }
+			ColumnDist* distCalculator = createDistCalculator();
+			if (output != "square") {  driver(0, numSeqs, outFile, distCalculator, cutoff); }
+			else { driver(0, numSeqs, outFile, distCalculator, "square");  }
+			delete distCalculator;
 		}else{ //you have multiple processors
-			createProcesses(outputFile, numSeqs);
+			createProcesses(outFile, numSeqs);
 		}
+		if (output == "sparse") { SparseDistFile::writeTables(outFile, seqNames, sparseRowSizes, cutoff); sparseRowSizes.clear(); }
+		outFile.close();
+		
+		m->mothurOutJustToScreen(toString(numSeqs-1) + "\t" + toString(time(NULL) - startTime)+"\n");
 
 		if (m->control_pressed) { outputTypes.clear();  m->mothurRemove(outputFile); return 0; }
 		
 		ifstream fileHandle;
 		fileHandle.open(outputFile.c_str());
-		if(fileHandle) {
+		if(fileHandle && (output != "sparse")) {
 			m->gobble(fileHandle);
 			if (fileHandle.eof()) { m->mothurOut(outputFile + " is blank. This can result if there are no distances below your cutoff.");  m->mothurOutEndLine(); }
 		}
@@ -348,169 +379,84 @@ int DistanceCommand::execute(){
 	}
 }
 /**************************************************************************************************/
-void DistanceCommand::createProcesses(string filename, int numSeqs) {
+//packs the alignment into one buffer so the calculators read every pair in place instead of copying sequences.
+//columns that are '-' in every sequence never change a distance, so they are left out, and each sequence's span
+//(first to last column that isn't '.') is saved so a pair only looks at the columns either of them covers.
+void DistanceCommand::packAlignment() {
 	try {
-        unsigned long long numDists = 0;
-        
-        if (output == "square") {
-            numDists = numSeqs * numSeqs;
-        }else {
-            for(int i=0;i<numSeqs;i++){
-                for(int j=0;j<i;j++){
-                    numDists++;
-                    if (numDists > processors) { break; }
-                }
-            }
-        }
-        
-        if (numDists < processors) { processors = numDists; }
-        
-        for (int i = 0; i < processors; i++) {
-            distlinePair tempLine;
-            lines.push_back(tempLine);
-            if (output != "square") {
-                lines[i].start = int (sqrt(float(i)/float(processors)) * numSeqs);
-                lines[i].end = int (sqrt(float(i+1)/float(processors)) * numSeqs);
-            }else{
-                lines[i].start = int ((float(i)/float(processors)) * numSeqs);
-                lines[i].end = int ((float(i+1)/float(processors)) * numSeqs);
-            }
-            
-        }
-
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-		int process = 1;
-		processIDS.clear();
-        bool recalc = false;
-		
-		//loop through and create all the processes you want
-		while (process != processors) {
-			pid_t pid = fork();
-			
-			if (pid > 0) {
-                processIDS.push_back(pid);  //create map from line number to pid so you can append files in correct order later
-                process++;
-                if (m->debug) { m->mothurOut("[DEBUG]: parent process is saving child pid " + toString(pid) + ".\n"); }
-            }else if (pid == 0){
-				if (output != "square") {  driver(lines[process].start, lines[process].end, filename + m->mothurGetpid(process) + ".temp", cutoff); }
-				else { driver(lines[process].start, lines[process].end, filename + m->mothurGetpid(process) + ".temp", "square"); }
-				exit(0);
-			}else { 
-                m->mothurOut("[ERROR]: unable to spawn the number of processes you requested, reducing number to " + toString(process) + "\n"); processors = process;
-                for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); }
-                //wait to die
-                for (int i=0;i<processIDS.size();i++) {
-                    int temp = processIDS[i];
-                    wait(&temp);
-                }
-                for (int i=0;i<processIDS.size();i++) {
-                    m->mothurRemove(filename + (toString(processIDS[i]) + ".temp"));
-                }
-                m->control_pressed = false;
-                recalc = true;
-                break;
-			}
-		}
-        
-        if (recalc) {
-            //test line, also set recalc to true.
-            //for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); } for (int i=0;i<processIDS.size();i++) { int temp = processIDS[i]; wait(&temp); } for (int i=0;i<processIDS.size();i++) {m->mothurRemove(filename + (toString(processIDS[i]) + ".temp"));}m->control_pressed = false;  processors=3; m->mothurOut("[ERROR]: unable to spawn the number of processes you requested, reducing number to " + toString(processors) + "\n");
-            
-            processIDS.resize(0);
-            process = 1;
-            lines.clear();
-            
-            for (int i = 0; i < processors; i++) {
-                distlinePair tempLine;
-                lines.push_back(tempLine);
-                if (output != "square") {
-                    lines[i].start = int (sqrt(float(i)/float(processors)) * numSeqs);
-                    lines[i].end = int (sqrt(float(i+1)/float(processors)) * numSeqs);
-                }else{
-                    lines[i].start = int ((float(i)/float(processors)) * numSeqs);
-                    lines[i].end = int ((float(i+1)/float(processors)) * numSeqs);
-                }
-            }
-            
-            //loop through and create all the processes you want
-            while (process != processors) {
-                pid_t pid = fork();
-                
-                if (pid > 0) {
-                    processIDS.push_back(pid);  //create map from line number to pid so you can append files in correct order later
-                    process++;
-                    if (m->debug) { m->mothurOut("[DEBUG]: parent process is saving child pid " + toString(pid) + ".\n"); }
-                }else if (pid == 0){
-                    if (output != "square") {  driver(lines[process].start, lines[process].end, filename + m->mothurGetpid(process) + ".temp", cutoff); }
-                    else { driver(lines[process].start, lines[process].end, filename + m->mothurGetpid(process) + ".temp", "square"); }
-                    exit(0);
-                }else {
-                    m->mothurOut("[ERROR]: unable to spawn the necessary processes. Error code: " + toString(pid)); m->mothurOutEndLine();
-                    perror(" : ");
-                    for (int i=0;i<processIDS.size();i++) {  int temp = processIDS[i]; kill (temp, SIGINT); }
-                    exit(0);
-                }
-            }
-        }
-		
-		//parent does its part
-		if (output != "square") {  driver(lines[0].start, lines[0].end, filename, cutoff); }
-		else { driver(lines[0].start, lines[0].end, filename, "square"); }
-		
-		
-		//force parent to wait until all the processes are done
-		for (int i=0;i<processIDS.size();i++) { 
-			int temp = processIDS[i];
-			wait(&temp);
+		int numSeqs = alignDB.getNumSeqs();
+		int fullLength = 0;
+		if (numSeqs != 0) { fullLength = alignDB.get(0).getAligned().length(); }
+		
+		vector<bool> allGaps(fullLength, true);
+		for (int i = 0; i < numSeqs; i++) {
+			Sequence seq = alignDB.get(i);
+			const string& aligned = seq.getAligned();
+			for (int k = 0; k < fullLength; k++) { if (aligned[k] != '-') { allGaps[k] = false; } }
 		}
-#else
-		//////////////////////////////////////////////////////////////////////////////////////////////////////
-		//Windows version shared memory, so be careful when passing variables through the distanceData struct. 
-		//Above fork() will clone, so memory is separate, but that's not the case with windows, 
-		//that's why the distance calculator was moved inside of the driver to make separate copies.
-		//////////////////////////////////////////////////////////////////////////////////////////////////////
-		
-		vector<distanceData*> pDataArray; //[processors-1];
-		DWORD   dwThreadIdArray[processors-1];
-		HANDLE  hThreadArray[processors-1]; 
-		
-		//Create processor-1 worker threads.
-		for( int i=0; i<processors-1; i++ ){
-			
-			// Allocate memory for thread data.
-			distanceData* tempDist = new distanceData(lines[i+1].start, lines[i+1].end, (filename + toString(i) + ".temp"), cutoff, alignDB, Estimators, m, output, numNewFasta, countends);
-			pDataArray.push_back(tempDist);
-			processIDS.push_back(i);
+		
+		vector<int> keep;
+		for (int k = 0; k < fullLength; k++) { if (!allGaps[k]) { keep.push_back(k); } }
+		alignLength = keep.size();
+		
+		if (m->debug) { m->mothurOut("[DEBUG]: removed " + toString(fullLength - alignLength) + " columns that are gaps in every sequence.\n"); }
+		
+		alignBuffer.resize((unsigned long long)numSeqs * alignLength);
+		seqNames.resize(numSeqs);
+		seqStarts.assign(numSeqs, alignLength);
+		seqEnds.assign(numSeqs, -1);
+		
+		for (int i = 0; i < numSeqs; i++) {
+			Sequence seq = alignDB.get(i);
+			seqNames[i] = seq.getName();
 			
-			//MyDistThreadFunction is in header. It must be global or static to work with the threads.
-			//default security attributes, thread function name, argument to thread function, use default creation flags, returns the thread identifier
-			hThreadArray[i] = CreateThread(NULL, 0, MyDistThreadFunction, pDataArray[i], 0, &dwThreadIdArray[i]);   
+			const string& aligned = seq.getAligned();
+			char* packed = &alignBuffer[0] + (unsigned long long)i * alignLength;
+			for (int k = 0; k < alignLength; k++) {
+				packed[k] = aligned[keep[k]];
+				if (packed[k] != '.') {
+					if (seqStarts[i] == alignLength) { seqStarts[i] = k; }
+					seqEnds[i] = k;
+				}
+			}
 		}
 		
-		//do your part
-		if (output != "square") {  driver(lines[0].start, lines[0].end, filename, cutoff); }
-		else { driver(lines[0].start, lines[0].end, filename, "square"); }
+		alignDB.clear();
+	}
+	catch(exception& e) {
+		m->errorOut(e, "DistanceCommand", "packAlignment");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//the sequences are shared by all the threads, each thread gets its own calculator and the rows are written in order as they finish
+void DistanceCommand::createProcesses(ostream& out, int numSeqs) {
+	try {
+		vector<ColumnDist*> distCalculators;
+		for (int i = 0; i < processors; i++) { distCalculators.push_back(createDistCalculator()); }
+		
+		OrderedOutput writer(out, 0);
 		
-		//Wait until all threads have terminated.
-		WaitForMultipleObjects(processors-1, hThreadArray, TRUE, INFINITE);
+		//lower triangle rows get longer as i grows, so hand rows out a few at a time instead of in fixed blocks
+		long long grain = numSeqs / (processors * 100);
+		if (grain < 1) { grain = 1; }
 		
-		//Close all thread handles and free memory allocations.
-		for(int i=0; i < pDataArray.size(); i++){
-            if (pDataArray[i]->count != (pDataArray[i]->endLine-pDataArray[i]->startLine)) {
-                m->mothurOut("[ERROR]: process " + toString(i) + " only processed " + toString(pDataArray[i]->count) + " of " + toString(pDataArray[i]->endLine-pDataArray[i]->startLine) + " sequences assigned to it, quitting. \n"); m->control_pressed = true; 
-            }
-			CloseHandle(hThreadArray[i]);
-			delete pDataArray[i];
-		}
-#endif
+		ThreadPool::getInstance()->parallelForOrdered(0, numSeqs, processors, [&](long long startLine, long long endLine, int threadID) {
+			ostringstream rows;
+			rows.setf(ios::fixed, ios::showpoint);
+			rows << setprecision(4);
+			
+			if (output != "square") {  driver(startLine, endLine, rows, distCalculators[threadID], cutoff); }
+			else { driver(startLine, endLine, rows, distCalculators[threadID], "square"); }
+			
+			writer.commit(startLine, endLine, rows.str());
+		}, grain);
 		
-		//append and remove temp files
-		for (int i=0;i<processIDS.size();i++) {
-            if (m->debug) { m->mothurOut("[DEBUG]: parent process is appending child pid " + toString(processIDS[i]) + ".\n"); }
-			m->appendFiles((filename + toString(processIDS[i]) + ".temp"), filename);
-			m->mothurRemove((filename + toString(processIDS[i]) + ".temp"));
-		}
+		for (int i = 0; i < distCalculators.size(); i++) { delete distCalculators[i]; }
 		
+		if ((writer.getNext() != numSeqs) && (!m->control_pressed)) {
+			m->mothurOut("[ERROR]: only " + toString(writer.getNext()) + " of " + toString(numSeqs) + " rows were written, quitting. \n"); m->control_pressed = true;
+		}
 	}
 	catch(exception& e) {
 		m->errorOut(e, "DistanceCommand", "createProcesses");
@@ -518,41 +464,35 @@ void DistanceCommand::createProcesses(string filename, int numSeqs) {
 	}
 }
 /**************************************************************************************************/
-/////// need to fix to work with calcs and sequencedb
-int DistanceCommand::driver(int startLine, int endLine, string dFileName, float cutoff){
+ColumnDist* DistanceCommand::createDistCalculator(){
 	try {
 		ValidCalculators validCalculator;
-		Dist* distCalculator;
-		if (m->isTrue(countends) == true) {
-			for (int i=0; i<Estimators.size(); i++) {
-				if (validCalculator.isValidCalculator("distance", Estimators[i]) == true) { 
-					if (Estimators[i] == "nogaps")			{	distCalculator = new ignoreGaps();	}
-					else if (Estimators[i] == "eachgap")	{	distCalculator = new eachGapDist();	}
-					else if (Estimators[i] == "onegap")		{	distCalculator = new oneGapDist();	}
-				}
-			}
-		}else {
-			for (int i=0; i<Estimators.size(); i++) {
-				if (validCalculator.isValidCalculator("distance", Estimators[i]) == true) { 
-					if (Estimators[i] == "nogaps")		{	distCalculator = new ignoreGaps();					}
-					else if (Estimators[i] == "eachgap"){	distCalculator = new eachGapIgnoreTermGapDist();	}
-					else if (Estimators[i] == "onegap")	{	distCalculator = new oneGapIgnoreTermGapDist();		}
-				}
+		ColumnDist* distCalculator = NULL;
+		
+		//ColumnDist gives the same results as ignoreGaps, eachGapDist, oneGapDist and their ignore terminal gap versions, 64 columns at a time
+		for (int i=0; i<Estimators.size(); i++) {
+			if (validCalculator.isValidCalculator("distance", Estimators[i]) == true) { 
+				if (distCalculator != NULL) { delete distCalculator; }
+				distCalculator = new ColumnDist(Estimators[i], m->isTrue(countends));
 			}
 		}
 		
-		int startTime = time(NULL);
-		
-		//column file
-		ofstream outFile(dFileName.c_str(), ios::trunc);
-		outFile.setf(ios::fixed, ios::showpoint);
-		outFile << setprecision(4);
-		
-		if((output == "lt") && startLine == 0){	outFile << alignDB.getNumSeqs() << endl;	}
+		//only the column and sparse outputs drop distances above the cutoff, so only they can stop a pair early
+		if ((distCalculator != NULL) && ((output == "column") || (output == "sparse"))) { distCalculator->setCutoff(cutoff); }
 		
+		return distCalculator;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "DistanceCommand", "createDistCalculator");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+int DistanceCommand::driver(int startLine, int endLine, ostream& outFile, ColumnDist* distCalculator, float cutoff){
+	try {
 		for(int i=startLine;i<endLine;i++){
 			if(output == "lt")	{	
-				string name = alignDB.get(i).getName();
+				string name = seqNames[i];
 				if (name.length() < 10) { //pad with spaces to make compatible
 					while (name.length() < 10) {  name += " ";  }
 				}
@@ -560,17 +500,22 @@ int DistanceCommand::driver(int startLine, int endLine, string dFileName, float
 			}
 			for(int j=0;j<i;j++){
 				
-				if (m->control_pressed) { delete distCalculator; outFile.close(); return 0;  }
+				if (m->control_pressed) { return 0;  }
                 
 				//if there was a column file given and we are appending, we don't want to calculate the distances that are already in the column file
 				//the alignDB contains the new sequences and then the old, so if i an oldsequence and j is an old sequence then break out of this loop
 				if ((i >= numNewFasta) && (j >= numNewFasta)) { break; }
 				
-				distCalculator->calcDist(alignDB.get(i), alignDB.get(j));
+				calcPairDist(distCalculator, i, j);
 				double dist = distCalculator->getDist();
 				
 				if(dist <= cutoff){
-					if (output == "column") { outFile << alignDB.get(i).getName() << ' ' << alignDB.get(j).getName() << ' ' << dist << endl; }
+					if (output == "column") { outFile << seqNames[i] << ' ' << seqNames[j] << ' ' << dist << endl; }
+					else if (output == "sparse") { //stored as the column file would print it, so both cluster the same
+						char printed[32]; snprintf(printed, 32, "%.4g", dist);
+						SparseDistFile::writeCell(outFile, j, strtof(printed, NULL));
+						sparseRowSizes[i]++;
+					}
 				}
                 if (output == "lt") {  outFile  << '\t' << dist; }
 			}
@@ -582,10 +527,6 @@ int DistanceCommand::driver(int startLine, int endLine, string dFileName, float
 			}
 			
 		}
-		m->mothurOutJustToScreen(toString(endLine-1) + "\t" + toString(time(NULL) - startTime)+"\n");
-		
-		outFile.close();
-		delete distCalculator;
 		
 		return 1;
 	}
@@ -595,51 +536,21 @@ int DistanceCommand::driver(int startLine, int endLine, string dFileName, float
 	}
 }
 /**************************************************************************************************/
-/////// need to fix to work with calcs and sequencedb
-int DistanceCommand::driver(int startLine, int endLine, string dFileName, string square){
+int DistanceCommand::driver(int startLine, int endLine, ostream& outFile, ColumnDist* distCalculator, string square){
 	try {
-		ValidCalculators validCalculator;
-		Dist* distCalculator;
-		if (m->isTrue(countends) == true) {
-			for (int i=0; i<Estimators.size(); i++) {
-				if (validCalculator.isValidCalculator("distance", Estimators[i]) == true) { 
-					if (Estimators[i] == "nogaps")			{	distCalculator = new ignoreGaps();	}
-					else if (Estimators[i] == "eachgap")	{	distCalculator = new eachGapDist();	}
-					else if (Estimators[i] == "onegap")		{	distCalculator = new oneGapDist();	}
-				}
-			}
-		}else {
-			for (int i=0; i<Estimators.size(); i++) {
-				if (validCalculator.isValidCalculator("distance", Estimators[i]) == true) { 
-					if (Estimators[i] == "nogaps")		{	distCalculator = new ignoreGaps();					}
-					else if (Estimators[i] == "eachgap"){	distCalculator = new eachGapIgnoreTermGapDist();	}
-					else if (Estimators[i] == "onegap")	{	distCalculator = new oneGapIgnoreTermGapDist();		}
-				}
-			}
-		}
-		
-		int startTime = time(NULL);
-		
-		//column file
-		ofstream outFile(dFileName.c_str(), ios::trunc);
-		outFile.setf(ios::fixed, ios::showpoint);
-		outFile << setprecision(4);
-		
-		if(startLine == 0){	outFile << alignDB.getNumSeqs() << endl;	}
-		
 		for(int i=startLine;i<endLine;i++){
 				
-			string name = alignDB.get(i).getName();
+			string name = seqNames[i];
 			//pad with spaces to make compatible
 			if (name.length() < 10) { while (name.length() < 10) {  name += " ";  } }
 				
 			outFile << name << '\t';	
 			
-			for(int j=0;j<alignDB.getNumSeqs();j++){
+			for(int j=0;j<seqNames.size();j++){
 				
-				if (m->control_pressed) { delete distCalculator; outFile.close(); return 0;  }
+				if (m->control_pressed) { return 0;  }
 				
-				distCalculator->calcDist(alignDB.get(i), alignDB.get(j));
+				calcPairDist(distCalculator, i, j);
 				double dist = distCalculator->getDist();
 				
 				outFile << dist << '\t'; 
@@ -652,10 +563,6 @@ int DistanceCommand::driver(int startLine, int endLine, string dFileName, string
 			}
 			
 		}
-		m->mothurOutJustToScreen(toString(endLine-1) + "\t" + toString(time(NULL) - startTime)+"\n");
-		
-		outFile.close();
-		delete distCalculator;
 		
 		return 1;
 	}
@@ -12,6 +12,7 @@
 #include "readphylipvector.h"
 #include "sharedutilities.h"
 #include "designmap.h"
+#include "permutationtest.h"
 
 //**********************************************************************************************************************
 vector<string> HomovaCommand::setParameters(){	
@@ -21,6 +22,8 @@ vector<string> HomovaCommand::setParameters(){
         CommandParameter psets("sets", "String", "", "", "", "", "","",false,false); parameters.push_back(psets);
 		CommandParameter piters("iters", "Number", "", "1000", "", "", "","",false,false); parameters.push_back(piters);
 		CommandParameter palpha("alpha", "Number", "", "0.05", "", "", "","",false,false); parameters.push_back(palpha);
+		CommandParameter pearlystop("earlystop", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(pearlystop);
+		CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
 		CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
@@ -40,11 +43,13 @@ string HomovaCommand::getHelpString(){
 		string helpString = "";
 		helpString += "Referenced: Stewart CN, Excoffier L (1996). Assessing population genetic structure and variability with RAPD data: Application to Vaccinium macrocarpon (American Cranberry). J Evol Biol 9: 153-71.\n";
 		helpString += "The homova command outputs a .homova file. \n";
-		helpString += "The homova command parameters are phylip, iters, sets and alpha.  The phylip and design parameters are required, unless valid current files exist.\n";
+		helpString += "The homova command parameters are phylip, iters, sets, alpha, earlystop and processors.  The phylip and design parameters are required, unless valid current files exist.\n";
 		helpString += "The design parameter allows you to assign your samples to groups when you are running homova. It is required. \n";
 		helpString += "The design file looks like the group file.  It is a 2 column tab delimited file, where the first column is the sample name and the second column is the group the sample belongs to.\n";
         helpString += "The sets parameter allows you to specify which of the sets in your designfile you would like to analyze. The set names are separated by dashes. THe default is all sets in the designfile.\n";
 		helpString += "The iters parameter allows you to set number of randomization for the P value.  The default is 1000. \n";
+		helpString += "The processors parameter allows you to specify the number of processors to use for the randomizations. The default is 1.\n";
+		helpString += "The earlystop parameter allows you to stop the randomizations once the P value is clearly above or below the alpha of a comparison, in steps of 1000, and report how many were run. The default is F.\n";
 		helpString += "The homova command should be in the following format: homova(phylip=file.dist, design=file.design).\n";
 		helpString += "Note: No spaces between parameter labels (i.e. iters), '=' and parameters (i.e. 1000).\n";
 		return helpString;
@@ -162,6 +167,14 @@ HomovaCommand::HomovaCommand(string option) {
 			temp = validParameter.validFile(parameters, "alpha", false);
 			if (temp == "not found") { temp = "0.05"; }
 			m->mothurConvert(temp, experimentwiseAlpha); 
+			
+			temp = validParameter.validFile(parameters, "earlystop", false);
+			if (temp == "not found") { temp = "F"; }
+			earlyStop = m->isTrue(temp);
+			
+			temp = validParameter.validFile(parameters, "processors", false);	if (temp == "not found"){	temp = m->getProcessors();	}
+			m->setProcessors(temp);
+			m->mothurConvert(temp, processors);
             
             string sets = validParameter.validFile(parameters, "sets", false);			
 			if (sets == "not found") { sets = ""; }
@@ -244,8 +257,11 @@ int HomovaCommand::execute(){
 		m->openOutputFile(HOMOVAFileName, HOMOVAFile);
 		outputNames.push_back(HOMOVAFileName); outputTypes["homova"].push_back(HOMOVAFileName);
 		
-		HOMOVAFile << "HOMOVA\tBValue\tP-value\tSSwithin/(Ni-1)_values" << endl;
-		m->mothurOut("HOMOVA\tBValue\tP-value\tSSwithin/(Ni-1)_values\n");
+		string header = "HOMOVA\tBValue\tP-value\t";
+		if (earlyStop) { header += "permutations\t"; }
+		header += "SSwithin/(Ni-1)_values";
+		HOMOVAFile << header << endl;
+		m->mothurOut(header + "\n");
 		
 		double fullHOMOVAPValue = runHOMOVA(HOMOVAFile, origGroupSampleMap, experimentwiseAlpha);
 
@@ -304,18 +320,17 @@ double HomovaCommand::runHOMOVA(ofstream& HOMOVAFile, map<string, vector<int> >
 		vector<double> ssWithinOrigVector;
 		double bValueOrig = calcBValue(groupSampleMap, ssWithinOrigVector);
 		
-		double counter = 0;
-		for(int i=0;i<iters;i++){
+		PermutationTest test(iters, processors);
+		if (earlyStop) { test.setAlpha(alpha); }
+		test.run([&](mt19937_64& rng) {
 			vector<double> ssWithinRandVector;
-			map<string, vector<int> > randomizedGroup = getRandomizedGroups(groupSampleMap);
+			map<string, vector<int> > randomizedGroup = getRandomizedGroups(groupSampleMap, rng);
 			double bValueRand = calcBValue(randomizedGroup, ssWithinRandVector);
-			if(bValueRand >= bValueOrig){	counter++;	}
-		}
+			return (bValueRand >= bValueOrig);
+		});
 		
-		double pValue = (double) counter / (double) iters;
-		string pString = "";
-		if(pValue < 1/(double)iters){	pString = '<' + toString(1/(double)iters);	}
-		else						{	pString = toString(pValue);					}
+		double pValue = test.getPValue();
+		string pString = test.getPString();
 		
 		
 		//print homova table
@@ -335,6 +350,10 @@ double HomovaCommand::runHOMOVA(ofstream& HOMOVAFile, map<string, vector<int> >
 			HOMOVAFile << "*";
 			m->mothurOut("*");
 		}
+		if (earlyStop) {
+			HOMOVAFile << '\t' << test.getNumRun();
+			m->mothurOut('\t' + toString(test.getNumRun()));
+		}
 
 		for(int i=0;i<numGroups;i++){
 			HOMOVAFile << '\t' << ssWithinOrigVector[i];
@@ -391,7 +410,7 @@ double HomovaCommand::calcBValue(map<string, vector<int> > groupSampleMap, vecto
 		ssWithinVector.resize(numGroups, 0);
 		
 		double totalNumSamples = 0;
-		double ssWithinFull;
+		double ssWithinFull = 0;
 		double secondTermSum = 0;
 		double inverseOneMinusSum = 0;
 		int index = 0;
@@ -426,7 +445,7 @@ double HomovaCommand::calcBValue(map<string, vector<int> > groupSampleMap, vecto
 
 //**********************************************************************************************************************
 
-map<string, vector<int> > HomovaCommand::getRandomizedGroups(map<string, vector<int> > origMapping){
+map<string, vector<int> > HomovaCommand::getRandomizedGroups(map<string, vector<int> >& origMapping, mt19937_64& rng){
 	try{
 		vector<int> sampleIndices;
 		vector<int> samplesPerGroup;
@@ -438,7 +457,7 @@ map<string, vector<int> > HomovaCommand::getRandomizedGroups(map<string, vector<
 			sampleIndices.insert(sampleIndices.end(), indices.begin(), indices.end());
 		}
 		
-		m->mothurRandomShuffle(sampleIndices);
+		shuffle(sampleIndices.begin(), sampleIndices.end(), rng);
 		
 		int index = 0;
 		map<string, vector<int> > randomizedGroups = origMapping;
@@ -38,7 +38,7 @@ private:
 	double runHOMOVA(ofstream& , map<string, vector<int> >, double);
 	double calcSigleSSWithin(vector<int>);
 	double calcBValue(map<string, vector<int> >, vector<double>&);
-	map<string, vector<int> > getRandomizedGroups(map<string, vector<int> >);
+	map<string, vector<int> > getRandomizedGroups(map<string, vector<int> >&, mt19937_64&);
 
 	bool abort;
 	vector<string> outputNames, Sets;
@@ -46,8 +46,9 @@ private:
 	string outputDir, inputDir, designFileName, phylipFileName;
 	DesignMap* designMap;
 	vector< vector<double> > distanceMatrix;
-	int iters;
+	int iters, processors;
 	double experimentwiseAlpha;
+	bool earlyStop;
 };
 
 #endif
@@ -27,7 +27,7 @@ vector<string> MakeContigsCommand::setParameters(){
         CommandParameter ptdiffs("tdiffs", "Number", "", "0", "", "", "","",false,false); parameters.push_back(ptdiffs);
         CommandParameter preorient("checkorient", "Boolean", "", "F", "", "", "","",false,false,true); parameters.push_back(preorient);
         CommandParameter prename("rename", "Boolean", "", "F", "", "", "","",false,false,true); parameters.push_back(prename);
-        CommandParameter palign("align", "Multiple", "needleman-gotoh-kmer", "needleman", "", "", "","",false,false); parameters.push_back(palign);
+        CommandParameter palign("align", "Multiple", "needleman-gotoh-kmer-simd-banded", "needleman", "", "", "","",false,false); parameters.push_back(palign);
         CommandParameter pallfiles("allfiles", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(pallfiles);
         CommandParameter ptrimoverlap("trimoverlap", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(ptrimoverlap);
 		CommandParameter pmatch("match", "Number", "", "1.0", "", "", "","",false,false); parameters.push_back(pmatch);
@@ -67,7 +67,7 @@ string MakeContigsCommand::getHelpString(){
         helpString += "The fqfile and rqfile parameters are used to provide a forward quality and reverse quality files to process with the ffasta and rfasta parameters.  If you provide one, you must provide the other.\n";
 		helpString += "The format parameter is used to indicate whether your sequences are sanger, solexa, illumina1.8+ or illumina, default=illumina1.8+.\n";
         helpString += "The findex and rindex parameters are used to provide a forward index and reverse index files to process.  \n";
-        helpString += "The align parameter allows you to specify the alignment method to use.  Your options are: kmer, gotoh and needleman. The default is needleman.\n";
+        helpString += "The align parameter allows you to specify the alignment method to use.  Your options are: kmer, gotoh, needleman, simd and banded. simd gives the same alignments as needleman using SSE2. banded finds the diagonal the reads overlap on from their shared 8mers and only aligns near it, falling back to simd when no clear diagonal is found. It is faster but not exact, when the best overlap shares few 8mers its contigs can differ from needleman's. The default is needleman.\n";
         helpString += "The ksize parameter allows you to set the kmer size if you are doing align=kmer. Default=8.\n";
         helpString += "The tdiffs parameter is used to specify the total number of differences allowed in the sequence. The default is pdiffs + bdiffs + sdiffs + ldiffs.\n";
 		helpString += "The bdiffs parameter is used to specify the number of differences allowed in the barcode. The default is 0.\n";
@@ -134,7 +134,7 @@ MakeContigsCommand::MakeContigsCommand(){
 MakeContigsCommand::MakeContigsCommand(string option)  {
 	try {
 		abort = false; calledHelp = false;
-        createFileGroup = false; createOligosGroup = false; gz = false;
+        createFileGroup = false; createOligosGroup = false; gz = false; contigThreads = 1;
         
 		//allow user to run help
 		if(option == "help") { help(); abort = true; calledHelp = true; }
@@ -381,7 +381,7 @@ MakeContigsCommand::MakeContigsCommand(string option)  {
 			trimOverlap = m->isTrue(temp);
 			
 			align = validParameter.validFile(parameters, "align", false);		if (align == "not found"){	align = "needleman";	}
-			if ((align != "needleman") && (align != "gotoh") && (align != "kmer")) { m->mothurOut(align + " is not a valid alignment method. Options are kmer, needleman or gotoh. I will use needleman."); m->mothurOutEndLine(); align = "needleman"; }
+			if ((align != "needleman") && (align != "gotoh") && (align != "kmer") && (align != "simd") && (align != "banded")) { m->mothurOut(align + " is not a valid alignment method. Options are kmer, needleman, gotoh, simd or banded. I will use needleman."); m->mothurOutEndLine(); align = "needleman"; }
             
             format = validParameter.validFile(parameters, "format", false);		if (format == "not found"){	format = "illumina1.8+";	}
             
@@ -714,8 +714,14 @@ unsigned long long MakeContigsCommand::processSingleFileOption(map<string, int>&
         variables["[tag]"] = "";
         outMisMatchFile = getOutputFileName("report",variables);
         
-        //divides the files so that the processors can share the workload.
-        setLines(fileInputs, qualOrIndexInputs, lines, qLines, delim);
+        if (gz) { //compressed files can't be divided, driver runs them through processors threads instead
+            nameType = setNameType(fileInputs[0], fileInputs[1], delim);
+            lines.push_back(linePair(0, 1000)); lines.push_back(linePair(0, 1000));
+            qLines.push_back(linePair(0, 1000)); qLines.push_back(linePair(0, 1000));
+        }else {
+            //divides the files so that the processors can share the workload.
+            setLines(fileInputs, qualOrIndexInputs, lines, qLines, delim);
+        }
         
         vector<vector<string> > fastaFileNames, qualFileNames;
         map<string, string> uniqueFastaNames;// so we don't add the same groupfile multiple times
@@ -730,7 +736,12 @@ unsigned long long MakeContigsCommand::processSingleFileOption(map<string, int>&
         if (createFileGroup) {  createOligosGroup = false; }
         
         m->mothurOut("Making contigs...\n");
-        numReads = createProcesses(fileInputs, qualOrIndexInputs, outFastaFile, outScrapFastaFile, outQualFile, outScrapQualFile, outMisMatchFile, fastaFileNames, qualFileNames, lines, qLines, group);
+        if (gz) {
+            contigThreads = processors;
+            numReads = driver(fileInputs, qualOrIndexInputs, outFastaFile, outScrapFastaFile, outQualFile, outScrapQualFile, outMisMatchFile, fastaFileNames, qualFileNames, lines[0], lines[1], qLines[0], qLines[1], group);
+        }else {
+            numReads = createProcesses(fileInputs, qualOrIndexInputs, outFastaFile, outScrapFastaFile, outQualFile, outScrapQualFile, outMisMatchFile, fastaFileNames, qualFileNames, lines, qLines, group);
+        }
         
         if (m->control_pressed) { for (int i = 0; i < outputNames.size(); i++) {	m->mothurRemove(outputNames[i]); }  delete oligos; return 0; }
         
@@ -954,7 +965,8 @@ unsigned long long MakeContigsCommand::createProcessesGroups(vector< vector<stri
         //divide files between processors
         int remainingPairs = fileInputs.size();
         
-        if (remainingPairs < processors) { processors = remainingPairs; }
+        //with fewer pairs than processors, the processors left over assemble each pair on threads
+        if (remainingPairs < processors) { contigThreads = processors / max(remainingPairs, 1); processors = remainingPairs; }
         
         int startIndex = 0;
         for (int remainingProcessors = processors; remainingProcessors > 0; remainingProcessors--) {
@@ -1895,239 +1907,76 @@ unsigned long long MakeContigsCommand::driver(vector<string> inputFiles, vector<
         
         if (m->debug) { if (hasQuality) { m->mothurOut("[DEBUG]: hasQuality = true\n");  } else { m->mothurOut("[DEBUG]: hasQuality = false\n"); } }
         
-        TrimOligos trimOligos(pdiffs, bdiffs, 0, 0, oligos->getPairedPrimers(), oligos->getPairedBarcodes(), hasIndex);
-
-        TrimOligos* rtrimOligos = NULL;
-        if (reorient) {  rtrimOligos = new TrimOligos(pdiffs, bdiffs, 0, 0, oligos->getReorientedPairedPrimers(), oligos->getReorientedPairedBarcodes(), hasIndex); numBarcodes = oligos->getReorientedPairedBarcodes().size();    }
+        if (reorient) { numBarcodes = oligos->getReorientedPairedBarcodes().size(); }
         
-        Alignment* alignment;
-        if(align == "gotoh")			{	alignment = new GotohOverlap(gapOpen, gapExtend, match, misMatch, longestBase);			}
-        else if(align == "needleman")	{	alignment = new NeedlemanOverlap(gapOpen, match, misMatch, longestBase);				}
-        else if(align == "kmer")        {   alignment = new KmerAlign(kmerSize);                                                    }
-
-        bool good = true;
-        while (good) {
-            
-            if (m->control_pressed) { break; }
+        bool pipelined = false;
+        #ifdef USE_BOOST
+        pipelined = (gz && (contigThreads > 1));
+        #endif
+        
+        if (pipelined) {
+            #ifdef USE_BOOST
+            num = driverPipelined(inFF, inRF, inFQ, inRQ, thisfqualindexfile, thisrqualindexfile, qual_match_simple_bayesian, qual_mismatch_simple_bayesian, hasQuality, hasIndex, group, outFasta, outScrapFasta, outQual, outScrapQual, outMisMatch, fastaFileNames, qualFileNames);
+            #endif
+        }else {
+            TrimOligos trimOligos(pdiffs, bdiffs, 0, 0, oligos->getPairedPrimers(), oligos->getPairedBarcodes(), hasIndex);
             
-            int success = 1;
-            string trashCode = "";
-            string commentString = "";
-            int currentSeqsDiffs = 0;
+            TrimOligos* rtrimOligos = NULL;
+            if (reorient) {  rtrimOligos = new TrimOligos(pdiffs, bdiffs, 0, 0, oligos->getReorientedPairedPrimers(), oligos->getReorientedPairedBarcodes(), hasIndex);  }
             
-            bool ignore = false;
-            Sequence fSeq, rSeq;
-            QualityScores* fQual = NULL; QualityScores* rQual = NULL;
-            QualityScores* savedFQual = NULL; QualityScores* savedRQual = NULL;
-            Sequence findexBarcode("findex", "NONE");  Sequence rindexBarcode("rindex", "NONE");
-            
-            //read from input files
-            if (gz) {
-                #ifdef USE_BOOST
-                ignore = read(fSeq, rSeq, fQual, rQual, savedFQual, savedRQual, findexBarcode, rindexBarcode, delim, inFF, inRF, inFQ, inRQ, thisfqualindexfile, thisrqualindexfile);
-                #endif
-            }else    {
-                ignore = read(fSeq, rSeq, fQual, rQual, savedFQual, savedRQual, findexBarcode, rindexBarcode, delim, inFFasta, inRFasta, inFQualIndex, inRQualIndex, thisfqualindexfile, thisrqualindexfile);
-            }
+            Alignment* alignment = createAlignment();
             
-            //remove primers and barcodes if neccessary
-            if (!ignore) {
+            bool good = true;
+            while (good) {
                 
-                int barcodeIndex = 0;
-                int primerIndex = 0;
-                Sequence savedFSeq(fSeq.getName(), fSeq.getAligned());  Sequence savedRSeq(rSeq.getName(), rSeq.getAligned());
-                Sequence savedFindex(findexBarcode.getName(), findexBarcode.getAligned()); Sequence savedRIndex(rindexBarcode.getName(), rindexBarcode.getAligned());
+                if (m->control_pressed) { break; }
                 
-                if(numBarcodes != 0){
-                    vector<int> results;
-                    if (hasQuality) {
-                        if (hasIndex) {
-                            results = trimOligos.stripBarcode(findexBarcode, rindexBarcode, *fQual, *rQual, barcodeIndex);
-                        }else {
-                            results = trimOligos.stripBarcode(fSeq, rSeq, *fQual, *rQual, barcodeIndex);
-                        }
-                    }else {
-                        results = trimOligos.stripBarcode(fSeq, rSeq, barcodeIndex);
-                    }
-                    success = results[0] + results[2];
-                    commentString += "fbdiffs=" + toString(results[0]) + "(" + trimOligos.getCodeValue(results[1], bdiffs) + "), rbdiffs=" + toString(results[2]) + "(" + trimOligos.getCodeValue(results[3], bdiffs) + ") ";
-                    if(success > bdiffs)		{	trashCode += 'b';	}
-                    else{ currentSeqsDiffs += success;  }
-                }
+                contigPair thisPair;
                 
-                if(numFPrimers != 0){
-                    vector<int> results;
-                    if (hasQuality) {
-                        results = trimOligos.stripForward(fSeq, rSeq, *fQual, *rQual, primerIndex);
-                    }else {
-                        results = trimOligos.stripForward(fSeq, rSeq, primerIndex);
-                    }
-                    success = results[0] + results[2];
-                    commentString += "fpdiffs=" + toString(results[0]) + "(" + trimOligos.getCodeValue(results[1], pdiffs) + "), rpdiffs=" + toString(results[2]) + "(" + trimOligos.getCodeValue(results[3], pdiffs) + ") ";
-                    if(success > pdiffs)		{	trashCode += 'f';	}
-                    else{ currentSeqsDiffs += success;  }
+                //read from input files
+                if (gz) {
+                    #ifdef USE_BOOST
+                    thisPair.ignore = read(thisPair.fSeq, thisPair.rSeq, thisPair.fQual, thisPair.rQual, thisPair.savedFQual, thisPair.savedRQual, thisPair.findexBarcode, thisPair.rindexBarcode, delim, inFF, inRF, inFQ, inRQ, thisfqualindexfile, thisrqualindexfile);
+                    #endif
+                }else    {
+                    thisPair.ignore = read(thisPair.fSeq, thisPair.rSeq, thisPair.fQual, thisPair.rQual, thisPair.savedFQual, thisPair.savedRQual, thisPair.findexBarcode, thisPair.rindexBarcode, delim, inFFasta, inRFasta, inFQualIndex, inRQualIndex, thisfqualindexfile, thisrqualindexfile);
                 }
                 
-                if (currentSeqsDiffs > tdiffs)	{	trashCode += 't';   }
+                if (!thisPair.ignore) {
+                    assemblePair(thisPair, trimOligos, rtrimOligos, alignment, qual_match_simple_bayesian, qual_mismatch_simple_bayesian, hasQuality, hasIndex);
+                    writeContig(thisPair, group, hasQuality, outFasta, outScrapFasta, outQual, outScrapQual, outMisMatch, fastaFileNames, qualFileNames);
+                }else { delete thisPair.fQual; delete thisPair.rQual; delete thisPair.savedFQual; delete thisPair.savedRQual; }
+                num++;
                 
-                if (reorient && (trashCode != "")) { //if you failed and want to check the reverse
-                    int thisSuccess = 0;
-                    string thisTrashCode = "";
-                    string thiscommentString = "";
-                    int thisCurrentSeqsDiffs = 0;
-                    
-                    int thisBarcodeIndex = 0;
-                    int thisPrimerIndex = 0;
-                    
-                    if(numBarcodes != 0){
-                        vector<int> results;
-                        if (hasQuality) {
-                            if (hasIndex) {
-                                results = rtrimOligos->stripBarcode(savedFindex, savedRIndex, *savedFQual, *savedRQual, thisBarcodeIndex);
-                            }else {
-                                results = rtrimOligos->stripBarcode(savedFSeq, savedRSeq, *savedFQual, *savedRQual, thisBarcodeIndex);
-                            }
-                        }else {
-                            results = rtrimOligos->stripBarcode(savedFSeq, savedRSeq, thisBarcodeIndex);
-                        }
-                        thisSuccess = results[0] + results[2];
-                        thiscommentString += "fbdiffs=" + toString(results[0]) + "(" + rtrimOligos->getCodeValue(results[1], bdiffs) + "), rbdiffs=" + toString(results[2]) + "(" + rtrimOligos->getCodeValue(results[3], bdiffs) + ") ";
-                        if(thisSuccess > bdiffs)		{	thisTrashCode += 'b';	}
-                        else{ thisCurrentSeqsDiffs += thisSuccess;  }
+                #if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+                    if (!gz) {
+                        unsigned long long pos = inFFasta.tellg();
+                        if ((pos == -1) || (pos >= linesInput.end)) { good = false; break; }
+                    }else {
+                        #ifdef USE_BOOST
+                        if (inFF.eof() || inRF.eof()) { good = false; break; }
+                        #endif
                     }
-                    
-                    if(numFPrimers != 0){
-                        vector<int> results;
-                        if (hasQuality) {
-                            results = rtrimOligos->stripForward(savedFSeq, savedRSeq, *savedFQual, *savedRQual, thisPrimerIndex);
-                        }else {
-                            results = rtrimOligos->stripForward(savedFSeq, savedRSeq, thisPrimerIndex);
-                        }
-                        thisSuccess = results[0] + results[2];
-                        thiscommentString += "fpdiffs=" + toString(results[0]) + "(" + rtrimOligos->getCodeValue(results[1], pdiffs) + "), rpdiffs=" + toString(results[2]) + "(" + rtrimOligos->getCodeValue(results[3], pdiffs) + ") ";
-                        if(thisSuccess > pdiffs)		{	thisTrashCode += 'f';	}
-                        else{ thisCurrentSeqsDiffs += thisSuccess;  }
+                #else
+                    if (!gz) {
+                        if ((inFFasta.eof()) || (inRFasta.eof())) { good = false; break; }
+                    }else {
+                        #ifdef USE_BOOST
+                        if (inFF.eof() || inRF.eof()) { good = false; break; }
+                        #endif
                     }
-                    
-                    if (thisCurrentSeqsDiffs > tdiffs)	{	thisTrashCode += 't';   }
-                    
-                    if (thisTrashCode == "") {
-                        trashCode = thisTrashCode;
-                        success = thisSuccess;
-                        currentSeqsDiffs = thisCurrentSeqsDiffs;
-                        commentString = thiscommentString;
-                        barcodeIndex = thisBarcodeIndex;
-                        primerIndex = thisPrimerIndex;
-                        savedFSeq.reverseComplement();
-                        savedRSeq.reverseComplement();
-                        fSeq.setAligned(savedFSeq.getAligned());
-                        rSeq.setAligned(savedRSeq.getAligned());
-                        if(hasQuality){
-                            savedFQual->flipQScores(); savedRQual->flipQScores();
-                            fQual->setScores(savedFQual->getScores()); rQual->setScores(savedRQual->getScores());
-                        }
-                    }else { trashCode += "(" + thisTrashCode + ")";  }
-                }
-                
-                //assemble reads
-                string contig = "";
-                int oend, oStart;
-                int numMismatches = 0;
-                vector<int> contigScores = assembleFragments(qual_match_simple_bayesian, qual_mismatch_simple_bayesian, fSeq, rSeq, fQual, rQual, savedFQual, savedRQual, hasQuality, alignment, contig, trashCode, oend, oStart, numMismatches);
+                #endif
                 
-                //prints results to outputs files
-                if(trashCode.length() == 0){
-                    bool ignore = false;
-                    
-                    if (m->debug) { m->mothurOut("[DEBUG]: " + fSeq.getName()); }
-                    
-                    if (createOligosGroup) {
-                        string thisGroup = oligos->getGroupName(barcodeIndex, primerIndex);
-                        if (m->debug) { m->mothurOut(", group= " + thisGroup + "\n"); }
-                        
-                        int pos = thisGroup.find("ignore");
-                        if (pos == string::npos) {
-                            groupMap[fSeq.getName()] = thisGroup;
-                            
-                            map<string, int>::iterator it = groupCounts.find(thisGroup);
-                            if (it == groupCounts.end()) {	groupCounts[thisGroup] = 1; }
-                            else { groupCounts[it->first] ++; }
-                        }else { ignore = true; }
-                    }else if (createFileGroup) { //for 3 column file option
-                        int pos = group.find("ignore");
-                        if (pos == string::npos) {
-                            groupMap[fSeq.getName()] = group;
-                            
-                            map<string, int>::iterator it = groupCounts.find(group);
-                            if (it == groupCounts.end()) {	groupCounts[group] = 1; }
-                            else { groupCounts[it->first] ++; }
-                        }else { ignore = true; }
-                    }
-                    if (m->debug) { m->mothurOut("\n"); }
-                    
-                    if(!ignore){
-                        //output
-                        outFasta << ">" << fSeq.getName() << '\t' << commentString << endl << contig << endl;
-                        if (hasQuality) {
-                            outQual << ">" << fSeq.getName() << '\t' << commentString << endl;
-                            for (int i = 0; i < contigScores.size(); i++) { outQual << contigScores[i] << " "; }  outQual << endl;
-                        }
-                        int numNs = 0;
-                        for (int i = 0; i < contig.length(); i++) { if (contig[i] == 'N') { numNs++; }  }
-                        outMisMatch << fSeq.getName() << '\t' << contig.length() << '\t' << (oend-oStart) << '\t' << oStart << '\t' << oend << '\t' << numMismatches << '\t' << numNs << endl;
-                        
-                        if (allFiles) {
-                            ofstream output;
-                            m->openOutputFileAppend(fastaFileNames[barcodeIndex][primerIndex], output);
-                            output << ">" << fSeq.getName() << '\t' << commentString << endl << contig << endl;
-                            output.close();
-                            
-                            if (hasQuality) {
-                                ofstream output2;
-                                m->openOutputFileAppend(qualFileNames[barcodeIndex][primerIndex], output2);
-                                output2 << ">" << fSeq.getName() << '\t' << commentString << endl;
-                                for (int i = 0; i < contigScores.size(); i++) { output2 << contigScores[i] << " "; }  output2 << endl;
-                                output2.close();
-                            }
-                        }
-                    }
-                }else {
-                    //output
-                    outScrapFasta << ">" << fSeq.getName() << " | " << trashCode << '\t' << commentString << endl << contig << endl;
-                    if (hasQuality) {
-                        outScrapQual << ">" << fSeq.getName() << " | " << trashCode << '\t' << commentString << endl;
-                        for (int i = 0; i < contigScores.size(); i++) { outScrapQual << contigScores[i] << " "; }  outScrapQual << endl;
-                    }
-                    
-                }
+                //report progress
+                if((num) % 1000 == 0){	m->mothurOutJustToScreen(toString(num)+"\n"); }
             }
-            num++;
             
-            #if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-                if (!gz) {
-                    unsigned long long pos = inFFasta.tellg();
-                    if ((pos == -1) || (pos >= linesInput.end)) { good = false; break; }
-                }else {
-                    #ifdef USE_BOOST
-                    if (inFF.eof() || inRF.eof()) { good = false; break; }
-                    #endif
-                }
-            #else
-                if (!gz) {
-                    if ((inFFasta.eof()) || (inRFasta.eof())) { good = false; break; }
-                }else {
-                    #ifdef USE_BOOST
-                    if (inFF.eof() || inRF.eof()) { good = false; break; }
-                    #endif
-                }
-            #endif
+            //report progress
+            if((num) % 1000 != 0){	m->mothurOutJustToScreen(toString(num)+"\n"); }
             
-			//report progress
-            if((num) % 1000 == 0){	m->mothurOutJustToScreen(toString(num)+"\n"); }
-		}
-        
-		//report progress
-		if((num) % 1000 != 0){	m->mothurOutJustToScreen(toString(num)+"\n"); }
+            delete alignment;
+            if (reorient) { delete rtrimOligos; }
+        }
         
         //close files
         inFFasta.close();
@@ -2171,10 +2020,6 @@ unsigned long long MakeContigsCommand::driver(vector<string> inputFiles, vector<
             }
         }
         
-        //cleanup memory
-        delete alignment;
-        if (reorient) { delete rtrimOligos; }
-        
         if (m->control_pressed) {
             m->mothurRemove(outputFasta); m->mothurRemove(outputScrapFasta); m->mothurRemove(outputMisMatches);
             if (hasQuality) { m->mothurRemove(outputQual); m->mothurRemove(outputScrapQual); }
@@ -2187,6 +2032,330 @@ unsigned long long MakeContigsCommand::driver(vector<string> inputFiles, vector<
 		exit(1);
 	}
 }
+//**********************************************************************************************************************
+Alignment* MakeContigsCommand::createAlignment(){
+    try {
+        Alignment* alignment = NULL;
+        if(align == "gotoh")			{	alignment = new GotohOverlap(gapOpen, gapExtend, match, misMatch, longestBase);			}
+        else if(align == "needleman")	{	alignment = new NeedlemanOverlap(gapOpen, match, misMatch, longestBase);				}
+        else if(align == "simd")        {	alignment = new NeedlemanSIMD(gapOpen, match, misMatch, longestBase);					}
+        else if(align == "banded")      {	alignment = new NeedlemanBanded(gapOpen, match, misMatch, longestBase);					}
+        else if(align == "kmer")        {   alignment = new KmerAlign(kmerSize);                                                    }
+        return alignment;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "MakeContigsCommand", "createAlignment");
+        exit(1);
+    }
+}
+//**********************************************************************************************************************
+//removes the barcodes and primers, trying the reoriented oligos if that fails, and assembles the contig. Only reads
+//thisPair and the read only settings, so threads can share it
+void MakeContigsCommand::assemblePair(contigPair& thisPair, TrimOligos& trimOligos, TrimOligos* rtrimOligos, Alignment* alignment, vector< vector<double> >& qual_match_simple_bayesian, vector< vector<double> >& qual_mismatch_simple_bayesian, bool hasQuality, bool hasIndex){
+    try {
+        int success = 1;
+        int currentSeqsDiffs = 0;
+        Sequence& fSeq = thisPair.fSeq; Sequence& rSeq = thisPair.rSeq;
+        Sequence& findexBarcode = thisPair.findexBarcode; Sequence& rindexBarcode = thisPair.rindexBarcode;
+        QualityScores*& fQual = thisPair.fQual; QualityScores*& rQual = thisPair.rQual;
+        QualityScores*& savedFQual = thisPair.savedFQual; QualityScores*& savedRQual = thisPair.savedRQual;
+        string& trashCode = thisPair.trashCode; string& commentString = thisPair.commentString;
+        int& barcodeIndex = thisPair.barcodeIndex; int& primerIndex = thisPair.primerIndex;
+        
+        Sequence savedFSeq(fSeq.getName(), fSeq.getAligned());  Sequence savedRSeq(rSeq.getName(), rSeq.getAligned());
+        Sequence savedFindex(findexBarcode.getName(), findexBarcode.getAligned()); Sequence savedRIndex(rindexBarcode.getName(), rindexBarcode.getAligned());
+        
+        if(numBarcodes != 0){
+            vector<int> results;
+            if (hasQuality) {
+                if (hasIndex) {
+                    results = trimOligos.stripBarcode(findexBarcode, rindexBarcode, *fQual, *rQual, barcodeIndex);
+                }else {
+                    results = trimOligos.stripBarcode(fSeq, rSeq, *fQual, *rQual, barcodeIndex);
+                }
+            }else {
+                results = trimOligos.stripBarcode(fSeq, rSeq, barcodeIndex);
+            }
+            success = results[0] + results[2];
+            commentString += "fbdiffs=" + toString(results[0]) + "(" + trimOligos.getCodeValue(results[1], bdiffs) + "), rbdiffs=" + toString(results[2]) + "(" + trimOligos.getCodeValue(results[3], bdiffs) + ") ";
+            if(success > bdiffs)		{	trashCode += 'b';	}
+            else{ currentSeqsDiffs += success;  }
+        }
+        
+        if(numFPrimers != 0){
+            vector<int> results;
+            if (hasQuality) {
+                results = trimOligos.stripForward(fSeq, rSeq, *fQual, *rQual, primerIndex);
+            }else {
+                results = trimOligos.stripForward(fSeq, rSeq, primerIndex);
+            }
+            success = results[0] + results[2];
+            commentString += "fpdiffs=" + toString(results[0]) + "(" + trimOligos.getCodeValue(results[1], pdiffs) + "), rpdiffs=" + toString(results[2]) + "(" + trimOligos.getCodeValue(results[3], pdiffs) + ") ";
+            if(success > pdiffs)		{	trashCode += 'f';	}
+            else{ currentSeqsDiffs += success;  }
+        }
+        
+        if (currentSeqsDiffs > tdiffs)	{	trashCode += 't';   }
+        
+        if (reorient && (trashCode != "")) { //if you failed and want to check the reverse
+            int thisSuccess = 0;
+            string thisTrashCode = "";
+            string thiscommentString = "";
+            int thisCurrentSeqsDiffs = 0;
+            
+            int thisBarcodeIndex = 0;
+            int thisPrimerIndex = 0;
+            
+            if(numBarcodes != 0){
+                vector<int> results;
+                if (hasQuality) {
+                    if (hasIndex) {
+                        results = rtrimOligos->stripBarcode(savedFindex, savedRIndex, *savedFQual, *savedRQual, thisBarcodeIndex);
+                    }else {
+                        results = rtrimOligos->stripBarcode(savedFSeq, savedRSeq, *savedFQual, *savedRQual, thisBarcodeIndex);
+                    }
+                }else {
+                    results = rtrimOligos->stripBarcode(savedFSeq, savedRSeq, thisBarcodeIndex);
+                }
+                thisSuccess = results[0] + results[2];
+                thiscommentString += "fbdiffs=" + toString(results[0]) + "(" + rtrimOligos->getCodeValue(results[1], bdiffs) + "), rbdiffs=" + toString(results[2]) + "(" + rtrimOligos->getCodeValue(results[3], bdiffs) + ") ";
+                if(thisSuccess > bdiffs)		{	thisTrashCode += 'b';	}
+                else{ thisCurrentSeqsDiffs += thisSuccess;  }
+            }
+            
+            if(numFPrimers != 0){
+                vector<int> results;
+                if (hasQuality) {
+                    results = rtrimOligos->stripForward(savedFSeq, savedRSeq, *savedFQual, *savedRQual, thisPrimerIndex);
+                }else {
+                    results = rtrimOligos->stripForward(savedFSeq, savedRSeq, thisPrimerIndex);
+                }
+                thisSuccess = results[0] + results[2];
+                thiscommentString += "fpdiffs=" + toString(results[0]) + "(" + rtrimOligos->getCodeValue(results[1], pdiffs) + "), rpdiffs=" + toString(results[2]) + "(" + rtrimOligos->getCodeValue(results[3], pdiffs) + ") ";
+                if(thisSuccess > pdiffs)		{	thisTrashCode += 'f';	}
+                else{ thisCurrentSeqsDiffs += thisSuccess;  }
+            }
+            
+            if (thisCurrentSeqsDiffs > tdiffs)	{	thisTrashCode += 't';   }
+            
+            if (thisTrashCode == "") {
+                trashCode = thisTrashCode;
+                success = thisSuccess;
+                currentSeqsDiffs = thisCurrentSeqsDiffs;
+                commentString = thiscommentString;
+                barcodeIndex = thisBarcodeIndex;
+                primerIndex = thisPrimerIndex;
+                savedFSeq.reverseComplement();
+                savedRSeq.reverseComplement();
+                fSeq.setAligned(savedFSeq.getAligned());
+                rSeq.setAligned(savedRSeq.getAligned());
+                if(hasQuality){
+                    savedFQual->flipQScores(); savedRQual->flipQScores();
+                    fQual->setScores(savedFQual->getScores()); rQual->setScores(savedRQual->getScores());
+                }
+            }else { trashCode += "(" + thisTrashCode + ")";  }
+        }
+        
+        //assemble reads
+        thisPair.contigScores = assembleFragments(qual_match_simple_bayesian, qual_mismatch_simple_bayesian, fSeq, rSeq, fQual, rQual, savedFQual, savedRQual, hasQuality, alignment, thisPair.contig, trashCode, thisPair.oend, thisPair.oStart, thisPair.numMismatches);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "MakeContigsCommand", "assemblePair");
+        exit(1);
+    }
+}
+//**********************************************************************************************************************
+//writes an assembled pair and records its group, must be called in file order
+void MakeContigsCommand::writeContig(contigPair& thisPair, string group, bool hasQuality, ofstream& outFasta, ofstream& outScrapFasta, ofstream& outQual, ofstream& outScrapQual, ofstream& outMisMatch, vector<vector<string> >& fastaFileNames, vector<vector<string> >& qualFileNames){
+    try {
+        Sequence& fSeq = thisPair.fSeq;
+        string& trashCode = thisPair.trashCode; string& commentString = thisPair.commentString; string& contig = thisPair.contig;
+        vector<int>& contigScores = thisPair.contigScores;
+        int barcodeIndex = thisPair.barcodeIndex; int primerIndex = thisPair.primerIndex;
+        int oStart = thisPair.oStart; int oend = thisPair.oend; int numMismatches = thisPair.numMismatches;
+        
+        //prints results to outputs files
+        if(trashCode.length() == 0){
+            bool ignore = false;
+            
+            if (m->debug) { m->mothurOut("[DEBUG]: " + fSeq.getName()); }
+            
+            if (createOligosGroup) {
+                string thisGroup = oligos->getGroupName(barcodeIndex, primerIndex);
+                if (m->debug) { m->mothurOut(", group= " + thisGroup + "\n"); }
+                
+                int pos = thisGroup.find("ignore");
+                if (pos == string::npos) {
+                    groupMap[fSeq.getName()] = thisGroup;
+                    
+                    map<string, int>::iterator it = groupCounts.find(thisGroup);
+                    if (it == groupCounts.end()) {	groupCounts[thisGroup] = 1; }
+                    else { groupCounts[it->first] ++; }
+                }else { ignore = true; }
+            }else if (createFileGroup) { //for 3 column file option
+                int pos = group.find("ignore");
+                if (pos == string::npos) {
+                    groupMap[fSeq.getName()] = group;
+                    
+                    map<string, int>::iterator it = groupCounts.find(group);
+                    if (it == groupCounts.end()) {	groupCounts[group] = 1; }
+                    else { groupCounts[it->first] ++; }
+                }else { ignore = true; }
+            }
+            if (m->debug) { m->mothurOut("\n"); }
+            
+            if(!ignore){
+                //output
+                outFasta << ">" << fSeq.getName() << '\t' << commentString << endl << contig << endl;
+                if (hasQuality) {
+                    outQual << ">" << fSeq.getName() << '\t' << commentString << endl;
+                    for (int i = 0; i < contigScores.size(); i++) { outQual << contigScores[i] << " "; }  outQual << endl;
+                }
+                int numNs = 0;
+                for (int i = 0; i < contig.length(); i++) { if (contig[i] == 'N') { numNs++; }  }
+                outMisMatch << fSeq.getName() << '\t' << contig.length() << '\t' << (oend-oStart) << '\t' << oStart << '\t' << oend << '\t' << numMismatches << '\t' << numNs << endl;
+                
+                if (allFiles) {
+                    ofstream output;
+                    m->openOutputFileAppend(fastaFileNames[barcodeIndex][primerIndex], output);
+                    output << ">" << fSeq.getName() << '\t' << commentString << endl << contig << endl;
+                    output.close();
+                    
+                    if (hasQuality) {
+                        ofstream output2;
+                        m->openOutputFileAppend(qualFileNames[barcodeIndex][primerIndex], output2);
+                        output2 << ">" << fSeq.getName() << '\t' << commentString << endl;
+                        for (int i = 0; i < contigScores.size(); i++) { output2 << contigScores[i] << " "; }  output2 << endl;
+                        output2.close();
+                    }
+                }
+            }
+        }else {
+            //output
+            outScrapFasta << ">" << fSeq.getName() << " | " << trashCode << '\t' << commentString << endl << contig << endl;
+            if (hasQuality) {
+                outScrapQual << ">" << fSeq.getName() << " | " << trashCode << '\t' << commentString << endl;
+                for (int i = 0; i < contigScores.size(); i++) { outScrapQual << contigScores[i] << " "; }  outScrapQual << endl;
+            }
+            
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "MakeContigsCommand", "writeContig");
+        exit(1);
+    }
+}
+//**********************************************************************************************************************
+#ifdef USE_BOOST
+//compressed files can't be divided with seekg, so instead of splitting the file a reader thread decompresses the pairs
+//into batches, contigThreads threads trim and assemble them, and each finished batch is written as soon as the batches
+//before it are. The outputs are the same as the one thread loop in driver.
+unsigned long long MakeContigsCommand::driverPipelined(boost::iostreams::filtering_istream& inFF, boost::iostreams::filtering_istream& inRF, boost::iostreams::filtering_istream& inFQ, boost::iostreams::filtering_istream& inRQ, string thisfqualindexfile, string thisrqualindexfile, vector< vector<double> >& qual_match_simple_bayesian, vector< vector<double> >& qual_mismatch_simple_bayesian, bool hasQuality, bool hasIndex, string group, ofstream& outFasta, ofstream& outScrapFasta, ofstream& outQual, ofstream& outScrapQual, ofstream& outMisMatch, vector<vector<string> >& fastaFileNames, vector<vector<string> >& qualFileNames){
+    try {
+        int batchSize = 500;
+        int maxQueued = contigThreads * 2; //bounds memory, the reader waits when the assemblers fall behind
+        
+        mutex queueLock;
+        condition_variable batchReady, queueSpace;
+        deque<pair<long long, vector<contigPair>*> > batches;
+        bool doneReading = false;
+        
+        mutex writeLock;
+        map<long long, vector<contigPair>*> finished;
+        long long nextBatch = 0;
+        unsigned long long num = 0;
+        
+        thread reader([&]() {
+            long long numBatches = 0;
+            unsigned long long numRead = 0;
+            bool good = true;
+            
+            while (good && !m->control_pressed) {
+                vector<contigPair>* batch = new vector<contigPair>();
+                batch->reserve(batchSize);
+                
+                while (good && (batch->size() < batchSize)) {
+                    batch->push_back(contigPair());
+                    contigPair& thisPair = batch->back();
+                    thisPair.ignore = read(thisPair.fSeq, thisPair.rSeq, thisPair.fQual, thisPair.rQual, thisPair.savedFQual, thisPair.savedRQual, thisPair.findexBarcode, thisPair.rindexBarcode, delim, inFF, inRF, inFQ, inRQ, thisfqualindexfile, thisrqualindexfile);
+                    
+                    if (inFF.eof() || inRF.eof()) { good = false; }
+                    
+                    //report progress
+                    numRead++;
+                    if((numRead) % 1000 == 0){	m->mothurOutJustToScreen(toString(numRead)+"\n"); }
+                }
+                
+                unique_lock<mutex> guard(queueLock);
+                while (batches.size() >= maxQueued) { queueSpace.wait(guard); }
+                batches.push_back(make_pair(numBatches, batch)); numBatches++;
+                batchReady.notify_one();
+            }
+            
+            //report progress
+            if((numRead) % 1000 != 0){	m->mothurOutJustToScreen(toString(numRead)+"\n"); }
+            
+            lock_guard<mutex> guard(queueLock);
+            doneReading = true;
+            batchReady.notify_all();
+        });
+        
+        ThreadPool::getInstance()->runOnEach(contigThreads, [&](int threadID) {
+            TrimOligos trimOligos(pdiffs, bdiffs, 0, 0, oligos->getPairedPrimers(), oligos->getPairedBarcodes(), hasIndex);
+            
+            TrimOligos* rtrimOligos = NULL;
+            if (reorient) {  rtrimOligos = new TrimOligos(pdiffs, bdiffs, 0, 0, oligos->getReorientedPairedPrimers(), oligos->getReorientedPairedBarcodes(), hasIndex);  }
+            
+            Alignment* alignment = createAlignment();
+            
+            while (true) {
+                pair<long long, vector<contigPair>*> work;
+                {
+                    unique_lock<mutex> guard(queueLock);
+                    while (batches.empty() && !doneReading) { batchReady.wait(guard); }
+                    if (batches.empty()) { break; }
+                    work = batches.front(); batches.pop_front();
+                    queueSpace.notify_one();
+                }
+                
+                vector<contigPair>& batch = *work.second;
+                for (int i = 0; i < batch.size(); i++) {
+                    if (m->control_pressed) { batch[i].ignore = true; continue; } //unassembled pairs still own their quality scores, the write loop frees them as ignored
+                    if (!batch[i].ignore) { assemblePair(batch[i], trimOligos, rtrimOligos, alignment, qual_match_simple_bayesian, qual_mismatch_simple_bayesian, hasQuality, hasIndex); }
+                }
+                
+                //write this batch and any finished batches waiting on it
+                lock_guard<mutex> guard(writeLock);
+                finished[work.first] = work.second;
+                
+                map<long long, vector<contigPair>*>::iterator it = finished.begin();
+                while ((it != finished.end()) && (it->first == nextBatch)) {
+                    vector<contigPair>& ready = *(it->second);
+                    for (int i = 0; i < ready.size(); i++) {
+                        if (ready[i].ignore) { delete ready[i].fQual; delete ready[i].rQual; delete ready[i].savedFQual; delete ready[i].savedRQual; }
+                        else if (!m->control_pressed) { writeContig(ready[i], group, hasQuality, outFasta, outScrapFasta, outQual, outScrapQual, outMisMatch, fastaFileNames, qualFileNames); }
+                    }
+                    num += ready.size();
+                    delete it->second;
+                    finished.erase(it++);
+                    nextBatch++;
+                }
+            }
+            
+            delete alignment;
+            if (reorient) { delete rtrimOligos; }
+        });
+        
+        reader.join();
+        
+        return num;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "MakeContigsCommand", "driverPipelined");
+        exit(1);
+    }
+}
+#endif
 /**************************************************************************************************/
 //vector<int> contigScores = assembleFragments(qual_match_simple_bayesian, qual_mismatch_simple_bayesian, fSeq, rSeq, alignment, contig);
 vector<int> MakeContigsCommand::assembleFragments(vector< vector<double> >&qual_match_simple_bayesian, vector< vector<double> >& qual_mismatch_simple_bayesian, Sequence& fSeq, Sequence& rSeq, QualityScores*& fQual, QualityScores*& rQual, QualityScores*& savedFQual, QualityScores*& savedRQual, bool hasQuality, Alignment*& alignment, string& contig, string& trashCode, int& oend, int& oStart, int& numMismatches) {
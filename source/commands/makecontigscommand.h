@@ -15,12 +15,16 @@
 #include "alignment.hpp"
 #include "gotohoverlap.hpp"
 #include "needlemanoverlap.hpp"
+#include "needlemansimd.hpp"
+#include "needlemanbanded.hpp"
 #include "blastalign.hpp"
 #include "noalign.hpp"
 #include "trimoligos.h"
 #include "oligos.h"
 #include "fastqread.h"
 #include "kmeralign.h"
+#include "threadpool.h"
+#include <deque>
 
 #        define PROBABILITY(score) (pow(10.0, (-(double)(score)) / 10.0))
 #        define PHREDMAX 46
@@ -38,6 +42,19 @@ struct pairFastqRead {
 	~pairFastqRead() {};
 };
 /**************************************************************************************************/
+//one read pair as read from the input files, and the contig assembled from it
+struct contigPair {
+    Sequence fSeq, rSeq, findexBarcode, rindexBarcode;
+    QualityScores* fQual; QualityScores* rQual; QualityScores* savedFQual; QualityScores* savedRQual;
+    bool ignore;
+    string trashCode, commentString, contig;
+    vector<int> contigScores;
+    int barcodeIndex, primerIndex, oStart, oend, numMismatches;
+    
+    contigPair() : findexBarcode("findex", "NONE"), rindexBarcode("rindex", "NONE"), fQual(NULL), rQual(NULL), savedFQual(NULL), savedRQual(NULL), ignore(false), trashCode(""), commentString(""), contig(""), barcodeIndex(0), primerIndex(0), oStart(0), oend(0), numMismatches(0) {};
+	~contigPair() {};
+};
+/**************************************************************************************************/
 
 class MakeContigsCommand : public Command {
 public:
@@ -70,6 +87,7 @@ private:
     string outFastaFile, outQualFile, outScrapFastaFile, outScrapQualFile, outMisMatchFile, outputGroupFileName, group;
 	float match, misMatch, gapOpen, gapExtend;
 	int processors, longestBase, insert, tdiffs, bdiffs, pdiffs, ldiffs, sdiffs, deltaq, kmerSize, numBarcodes, numFPrimers, numLinkers, numSpacers, numRPrimers, nameType, offByOneTrimLength;
+    int contigThreads; //threads driver uses to assemble one pair of compressed files
     vector<string> outputNames;
     Oligos* oligos;
     
@@ -92,6 +110,9 @@ private:
     bool read(Sequence&, Sequence&, QualityScores*&, QualityScores*&, QualityScores*& savedFQual, QualityScores*& savedRQual, Sequence&, Sequence&, char, boost::iostreams::filtering_istream&, boost::iostreams::filtering_istream&, boost::iostreams::filtering_istream&, boost::iostreams::filtering_istream&, string, string);
     #endif
     bool read(Sequence&, Sequence&, QualityScores*&, QualityScores*&, QualityScores*& savedFQual, QualityScores*& savedRQual, Sequence&, Sequence&, char, ifstream&, ifstream&, ifstream&, ifstream&, string, string);
+    Alignment* createAlignment();
+    void assemblePair(contigPair&, TrimOligos&, TrimOligos*, Alignment*, vector< vector<double> >&, vector< vector<double> >&, bool, bool);
+    void writeContig(contigPair&, string, bool, ofstream&, ofstream&, ofstream&, ofstream&, ofstream&, vector<vector<string> >&, vector<vector<string> >&);
     vector<int> assembleFragments(vector< vector<double> >&qual_match_simple_bayesian, vector< vector<double> >& qual_mismatch_simple_bayesian, Sequence& fSeq, Sequence& rSeq, QualityScores*&, QualityScores*&, QualityScores*& savedFQual, QualityScores*& savedRQual, bool, Alignment*& alignment, string& contig, string&, int&, int&, int&);
     
     //main processing functions
@@ -99,6 +120,9 @@ private:
     unsigned long long createProcessesGroups(vector< vector<string> >, string compositeGroupFile, string compositeFastaFile, string compositeScrapFastaFile, string compositeQualFile, string compositeScrapQualFile, string compositeMisMatchFile, map<string, int>& totalGroupCounts, map<string, string>&);
     unsigned long long driverGroups(vector<vector<string> >, int, int, string, string, string, string, string, string, map<string, int>&, map<string, string>&);
     unsigned long long driver(vector<string> files, vector<string> qualOrIndexFiles, string outputFasta, string outputScrapFasta, string outputQual, string outputScrapQual,  string outputMisMatches, vector<vector<string> > fastaFileNames, vector<vector<string> > qualFileNames, linePair, linePair, linePair, linePair, string);
+    #ifdef USE_BOOST
+    unsigned long long driverPipelined(boost::iostreams::filtering_istream&, boost::iostreams::filtering_istream&, boost::iostreams::filtering_istream&, boost::iostreams::filtering_istream&, string, string, vector< vector<double> >&, vector< vector<double> >&, bool, bool, string, ofstream&, ofstream&, ofstream&, ofstream&, ofstream&, vector<vector<string> >&, vector<vector<string> >&);
+    #endif
     int convertProb(double qProb);
     vector< vector<string> > readFileNames(string);
     bool getOligos(vector<vector<string> >&, vector<vector<string> >&, string, map<string, string>&);
@@ -590,6 +614,8 @@ static DWORD WINAPI MyGroupContigsThreadFunction(LPVOID lpParam){
             Alignment* alignment;
             if(pDataArray->align == "gotoh")			{	alignment = new GotohOverlap(pDataArray->gapOpen, pDataArray->gapExtend, pDataArray->match, pDataArray->misMatch, longestBase);			}
             else if(pDataArray->align == "needleman")	{	alignment = new NeedlemanOverlap(pDataArray->gapOpen, pDataArray->match, pDataArray->misMatch, longestBase);				}
+            else if(pDataArray->align == "simd")        {	alignment = new NeedlemanSIMD(pDataArray->gapOpen, pDataArray->match, pDataArray->misMatch, longestBase);					}
+            else if(pDataArray->align == "banded")      {	alignment = new NeedlemanBanded(pDataArray->gapOpen, pDataArray->match, pDataArray->misMatch, longestBase);					}
             else if(pDataArray->align == "kmer")                    {	alignment = new KmerAlign(pDataArray->kmerSize);                                                    }
             
             string thisfqualindexfile, thisrqualindexfile, thisffastafile, thisrfastafile;
@@ -2417,6 +2443,8 @@ static DWORD WINAPI MyContigsThreadFunction(LPVOID lpParam){
         Alignment* alignment;
         if(pDataArray->align == "gotoh")			{	alignment = new GotohOverlap(pDataArray->gapOpen, pDataArray->gapExtend, pDataArray->match, pDataArray->misMatch, longestBase);			}
         else if(pDataArray->align == "needleman")	{	alignment = new NeedlemanOverlap(pDataArray->gapOpen, pDataArray->match, pDataArray->misMatch, longestBase);				}
+        else if(pDataArray->align == "simd")        {	alignment = new NeedlemanSIMD(pDataArray->gapOpen, pDataArray->match, pDataArray->misMatch, longestBase);					}
+        else if(pDataArray->align == "banded")      {	alignment = new NeedlemanBanded(pDataArray->gapOpen, pDataArray->match, pDataArray->misMatch, longestBase);					}
         else if(pDataArray->align == "kmer")                    {	alignment = new KmerAlign(pDataArray->kmerSize);                                                    }
         
         pDataArray->count = 0;
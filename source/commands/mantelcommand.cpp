@@ -9,6 +9,7 @@
 
 #include "mantelcommand.h"
 #include "readphylipvector.h"
+#include "permutationtest.h"
 
 
 //**********************************************************************************************************************
@@ -18,6 +19,7 @@ vector<string> MantelCommand::setParameters(){
 		CommandParameter pphylip2("phylip2", "InputTypes", "", "", "none", "none", "none","mantel",false,true,true); parameters.push_back(pphylip2);
 		CommandParameter piters("iters", "Number", "", "1000", "", "", "","",false,false); parameters.push_back(piters);
 		CommandParameter pmethod("method", "Multiple", "pearson-spearman-kendall", "pearson", "", "", "","",false,false); parameters.push_back(pmethod);
+		CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
 		CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
@@ -37,9 +39,10 @@ string MantelCommand::getHelpString(){
 		string helpString = "";
 		helpString += "Sokal, R. R., & Rohlf, F. J. (1995). Biometry, 3rd edn. New York: Freeman.\n";
 		helpString += "The mantel command reads two distance matrices and calculates the mantel correlation coefficient.\n";
-		helpString += "The mantel command parameters are phylip1, phylip2, iters and method.  The phylip1 and phylip2 parameters are required.  Matrices must be the same size and contain the same names.\n";
+		helpString += "The mantel command parameters are phylip1, phylip2, iters, method and processors.  The phylip1 and phylip2 parameters are required.  Matrices must be the same size and contain the same names.\n";
 		helpString += "The method parameter allows you to select what method you would like to use. Options are pearson, spearman and kendall. Default=pearson.\n";
 		helpString += "The iters parameter allows you to set number of randomization for the P value.  The default is 1000. \n";
+		helpString += "The processors parameter allows you to specify the number of processors to use for the randomizations. The default is 1.\n";
 		helpString += "The mantel command should be in the following format: mantel(phylip1=veg.dist, phylip2=env.dist).\n";
 		helpString += "The mantel command outputs a .mantel file.\n";
 		helpString += "Note: No spaces between parameter labels (i.e. phylip1), '=' and parameters (i.e. veg.dist).\n";
@@ -143,6 +146,10 @@ MantelCommand::MantelCommand(string option)  {
 			string temp = validParameter.validFile(parameters, "iters", false);			if (temp == "not found") { temp = "1000"; }
 			m->mothurConvert(temp, iters);
 			
+			temp = validParameter.validFile(parameters, "processors", false);	if (temp == "not found"){	temp = m->getProcessors();	}
+			m->setProcessors(temp);
+			m->mothurConvert(temp, processors);
+			
 			if ((method != "pearson") && (method != "spearman") && (method != "kendall")) { m->mothurOut(method + " is not a valid method. Valid methods are pearson, spearman, and kendall."); m->mothurOutEndLine(); abort = true; }
 		}
 	}
@@ -199,15 +206,11 @@ int MantelCommand::execute(){
 		else if (method == "kendall")	{  mantel = linear.calcKendall(matrix1, matrix2);	}
 		
 		
-		//calc signifigance
-		int count = 0;
-		for (int i = 0; i < iters; i++) {
-			
-			if (m->control_pressed) { return 0; }
-			
-			//randomize matrix2
+		//calc signifigance, each permutation randomizes the rows of its own copy of matrix2
+		PermutationTest test(iters, processors);
+		test.run([&](mt19937_64& rng) {
 			vector< vector<double> > matrix2Copy = matrix2;
-			m->mothurRandomShuffle(matrix2Copy);
+			shuffle(matrix2Copy.begin(), matrix2Copy.end(), rng);
 		
 			//calc random mantel
 			double randomMantel = 0.0;
@@ -215,10 +218,10 @@ int MantelCommand::execute(){
 			else if (method == "spearman")	{  randomMantel = linear.calcSpearman(matrix1, matrix2Copy);	}
 			else if (method == "kendall")	{  randomMantel = linear.calcKendall(matrix1, matrix2Copy);	}
 			
-			if (randomMantel >= mantel) { count++; }
-		}
+			return (randomMantel >= mantel);
+		});
 		
-		double pValue = count / (float) iters;
+		double pValue = test.getPValue();
 		
 		if (m->control_pressed) { return 0; }
 		
@@ -9,6 +9,8 @@
 
 #include "matrixoutputcommand.h"
 #include "subsample.h"
+#include "sharedutilities.h"
+#include "threadpool.h"
 
 //**********************************************************************************************************************
 vector<string> MatrixOutputCommand::setParameters(){	
@@ -197,100 +199,7 @@ MatrixOutputCommand::MatrixOutputCommand(string option)  {
             
             if (subsample == false) { iters = 0; }
             
-			if (abort == false) {
-			
-				ValidCalculators validCalculator;
-				
-				int i;
-				for (i=0; i<Estimators.size(); i++) {
-					if (validCalculator.isValidCalculator("matrix", Estimators[i]) == true) { 
-						if (Estimators[i] == "sharedsobs") { 
-							matrixCalculators.push_back(new SharedSobsCS());
-						}else if (Estimators[i] == "sharedchao") { 
-							matrixCalculators.push_back(new SharedChao1());
-						}else if (Estimators[i] == "sharedace") { 
-							matrixCalculators.push_back(new SharedAce());
-						}else if (Estimators[i] == "jabund") { 	
-							matrixCalculators.push_back(new JAbund());
-						}else if (Estimators[i] == "sorabund") { 
-							matrixCalculators.push_back(new SorAbund());
-						}else if (Estimators[i] == "jclass") { 
-							matrixCalculators.push_back(new Jclass());
-						}else if (Estimators[i] == "sorclass") { 
-							matrixCalculators.push_back(new SorClass());
-						}else if (Estimators[i] == "jest") { 
-							matrixCalculators.push_back(new Jest());
-						}else if (Estimators[i] == "sorest") { 
-							matrixCalculators.push_back(new SorEst());
-						}else if (Estimators[i] == "thetayc") { 
-							matrixCalculators.push_back(new ThetaYC());
-						}else if (Estimators[i] == "thetan") { 
-							matrixCalculators.push_back(new ThetaN());
-						}else if (Estimators[i] == "kstest") { 
-							matrixCalculators.push_back(new KSTest());
-						}else if (Estimators[i] == "sharednseqs") { 
-							matrixCalculators.push_back(new SharedNSeqs());
-						}else if (Estimators[i] == "ochiai") { 
-							matrixCalculators.push_back(new Ochiai());
-						}else if (Estimators[i] == "anderberg") { 
-							matrixCalculators.push_back(new Anderberg());
-						}else if (Estimators[i] == "kulczynski") { 
-							matrixCalculators.push_back(new Kulczynski());
-						}else if (Estimators[i] == "kulczynskicody") { 
-							matrixCalculators.push_back(new KulczynskiCody());
-						}else if (Estimators[i] == "lennon") { 
-							matrixCalculators.push_back(new Lennon());
-						}else if (Estimators[i] == "morisitahorn") { 
-							matrixCalculators.push_back(new MorHorn());
-						}else if (Estimators[i] == "braycurtis") { 
-							matrixCalculators.push_back(new BrayCurtis());
-						}else if (Estimators[i] == "whittaker") { 
-							matrixCalculators.push_back(new Whittaker());
-						}else if (Estimators[i] == "odum") { 
-							matrixCalculators.push_back(new Odum());
-						}else if (Estimators[i] == "canberra") { 
-							matrixCalculators.push_back(new Canberra());
-						}else if (Estimators[i] == "structeuclidean") { 
-							matrixCalculators.push_back(new StructEuclidean());
-						}else if (Estimators[i] == "structchord") { 
-							matrixCalculators.push_back(new StructChord());
-						}else if (Estimators[i] == "hellinger") { 
-							matrixCalculators.push_back(new Hellinger());
-						}else if (Estimators[i] == "manhattan") { 
-							matrixCalculators.push_back(new Manhattan());
-						}else if (Estimators[i] == "structpearson") { 
-							matrixCalculators.push_back(new StructPearson());
-						}else if (Estimators[i] == "soergel") { 
-							matrixCalculators.push_back(new Soergel());
-						}else if (Estimators[i] == "spearman") { 
-							matrixCalculators.push_back(new Spearman());
-						}else if (Estimators[i] == "structkulczynski") { 
-							matrixCalculators.push_back(new StructKulczynski());
-						}else if (Estimators[i] == "speciesprofile") { 
-							matrixCalculators.push_back(new SpeciesProfile());
-						}else if (Estimators[i] == "hamming") { 
-							matrixCalculators.push_back(new Hamming());
-						}else if (Estimators[i] == "structchi2") { 
-							matrixCalculators.push_back(new StructChi2());
-						}else if (Estimators[i] == "gower") { 
-							matrixCalculators.push_back(new Gower());
-						}else if (Estimators[i] == "memchi2") { 
-							matrixCalculators.push_back(new MemChi2());
-						}else if (Estimators[i] == "memchord") { 
-							matrixCalculators.push_back(new MemChord());
-						}else if (Estimators[i] == "memeuclidean") { 
-							matrixCalculators.push_back(new MemEuclidean());
-						}else if (Estimators[i] == "mempearson") { 
-							matrixCalculators.push_back(new MemPearson());
-                        }else if (Estimators[i] == "jsd") {
-                                matrixCalculators.push_back(new JSD());
-                        }else if (Estimators[i] == "rjsd") {
-                            matrixCalculators.push_back(new RJSD());
-						}
-					}
-				}
-				
-			}
+			if (abort == false) { matrixCalculators = createCalculators(); }
 		}
 		
 	}
@@ -300,6 +209,107 @@ MatrixOutputCommand::MatrixOutputCommand(string option)  {
 	}
 }
 
+//**********************************************************************************************************************
+vector<Calculator*> MatrixOutputCommand::createCalculators(){
+	try {
+		vector<Calculator*> calculators;
+		ValidCalculators validCalculator;
+		
+		for (int i=0; i<Estimators.size(); i++) {
+			if (validCalculator.isValidCalculator("matrix", Estimators[i]) == true) { 
+				if (Estimators[i] == "sharedsobs") { 
+					calculators.push_back(new SharedSobsCS());
+				}else if (Estimators[i] == "sharedchao") { 
+					calculators.push_back(new SharedChao1());
+				}else if (Estimators[i] == "sharedace") { 
+					calculators.push_back(new SharedAce());
+				}else if (Estimators[i] == "jabund") { 	
+					calculators.push_back(new JAbund());
+				}else if (Estimators[i] == "sorabund") { 
+					calculators.push_back(new SorAbund());
+				}else if (Estimators[i] == "jclass") { 
+					calculators.push_back(new Jclass());
+				}else if (Estimators[i] == "sorclass") { 
+					calculators.push_back(new SorClass());
+				}else if (Estimators[i] == "jest") { 
+					calculators.push_back(new Jest());
+				}else if (Estimators[i] == "sorest") { 
+					calculators.push_back(new SorEst());
+				}else if (Estimators[i] == "thetayc") { 
+					calculators.push_back(new ThetaYC());
+				}else if (Estimators[i] == "thetan") { 
+					calculators.push_back(new ThetaN());
+				}else if (Estimators[i] == "kstest") { 
+					calculators.push_back(new KSTest());
+				}else if (Estimators[i] == "sharednseqs") { 
+					calculators.push_back(new SharedNSeqs());
+				}else if (Estimators[i] == "ochiai") { 
+					calculators.push_back(new Ochiai());
+				}else if (Estimators[i] == "anderberg") { 
+					calculators.push_back(new Anderberg());
+				}else if (Estimators[i] == "kulczynski") { 
+					calculators.push_back(new Kulczynski());
+				}else if (Estimators[i] == "kulczynskicody") { 
+					calculators.push_back(new KulczynskiCody());
+				}else if (Estimators[i] == "lennon") { 
+					calculators.push_back(new Lennon());
+				}else if (Estimators[i] == "morisitahorn") { 
+					calculators.push_back(new MorHorn());
+				}else if (Estimators[i] == "braycurtis") { 
+					calculators.push_back(new BrayCurtis());
+				}else if (Estimators[i] == "whittaker") { 
+					calculators.push_back(new Whittaker());
+				}else if (Estimators[i] == "odum") { 
+					calculators.push_back(new Odum());
+				}else if (Estimators[i] == "canberra") { 
+					calculators.push_back(new Canberra());
+				}else if (Estimators[i] == "structeuclidean") { 
+					calculators.push_back(new StructEuclidean());
+				}else if (Estimators[i] == "structchord") { 
+					calculators.push_back(new StructChord());
+				}else if (Estimators[i] == "hellinger") { 
+					calculators.push_back(new Hellinger());
+				}else if (Estimators[i] == "manhattan") { 
+					calculators.push_back(new Manhattan());
+				}else if (Estimators[i] == "structpearson") { 
+					calculators.push_back(new StructPearson());
+				}else if (Estimators[i] == "soergel") { 
+					calculators.push_back(new Soergel());
+				}else if (Estimators[i] == "spearman") { 
+					calculators.push_back(new Spearman());
+				}else if (Estimators[i] == "structkulczynski") { 
+					calculators.push_back(new StructKulczynski());
+				}else if (Estimators[i] == "speciesprofile") { 
+					calculators.push_back(new SpeciesProfile());
+				}else if (Estimators[i] == "hamming") { 
+					calculators.push_back(new Hamming());
+				}else if (Estimators[i] == "structchi2") { 
+					calculators.push_back(new StructChi2());
+				}else if (Estimators[i] == "gower") { 
+					calculators.push_back(new Gower());
+				}else if (Estimators[i] == "memchi2") { 
+					calculators.push_back(new MemChi2());
+				}else if (Estimators[i] == "memchord") { 
+					calculators.push_back(new MemChord());
+				}else if (Estimators[i] == "memeuclidean") { 
+					calculators.push_back(new MemEuclidean());
+				}else if (Estimators[i] == "mempearson") { 
+					calculators.push_back(new MemPearson());
+				}else if (Estimators[i] == "jsd") {
+					calculators.push_back(new JSD());
+				}else if (Estimators[i] == "rjsd") {
+					calculators.push_back(new RJSD());
+				}
+			}
+		}
+		
+		return calculators;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "MatrixOutputCommand", "createCalculators");
+		exit(1);
+	}
+}
 //**********************************************************************************************************************
 
 MatrixOutputCommand::~MatrixOutputCommand(){}
@@ -353,11 +363,6 @@ int MatrixOutputCommand::execute(){
         }
         
 		numGroups = lookup.size();
-        lines.resize(processors);
-		for (int i = 0; i < processors; i++) {
-			lines[i].start = int (sqrt(float(i)/float(processors)) * numGroups);
-			lines[i].end = int (sqrt(float(i+1)/float(processors)) * numGroups);
-		}	
         
 		if (m->control_pressed) { delete input; for (int i = 0; i < lookup.size(); i++) {  delete lookup[i];  } m->clearGroups(); return 0;  }
 				
@@ -489,277 +494,104 @@ void MatrixOutputCommand::printSims(ostream& out, vector< vector<double> >& simM
 /***********************************************************/
 int MatrixOutputCommand::process(vector<SharedRAbundVector*> thisLookup){
 	try {
-		vector< vector< vector<seqDist> > > calcDistsTotals;  //each iter, one for each calc, then each groupCombos dists. this will be used to make .dist files
-        vector< vector<seqDist>  > calcDists; calcDists.resize(matrixCalculators.size()); 		
-                  
-        for (int thisIter = 0; thisIter < iters+1; thisIter++) {
-            map<string, string> variables; 
-            variables["[filename]"] = outputDir + m->getRootName(m->getSimpleName(sharedfile));
-            variables["[distance]"] = thisLookup[0]->getLabel();
-            variables["[tag2]"] = "";
-            
-            vector<SharedRAbundVector*> thisItersLookup = thisLookup;
-            
-            if (subsample && (thisIter != 0)) {
-                SubSample sample;
-                vector<string> tempLabels; //dont need since we arent printing the sampled sharedRabunds
-                
-                //make copy of lookup so we don't get access violations
-                vector<SharedRAbundVector*> newLookup;
-                for (int k = 0; k < thisItersLookup.size(); k++) {
-                    SharedRAbundVector* temp = new SharedRAbundVector();
-                    temp->setLabel(thisItersLookup[k]->getLabel());
-                    temp->setGroup(thisItersLookup[k]->getGroup());
-                    newLookup.push_back(temp);
-                }
-                
-                //for each bin
-                for (int k = 0; k < thisItersLookup[0]->getNumBins(); k++) {
-                    if (m->control_pressed) { for (int j = 0; j < newLookup.size(); j++) {  delete newLookup[j];  } return 0; }
-                    for (int j = 0; j < thisItersLookup.size(); j++) { newLookup[j]->push_back(thisItersLookup[j]->getAbundance(k), thisItersLookup[j]->getGroup()); }
-                }
-                
-                tempLabels = sample.getSample(newLookup, subsampleSize);
-                thisItersLookup = newLookup;
-            }
-        
-            if(processors == 1){
-                driver(thisItersLookup, 0, numGroups, calcDists);
-            }else{
-                int process = 1;
-                vector<int> processIDS;
-                bool recalc = false;
-                
-                #if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-                //loop through and create all the processes you want
-                while (process != processors) {
-                    pid_t pid = fork();
-                    
-                    if (pid > 0) {
-                        processIDS.push_back(pid); 
-                        process++;
-                    }else if (pid == 0){
-                        
-                        driver(thisItersLookup, lines[process].start, lines[process].end, calcDists);   
-                        
-                        string tempdistFileName = m->getRootName(m->getSimpleName(sharedfile)) + m->mothurGetpid(process) + ".dist";
-                        ofstream outtemp;
-                        m->openOutputFile(tempdistFileName, outtemp);
-                            
-                        for (int i = 0; i < calcDists.size(); i++) {
-                            outtemp << calcDists[i].size() << endl;
-                                
-                            for (int j = 0; j < calcDists[i].size(); j++) {
-                                outtemp << calcDists[i][j].seq1 << '\t' << calcDists[i][j].seq2 << '\t' << calcDists[i][j].dist << endl;
-                            }
-                        }
-                        outtemp.close();
-                                        
-                        exit(0);
-                    }else { 
-                        m->mothurOut("[ERROR]: unable to spawn the number of processes you requested, reducing number to " + toString(process) + "\n"); processors = process;
-                        for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); }
-                        //wait to die
-                        for (int i=0;i<processIDS.size();i++) {
-                            int temp = processIDS[i];
-                            wait(&temp);
-                        }
-                        m->control_pressed = false;
-                        for (int i=0;i<processIDS.size();i++) {
-                            m->mothurRemove(m->getRootName(m->getSimpleName(sharedfile)) + m->mothurGetpid(process) + ".dist");
-                        }
-                        recalc = true;
-                        break;
-                    }
-                }
-                
-                if (recalc) {
-                    //test line, also set recalc to true.
-                    //for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); } for (int i=0;i<processIDS.size();i++) { int temp = processIDS[i]; wait(&temp); } m->control_pressed = false;  for (int i=0;i<processIDS.size();i++) {m->mothurRemove(m->getRootName(m->getSimpleName(sharedfile)) + m->mothurGetpid(process) + ".dist");}processors=3; m->mothurOut("[ERROR]: unable to spawn the number of processes you requested, reducing number to " + toString(processors) + "\n");
-                    
-                    
-                    lines.clear();
-                    lines.resize(processors);
-                    for (int i = 0; i < processors; i++) {
-                        lines[i].start = int (sqrt(float(i)/float(processors)) * numGroups);
-                        lines[i].end = int (sqrt(float(i+1)/float(processors)) * numGroups);
-                    }
-                    
-                    processIDS.resize(0);
-                    process = 1;
-                    
-                    //loop through and create all the processes you want
-                    while (process != processors) {
-                        pid_t pid = fork();
-                        
-                        if (pid > 0) {
-                            processIDS.push_back(pid);
-                            process++;
-                        }else if (pid == 0){
-                            
-                            driver(thisItersLookup, lines[process].start, lines[process].end, calcDists);
-                            
-                            string tempdistFileName = m->getRootName(m->getSimpleName(sharedfile)) + m->mothurGetpid(process) + ".dist";
-                            ofstream outtemp;
-                            m->openOutputFile(tempdistFileName, outtemp);
-                            
-                            for (int i = 0; i < calcDists.size(); i++) {
-                                outtemp << calcDists[i].size() << endl;
-                                
-                                for (int j = 0; j < calcDists[i].size(); j++) {
-                                    outtemp << calcDists[i][j].seq1 << '\t' << calcDists[i][j].seq2 << '\t' << calcDists[i][j].dist << endl;
-                                }
-                            }
-                            outtemp.close();
-                            
-                            exit(0);
-                        }else {
-                            m->mothurOut("[ERROR]: unable to spawn the necessary processes."); m->mothurOutEndLine();
-                            for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); }
-                            exit(0);
-                        }
-                    }
-                }
-
-                
-                //parent do your part
-                driver(thisItersLookup, lines[0].start, lines[0].end, calcDists);   
-                            
-                //force parent to wait until all the processes are done
-                for (int i = 0; i < processIDS.size(); i++) {
-                    int temp = processIDS[i];
-                    wait(&temp);
-                }
-                
-                for (int i = 0; i < processIDS.size(); i++) {
-                    string tempdistFileName = m->getRootName(m->getSimpleName(sharedfile)) + toString(processIDS[i]) +  ".dist";
-                    ifstream intemp;
-                    m->openInputFile(tempdistFileName, intemp);
-                        
-                    for (int k = 0; k < calcDists.size(); k++) {
-                        int size = 0;
-                        intemp >> size; m->gobble(intemp);
-                            
-                        for (int j = 0; j < size; j++) {
-                            int seq1 = 0;
-                            int seq2 = 0;
-                            float dist = 1.0;
-                                
-                            intemp >> seq1 >> seq2 >> dist;   m->gobble(intemp);
-                                
-                            seqDist tempDist(seq1, seq2, dist);
-                            calcDists[k].push_back(tempDist);
-                        }
-                    }
-                    intemp.close();
-                    m->mothurRemove(tempdistFileName);
-                }
-                #else
-                //////////////////////////////////////////////////////////////////////////////////////////////////////
-                //Windows version shared memory, so be careful when passing variables through the distSharedData struct. 
-                //Above fork() will clone, so memory is separate, but that's not the case with windows, 
-                //Taking advantage of shared memory to pass results vectors.
-                //////////////////////////////////////////////////////////////////////////////////////////////////////
-                
-                vector<distSharedData*> pDataArray; 
-                DWORD   dwThreadIdArray[processors-1];
-                HANDLE  hThreadArray[processors-1]; 
-                
-                //Create processor worker threads.
-                for( int i=1; i<processors; i++ ){
-                    
-                    //make copy of lookup so we don't get access violations
-                    vector<SharedRAbundVector*> newLookup;
-                    for (int k = 0; k < thisItersLookup.size(); k++) {
-                        SharedRAbundVector* temp = new SharedRAbundVector();
-                        temp->setLabel(thisItersLookup[k]->getLabel());
-                        temp->setGroup(thisItersLookup[k]->getGroup());
-                        newLookup.push_back(temp);
-                    }
-                    
-                    //for each bin
-                    for (int k = 0; k < thisItersLookup[0]->getNumBins(); k++) {
-                        if (m->control_pressed) { for (int j = 0; j < newLookup.size(); j++) {  delete newLookup[j];  } return 0; }
-                        for (int j = 0; j < thisItersLookup.size(); j++) { newLookup[j]->push_back(thisItersLookup[j]->getAbundance(k), thisItersLookup[j]->getGroup()); }
-                    }
-                    
-                    // Allocate memory for thread data.
-                    distSharedData* tempSum = new distSharedData(m, lines[i].start, lines[i].end, Estimators, newLookup);
-                    pDataArray.push_back(tempSum);
-                    processIDS.push_back(i);
-                    
-                    hThreadArray[i-1] = CreateThread(NULL, 0, MyDistSharedThreadFunction, pDataArray[i-1], 0, &dwThreadIdArray[i-1]);   
-                }
-                
-                //parent do your part
-                driver(thisItersLookup, lines[0].start, lines[0].end, calcDists);   
-                           
-                //Wait until all threads have terminated.
-                WaitForMultipleObjects(processors-1, hThreadArray, TRUE, INFINITE);
-                
-                //Close all thread handles and free memory allocations.
-                for(int i=0; i < pDataArray.size(); i++){
-                    if (pDataArray[i]->count != (pDataArray[i]->end-pDataArray[i]->start)) {
-                        m->mothurOut("[ERROR]: process " + toString(i) + " only processed " + toString(pDataArray[i]->count) + " of " + toString(pDataArray[i]->end-pDataArray[i]->start) + " groups assigned to it, quitting. \n"); m->control_pressed = true; 
-                    }
-                    for (int j = 0; j < pDataArray[i]->thisLookup.size(); j++) {  delete pDataArray[i]->thisLookup[j];  } 
-                    
-                    for (int k = 0; k < calcDists.size(); k++) {
-                        int size = pDataArray[i]->calcDists[k].size();
-                        for (int j = 0; j < size; j++) {    calcDists[k].push_back(pDataArray[i]->calcDists[k][j]);    }
-                    }
-                    
-                    CloseHandle(hThreadArray[i]);
-                    delete pDataArray[i];
-                }
-
-                #endif
-            }
-            
-            if (subsample && (thisIter != 0)) {  
-                if((thisIter) % 100 == 0){	m->mothurOutJustToScreen(toString(thisIter)+"\n"); 		}
-                calcDistsTotals.push_back(calcDists);
-                for (int i = 0; i < calcDists.size(); i++) {
-                    for (int j = 0; j < calcDists[i].size(); j++) {
-                        if (m->debug) {  m->mothurOut("[DEBUG]: Results: iter = " + toString(thisIter) + ", " + thisLookup[calcDists[i][j].seq1]->getGroup() + " - " + thisLookup[calcDists[i][j].seq2]->getGroup() + " distance = " + toString(calcDists[i][j].dist) + ".\n");  }
-                    } 
-                }
-                //clean up memory
-                for (int i = 0; i < thisItersLookup.size(); i++) { delete thisItersLookup[i]; }
-                thisItersLookup.clear();
-            }else { //print results for whole dataset
-                for (int i = 0; i < calcDists.size(); i++) {
-                    if (m->control_pressed) { break; }
-                    
-                    //initialize matrix
-                    vector< vector<double> > matrix; //square matrix to represent the distance
-                    matrix.resize(thisLookup.size());
-                    for (int k = 0; k < thisLookup.size(); k++) {  matrix[k].resize(thisLookup.size(), 0.0); }
-                    
-                    for (int j = 0; j < calcDists[i].size(); j++) {
-                        int row = calcDists[i][j].seq1;
-                        int column = calcDists[i][j].seq2;
-                        double dist = calcDists[i][j].dist;
-                        
-                        matrix[row][column] = dist;
-                        matrix[column][row] = dist;
-                    }
-                    
-                    variables["[outputtag]"] = output;
-                    variables["[calc]"] = matrixCalculators[i]->getName();
-                    string distFileName = getOutputFileName("phylip",variables);
-                    outputNames.push_back(distFileName); outputTypes["phylip"].push_back(distFileName);
-                    
-                    ofstream outDist;
-                    m->openOutputFile(distFileName, outDist);
-                    outDist.setf(ios::fixed, ios::floatfield); outDist.setf(ios::showpoint);
-                    
-                    printSims(outDist, matrix);
-                    
-                    outDist.close();
-                }
-            }
-            for (int i = 0; i < calcDists.size(); i++) {  calcDists[i].clear(); }
+		//each thread gets its own calculators, they keep their results in data. kstest sorts the pair it is given and
+		//puts it back, so the threads comparing the whole dataset each work on their own copy of it.
+		vector< vector<Calculator*> > calculators(processors);
+		vector< vector<SharedRAbundVector*> > threadLookups(processors);
+		calculators[0] = matrixCalculators; threadLookups[0] = thisLookup;
+		for (int t = 1; t < processors; t++) {
+			calculators[t] = createCalculators();
+			for (int k = 0; k < thisLookup.size(); k++) { threadLookups[t].push_back(new SharedRAbundVector(*thisLookup[k])); }
+		}
+		
+		//the rows of the whole dataset are divided among the threads, and merged in row order
+		vector< vector< vector<seqDist> > > rowDists(numGroups, vector< vector<seqDist> >(matrixCalculators.size()));
+		ThreadPool::getInstance()->parallelFor(0, numGroups, processors, [&](long long start, long long end, int threadID) {
+			for (long long k = start; k < end; k++) { driver(threadLookups[threadID], k, k+1, rowDists[k], calculators[threadID]); }
+		});
+		
+		vector< vector<seqDist>  > calcDists; calcDists.resize(matrixCalculators.size());
+		for (int k = 0; k < rowDists.size(); k++) {
+			for (int i = 0; i < calcDists.size(); i++) { calcDists[i].insert(calcDists[i].end(), rowDists[k][i].begin(), rowDists[k][i].end()); }
+		}
+		rowDists.clear();
+		
+		//each iteration subsamples with its own random stream, so the results under set.seed are the same for any number of processors
+		vector< vector< vector<seqDist> > > calcDistsTotals(iters, vector< vector<seqDist> >(matrixCalculators.size()));  //each iter, one for each calc, then each groupCombos dists. this will be used to make .dist files
+		if (subsample) {
+			unsigned long long baseSeed = m->getRandomNumber();
+			atomic<int> itersDone(0);
+			mutex outputLock;
+			
+			ThreadPool::getInstance()->parallelFor(0, iters, processors, [&](long long start, long long end, int threadID) {
+				SubSample sample;
+				for (long long iter = start; iter < end; iter++) {
+					if (m->control_pressed) { return; }
+					
+					mt19937_64 rng(getStreamSeed(baseSeed, iter));
+					vector<SharedRAbundVector*> thisItersLookup = sample.getSamplePreserve(thisLookup, subsampleSize, rng);
+					driver(thisItersLookup, 0, numGroups, calcDistsTotals[iter], calculators[threadID]);
+					for (int k = 0; k < thisItersLookup.size(); k++) { delete thisItersLookup[k]; }
+					
+					int done = ++itersDone;
+					if ((done % 100) == 0) { lock_guard<mutex> guard(outputLock); m->mothurOutJustToScreen(toString(done)+"\n"); }
+				}
+			});
+		}
+		
+		for (int t = 1; t < processors; t++) {
+			for (int i = 0; i < calculators[t].size(); i++) { delete calculators[t][i]; }
+			for (int k = 0; k < threadLookups[t].size(); k++) { delete threadLookups[t][k]; }
+		}
+		
+		if (m->control_pressed) { return 0; }
+		
+		if (m->debug) {
+			for (int thisIter = 0; thisIter < calcDistsTotals.size(); thisIter++) {
+				for (int i = 0; i < calcDistsTotals[thisIter].size(); i++) {
+					for (int j = 0; j < calcDistsTotals[thisIter][i].size(); j++) {
+						seqDist& dist = calcDistsTotals[thisIter][i][j];
+						m->mothurOut("[DEBUG]: Results: iter = " + toString(thisIter+1) + ", " + thisLookup[dist.seq1]->getGroup() + " - " + thisLookup[dist.seq2]->getGroup() + " distance = " + toString(dist.dist) + ".\n");
+					}
+				}
+			}
+		}
+		
+		//print results for whole dataset
+		map<string, string> variables; 
+		variables["[filename]"] = outputDir + m->getRootName(m->getSimpleName(sharedfile));
+		variables["[distance]"] = thisLookup[0]->getLabel();
+		variables["[tag2]"] = "";
+		
+		for (int i = 0; i < calcDists.size(); i++) {
+			if (m->control_pressed) { break; }
+			
+			//initialize matrix
+			vector< vector<double> > matrix; //square matrix to represent the distance
+			matrix.resize(thisLookup.size());
+			for (int k = 0; k < thisLookup.size(); k++) {  matrix[k].resize(thisLookup.size(), 0.0); }
+			
+			for (int j = 0; j < calcDists[i].size(); j++) {
+				int row = calcDists[i][j].seq1;
+				int column = calcDists[i][j].seq2;
+				double dist = calcDists[i][j].dist;
+				
+				matrix[row][column] = dist;
+				matrix[column][row] = dist;
+			}
+			
+			variables["[outputtag]"] = output;
+			variables["[calc]"] = matrixCalculators[i]->getName();
+			string distFileName = getOutputFileName("phylip",variables);
+			outputNames.push_back(distFileName); outputTypes["phylip"].push_back(distFileName);
+			
+			ofstream outDist;
+			m->openOutputFile(distFileName, outDist);
+			outDist.setf(ios::fixed, ios::floatfield); outDist.setf(ios::showpoint);
+			
+			printSims(outDist, matrix);
+			
+			outDist.close();
 		}
 		
         if (iters != 0) {
@@ -832,9 +664,13 @@ int MatrixOutputCommand::process(vector<SharedRAbundVector*> thisLookup){
 	}
 }
 /**************************************************************************************************/
-int MatrixOutputCommand::driver(vector<SharedRAbundVector*> thisLookup, int start, int end, vector< vector<seqDist> >& calcDists) { 
+int MatrixOutputCommand::driver(vector<SharedRAbundVector*> thisLookup, int start, int end, vector< vector<seqDist> >& calcDists, vector<Calculator*>& calculators) { 
 	try {
 		vector<SharedRAbundVector*> subset;
+		SharedUtil util;
+		
+		bool usePresentOtus = false;
+		for(int i=0;i<calculators.size();i++) { if (calculators[i]->getIgnoresEmptyOtus()) { usePresentOtus = true; } }
         
 		for (int k = start; k < end; k++) { // pass cdd each set of groups to compare
 			
@@ -845,23 +681,31 @@ int MatrixOutputCommand::driver(vector<SharedRAbundVector*> thisLookup, int star
 					//add new pair of sharedrabunds
 					subset.push_back(thisLookup[k]); subset.push_back(thisLookup[l]); 
 					
-					for(int i=0;i<matrixCalculators.size();i++) {
+					//with sparse groups most otus are in neither, so calcs that ignore them get the pair without them
+					vector<SharedRAbundVector*> presentSubset;
+					if (usePresentOtus) { util.getPresentOtus(subset, presentSubset); }
+					
+					for(int i=0;i<calculators.size();i++) {
 						
 						//if this calc needs all groups to calculate the pair load all groups
-						if (matrixCalculators[i]->getNeedsAll()) { 
+						if (calculators[i]->getNeedsAll()) { 
 							//load subset with rest of lookup for those calcs that need everyone to calc for a pair
 							for (int w = 0; w < thisLookup.size(); w++) {
 								if ((w != k) && (w != l)) { subset.push_back(thisLookup[w]); }
 							}
 						}
 						
-						vector<double> tempdata = matrixCalculators[i]->getValues(subset); //saves the calculator outputs
+						vector<double> tempdata;
+						if ((presentSubset.size() != 0) && calculators[i]->getIgnoresEmptyOtus()) { tempdata = calculators[i]->getValues(presentSubset); }
+						else { tempdata = calculators[i]->getValues(subset); } //saves the calculator outputs
 						
-						if (m->control_pressed) { return 1; }
+						if (m->control_pressed) { for (int w = 0; w < presentSubset.size(); w++) { delete presentSubset[w]; } return 1; }
         
 						seqDist temp(l, k, tempdata[0]);
 						calcDists[i].push_back(temp);
 					}
+					
+					for (int w = 0; w < presentSubset.size(); w++) { delete presentSubset[w]; }
 				}
 			}
 		}
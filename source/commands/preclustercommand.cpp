@@ -666,6 +666,12 @@ int PreClusterCommand::process(string newMapFile){
 		int count = 0;
 		int numSeqs = alignSeqs.size();
 		
+		//aligned seqs only compare the seqs that could be within diffs
+		bool useIndex = (method == "aligned");
+		vector<int> candidates;
+		vector<int> lastSeen(numSeqs, -1);
+		if (useIndex) { indexSegments(); }
+		
         if (topdown) {
             //think about running through twice...
             for (int i = 0; i < numSeqs; i++) {
@@ -675,15 +681,20 @@ int PreClusterCommand::process(string newMapFile){
                     string chunk = alignSeqs[i].seq.getName() + "\t" + toString(alignSeqs[i].numIdentical) + "\t" + toString(0) + "\t" + alignSeqs[i].seq.getAligned() + "\n";
                     
                     //try to merge it with all smaller seqs
-                    for (int j = i+1; j < numSeqs; j++) {
+                    int numCandidates = numSeqs - (i+1);
+                    if (useIndex) { numCandidates = findCandidates(i, candidates, lastSeen); }
+                    
+                    for (int k = 0; k < numCandidates; k++) {
+                        int j = i+1+k;
+                        if (useIndex) { j = candidates[k]; }
                         
-                        if (m->control_pressed) { out.close(); return 0; }
+                        if (m->control_pressed) { out.close(); segmentIndex.clear(); return 0; }
                         
                         if (alignSeqs[j].active) {  //this sequence has not been merged yet
                             //are you within "diff" bases
                             int mismatch = length;
                             if (method == "unaligned") { mismatch = calcMisMatches(alignSeqs[i].seq.getAligned(), alignSeqs[j].seq.getAligned()); }
-                            else { mismatch = calcMisMatches(alignSeqs[i].filteredSeq, alignSeqs[j].filteredSeq); }
+                            else { mismatch = countDiffs(alignSeqs[i].filteredSeq, alignSeqs[j].filteredSeq); }
                             
                             if (mismatch <= diffs) {
                                 //merge
@@ -718,15 +729,20 @@ int PreClusterCommand::process(string newMapFile){
             for (int i = 0; i < numSeqs; i++) {
                 
                 //try to merge it into larger seqs
-                for (int j = i+1; j < numSeqs; j++) {
+                int numCandidates = numSeqs - (i+1);
+                if (useIndex) { numCandidates = findCandidates(i, candidates, lastSeen); }
+                
+                for (int k = 0; k < numCandidates; k++) {
+                    int j = i+1+k;
+                    if (useIndex) { j = candidates[k]; }
                     
-                    if (m->control_pressed) { out.close(); return 0; }
+                    if (m->control_pressed) { out.close(); segmentIndex.clear(); return 0; }
                     
                     if (originalCount[j] > originalCount[i]) {  //this sequence is more abundant than I am
                         //are you within "diff" bases
                         int mismatch = length;
                         if (method == "unaligned") { mismatch = calcMisMatches(alignSeqs[i].seq.getAligned(), alignSeqs[j].seq.getAligned()); }
-                        else { mismatch = calcMisMatches(alignSeqs[i].filteredSeq, alignSeqs[j].filteredSeq); }
+                        else { mismatch = countDiffs(alignSeqs[i].filteredSeq, alignSeqs[j].filteredSeq); }
                         
                         if (mismatch <= diffs) {
                             //merge
@@ -738,7 +754,7 @@ int PreClusterCommand::process(string newMapFile){
                             originalCount.erase(i);
                             mapFile[i] = "";
                             count++;
-                            j+=numSeqs; //exit search, we merged this one in.
+                            k+=numSeqs; //exit search, we merged this one in.
                         }
                     }//end abundance check
                 }//end for loop j
@@ -754,6 +770,7 @@ int PreClusterCommand::process(string newMapFile){
             
         }
 		out.close();
+		segmentIndex.clear(); //a hash bucket per piece for every seq, the next group builds its own
 		
 		if(numSeqs % 100 != 0)	{ m->mothurOut(toString(numSeqs) + "\t" + toString(numSeqs - count) + "\t" + toString(count)); m->mothurOutEndLine();	}	
 		
@@ -913,11 +930,7 @@ int PreClusterCommand::calcMisMatches(string seq1, string seq2){
 
         }else {
             //count diffs
-            for (int i = 0; i < seq1.length(); i++) {
-                //do they match
-                if (seq1[i] != seq2[i]) { numBad++; }
-                if (numBad > diffs) { return length;  } //to far to cluster
-            }
+            numBad = countDiffs(seq1, seq2);
         }
 		return numBad;
 	}
@@ -927,6 +940,109 @@ int PreClusterCommand::calcMisMatches(string seq1, string seq2){
 	}
 }
 /**************************************************************************************************/
+//mismatches between two filtered seqs of the same length, or length if there are more than diffs
+int PreClusterCommand::countDiffs(const string& seq1, const string& seq2){
+	try {
+		int numBad = 0;
+		int seqLength = seq1.length();
+		const char* first = seq1.c_str();
+		const char* second = seq2.c_str();
+		
+		//compare 8 columns at a time, a byte of different is nonzero where the columns don't match
+		int i = 0;
+		for (; (i + 8) <= seqLength; i += 8) {
+			unsigned long long firstWord, secondWord;
+			memcpy(&firstWord, first + i, 8);
+			memcpy(&secondWord, second + i, 8);
+			
+			unsigned long long different = firstWord ^ secondWord;
+			if (different != 0) {
+				//sets the high bit of each nonzero byte
+				unsigned long long highBits = (((different & 0x7F7F7F7F7F7F7F7FULL) + 0x7F7F7F7F7F7F7F7FULL) | different) & 0x8080808080808080ULL;
+				numBad += __builtin_popcountll(highBits);
+				if (numBad > diffs) { return length;  } //to far to cluster
+			}
+		}
+		
+		for (; i < seqLength; i++) {
+			if (first[i] != second[i]) { numBad++; }
+			if (numBad > diffs) { return length;  } //to far to cluster
+		}
+		
+		return numBad;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PreClusterCommand", "countDiffs");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//if two filtered seqs have diffs or fewer mismatches then at least one of diffs+1 pieces has none, so the seqs that
+//could merge are the ones sharing a piece. Called after alignSeqs is sorted.
+void PreClusterCommand::indexSegments(){
+	try {
+		segmentStarts.clear();
+		segmentIndex.clear();
+		if (alignSeqs.size() == 0) { return; }
+		
+		int filteredLength = alignSeqs[0].filteredSeq.length();
+		int numSegments = diffs + 1;
+		
+		for (int s = 0; s <= numSegments; s++) { segmentStarts.push_back((s * (long long) filteredLength) / numSegments); }
+		
+		segmentIndex.resize(numSegments);
+		for (int i = 0; i < alignSeqs.size(); i++) {
+			if (m->control_pressed) { return; }
+			for (int s = 0; s < numSegments; s++) { segmentIndex[s][hashSegment(alignSeqs[i].filteredSeq, s)].push_back(i); }
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PreClusterCommand", "indexSegments");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//FNV-1a, a collision only adds a seq that countDiffs will reject
+unsigned long long PreClusterCommand::hashSegment(const string& seq, int segment){
+	try {
+		unsigned long long hash = 14695981039346656037ULL;
+		for (int i = segmentStarts[segment]; i < segmentStarts[segment+1]; i++) {
+			hash ^= (unsigned char)seq[i];
+			hash *= 1099511628211ULL;
+		}
+		return hash;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PreClusterCommand", "hashSegment");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//fills candidates with the seqs after i that share a piece with it, in order, and returns how many there are
+int PreClusterCommand::findCandidates(int i, vector<int>& candidates, vector<int>& lastSeen){
+	try {
+		candidates.clear();
+		
+		for (int s = 0; s < segmentIndex.size(); s++) {
+			unordered_map<unsigned long long, vector<int> >::iterator it = segmentIndex[s].find(hashSegment(alignSeqs[i].filteredSeq, s));
+			if (it == segmentIndex[s].end()) { continue; }
+			
+			vector<int>& seqs = it->second;
+			for (vector<int>::iterator itSeq = upper_bound(seqs.begin(), seqs.end(), i); itSeq != seqs.end(); itSeq++) {
+				if (lastSeen[*itSeq] != i) { lastSeen[*itSeq] = i; candidates.push_back(*itSeq); }
+			}
+		}
+		
+		sort(candidates.begin(), candidates.end());
+		
+		return candidates.size();
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PreClusterCommand", "findCandidates");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
 
 int PreClusterCommand::mergeGroupCounts(string newcount, string newname, string newfasta){
 	try {
@@ -23,6 +23,8 @@
 #include "noalign.hpp"
 #include "filters.h"
 
+#include <unordered_map>
+
 /************************************************************/
 struct seqPNode {
 	int numIdentical;
@@ -56,6 +58,10 @@ inline bool comparePriorityDownTop(seqPNode first, seqPNode second) {
 
 class PreClusterCommand : public Command {
 	
+#ifdef UNIT_TEST
+	friend class TestPreClusterCommand;
+#endif
+	
 public:
 	PreClusterCommand(string);
 	PreClusterCommand();
@@ -86,9 +92,15 @@ private:
 	string fastafile, namefile, outputDir, groupfile, countfile, method, align;
 	vector<seqPNode> alignSeqs; //maps the number of identical seqs to a sequence
 	vector<string> outputNames;
+	vector<int> segmentStarts; //aligned seqs are split into diffs+1 pieces, segmentStarts[s] to segmentStarts[s+1] is piece s
+	vector< unordered_map<unsigned long long, vector<int> > > segmentIndex; //hash of piece s -> seqs with that piece, in order
 	
 	int readFASTA();
 	int calcMisMatches(string, string);
+	int countDiffs(const string&, const string&);
+	void indexSegments();
+	unsigned long long hashSegment(const string&, int);
+	int findCandidates(int, vector<int>&, vector<int>&);
 	void printData(string, string, string); //fasta filename, names file name
 	int process(string);
 	int loadSeqs(map<string, string>&, vector<Sequence>&, string);
@@ -17,6 +17,7 @@ vector<string> SetDirectoryCommand::setParameters(){
         CommandParameter pdebug("debug", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(pdebug);
         CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
         CommandParameter pmodnames("modifynames", "Boolean", "", "T", "", "", "","",false,false); parameters.push_back(pmodnames);
+        CommandParameter pcountcache("countcache", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(pcountcache);
 		CommandParameter pinput("input", "String", "", "", "", "", "","",false,false,true); parameters.push_back(pinput);
 		CommandParameter poutput("output", "String", "", "", "", "", "","",false,false,true); parameters.push_back(poutput);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
@@ -42,6 +43,7 @@ string SetDirectoryCommand::getHelpString(){
         helpString += "The set.dir command can also be used to run mothur in debug mode.\n";
         helpString += "The set.dir command can also be used to seed random.\n";
         helpString += "The set.dir command can also be used to set the modifynames parameter. Default=t, meaning if your sequence names contain ':' change them to '_' to avoid issues while making trees.  modifynames=F will leave sequence names as they are.\n";
+        helpString += "The set.dir command can also be used to set the countcache parameter. countcache=T saves count tables larger than 16MB, as they are read, to <countfile>.bin in the output directory, or next to the count file if none is set, and later reads of the unchanged count file load it instead of parsing the text. Default=F.\n";
 		helpString += "The set.dir command parameters are input, output, tempdefault and debug and one is required.\n";
         helpString += "To run mothur in debug mode set debug=true. Default debug=false.\n";
         helpString += "To seed random set seed=yourRandomValue. By default mothur seeds random with the start time.\n";
@@ -110,6 +112,11 @@ SetDirectoryCommand::SetDirectoryCommand(string option)  {
             else {  modifyNames = m->isTrue(temp); }
             m->modifyNames = modifyNames;
             
+            bool nocache = false;
+            temp = validParameter.validFile(parameters, "countcache", false);
+            if (temp == "not found") {  nocache = true; }
+            else {  m->countCache = m->isTrue(temp); }
+            
             bool seed = false;
             temp = validParameter.validFile(parameters, "seed", false);
             if (temp == "not found") { random = 0; }
@@ -124,8 +131,8 @@ SetDirectoryCommand::SetDirectoryCommand(string option)  {
                 m->mothurOut("Setting random seed to " + toString(random) + ".\n\n");
             }
             
-			if ((input == "") && (output == "") && (tempdefault == "") && (blastLocation == "") && nodebug && nomod && !seed) {
-				m->mothurOut("[ERROR]: You must provide either an input, output, tempdefault, blastdir, debug or modifynames for the set.dir command."); m->mothurOutEndLine(); abort = true;
+			if ((input == "") && (output == "") && (tempdefault == "") && (blastLocation == "") && nodebug && nomod && nocache && !seed) {
+				m->mothurOut("[ERROR]: You must provide either an input, output, tempdefault, blastdir, debug, modifynames or countcache for the set.dir command."); m->mothurOutEndLine(); abort = true;
 			}else if((input == "") && (output == "") && (tempdefault == "") && (blastLocation == "")) { debugorSeedOnly = true; }
 		}
 	}
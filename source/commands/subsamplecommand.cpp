@@ -1499,13 +1499,13 @@ int SubSampleCommand::processRabund(RAbundVector*& rabund, ofstream& out) {
 			
 		if (thisSize != size) {
 				
-			vector<int> order;
-			for(int p=0;p<numBins;p++){
-				for(int j=0;j<rabund->get(p);j++){
-					order.push_back(p);
-				}
-			}
-			m->mothurRandomShuffle(order);
+			vector<int> abunds(numBins, 0);
+			for(int p=0;p<numBins;p++){ abunds[p] = rabund->get(p); }
+			
+			SubSample sample;
+			vector<int> sampled = sample.getSample(abunds, size);
+			
+			if (m->control_pressed) {  return 0; }
 			
 			RAbundVector* temp = new RAbundVector(numBins);
 			temp->setLabel(rabund->getLabel());
@@ -1513,14 +1513,8 @@ int SubSampleCommand::processRabund(RAbundVector*& rabund, ofstream& out) {
 			delete rabund;
 			rabund = temp;
 			
-			for (int j = 0; j < size; j++) {
-				
-				if (m->control_pressed) {  return 0; }
-				
-				int bin = order[j];
-				
-				int abund = rabund->get(bin);
-				rabund->set(bin, (abund+1));
+			for (int j = 0; j < numBins; j++) {
+				if (sampled[j] != 0) { rabund->set(j, sampled[j]); }
 			}
 		}
 		
@@ -1658,13 +1652,13 @@ int SubSampleCommand::processSabund(SAbundVector*& sabund, ofstream& out) {
 	
 		if (thisSize != size) {
 			
-			vector<int> order;
-			for(int p=0;p<numBins;p++){
-				for(int j=0;j<rabund->get(p);j++){
-					order.push_back(p);
-				}
-			}
-			m->mothurRandomShuffle(order);
+			vector<int> abunds(numBins, 0);
+			for(int p=0;p<numBins;p++){ abunds[p] = rabund->get(p); }
+			
+			SubSample sample;
+			vector<int> sampled = sample.getSample(abunds, size);
+			
+			if (m->control_pressed) {  delete rabund; return 0; }
 			
 			RAbundVector* temp = new RAbundVector(numBins);
 			temp->setLabel(rabund->getLabel());
@@ -1672,14 +1666,8 @@ int SubSampleCommand::processSabund(SAbundVector*& sabund, ofstream& out) {
 			delete rabund;
 			rabund = temp;
 			
-			for (int j = 0; j < size; j++) {
-	
-				if (m->control_pressed) {  return 0; }
-				
-				int bin = order[j];
-				
-				int abund = rabund->get(bin);
-				rabund->set(bin, (abund+1));
+			for (int j = 0; j < numBins; j++) {
+				if (sampled[j] != 0) { rabund->set(j, sampled[j]); }
 			}
 		}
 		
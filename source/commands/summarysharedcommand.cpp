@@ -9,6 +9,8 @@
 
 #include "summarysharedcommand.h"
 #include "subsample.h"
+#include "sharedutilities.h"
+#include "threadpool.h"
 
 //**********************************************************************************************************************
 vector<string> SummarySharedCommand::setParameters(){	
@@ -211,98 +213,7 @@ SummarySharedCommand::SummarySharedCommand(string option)  {
 			m->mothurConvert(temp, processors); 
 			
 			if (abort == false) {
-			
-				ValidCalculators validCalculator;
-				int i;
-				
-				for (i=0; i<Estimators.size(); i++) {
-					if (validCalculator.isValidCalculator("sharedsummary", Estimators[i]) == true) { 
-						if (Estimators[i] == "sharedsobs") { 
-							sumCalculators.push_back(new SharedSobsCS());
-						}else if (Estimators[i] == "sharedchao") { 
-							sumCalculators.push_back(new SharedChao1());
-						}else if (Estimators[i] == "sharedace") { 
-							sumCalculators.push_back(new SharedAce());
-						}else if (Estimators[i] == "jabund") { 	
-							sumCalculators.push_back(new JAbund());
-						}else if (Estimators[i] == "sorabund") { 
-							sumCalculators.push_back(new SorAbund());
-						}else if (Estimators[i] == "jclass") { 
-							sumCalculators.push_back(new Jclass());
-						}else if (Estimators[i] == "sorclass") { 
-							sumCalculators.push_back(new SorClass());
-						}else if (Estimators[i] == "jest") { 
-							sumCalculators.push_back(new Jest());
-						}else if (Estimators[i] == "sorest") { 
-							sumCalculators.push_back(new SorEst());
-						}else if (Estimators[i] == "thetayc") { 
-							sumCalculators.push_back(new ThetaYC());
-						}else if (Estimators[i] == "thetan") { 
-							sumCalculators.push_back(new ThetaN());
-						}else if (Estimators[i] == "kstest") { 
-							sumCalculators.push_back(new KSTest());
-						}else if (Estimators[i] == "sharednseqs") { 
-							sumCalculators.push_back(new SharedNSeqs());
-						}else if (Estimators[i] == "ochiai") { 
-							sumCalculators.push_back(new Ochiai());
-						}else if (Estimators[i] == "anderberg") { 
-							sumCalculators.push_back(new Anderberg());
-						}else if (Estimators[i] == "kulczynski") { 
-							sumCalculators.push_back(new Kulczynski());
-						}else if (Estimators[i] == "kulczynskicody") { 
-							sumCalculators.push_back(new KulczynskiCody());
-						}else if (Estimators[i] == "lennon") { 
-							sumCalculators.push_back(new Lennon());
-						}else if (Estimators[i] == "morisitahorn") { 
-							sumCalculators.push_back(new MorHorn());
-						}else if (Estimators[i] == "braycurtis") { 
-							sumCalculators.push_back(new BrayCurtis());
-						}else if (Estimators[i] == "whittaker") { 
-							sumCalculators.push_back(new Whittaker());
-						}else if (Estimators[i] == "odum") { 
-							sumCalculators.push_back(new Odum());
-						}else if (Estimators[i] == "canberra") { 
-							sumCalculators.push_back(new Canberra());
-						}else if (Estimators[i] == "structeuclidean") { 
-							sumCalculators.push_back(new StructEuclidean());
-						}else if (Estimators[i] == "structchord") { 
-							sumCalculators.push_back(new StructChord());
-						}else if (Estimators[i] == "hellinger") { 
-							sumCalculators.push_back(new Hellinger());
-						}else if (Estimators[i] == "manhattan") { 
-							sumCalculators.push_back(new Manhattan());
-						}else if (Estimators[i] == "structpearson") { 
-							sumCalculators.push_back(new StructPearson());
-						}else if (Estimators[i] == "soergel") { 
-							sumCalculators.push_back(new Soergel());
-						}else if (Estimators[i] == "spearman") { 
-							sumCalculators.push_back(new Spearman());
-						}else if (Estimators[i] == "structkulczynski") { 
-							sumCalculators.push_back(new StructKulczynski());
-						}else if (Estimators[i] == "speciesprofile") { 
-							sumCalculators.push_back(new SpeciesProfile());
-						}else if (Estimators[i] == "hamming") { 
-							sumCalculators.push_back(new Hamming());
-						}else if (Estimators[i] == "structchi2") { 
-							sumCalculators.push_back(new StructChi2());
-						}else if (Estimators[i] == "gower") { 
-							sumCalculators.push_back(new Gower());
-						}else if (Estimators[i] == "memchi2") { 
-							sumCalculators.push_back(new MemChi2());
-						}else if (Estimators[i] == "memchord") { 
-							sumCalculators.push_back(new MemChord());
-						}else if (Estimators[i] == "memeuclidean") { 
-							sumCalculators.push_back(new MemEuclidean());
-						}else if (Estimators[i] == "mempearson") { 
-							sumCalculators.push_back(new MemPearson());
-						}else if (Estimators[i] == "jsd") {
-							sumCalculators.push_back(new JSD());
-						}else if (Estimators[i] == "rjsd") {
-							sumCalculators.push_back(new RJSD());
-						}
-					}
-				}
-				
+				sumCalculators = createCalculators();
 				mult = false;
 			}
 		}
@@ -313,6 +224,107 @@ SummarySharedCommand::SummarySharedCommand(string option)  {
 	}
 }
 //**********************************************************************************************************************
+vector<Calculator*> SummarySharedCommand::createCalculators(){
+	try {
+		vector<Calculator*> calculators;
+		ValidCalculators validCalculator;
+		
+		for (int i=0; i<Estimators.size(); i++) {
+			if (validCalculator.isValidCalculator("sharedsummary", Estimators[i]) == true) { 
+				if (Estimators[i] == "sharedsobs") { 
+					calculators.push_back(new SharedSobsCS());
+				}else if (Estimators[i] == "sharedchao") { 
+					calculators.push_back(new SharedChao1());
+				}else if (Estimators[i] == "sharedace") { 
+					calculators.push_back(new SharedAce());
+				}else if (Estimators[i] == "jabund") { 	
+					calculators.push_back(new JAbund());
+				}else if (Estimators[i] == "sorabund") { 
+					calculators.push_back(new SorAbund());
+				}else if (Estimators[i] == "jclass") { 
+					calculators.push_back(new Jclass());
+				}else if (Estimators[i] == "sorclass") { 
+					calculators.push_back(new SorClass());
+				}else if (Estimators[i] == "jest") { 
+					calculators.push_back(new Jest());
+				}else if (Estimators[i] == "sorest") { 
+					calculators.push_back(new SorEst());
+				}else if (Estimators[i] == "thetayc") { 
+					calculators.push_back(new ThetaYC());
+				}else if (Estimators[i] == "thetan") { 
+					calculators.push_back(new ThetaN());
+				}else if (Estimators[i] == "kstest") { 
+					calculators.push_back(new KSTest());
+				}else if (Estimators[i] == "sharednseqs") { 
+					calculators.push_back(new SharedNSeqs());
+				}else if (Estimators[i] == "ochiai") { 
+					calculators.push_back(new Ochiai());
+				}else if (Estimators[i] == "anderberg") { 
+					calculators.push_back(new Anderberg());
+				}else if (Estimators[i] == "kulczynski") { 
+					calculators.push_back(new Kulczynski());
+				}else if (Estimators[i] == "kulczynskicody") { 
+					calculators.push_back(new KulczynskiCody());
+				}else if (Estimators[i] == "lennon") { 
+					calculators.push_back(new Lennon());
+				}else if (Estimators[i] == "morisitahorn") { 
+					calculators.push_back(new MorHorn());
+				}else if (Estimators[i] == "braycurtis") { 
+					calculators.push_back(new BrayCurtis());
+				}else if (Estimators[i] == "whittaker") { 
+					calculators.push_back(new Whittaker());
+				}else if (Estimators[i] == "odum") { 
+					calculators.push_back(new Odum());
+				}else if (Estimators[i] == "canberra") { 
+					calculators.push_back(new Canberra());
+				}else if (Estimators[i] == "structeuclidean") { 
+					calculators.push_back(new StructEuclidean());
+				}else if (Estimators[i] == "structchord") { 
+					calculators.push_back(new StructChord());
+				}else if (Estimators[i] == "hellinger") { 
+					calculators.push_back(new Hellinger());
+				}else if (Estimators[i] == "manhattan") { 
+					calculators.push_back(new Manhattan());
+				}else if (Estimators[i] == "structpearson") { 
+					calculators.push_back(new StructPearson());
+				}else if (Estimators[i] == "soergel") { 
+					calculators.push_back(new Soergel());
+				}else if (Estimators[i] == "spearman") { 
+					calculators.push_back(new Spearman());
+				}else if (Estimators[i] == "structkulczynski") { 
+					calculators.push_back(new StructKulczynski());
+				}else if (Estimators[i] == "speciesprofile") { 
+					calculators.push_back(new SpeciesProfile());
+				}else if (Estimators[i] == "hamming") { 
+					calculators.push_back(new Hamming());
+				}else if (Estimators[i] == "structchi2") { 
+					calculators.push_back(new StructChi2());
+				}else if (Estimators[i] == "gower") { 
+					calculators.push_back(new Gower());
+				}else if (Estimators[i] == "memchi2") { 
+					calculators.push_back(new MemChi2());
+				}else if (Estimators[i] == "memchord") { 
+					calculators.push_back(new MemChord());
+				}else if (Estimators[i] == "memeuclidean") { 
+					calculators.push_back(new MemEuclidean());
+				}else if (Estimators[i] == "mempearson") { 
+					calculators.push_back(new MemPearson());
+				}else if (Estimators[i] == "jsd") {
+					calculators.push_back(new JSD());
+				}else if (Estimators[i] == "rjsd") {
+					calculators.push_back(new RJSD());
+				}
+			}
+		}
+		
+		return calculators;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SummarySharedCommand", "createCalculators");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
 
 int SummarySharedCommand::execute(){
 	try {
@@ -423,15 +435,7 @@ int SummarySharedCommand::execute(){
         }
 
 		
-		/******************************************************/
-		//comparison breakup to be used by different processes later
 		numGroups = lookup.size();
-		lines.resize(processors);
-		for (int i = 0; i < processors; i++) {
-			lines[i].start = int (sqrt(float(i)/float(processors)) * numGroups);
-			lines[i].end = int (sqrt(float(i+1)/float(processors)) * numGroups);
-		}		
-		/******************************************************/
 		
 		//if the users enters label "0.06" and there is no "0.06" in their file use the next lowest label.
 		set<string> processedLabels;
@@ -580,309 +584,102 @@ int SummarySharedCommand::printSims(ostream& out, vector< vector<double> >& simM
 /***********************************************************/
 int SummarySharedCommand::process(vector<SharedRAbundVector*> thisLookup, string sumFileName, string sumAllFileName) {
 	try {
-        vector< vector< vector<seqDist> > > calcDistsTotals;  //each iter, one for each calc, then each groupCombos dists. this will be used to make .dist files
-        vector< vector<seqDist>  > calcDists; calcDists.resize(sumCalculators.size()); 		
-        
-        for (int thisIter = 0; thisIter < iters+1; thisIter++) {
-            
-            vector<SharedRAbundVector*> thisItersLookup = thisLookup;
-            
-            if (subsample && (thisIter != 0)) { //we want the summary results for the whole dataset, then the subsampling
-                SubSample sample;
-                vector<string> tempLabels; //dont need since we arent printing the sampled sharedRabunds
-                
-                //make copy of lookup so we don't get access violations
-                vector<SharedRAbundVector*> newLookup;
-                for (int k = 0; k < thisItersLookup.size(); k++) {
-                    SharedRAbundVector* temp = new SharedRAbundVector();
-                    temp->setLabel(thisItersLookup[k]->getLabel());
-                    temp->setGroup(thisItersLookup[k]->getGroup());
-                    newLookup.push_back(temp);
-                }
-                
-                //for each bin
-                for (int k = 0; k < thisItersLookup[0]->getNumBins(); k++) {
-                    if (m->control_pressed) { for (int j = 0; j < newLookup.size(); j++) {  delete newLookup[j];  } return 0; }
-                    for (int j = 0; j < thisItersLookup.size(); j++) { newLookup[j]->push_back(thisItersLookup[j]->getAbundance(k), thisItersLookup[j]->getGroup()); }
-                }
-                
-                tempLabels = sample.getSample(newLookup, subsampleSize);
-                thisItersLookup = newLookup;
-            }
-        
-            
-            if(processors == 1){
-                driver(thisItersLookup, 0, numGroups, sumFileName+".temp", sumAllFileName+".temp", calcDists);
-                m->appendFiles((sumFileName + ".temp"), sumFileName);
-                m->mothurRemove((sumFileName + ".temp"));
-                if (mult) {
-                    m->appendFiles((sumAllFileName + ".temp"), sumAllFileName);
-                    m->mothurRemove((sumAllFileName + ".temp"));
-                }
-            }else{
-                
-                int process = 1;
-                vector<int> processIDS;
-                bool recalc = false;
-                
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-                //loop through and create all the processes you want
-                while (process != processors) {
-                    pid_t pid = fork();
-                    
-                    if (pid > 0) {
-                        processIDS.push_back(pid); 
-                        process++;
-                    }else if (pid == 0){
-                        driver(thisItersLookup, lines[process].start, lines[process].end, sumFileName + m->mothurGetpid(process) + ".temp", sumAllFileName + m->mothurGetpid(process) + ".temp", calcDists);
-                        
-                        //only do this if you want a distance file
-                        if (createPhylip) {
-                            string tempdistFileName = m->getRootName(m->getSimpleName(sumFileName)) + m->mothurGetpid(process) + ".dist";
-                            ofstream outtemp;
-                            m->openOutputFile(tempdistFileName, outtemp);
-                            
-                            for (int i = 0; i < calcDists.size(); i++) {
-                                outtemp << calcDists[i].size() << endl;
-                                
-                                for (int j = 0; j < calcDists[i].size(); j++) {
-                                    outtemp << calcDists[i][j].seq1 << '\t' << calcDists[i][j].seq2 << '\t' << calcDists[i][j].dist << endl;
-                                }
-                            }
-                            outtemp.close();
-                        }
-                        
-                        exit(0);
-                    }else { 
-                        m->mothurOut("[ERROR]: unable to spawn the number of processes you requested, reducing number to " + toString(process) + "\n"); processors = process;
-                        for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); }
-                        //wait to die
-                        for (int i=0;i<processIDS.size();i++) {
-                            int temp = processIDS[i];
-                            wait(&temp);
-                        }
-                        m->control_pressed = false;
-                        for (int i=0;i<processIDS.size();i++) {
-                            m->mothurRemove(sumFileName + (toString(processIDS[i]) + ".temp"));
-                            m->mothurRemove(sumAllFileName + (toString(processIDS[i]) + ".temp"));
-                            if (createPhylip) { m->mothurRemove(m->getRootName(m->getSimpleName(sumFileName)) + (toString(processIDS[i]) + ".dist")); }
-                        }
-                        recalc = true;
-                        break;
-                    }
-                }
-                
-                if (recalc) {
-                    //test line, also set recalc to true.
-                    //for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); } for (int i=0;i<processIDS.size();i++) { int temp = processIDS[i]; wait(&temp); } m->control_pressed = false;  for (int i=0;i<processIDS.size();i++) {m->mothurRemove(sumFileName + (toString(processIDS[i]) + ".temp"));m->mothurRemove(sumAllFileName + (toString(processIDS[i]) + ".temp"));if (createPhylip) { m->mothurRemove(m->getRootName(m->getSimpleName(sumFileName)) + (toString(processIDS[i]) + ".dist")); }}processors=3; m->mothurOut("[ERROR]: unable to spawn the number of processes you requested, reducing number to " + toString(processors) + "\n");
-                    
-                    /******************************************************/
-                    //comparison breakup to be used by different processes later
-                    lines.clear();
-                    numGroups = thisLookup.size();
-                    lines.resize(processors);
-                    for (int i = 0; i < processors; i++) {
-                        lines[i].start = int (sqrt(float(i)/float(processors)) * numGroups);
-                        lines[i].end = int (sqrt(float(i+1)/float(processors)) * numGroups);
-                    }		
-                    /******************************************************/
-                    
-                    calcDists.clear(); calcDists.resize(sumCalculators.size());
-                    processIDS.resize(0);
-                    process = 1;
-                    
-                    //loop through and create all the processes you want
-                    while (process != processors) {
-                        pid_t pid = fork();
-                        
-                        if (pid > 0) {
-                            processIDS.push_back(pid);
-                            process++;
-                        }else if (pid == 0){
-                            driver(thisItersLookup, lines[process].start, lines[process].end, sumFileName + m->mothurGetpid(process) + ".temp", sumAllFileName + m->mothurGetpid(process) + ".temp", calcDists);
-                            
-                            //only do this if you want a distance file
-                            if (createPhylip) {
-                                string tempdistFileName = m->getRootName(m->getSimpleName(sumFileName)) + m->mothurGetpid(process) + ".dist";
-                                ofstream outtemp;
-                                m->openOutputFile(tempdistFileName, outtemp);
-                                
-                                for (int i = 0; i < calcDists.size(); i++) {
-                                    outtemp << calcDists[i].size() << endl;
-                                    
-                                    for (int j = 0; j < calcDists[i].size(); j++) {
-                                        outtemp << calcDists[i][j].seq1 << '\t' << calcDists[i][j].seq2 << '\t' << calcDists[i][j].dist << endl;
-                                    }
-                                }
-                                outtemp.close();
-                            }
-                            
-                            exit(0);
-                        }else {
-                            m->mothurOut("[ERROR]: unable to spawn the necessary processes."); m->mothurOutEndLine();
-                            for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); }
-                            exit(0);
-                        }
-                    }
-                    
-                }
-
-                //parent do your part
-                driver(thisItersLookup, lines[0].start, lines[0].end, sumFileName + m->mothurGetpid(process) + ".temp", sumAllFileName + m->mothurGetpid(process) + ".temp", calcDists);
-                m->appendFiles((sumFileName + m->mothurGetpid(process) + ".temp"), sumFileName);
-                m->mothurRemove((sumFileName + m->mothurGetpid(process) + ".temp"));
-                if (mult) { m->appendFiles((sumAllFileName + m->mothurGetpid(process) + ".temp"), sumAllFileName); }
-                
-                //force parent to wait until all the processes are done
-                for (int i = 0; i < processIDS.size(); i++) {
-                    int temp = processIDS[i];
-                    wait(&temp);
-                }
-                
-                for (int i = 0; i < processIDS.size(); i++) {
-                    m->appendFiles((sumFileName + toString(processIDS[i]) + ".temp"), sumFileName);
-                    m->mothurRemove((sumFileName + toString(processIDS[i]) + ".temp"));
-                    if (mult) {	m->mothurRemove((sumAllFileName + toString(processIDS[i]) + ".temp"));	}
-                    
-                    if (createPhylip) {
-                        string tempdistFileName = m->getRootName(m->getSimpleName(sumFileName)) + toString(processIDS[i]) +  ".dist";
-                        ifstream intemp;
-                        m->openInputFile(tempdistFileName, intemp);
-                        
-                        for (int k = 0; k < calcDists.size(); k++) {
-                            int size = 0;
-                            intemp >> size; m->gobble(intemp);
-                            
-                            for (int j = 0; j < size; j++) {
-                                int seq1 = 0;
-                                int seq2 = 0;
-                                float dist = 1.0;
-                                
-                                intemp >> seq1 >> seq2 >> dist;   m->gobble(intemp);
-                                
-                                seqDist tempDist(seq1, seq2, dist);
-                                calcDists[k].push_back(tempDist);
-                            }
-                        }
-                        intemp.close();
-                        m->mothurRemove(tempdistFileName);
-                    }
-                }
-#else
-                //////////////////////////////////////////////////////////////////////////////////////////////////////
-                //Windows version shared memory, so be careful when passing variables through the summarySharedData struct. 
-                //Above fork() will clone, so memory is separate, but that's not the case with windows, 
-                //Taking advantage of shared memory to pass results vectors.
-                //////////////////////////////////////////////////////////////////////////////////////////////////////
-                
-                vector<summarySharedData*> pDataArray; 
-                DWORD   dwThreadIdArray[processors-1];
-                HANDLE  hThreadArray[processors-1];
-                
-                //Create processor worker threads.
-                for( int i=1; i<processors; i++ ){
-                    
-                    //make copy of lookup so we don't get access violations
-                    vector<SharedRAbundVector*> newLookup;
-                    for (int k = 0; k < thisLookup.size(); k++) {
-                        SharedRAbundVector* temp = new SharedRAbundVector();
-                        temp->setLabel(thisLookup[k]->getLabel());
-                        temp->setGroup(thisLookup[k]->getGroup());
-                        newLookup.push_back(temp);
-                    }
-                
-                    
-                    //for each bin
-                    for (int k = 0; k < thisItersLookup[0]->getNumBins(); k++) {
-                        if (m->control_pressed) { for (int j = 0; j < newLookup.size(); j++) {  delete newLookup[j];  } return 0; }
-                        for (int j = 0; j < thisItersLookup.size(); j++) { newLookup[j]->push_back(thisItersLookup[j]->getAbundance(k), thisItersLookup[j]->getGroup()); }
-                    }
-                    
-                    // Allocate memory for thread data.
-                    summarySharedData* tempSum = new summarySharedData((sumFileName+toString(i)+".temp"), m, lines[i].start, lines[i].end, Estimators, newLookup);
-                    pDataArray.push_back(tempSum);
-                    processIDS.push_back(i);
-                    
-                    hThreadArray[i-1] = CreateThread(NULL, 0, MySummarySharedThreadFunction, pDataArray[i-1], 0, &dwThreadIdArray[i-1]);   
-                }
-                
-                //parent do your part
-                driver(thisItersLookup, lines[0].start, lines[0].end, sumFileName +"0.temp", sumAllFileName + "0.temp", calcDists);
-                m->appendFiles((sumFileName + "0.temp"), sumFileName);
-                m->mothurRemove((sumFileName + "0.temp"));
-                if (mult) { m->appendFiles((sumAllFileName + "0.temp"), sumAllFileName); }
-                
-                //Wait until all threads have terminated.
-                WaitForMultipleObjects(processors-1, hThreadArray, TRUE, INFINITE);
-                
-                //Close all thread handles and free memory allocations.
-                for(int i=0; i < pDataArray.size(); i++){
-                    if (pDataArray[i]->count != (pDataArray[i]->end-pDataArray[i]->start)) {
-                        m->mothurOut("[ERROR]: process " + toString(i) + " only processed " + toString(pDataArray[i]->count) + " of " + toString(pDataArray[i]->end-pDataArray[i]->start) + " groups assigned to it, quitting. \n"); m->control_pressed = true; 
-                    }
-                    m->appendFiles((sumFileName + toString(processIDS[i]) + ".temp"), sumFileName);
-                    m->mothurRemove((sumFileName + toString(processIDS[i]) + ".temp"));
-                    
-                    for (int j = 0; j < pDataArray[i]->thisLookup.size(); j++) {  delete pDataArray[i]->thisLookup[j];  }
-                    
-                    if (createPhylip) {
-                        for (int k = 0; k < calcDists.size(); k++) {
-                            int size = pDataArray[i]->calcDists[k].size();
-                            for (int j = 0; j < size; j++) {    calcDists[k].push_back(pDataArray[i]->calcDists[k][j]);    }
-                        }
-                    }
-                    
-                    CloseHandle(hThreadArray[i]);
-                    delete pDataArray[i];
-                }
-                
-#endif
-            }
-            
-            if (subsample && (thisIter != 0)) { //we want the summary results for the whole dataset, then the subsampling
-                
-                calcDistsTotals.push_back(calcDists); 
-                //clean up memory
-                for (int i = 0; i < thisItersLookup.size(); i++) { delete thisItersLookup[i]; }
-                thisItersLookup.clear();
-            }else {
-                if (createPhylip) {
-                    for (int i = 0; i < calcDists.size(); i++) {
-                        if (m->control_pressed) { break; }
-                        
-                        //initialize matrix
-                        vector< vector<double> > matrix; //square matrix to represent the distance
-                        matrix.resize(thisLookup.size());
-                        for (int k = 0; k < thisLookup.size(); k++) {  matrix[k].resize(thisLookup.size(), 0.0); }
-                        
-                        for (int j = 0; j < calcDists[i].size(); j++) {
-                            int row = calcDists[i][j].seq1;
-                            int column = calcDists[i][j].seq2;
-                            double dist = calcDists[i][j].dist;
-                            
-                            matrix[row][column] = dist;
-                            matrix[column][row] = dist;
-                        }
-                        
-                        map<string, string> variables; 
-                        variables["[filename]"] = outputDir + m->getRootName(m->getSimpleName(sharedfile));
-                        variables["[calc]"] = sumCalculators[i]->getName();
-                        variables["[distance]"] = thisLookup[0]->getLabel();
-                        variables["[outputtag]"] = output;
-                        variables["[tag2]"] = "";
-                        string distFileName = getOutputFileName("phylip",variables);
-                        outputNames.push_back(distFileName); outputTypes["phylip"].push_back(distFileName);
-                        ofstream outDist;
-                        m->openOutputFile(distFileName, outDist);
-                        outDist.setf(ios::fixed, ios::floatfield); outDist.setf(ios::showpoint);
-                        
-                        printSims(outDist, matrix);
-                        
-                        outDist.close();
-                    }
-                }
-            }
-            for (int i = 0; i < calcDists.size(); i++) {  calcDists[i].clear(); }
+		//each thread gets its own calculators, they keep their results in data. kstest sorts the pair it is given and
+		//puts it back, so the threads comparing the whole dataset each work on their own copy of it.
+		vector< vector<Calculator*> > calculators(processors);
+		vector< vector<SharedRAbundVector*> > threadLookups(processors);
+		calculators[0] = sumCalculators; threadLookups[0] = thisLookup;
+		for (int t = 1; t < processors; t++) {
+			calculators[t] = createCalculators();
+			for (int k = 0; k < thisLookup.size(); k++) { threadLookups[t].push_back(new SharedRAbundVector(*thisLookup[k])); }
+		}
+		
+		ofstream outSum, outAll;
+		m->openOutputFileAppend(sumFileName, outSum);
+		if (mult) { m->openOutputFileAppend(sumAllFileName, outAll); driverAll(thisLookup, outAll, sumCalculators); }
+		
+		//the rows of the whole dataset are divided among the threads, and written and merged in row order
+		vector< vector< vector<seqDist> > > rowDists(numGroups, vector< vector<seqDist> >(sumCalculators.size()));
+		OrderedOutput writer(outSum, 0);
+		ThreadPool::getInstance()->parallelForOrdered(0, numGroups, processors, [&](long long start, long long end, int threadID) {
+			ostringstream rows;
+			for (long long k = start; k < end; k++) { driver(threadLookups[threadID], k, k+1, rows, rowDists[k], calculators[threadID]); }
+			writer.commit(start, end, rows.str());
+		});
+		
+		vector< vector<seqDist>  > calcDists; calcDists.resize(sumCalculators.size());
+		for (int k = 0; k < rowDists.size(); k++) {
+			for (int i = 0; i < calcDists.size(); i++) { calcDists[i].insert(calcDists[i].end(), rowDists[k][i].begin(), rowDists[k][i].end()); }
+		}
+		rowDists.clear();
+		
+		//each iteration subsamples with its own random stream, so the results under set.seed are the same for any number of processors
+		vector< vector< vector<seqDist> > > calcDistsTotals(iters, vector< vector<seqDist> >(sumCalculators.size()));  //each iter, one for each calc, then each groupCombos dists. this will be used to make .dist files
+		if (subsample) {
+			unsigned long long baseSeed = m->getRandomNumber();
+			OrderedOutput iterWriter(outSum, 0), iterAllWriter(outAll, 0);
+			
+			ThreadPool::getInstance()->parallelForOrdered(0, iters, processors, [&](long long start, long long end, int threadID) {
+				SubSample sample;
+				ostringstream rows, allRows;
+				for (long long iter = start; iter < end; iter++) {
+					if (m->control_pressed) { break; }
+					
+					mt19937_64 rng(getStreamSeed(baseSeed, iter));
+					vector<SharedRAbundVector*> thisItersLookup = sample.getSamplePreserve(thisLookup, subsampleSize, rng);
+					if (mult) { driverAll(thisItersLookup, allRows, calculators[threadID]); }
+					driver(thisItersLookup, 0, numGroups, rows, calcDistsTotals[iter], calculators[threadID]);
+					for (int k = 0; k < thisItersLookup.size(); k++) { delete thisItersLookup[k]; }
+				}
+				iterWriter.commit(start, end, rows.str());
+				if (mult) { iterAllWriter.commit(start, end, allRows.str()); }
+			});
+		}
+		
+		outSum.close();
+		if (mult) { outAll.close(); }
+		
+		for (int t = 1; t < processors; t++) {
+			for (int i = 0; i < calculators[t].size(); i++) { delete calculators[t][i]; }
+			for (int k = 0; k < threadLookups[t].size(); k++) { delete threadLookups[t][k]; }
+		}
+		
+		if (m->control_pressed) { return 0; }
+		
+		if (createPhylip) {
+			for (int i = 0; i < calcDists.size(); i++) {
+				if (m->control_pressed) { break; }
+				
+				//initialize matrix
+				vector< vector<double> > matrix; //square matrix to represent the distance
+				matrix.resize(thisLookup.size());
+				for (int k = 0; k < thisLookup.size(); k++) {  matrix[k].resize(thisLookup.size(), 0.0); }
+				
+				for (int j = 0; j < calcDists[i].size(); j++) {
+					int row = calcDists[i][j].seq1;
+					int column = calcDists[i][j].seq2;
+					double dist = calcDists[i][j].dist;
+					
+					matrix[row][column] = dist;
+					matrix[column][row] = dist;
+				}
+				
+				map<string, string> variables; 
+				variables["[filename]"] = outputDir + m->getRootName(m->getSimpleName(sharedfile));
+				variables["[calc]"] = sumCalculators[i]->getName();
+				variables["[distance]"] = thisLookup[0]->getLabel();
+				variables["[outputtag]"] = output;
+				variables["[tag2]"] = "";
+				string distFileName = getOutputFileName("phylip",variables);
+				outputNames.push_back(distFileName); outputTypes["phylip"].push_back(distFileName);
+				ofstream outDist;
+				m->openOutputFile(distFileName, outDist);
+				outDist.setf(ios::fixed, ios::floatfield); outDist.setf(ios::showpoint);
+				
+				printSims(outDist, matrix);
+				
+				outDist.close();
+			}
 		}
 
         if (iters != 0) {
@@ -953,43 +750,48 @@ int SummarySharedCommand::process(vector<SharedRAbundVector*> thisLookup, string
 	}
 }
 /**************************************************************************************************/
-int SummarySharedCommand::driver(vector<SharedRAbundVector*> thisLookup, int start, int end, string sumFile, string sumAllFile, vector< vector<seqDist> >& calcDists) { 
+int SummarySharedCommand::driverAll(vector<SharedRAbundVector*> thisLookup, ostream& outAll, vector<Calculator*>& calculators) { 
 	try {
+		//output label
+		outAll << thisLookup[0]->getLabel() << '\t';
+		
+		//output groups names
+		string outNames = "";
+		for (int j = 0; j < thisLookup.size(); j++) {
+			outNames += thisLookup[j]->getGroup() +  "-";
+		}
+		outNames = outNames.substr(0, outNames.length()-1); //rip off extra '-';
+		outAll << outNames << '\t';
 		
 		//loop through calculators and add to file all for all calcs that can do mutiple groups
-		if (mult == true) {
-			ofstream outAll;
-			m->openOutputFile(sumAllFile, outAll);
-			
-			//output label
-			outAll << thisLookup[0]->getLabel() << '\t';
-			
-			//output groups names
-			string outNames = "";
-			for (int j = 0; j < thisLookup.size(); j++) {
-				outNames += thisLookup[j]->getGroup() +  "-";
-			}
-			outNames = outNames.substr(0, outNames.length()-1); //rip off extra '-';
-			outAll << outNames << '\t';
-			
-			for(int i=0;i<sumCalculators.size();i++){
-				if (sumCalculators[i]->getMultiple() == true) { 
-					sumCalculators[i]->getValues(thisLookup);
-					
-					if (m->control_pressed) { outAll.close(); return 1; }
-					
-					outAll << '\t';
-					sumCalculators[i]->print(outAll);
-				}
+		for(int i=0;i<calculators.size();i++){
+			if (calculators[i]->getMultiple() == true) { 
+				calculators[i]->getValues(thisLookup);
+				
+				if (m->control_pressed) { return 1; }
+				
+				outAll << '\t';
+				calculators[i]->print(outAll);
 			}
-			outAll << endl;
-			outAll.close();
 		}
+		outAll << endl;
 		
-		ofstream outputFileHandle;
-		m->openOutputFile(sumFile, outputFileHandle);
-		
+		return 0;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SummarySharedCommand", "driverAll");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+int SummarySharedCommand::driver(vector<SharedRAbundVector*> thisLookup, int start, int end, ostream& outputFileHandle, vector< vector<seqDist> >& calcDists, vector<Calculator*>& calculators) { 
+	try {
 		vector<SharedRAbundVector*> subset;
+		SharedUtil util;
+		
+		bool usePresentOtus = false;
+		for(int i=0;i<calculators.size();i++) { if (calculators[i]->getIgnoresEmptyOtus()) { usePresentOtus = true; } }
+		
 		for (int k = start; k < end; k++) { // pass cdd each set of groups to compare
 
 			for (int l = 0; l < k; l++) {
@@ -1000,6 +802,10 @@ int SummarySharedCommand::driver(vector<SharedRAbundVector*> thisLookup, int sta
 				//add new pair of sharedrabunds
 				subset.push_back(thisLookup[k]); subset.push_back(thisLookup[l]); 
 				
+				//with sparse groups most otus are in neither, so calcs that ignore them get the pair without them
+				vector<SharedRAbundVector*> presentSubset;
+				if (usePresentOtus) { util.getPresentOtus(subset, presentSubset); }
+				
 				//sort groups to be alphanumeric
 				if (thisLookup[k]->getGroup() > thisLookup[l]->getGroup()) {
 					outputFileHandle << (thisLookup[l]->getGroup() +'\t' + thisLookup[k]->getGroup()) << '\t'; //print out groups
@@ -1007,32 +813,34 @@ int SummarySharedCommand::driver(vector<SharedRAbundVector*> thisLookup, int sta
 					outputFileHandle << (thisLookup[k]->getGroup() +'\t' + thisLookup[l]->getGroup()) << '\t'; //print out groups
 				}
 				
-				for(int i=0;i<sumCalculators.size();i++) {
+				for(int i=0;i<calculators.size();i++) {
 					
 					//if this calc needs all groups to calculate the pair load all groups
-					if (sumCalculators[i]->getNeedsAll()) { 
+					if (calculators[i]->getNeedsAll()) { 
 						//load subset with rest of lookup for those calcs that need everyone to calc for a pair
 						for (int w = 0; w < thisLookup.size(); w++) {
 							if ((w != k) && (w != l)) { subset.push_back(thisLookup[w]); }
 						}
 					}
 					
-					vector<double> tempdata = sumCalculators[i]->getValues(subset); //saves the calculator outputs
+					vector<double> tempdata;
+					if ((presentSubset.size() != 0) && calculators[i]->getIgnoresEmptyOtus()) { tempdata = calculators[i]->getValues(presentSubset); }
+					else { tempdata = calculators[i]->getValues(subset); } //saves the calculator outputs
 					
-					if (m->control_pressed) { outputFileHandle.close(); return 1; }
+					if (m->control_pressed) { for (int w = 0; w < presentSubset.size(); w++) { delete presentSubset[w]; } return 1; }
 					
 					outputFileHandle << '\t';
-					sumCalculators[i]->print(outputFileHandle);
+					calculators[i]->print(outputFileHandle);
 					
 					seqDist temp(l, k, tempdata[0]);
 					calcDists[i].push_back(temp);
 				}
 				outputFileHandle << endl;
+				
+				for (int w = 0; w < presentSubset.size(); w++) { delete presentSubset[w]; }
 			}
 		}
 		
-		outputFileHandle.close();
-		
 		return 0;
 	}
 	catch(exception& e) {
@@ -78,54 +78,50 @@ void Alignment::traceBack(){			//	This traceback routine is used by the dynamic
 		//	seqAstart = 1;
 		//	seqAend = column;
 		
-		AlignmentCell currentCell = alignment[row][column];	//	Start the traceback from the bottom-right corner of the
+		//	the alignments are built backwards and flipped at the end, each base is saved with its position from the end
+		vector<pair<int, int> > ABases, BBases;
+		
+		char prevCell = getPrevCell(row, column);	//	Start the traceback from the bottom-right corner of the
 		//	matrix
 		
-		if(currentCell.prevCell == 'x'){	seqAaln = seqBaln = "NOALIGNMENT";		}//If there's an 'x' in the bottom-
+		if(prevCell == 'x'){	seqAaln = seqBaln = "NOALIGNMENT";		}//If there's an 'x' in the bottom-
 		else{	//	right corner bail out because it means nothing got aligned
             int count = 0;
-			while(currentCell.prevCell != 'x'){				//	while the previous cell isn't an 'x', keep going...
+			seqAaln.reserve(lA+lB); seqBaln.reserve(lA+lB);
+			while(prevCell != 'x'){				//	while the previous cell isn't an 'x', keep going...
 				
-				if(currentCell.prevCell == 'u'){			//	if the pointer to the previous cell is 'u', go up in the
-					seqAaln = '-' + seqAaln;				//	matrix.  this indicates that we need to insert a gap in
-					seqBaln = seqB[row] + seqBaln;			//	seqA and a base in seqB
-                    BBaseMap[row] = count;
-					currentCell = alignment[--row][column];
+				if(prevCell == 'u'){			//	if the pointer to the previous cell is 'u', go up in the
+					seqAaln += '-';							//	matrix.  this indicates that we need to insert a gap in
+					seqBaln += seqB[row];					//	seqA and a base in seqB
+                    BBases.push_back(make_pair(count, row-1));
+					prevCell = getPrevCell(--row, column);
 				}
-				else if(currentCell.prevCell == 'l'){		//	if the pointer to the previous cell is 'l', go to the left
-					seqBaln = '-' + seqBaln;				//	in the matrix.  this indicates that we need to insert a gap
-					seqAaln = seqA[column] + seqAaln;		//	in seqB and a base in seqA
-                    ABaseMap[column] = count;
-					currentCell = alignment[row][--column];
+				else if(prevCell == 'l'){		//	if the pointer to the previous cell is 'l', go to the left
+					seqBaln += '-';							//	in the matrix.  this indicates that we need to insert a gap
+					seqAaln += seqA[column];				//	in seqB and a base in seqA
+                    ABases.push_back(make_pair(count, column-1));
+					prevCell = getPrevCell(row, --column);
 				}
 				else{
-					seqAaln = seqA[column] + seqAaln;		//	otherwise we need to go diagonally up and to the left,
-					seqBaln = seqB[row] + seqBaln;			//	here we add a base to both alignments
-                    BBaseMap[row] = count;
-                    ABaseMap[column] = count;
-					currentCell = alignment[--row][--column];
+					seqAaln += seqA[column];				//	otherwise we need to go diagonally up and to the left,
+					seqBaln += seqB[row];					//	here we add a base to both alignments
+                    BBases.push_back(make_pair(count, row-1));
+                    ABases.push_back(make_pair(count, column-1));
+					prevCell = getPrevCell(--row, --column);
 				}
                 count++;
 			}
+			reverse(seqAaln.begin(), seqAaln.end());
+			reverse(seqBaln.begin(), seqBaln.end());
 		}
 		
        
         pairwiseLength = seqAaln.length();
 		seqAstart = 1;	seqAend = 0;
 		seqBstart = 1;	seqBend = 0;
-        //flip maps since we now know the total length
-        map<int, int> newAMap;
-        for (map<int, int>::iterator it = ABaseMap.begin(); it != ABaseMap.end(); it++) {
-            int spot = it->second;
-            newAMap[pairwiseLength-spot-1] = it->first-1;
-        }
-        ABaseMap = newAMap;
-        map<int, int> newBMap;
-        for (map<int, int>::iterator it = BBaseMap.begin(); it != BBaseMap.end(); it++) {
-            int spot = it->second;
-            newBMap[pairwiseLength-spot-1] = it->first-1;
-        }
-		BBaseMap = newBMap;
+        //flip maps since we now know the total length, the last base saved is the first in the alignment
+        for (int i = ABases.size()-1; i >= 0; i--) { ABaseMap.insert(ABaseMap.end(), make_pair(pairwiseLength-ABases[i].first-1, ABases[i].second)); }
+        for (int i = BBases.size()-1; i >= 0; i--) { BBaseMap.insert(BBaseMap.end(), make_pair(pairwiseLength-BBases[i].first-1, BBases[i].second)); }
         
 		for(int i=0;i<seqAaln.length();i++){
 			if(seqAaln[i] != '-' && seqBaln[i] == '-')		{	seqAstart++;	}
@@ -151,6 +147,44 @@ void Alignment::traceBack(){			//	This traceback routine is used by the dynamic
 	}
 }
 /**************************************************************************************************/
+//true if the base in seq matches the oligo base, oligo may be ambiguous
+bool Alignment::isEquivalent(char oligo, char seq){
+	try {
+		
+        bool same = true;
+					
+        oligo = toupper(oligo);
+        seq = toupper(seq);
+        
+        if(oligo != seq){
+            if(oligo == 'A' && (seq != 'A' && seq != 'M' && seq != 'R' && seq != 'W' && seq != 'D' && seq != 'H' && seq != 'V'))       {	same = false;	}
+            else if(oligo == 'C' && (seq != 'C' && seq != 'Y' && seq != 'M' && seq != 'S' && seq != 'B' && seq != 'H' && seq != 'V'))       {	same = false;	}
+            else if(oligo == 'G' && (seq != 'G' && seq != 'R' && seq != 'K' && seq != 'S' && seq != 'B' && seq != 'D' && seq != 'V'))       {	same = false;	}
+            else if(oligo == 'T' && (seq != 'T' && seq != 'Y' && seq != 'K' && seq != 'W' && seq != 'B' && seq != 'D' && seq != 'H'))       {	same = false;	}
+            else if((oligo == '.' || oligo == '-'))           {	same = false;	}
+            else if((oligo == 'N' || oligo == 'I') && (seq == 'N'))                         {	same = false;	}
+            else if(oligo == 'R' && (seq != 'A' && seq != 'G'))                        {	same = false;	}
+            else if(oligo == 'Y' && (seq != 'C' && seq != 'T'))                        {	same = false;	}
+            else if(oligo == 'M' && (seq != 'C' && seq != 'A'))                        {	same = false;	}
+            else if(oligo == 'K' && (seq != 'T' && seq != 'G'))                        {	same = false;	}
+            else if(oligo == 'W' && (seq != 'T' && seq != 'A'))                        {	same = false;	}
+            else if(oligo == 'S' && (seq != 'C' && seq != 'G'))                        {	same = false;	}
+            else if(oligo == 'B' && (seq != 'C' && seq != 'T' && seq != 'G'))       {	same = false;	}
+            else if(oligo == 'D' && (seq != 'A' && seq != 'T' && seq != 'G'))       {	same = false;	}
+            else if(oligo == 'H' && (seq != 'A' && seq != 'T' && seq != 'C'))       {	same = false;	}
+            else if(oligo == 'V' && (seq != 'A' && seq != 'C' && seq != 'G'))       {	same = false;	}
+        }
+
+		
+		
+		return same;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Alignment", "isEquivalent");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
 
 Alignment::~Alignment(){
 	try {
@@ -40,12 +40,14 @@ public:
 	int getTemplateEndPos();
 	
 	int getPairwiseLength();
-	void resize(int);
+	virtual void resize(int);
 	int getnRows() { return nRows; }
 //	int getLongestTemplateGap();
 
 protected:
 	void traceBack();
+	virtual char getPrevCell(int row, int column) { return alignment[row][column].prevCell; }
+	bool isEquivalent(char, char);
 	string seqA, seqAaln;
 	string seqB, seqBaln;
 	int seqAstart, seqAend;
@@ -8,16 +8,31 @@
 
 #include "counttable.h"
 
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+	#include <sys/stat.h>
+#endif
+
+static const char countTableMagic[8] = { 'M', 'O', 'T', 'H', 'U', 'R', 'C', 'T' };
+static const unsigned int countTableVersion = 2;
+static const long long countTableBinaryMinSize = 16 * 1024 * 1024; //smaller tables parse quickly enough
+
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+//nanoseconds of the modified time, so an edit within the same second as the save is still seen
+static long long getModifiedNsec(struct stat& info) {
+#if defined (__APPLE__) || (__MACH__)
+    return info.st_mtimespec.tv_nsec;
+#else
+    return info.st_mtim.tv_nsec;
+#endif
+}
+#endif
+
 /************************************************************/
 int CountTable::createTable(set<string>& n, map<string, string>& g, set<string>& gs) {
     try {
         hasGroups = false;
         int numGroups = 0;
-        groups.clear();
-        totalGroups.clear();
-        indexGroupMap.clear();
-        indexNameMap.clear();
-        counts.clear();
+        clearTable();
         for (set<string>::iterator it = gs.begin(); it != gs.end(); it++) { groups.push_back(*it);  hasGroups = true; }
         numGroups = groups.size();
         totalGroups.resize(numGroups, 0);
@@ -37,11 +52,11 @@ int CountTable::createTable(set<string>& n, map<string, string>& g, set<string>&
             
             string seqName = *it;
             
-            vector<int> groupCounts; groupCounts.resize(numGroups, 0);
+            vector<GroupCount> groupCounts;
             map<string, string>::iterator itGroup = g.find(seqName);
             
             if (itGroup != g.end()) {   
-                groupCounts[indexGroupMap[itGroup->second]] = 1; 
+                groupCounts.push_back(GroupCount(indexGroupMap[itGroup->second], 1));
                 totalGroups[indexGroupMap[itGroup->second]]++;
             }else {
                 //look for it in names of groups to see if the user accidently used the wrong file
@@ -51,13 +66,8 @@ int CountTable::createTable(set<string>& n, map<string, string>& g, set<string>&
                 m->mothurOut("[ERROR]: Your group file does not contain " + seqName + ". Please correct."); m->mothurOutEndLine();
             }
             
-            map<string, int>::iterator it2 = indexNameMap.find(seqName);
-            if (it2 == indexNameMap.end()) {
-                if (hasGroups) {  counts.push_back(groupCounts);  }
-                indexNameMap[seqName] = uniques;
-                totals.push_back(1);
+            if (addSeq(seqName, 1, groupCounts) != -1) {
                 total++;
-                uniques++;
             }else {
                 error = true;
                 m->mothurOut("[ERROR]: Your count table contains more than 1 sequence named " + seqName + ", sequence names must be unique. Please correct."); m->mothurOutEndLine();
@@ -148,11 +158,7 @@ int CountTable::createTable(string namefile, string groupfile, bool createGroup)
                                            
         GroupMap* groupMap;
         int numGroups = 0;
-        groups.clear();
-        totalGroups.clear();
-        indexGroupMap.clear();
-        indexNameMap.clear();
-        counts.clear();
+        clearTable();
         map<int, string> originalGroupIndexes;
         
         if (groupfile != "") { 
@@ -225,19 +231,15 @@ int CountTable::createTable(string namefile, string groupfile, bool createGroup)
             }else { thisTotal = names.size();  }
             
             //if group info, then read it
-            vector<int> thisGroupsCount; thisGroupsCount.resize(numGroups, 0);
+            vector<GroupCount> thisGroupsCount;
             for (int i = 0; i < numGroups; i++) {  
-                thisGroupsCount[i] = groupCounts[groups[i]]; 
-                totalGroups[i] += thisGroupsCount[i]; 
+                int thisCount = groupCounts[groups[i]];
+                if (thisCount != 0) { thisGroupsCount.push_back(GroupCount(i, thisCount)); }
+                totalGroups[i] += thisCount; 
             }
             
-            map<string, int>::iterator it = indexNameMap.find(firstCol);
-            if (it == indexNameMap.end()) {
-                if (hasGroups) {  counts.push_back(thisGroupsCount);  }
-                indexNameMap[firstCol] = uniques;
-                totals.push_back(thisTotal);
+            if (addSeq(firstCol, thisTotal, thisGroupsCount) != -1) {
                 total += thisTotal;
-                uniques++;
             }else {
                 error = true;
                 m->mothurOut("[ERROR]: Your count table contains more than 1 sequence named " + firstCol + ", sequence names must be unique. Please correct."); m->mothurOutEndLine(); 
@@ -266,6 +268,10 @@ int CountTable::createTable(string namefile, string groupfile, bool createGroup)
 int CountTable::readTable(string file, bool readGroups, bool mothurRunning) {
     try {
         filename = file;
+        
+        bool error = false;
+        if (!m->countCache || !readBinaryTable(filename, readGroups, mothurRunning)) {
+        
         ifstream in;
         m->openInputFile(filename, in);
         
@@ -273,11 +279,7 @@ int CountTable::readTable(string file, bool readGroups, bool mothurRunning) {
         vector<string> columnHeaders = m->splitWhiteSpace(headers);
         
         int numGroups = 0;
-        groups.clear();
-        totalGroups.clear();
-        indexGroupMap.clear();
-        indexNameMap.clear();
-        counts.clear();
+        clearTable();
         map<int, string> originalGroupIndexes;
         if ((columnHeaders.size() > 2) && readGroups) { hasGroups = true; numGroups = columnHeaders.size() - 2;  }
         for (int i = 2; i < columnHeaders.size(); i++) {  groups.push_back(columnHeaders[i]);  originalGroupIndexes[i-2] = columnHeaders[i]; totalGroups.push_back(0); }
@@ -286,7 +288,10 @@ int CountTable::readTable(string file, bool readGroups, bool mothurRunning) {
         for (int i = 0; i < groups.size(); i++) {  indexGroupMap[groups[i]] = i; }
         m->setAllGroups(groups);
         
-        bool error = false;
+        vector<int> columnGroupIndexes; //column in file -> sorted group index
+        for (int i = 0; i < numGroups; i++) {  columnGroupIndexes.push_back(indexGroupMap[originalGroupIndexes[i]]); }
+        
+        bool hasZeroTotals = false;
         string name;
         int thisTotal;
         uniques = 0;
@@ -298,26 +303,27 @@ int CountTable::readTable(string file, bool readGroups, bool mothurRunning) {
             in >> name; m->gobble(in); in >> thisTotal; m->gobble(in);
             if (m->debug) { m->mothurOut("[DEBUG]: " + name + '\t' + toString(thisTotal) + "\n"); }
             
+            if (thisTotal == 0) { hasZeroTotals = true; }
             if ((thisTotal == 0) && !mothurRunning) { error=true; m->mothurOut("[ERROR]: Your count table contains a sequence named " + name + " with a total=0. Please correct."); m->mothurOutEndLine();
             }
             
             //if group info, then read it
-            vector<int> groupCounts; groupCounts.resize(numGroups, 0);
+            vector<GroupCount> groupCounts;
             if (columnHeaders.size() > 2) { //file contains groups
                 if (readGroups) { //user wants to save them
-                    for (int i = 0; i < numGroups; i++) {  int thisIndex = indexGroupMap[originalGroupIndexes[i]]; in >> groupCounts[thisIndex]; m->gobble(in); totalGroups[thisIndex] += groupCounts[thisIndex];  }
+                    for (int i = 0; i < numGroups; i++) {
+                        int thisIndex = columnGroupIndexes[i]; int thisCount = 0;
+                        in >> thisCount; m->gobble(in);
+                        if (thisCount != 0) { groupCounts.push_back(GroupCount(thisIndex, thisCount)); totalGroups[thisIndex] += thisCount; }
+                    }
+                    sort(groupCounts.begin(), groupCounts.end());
                 }else { //read and discard
                     m->getline(in); m->gobble(in);
                 }
             }
             
-            map<string, int>::iterator it = indexNameMap.find(name);
-            if (it == indexNameMap.end()) {
-                if (hasGroups) {  counts.push_back(groupCounts);  }
-                indexNameMap[name] = uniques;
-                totals.push_back(thisTotal);
+            if (addSeq(name, thisTotal, groupCounts) != -1) {
                 total += thisTotal;
-                uniques++;
             }else {
                 error = true;
                 m->mothurOut("[ERROR]: Your count table contains more than 1 sequence named " + name + ", sequence names must be unique. Please correct."); m->mothurOutEndLine(); 
@@ -325,6 +331,9 @@ int CountTable::readTable(string file, bool readGroups, bool mothurRunning) {
         }
         in.close();
         
+        if (!error && readGroups && m->countCache && !m->control_pressed) { writeBinaryTable(filename, hasZeroTotals); }
+        }
+        
         if (error) { m->control_pressed = true; }
         else { //check for zero groups
             if (hasGroups) {
@@ -350,32 +359,22 @@ int CountTable::printTable(string file) {
         for (int i = 0; i < groups.size(); i++) { out << '\t' << groups[i]; }
         out << endl;
         
-        map<int, string> reverse; //use this to preserve order
-        for (map<string, int>::iterator it = indexNameMap.begin(); it !=indexNameMap.end(); it++) { reverse[it->second] = it->first;  }
+        //a saved table from an earlier read of this file no longer matches it
+        m->mothurRemove(getBinaryName(file));
         
         for (int i = 0; i < totals.size(); i++) {
-            map<int, string>::iterator itR = reverse.find(i);
-            
-            if (itR != reverse.end()) { //will equal end if seqs were removed because remove just removes from indexNameMap
-                out << itR->second << '\t' << totals[i];
+            if (seqNames[i] != NULL) { //will equal NULL if seqs were removed because remove just removes from indexNameMap
+                out << *seqNames[i] << '\t' << totals[i];
                 if (hasGroups) {
+                    int next = 0;
                     for (int j = 0; j < groups.size(); j++) {
-                        out << '\t' << counts[i][j];
+                        if ((next < counts[i].size()) && (counts[i][next].group == j)) { out << '\t' << counts[i][next].abund; next++; }
+                        else { out << "\t0"; }
                     }
                 }
                 out << endl;
             }
         }
-        /*for (map<string, int>::iterator itNames = indexNameMap.begin(); itNames != indexNameMap.end(); itNames++) {
-            out << itNames->first << '\t' << totals[itNames->second];
-            if (hasGroups) {
-                
-                for (int i = 0; i < groups.size(); i++) {
-                    out << '\t' << counts[itNames->second][i];
-                }
-            }
-            out << endl;
-        }*/
         out.close();
         return 0;
     }
@@ -400,14 +399,14 @@ int CountTable::printHeaders(ofstream& out) {
 /************************************************************/
 int CountTable::printSeq(ofstream& out, string seqName) {
     try {
-		map<string, int>::iterator it = indexNameMap.find(seqName);
+		unordered_map<string, int>::iterator it = indexNameMap.find(seqName);
         if (it == indexNameMap.end()) {
             m->mothurOut("[ERROR]: " + seqName + " is not in your count table. Please correct.\n"); m->control_pressed = true;
         }else { 
             out << it->first << '\t' << totals[it->second];
             if (hasGroups) {
                 for (int i = 0; i < groups.size(); i++) {
-                    out << '\t' << counts[it->second][i];
+                    out << '\t' << getAbund(it->second, i);
                 }
             }
             out << endl;
@@ -425,7 +424,7 @@ vector<int> CountTable::getGroupCounts(string seqName) {
     try {
         vector<int> temp;
         if (hasGroups) {
-            map<string, int>::iterator it = indexNameMap.find(seqName);
+            unordered_map<string, int>::iterator it = indexNameMap.find(seqName);
             if (it == indexNameMap.end()) {
                 //look for it in names of groups to see if the user accidently used the wrong file
                 if (m->inUsersGroups(seqName, groups)) {
@@ -433,7 +432,8 @@ vector<int> CountTable::getGroupCounts(string seqName) {
                 }
                 m->mothurOut("[ERROR]: " + seqName + " is not in your count table. Please correct.\n"); m->control_pressed = true;
             }else { 
-                temp = counts[it->second];
+                temp.resize(groups.size(), 0);
+                for (int i = 0; i < counts[it->second].size(); i++) {  temp[counts[it->second][i].group] = counts[it->second][i].abund; }
             }
         }else{  m->mothurOut("[ERROR]: Your count table does not have group info. Please correct.\n"); m->control_pressed = true; }
         
@@ -449,7 +449,7 @@ vector<int> CountTable::getGroupCounts(string seqName) {
 int CountTable::getGroupCount(string groupName) {
     try {
         if (hasGroups) {
-            map<string, int>::iterator it = indexGroupMap.find(groupName);
+            unordered_map<string, int>::iterator it = indexGroupMap.find(groupName);
             if (it == indexGroupMap.end()) {
                 m->mothurOut("[ERROR]: group " + groupName + " is not in your count table. Please correct.\n"); m->control_pressed = true;
             }else { 
@@ -469,11 +469,11 @@ int CountTable::getGroupCount(string groupName) {
 int CountTable::getGroupCount(string seqName, string groupName) {
     try {
         if (hasGroups) {
-            map<string, int>::iterator it = indexGroupMap.find(groupName);
+            unordered_map<string, int>::iterator it = indexGroupMap.find(groupName);
             if (it == indexGroupMap.end()) {
                 m->mothurOut("[ERROR]: group " + groupName + " is not in your count table. Please correct.\n"); m->control_pressed = true;
             }else { 
-                map<string, int>::iterator it2 = indexNameMap.find(seqName);
+                unordered_map<string, int>::iterator it2 = indexNameMap.find(seqName);
                 if (it2 == indexNameMap.end()) {
                     //look for it in names of groups to see if the user accidently used the wrong file
                     if (m->inUsersGroups(seqName, groups)) {
@@ -481,7 +481,7 @@ int CountTable::getGroupCount(string seqName, string groupName) {
                     }
                     m->mothurOut("[ERROR]: seq " + seqName + " is not in your count table. Please correct.\n"); m->control_pressed = true;
                 }else { 
-                    return counts[it2->second][it->second];
+                    return getAbund(it2->second, it->second);
                 }
             }
         }else{  m->mothurOut("[ERROR]: Your count table does not have group info. Please correct.\n");  m->control_pressed = true; }
@@ -498,11 +498,11 @@ int CountTable::getGroupCount(string seqName, string groupName) {
 int CountTable::setAbund(string seqName, string groupName, int num) {
     try {
         if (hasGroups) {
-            map<string, int>::iterator it = indexGroupMap.find(groupName);
+            unordered_map<string, int>::iterator it = indexGroupMap.find(groupName);
             if (it == indexGroupMap.end()) {
                 m->mothurOut("[ERROR]: " + groupName + " is not in your count table. Please correct.\n"); m->control_pressed = true;
             }else { 
-                map<string, int>::iterator it2 = indexNameMap.find(seqName);
+                unordered_map<string, int>::iterator it2 = indexNameMap.find(seqName);
                 if (it2 == indexNameMap.end()) {
                     //look for it in names of groups to see if the user accidently used the wrong file
                     if (m->inUsersGroups(seqName, groups)) {
@@ -510,8 +510,8 @@ int CountTable::setAbund(string seqName, string groupName, int num) {
                     }
                     m->mothurOut("[ERROR]: " + seqName + " is not in your count table. Please correct.\n"); m->control_pressed = true;
                 }else { 
-                    int oldCount = counts[it2->second][it->second];
-                    counts[it2->second][it->second] = num;
+                    int oldCount = getAbund(it2->second, it->second);
+                    setCount(it2->second, it->second, num);
                     totalGroups[it->second] += (num - oldCount);
                     total += (num - oldCount);
                     totals[it2->second] += (num - oldCount);
@@ -534,35 +534,29 @@ int CountTable::addGroup(string groupName) {
         if (sanity) { m->mothurOut("[ERROR]: " + groupName + " is already in the count table, cannot add again.\n"); m->control_pressed = true;  return 0; }
         
         groups.push_back(groupName);
-        if (!hasGroups) { counts.resize(uniques);  }
-        
-        for (int i = 0; i < counts.size(); i++) { counts[i].push_back(0); }
         totalGroups.push_back(0);
         indexGroupMap[groupName] = groups.size()-1;
-        map<string, int> originalGroupMap = indexGroupMap;
+        unordered_map<string, int> originalGroupMap = indexGroupMap;
         
         //important to play well with others, :)
         sort(groups.begin(), groups.end());
         
         //fix indexGroupMap && totalGroups
         vector<int> newTotals; newTotals.resize(groups.size(), 0);
+        vector<int> newIndexes; newIndexes.resize(groups.size(), 0); //original index -> sorted index
         for (int i = 0; i < groups.size(); i++) {  
             indexGroupMap[groups[i]] = i;  
             //find original spot of group[i]
             int index = originalGroupMap[groups[i]];
             newTotals[i] = totalGroups[index];
+            newIndexes[index] = i;
         }
         totalGroups = newTotals;
         
         //fix counts vectors
         for (int i = 0; i < counts.size(); i++) {
-            vector<int> newCounts; newCounts.resize(groups.size(), 0);
-            for (int j = 0; j < groups.size(); j++) {  
-                //find original spot of group[i]
-                int index = originalGroupMap[groups[j]];
-                newCounts[j] = counts[i][index];
-            }
-            counts[i] = newCounts;
+            for (int j = 0; j < counts[i].size(); j++) {  counts[i][j].group = newIndexes[counts[i][j].group];  }
+            sort(counts[i].begin(), counts[i].end());
         }
         hasGroups = true;
         m->setAllGroups(groups);
@@ -579,16 +573,11 @@ int CountTable::addGroup(string groupName) {
 int CountTable::removeGroup(string groupName) {
     try {        
         if (hasGroups) {
-            //save for later in case removing a group means we need to remove a seq.
-            map<int, string> reverse;
-            for (map<string, int>::iterator it = indexNameMap.begin(); it !=indexNameMap.end(); it++) { reverse[it->second] = it->first;  }
-            
-            map<string, int>::iterator it = indexGroupMap.find(groupName);
+            unordered_map<string, int>::iterator it = indexGroupMap.find(groupName);
             if (it == indexGroupMap.end()) {
                 m->mothurOut("[ERROR]: " + groupName + " is not in your count table. Please correct.\n"); m->control_pressed = true;
             }else { 
                 int indexOfGroupToRemove = it->second;
-                map<string, int> currentGroupIndex = indexGroupMap;
                 vector<string> newGroups;
                 for (int i = 0; i < groups.size(); i++) {
                     if (groups[i] != groupName) { 
@@ -601,22 +590,30 @@ int CountTable::removeGroup(string groupName) {
                 totalGroups.erase(totalGroups.begin()+indexOfGroupToRemove);
                 
                 int thisIndex = 0;
-                map<string, int> newIndexNameMap;
                 for (int i = 0; i < counts.size(); i++) {
-                    int num = counts[i][indexOfGroupToRemove];
-                    counts[i].erase(counts[i].begin()+indexOfGroupToRemove);
+                    int num = 0;
+                    vector<GroupCount>& thisCounts = counts[i];
+                    for (int j = 0; j < thisCounts.size(); j++) {
+                        if (thisCounts[j].group == indexOfGroupToRemove) { num = thisCounts[j].abund; thisCounts.erase(thisCounts.begin()+j); j--; }
+                        else if (thisCounts[j].group > indexOfGroupToRemove) { thisCounts[j].group--; }
+                    }
                     totals[i] -= num;
                     total -= num;
-                    if (totals[i] == 0) { //your sequences are only from the group we want to remove, then remove you.
-                        counts.erase(counts.begin()+i);
-                        totals.erase(totals.begin()+i);
-                        uniques--;
-                        i--;
+                    if ((totals[i] == 0) || (seqNames[i] == NULL)) { //your sequences are only from the group we want to remove, then remove you.
+                        if (seqNames[i] != NULL) { indexNameMap.erase(*seqNames[i]); }
+                        continue;
+                    }
+                    if (thisIndex != i) {
+                        counts[thisIndex].swap(counts[i]);
+                        totals[thisIndex] = totals[i];
+                        seqNames[thisIndex] = seqNames[i];
+                        indexNameMap[*seqNames[thisIndex]] = thisIndex;
                     }
-                    newIndexNameMap[reverse[thisIndex]] = i;
                     thisIndex++;
                 }
-                indexNameMap = newIndexNameMap;
+                counts.resize(thisIndex); totals.resize(thisIndex); seqNames.resize(thisIndex);
+                uniques = indexNameMap.size();
+                sortedValid = false;
                 
                 if (groups.size() == 0) { hasGroups = false; }
             }
@@ -653,7 +650,7 @@ vector<string> CountTable::getGroups(string seqName) {
 int CountTable::renameSeq(string oldSeqName, string newSeqName) {
     try {
         
-        map<string, int>::iterator it = indexNameMap.find(oldSeqName);
+        unordered_map<string, int>::iterator it = indexNameMap.find(oldSeqName);
         if (it == indexNameMap.end()) {
             if (hasGroupInfo()) {
                 //look for it in names of groups to see if the user accidently used the wrong file
@@ -662,10 +659,16 @@ int CountTable::renameSeq(string oldSeqName, string newSeqName) {
                 }
             }
             m->mothurOut("[ERROR]: " + oldSeqName + " is not in your count table. Please correct.\n"); m->control_pressed = true;
-        }else {  
+        }else if (oldSeqName != newSeqName) {
+            //a sequence already named newSeqName gives up its row, otherwise both rows would print under the same name
+            if (indexNameMap.count(newSeqName) != 0) { remove(newSeqName); }
+
+            it = indexNameMap.find(oldSeqName);
             int index = it->second;
             indexNameMap.erase(it);
-            indexNameMap[newSeqName] = index;
+            it = indexNameMap.insert(make_pair(newSeqName, index)).first;
+            seqNames[index] = &(it->first);
+            sortedValid = false;
         }
         
         return 0;
@@ -681,7 +684,7 @@ int CountTable::renameSeq(string oldSeqName, string newSeqName) {
 int CountTable::getNumSeqs(string seqName) {
     try {
                 
-        map<string, int>::iterator it = indexNameMap.find(seqName);
+        unordered_map<string, int>::iterator it = indexNameMap.find(seqName);
         if (it == indexNameMap.end()) {
             if (hasGroupInfo()) {
                 //look for it in names of groups to see if the user accidently used the wrong file
@@ -706,7 +709,7 @@ int CountTable::getNumSeqs(string seqName) {
 int CountTable::setNumSeqs(string seqName, int abund) {
     try {
         
-        map<string, int>::iterator it = indexNameMap.find(seqName);
+        unordered_map<string, int>::iterator it = indexNameMap.find(seqName);
         if (it == indexNameMap.end()) {
             m->mothurOut("[ERROR]: " + seqName + " is not in your count table. Please correct.\n"); m->control_pressed = true; return -1;
         }else {
@@ -728,7 +731,7 @@ int CountTable::setNumSeqs(string seqName, int abund) {
 int CountTable::get(string seqName) {
     try {
         
-        map<string, int>::iterator it = indexNameMap.find(seqName);
+        unordered_map<string, int>::iterator it = indexNameMap.find(seqName);
         if (it == indexNameMap.end()) {
             if (hasGroupInfo()) {
                 //look for it in names of groups to see if the user accidently used the wrong file
@@ -750,13 +753,9 @@ int CountTable::get(string seqName) {
 //add seqeunce without group info
 int CountTable::push_back(string seqName) {
     try {
-        map<string, int>::iterator it = indexNameMap.find(seqName);
-        if (it == indexNameMap.end()) {
+        if (addSeq(seqName, 1, vector<GroupCount>()) != -1) {
             if (hasGroups) {  m->mothurOut("[ERROR]: Your count table has groups and I have no group information for " + seqName + "."); m->mothurOutEndLine(); m->control_pressed = true;  }
-            indexNameMap[seqName] = uniques;
-            totals.push_back(1);
             total++;
-            uniques++;
         }else {
             m->mothurOut("[ERROR]: Your count table contains more than 1 sequence named " + seqName + ", sequence names must be unique. Please correct."); m->mothurOutEndLine(); m->control_pressed = true;
         }
@@ -772,15 +771,19 @@ int CountTable::push_back(string seqName) {
 //remove sequence
 int CountTable::remove(string seqName) {
     try {
-        map<string, int>::iterator it = indexNameMap.find(seqName);
+        unordered_map<string, int>::iterator it = indexNameMap.find(seqName);
         if (it != indexNameMap.end()) {
             uniques--;
+            vector<GroupCount>& thisCounts = counts[it->second];
             if (hasGroups){ //remove this sequences counts from group totals
-                for (int i = 0; i < totalGroups.size(); i++) {  totalGroups[i] -= counts[it->second][i];  counts[it->second][i] = 0; }
+                for (int i = 0; i < thisCounts.size(); i++) {  totalGroups[thisCounts[i].group] -= thisCounts[i].abund;  }
             }
+            thisCounts.clear();
             int thisTotal = totals[it->second]; totals[it->second] = 0;
             total -= thisTotal;
+            seqNames[it->second] = NULL;
             indexNameMap.erase(it);
+            sortedValid = false;
         }else {
             if (hasGroupInfo()) {
                 //look for it in names of groups to see if the user accidently used the wrong file
@@ -802,13 +805,9 @@ int CountTable::remove(string seqName) {
 //add seqeunce without group info
 int CountTable::push_back(string seqName, int thisTotal) {
     try {
-        map<string, int>::iterator it = indexNameMap.find(seqName);
-        if (it == indexNameMap.end()) {
+        if (addSeq(seqName, thisTotal, vector<GroupCount>()) != -1) {
             if (hasGroups) {  m->mothurOut("[ERROR]: Your count table has groups and I have no group information for " + seqName + "."); m->mothurOutEndLine(); m->control_pressed = true;  }
-            indexNameMap[seqName] = uniques;
-            totals.push_back(thisTotal);
             total+=thisTotal;
-            uniques++;
         }else {
             m->mothurOut("[ERROR]: Your count table contains more than 1 sequence named " + seqName + ", sequence names must be unique. Please correct."); m->mothurOutEndLine(); m->control_pressed = true;
         }
@@ -825,16 +824,17 @@ int CountTable::push_back(string seqName, int thisTotal) {
 int CountTable::push_back(string seqName, vector<int> groupCounts) {
     try {
         int thisTotal = 0;
-        map<string, int>::iterator it = indexNameMap.find(seqName);
+        unordered_map<string, int>::iterator it = indexNameMap.find(seqName);
         if (it == indexNameMap.end()) {
             if ((hasGroups) && (groupCounts.size() != getNumGroups())) {  m->mothurOut("[ERROR]: Your count table has a " + toString(getNumGroups()) + " groups and " + seqName + " has " + toString(groupCounts.size()) + ", please correct."); m->mothurOutEndLine(); m->control_pressed = true;  }
             
-            for (int i = 0; i < getNumGroups(); i++) {   totalGroups[i] += groupCounts[i];  thisTotal += groupCounts[i]; }
-            if (hasGroups) {  counts.push_back(groupCounts);  }
-            indexNameMap[seqName] = uniques;
-            totals.push_back(thisTotal);
+            vector<GroupCount> thisCounts;
+            for (int i = 0; i < getNumGroups(); i++) {   
+                totalGroups[i] += groupCounts[i];  thisTotal += groupCounts[i]; 
+                if (groupCounts[i] != 0) { thisCounts.push_back(GroupCount(i, groupCounts[i])); }
+            }
+            addSeq(seqName, thisTotal, thisCounts);
             total+= thisTotal;
-            uniques++;
         }else {
             m->mothurOut("[ERROR]: Your count table contains more than 1 sequence named " + seqName + ", sequence names must be unique. Please correct."); m->mothurOutEndLine(); m->control_pressed = true;
         }
@@ -852,7 +852,7 @@ int CountTable::push_back(string seqName, vector<int> groupCounts) {
 ListVector CountTable::getListVector() {
     try {
         ListVector list(indexNameMap.size());
-        for (map<string, int>::iterator it = indexNameMap.begin(); it != indexNameMap.end(); it++) { 
+        for (unordered_map<string, int>::iterator it = indexNameMap.begin(); it != indexNameMap.end(); it++) { 
             if (m->control_pressed) { break; }
             list.set(it->second, it->first); 
         }
@@ -868,10 +868,9 @@ ListVector CountTable::getListVector() {
 //returns the names of all unique sequences in file
 vector<string> CountTable::getNamesOfSeqs() {
     try {
-        vector<string> names;
-        for (map<string, int>::iterator it = indexNameMap.begin(); it != indexNameMap.end(); it++) {
-            names.push_back(it->first);
-        }
+        vector<string> names; names.reserve(indexNameMap.size());
+        sortSeqs();
+        for (int i = 0; i < sortedSeqs.size(); i++) {  names.push_back(*seqNames[sortedSeqs[i]]); }
                 
         return names;
     }
@@ -885,7 +884,7 @@ vector<string> CountTable::getNamesOfSeqs() {
 map<string, int> CountTable::getNameMap() {
     try {
         map<string, int> names;
-        for (map<string, int>::iterator it = indexNameMap.begin(); it != indexNameMap.end(); it++) {
+        for (unordered_map<string, int>::iterator it = indexNameMap.begin(); it != indexNameMap.end(); it++) {
             names[it->first] = totals[it->second];
         }
         
@@ -902,12 +901,13 @@ vector<string> CountTable::getNamesOfSeqs(string group) {
     try {
         vector<string> names;
         if (hasGroups) {
-            map<string, int>::iterator it = indexGroupMap.find(group);
+            unordered_map<string, int>::iterator it = indexGroupMap.find(group);
             if (it == indexGroupMap.end()) {
                 m->mothurOut("[ERROR]: " + group + " is not in your count table. Please correct.\n"); m->control_pressed = true;
             }else { 
-                for (map<string, int>::iterator it2 = indexNameMap.begin(); it2 != indexNameMap.end(); it2++) {
-                    if (counts[it2->second][it->second] != 0) {  names.push_back(it2->first); }
+                sortSeqs();
+                for (int i = 0; i < sortedSeqs.size(); i++) {
+                    if (getAbund(sortedSeqs[i], it->second) != 0) {  names.push_back(*seqNames[sortedSeqs[i]]); }
                 }
             }
         }else{  m->mothurOut("[ERROR]: Your count table does not have group info. Please correct.\n");  m->control_pressed = true; }
@@ -923,7 +923,7 @@ vector<string> CountTable::getNamesOfSeqs(string group) {
 //merges counts of seq1 and seq2, saving in seq1
 int CountTable::mergeCounts(string seq1, string seq2) {
     try {
-        map<string, int>::iterator it = indexNameMap.find(seq1);
+        unordered_map<string, int>::iterator it = indexNameMap.find(seq1);
         if (it == indexNameMap.end()) {
             if (hasGroupInfo()) {
                 //look for it in names of groups to see if the user accidently used the wrong file
@@ -933,7 +933,7 @@ int CountTable::mergeCounts(string seq1, string seq2) {
             }
             m->mothurOut("[ERROR]: " + seq1 + " is not in your count table. Please correct.\n"); m->control_pressed = true;
         }else { 
-            map<string, int>::iterator it2 = indexNameMap.find(seq2);
+            unordered_map<string, int>::iterator it2 = indexNameMap.find(seq2);
             if (it2 == indexNameMap.end()) {
                 if (hasGroupInfo()) {
                     //look for it in names of groups to see if the user accidently used the wrong file
@@ -944,10 +944,15 @@ int CountTable::mergeCounts(string seq1, string seq2) {
                 m->mothurOut("[ERROR]: " + seq2 + " is not in your count table. Please correct.\n"); m->control_pressed = true;
             }else { 
                 //merge data
-                for (int i = 0; i < groups.size(); i++) { counts[it->second][i] += counts[it2->second][i]; }
+                vector<GroupCount>& thisCounts = counts[it2->second];
+                for (int i = 0; i < thisCounts.size(); i++) { setCount(it->second, thisCounts[i].group, getAbund(it->second, thisCounts[i].group) + thisCounts[i].abund); }
+                thisCounts.clear();
                 totals[it->second] += totals[it2->second];
+                totals[it2->second] = 0;
                 uniques--;
+                seqNames[it2->second] = NULL;
                 indexNameMap.erase(it2); 
+                sortedValid = false;
             }
         }
         return 0;
@@ -976,7 +981,295 @@ int CountTable::copy(CountTable* ct) {
 		exit(1);
 	}
 }
+/************************************************************/
+CountTable& CountTable::operator=(const CountTable& other) {
+    try {
+        if (this == &other) { return *this; }
+
+        m = MothurOut::getInstance();
+        filename = other.filename;
+        hasGroups = other.hasGroups;
+        total = other.total;
+        uniques = other.uniques;
+        groups = other.groups;
+        counts = other.counts;
+        totals = other.totals;
+        totalGroups = other.totalGroups;
+        indexNameMap = other.indexNameMap;
+        indexGroupMap = other.indexGroupMap;
+        sortedSeqs = other.sortedSeqs;
+        sortedValid = other.sortedValid;
+
+        //seqNames must point at our own copies of the names
+        seqNames.assign(other.seqNames.size(), NULL);
+        for (unordered_map<string, int>::iterator it = indexNameMap.begin(); it != indexNameMap.end(); it++) { seqNames[it->second] = &(it->first); }
+
+        return *this;
+    }
+	catch(exception& e) {
+		m->errorOut(e, "CountTable", "operator=");
+		exit(1);
+	}
+}
+/************************************************************/
+void CountTable::clearTable() {
+    try {
+        groups.clear();
+        totalGroups.clear();
+        indexGroupMap.clear();
+        indexNameMap.clear();
+        counts.clear();
+        totals.clear();
+        seqNames.clear();
+        sortedSeqs.clear();
+        sortedValid = false;
+    }
+	catch(exception& e) {
+		m->errorOut(e, "CountTable", "clearTable");
+		exit(1);
+	}
+}
+/************************************************************/
+//adds the name and its counts at the next index, does not change total
+int CountTable::addSeq(const string& seqName, int thisTotal, const vector<GroupCount>& groupCounts) {
+    try {
+        pair<unordered_map<string, int>::iterator, bool> inserted = indexNameMap.insert(make_pair(seqName, (int)totals.size()));
+        if (!inserted.second) { return -1; }
+
+        seqNames.push_back(&(inserted.first->first));
+        counts.push_back(groupCounts);
+        totals.push_back(thisTotal);
+        uniques++;
+        sortedValid = false;
 
+        return inserted.first->second;
+    }
+	catch(exception& e) {
+		m->errorOut(e, "CountTable", "addSeq");
+		exit(1);
+	}
+}
+/************************************************************/
+int CountTable::getAbund(int seqIndex, int groupIndex) {
+    try {
+        vector<GroupCount>& thisCounts = counts[seqIndex];
+        vector<GroupCount>::iterator it = lower_bound(thisCounts.begin(), thisCounts.end(), GroupCount(groupIndex, 0));
+        if ((it != thisCounts.end()) && (it->group == groupIndex)) { return it->abund; }
+        return 0;
+    }
+	catch(exception& e) {
+		m->errorOut(e, "CountTable", "getAbund");
+		exit(1);
+	}
+}
+/************************************************************/
+void CountTable::setCount(int seqIndex, int groupIndex, int num) {
+    try {
+        vector<GroupCount>& thisCounts = counts[seqIndex];
+        vector<GroupCount>::iterator it = lower_bound(thisCounts.begin(), thisCounts.end(), GroupCount(groupIndex, 0));
+        if ((it != thisCounts.end()) && (it->group == groupIndex)) {
+            if (num == 0) { thisCounts.erase(it); }
+            else { it->abund = num; }
+        }else if (num != 0) { thisCounts.insert(it, GroupCount(groupIndex, num)); }
+    }
+	catch(exception& e) {
+		m->errorOut(e, "CountTable", "setCount");
+		exit(1);
+	}
+}
+/************************************************************/
+//callers expect the names in alphabetical order, so keep the order around until a name changes
+void CountTable::sortSeqs() {
+    try {
+        if (sortedValid) { return; }
+
+        sortedSeqs.clear(); sortedSeqs.reserve(indexNameMap.size());
+        for (int i = 0; i < seqNames.size(); i++) { if (seqNames[i] != NULL) { sortedSeqs.push_back(i); } }
+
+        const vector<const string*>& names = seqNames;
+        sort(sortedSeqs.begin(), sortedSeqs.end(), [&names](int a, int b) { return *names[a] < *names[b]; });
+        sortedValid = true;
+    }
+	catch(exception& e) {
+		m->errorOut(e, "CountTable", "sortSeqs");
+		exit(1);
+	}
+}
+/************************************************************/
+//file.bin, in the output directory if one is set with set.dir
+string CountTable::getBinaryName(string file) {
+    try {
+        string outputDir = m->getOutputDir();
+        if (outputDir == "") { return file + ".bin"; }
+        return outputDir + m->getSimpleName(file) + ".bin";
+    }
+	catch(exception& e) {
+		m->errorOut(e, "CountTable", "getBinaryName");
+		exit(1);
+	}
+}
+/************************************************************/
+//reads file.bin if it was saved from the current version of file, returns false if the text needs to be parsed.
+//Anything in it that does not add up, sizes, offsets or group indexes, also sends the read back to the text.
+bool CountTable::readBinaryTable(string file, bool readGroups, bool mothurRunning) {
+    try {
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+        struct stat textInfo;
+        if (stat(file.c_str(), &textInfo) != 0) { return false; }
+
+        ifstream in(getBinaryName(file).c_str(), ios::binary);
+        if (!in) { return false; }
+        in.seekg(0, ios::end);
+        unsigned long long binSize = in.tellg();
+        in.seekg(0, ios::beg);
+
+        //the header starts at the first multiple of 8 after the version line
+        string versionLine; getline(in, versionLine);
+        if (!in) { return false; }
+        long long headerStart = ((versionLine.length() + 1 + 7) / 8) * 8;
+        in.seekg(headerStart);
+
+        BinaryHeader header;
+        in.read((char*)&header, sizeof(BinaryHeader));
+        if (!in) { return false; }
+        if (memcmp(header.magic, countTableMagic, 8) != 0) { return false; }
+        if (header.version != countTableVersion) { return false; }
+        if ((header.textSize != (unsigned long long)textInfo.st_size) || (header.textModified != (long long)textInfo.st_mtime) || (header.textModifiedNsec != getModifiedNsec(textInfo))) { return false; }
+        if (header.hasZeroTotals && !mothurRunning) { return false; } //let the text read report them
+
+        //each block is checked against the file before anything is allocated for it
+        unsigned long long remaining = binSize - min(binSize, (unsigned long long)(headerStart + sizeof(BinaryHeader)));
+        if ((header.groupBytes > remaining) || (header.nameBytes > (remaining -= header.groupBytes))) { return false; }
+        remaining -= header.nameBytes;
+        if (remaining < sizeof(unsigned long long)) { return false; }
+        remaining -= sizeof(unsigned long long);
+        if (header.numSeqs > (remaining / (sizeof(int) + sizeof(unsigned long long)))) { return false; }
+        remaining -= header.numSeqs * (sizeof(int) + sizeof(unsigned long long));
+        if (((remaining % sizeof(GroupCount)) != 0) || (header.numCells != (remaining / sizeof(GroupCount)))) { return false; }
+
+        string groupBlock(header.groupBytes, '\0'), nameBlock(header.nameBytes, '\0');
+        vector<int> binTotals(header.numSeqs);
+        vector<unsigned long long> cellStarts(header.numSeqs+1);
+        vector<GroupCount> cells(header.numCells);
+        if (header.groupBytes != 0) { in.read(&groupBlock[0], header.groupBytes); }
+        if (header.nameBytes != 0) { in.read(&nameBlock[0], header.nameBytes); }
+        in.read((char*)&binTotals[0], header.numSeqs * sizeof(int));
+        in.read((char*)&cellStarts[0], (header.numSeqs+1) * sizeof(unsigned long long));
+        if (header.numCells != 0) { in.read((char*)&cells[0], header.numCells * sizeof(GroupCount)); }
+        if (!in) { return false; }
+        in.close();
+
+        vector<string> binGroups;
+        if (header.numGroups != 0) { m->splitAtChar(groupBlock, binGroups, '\n'); }
+        if ((binGroups.size() != header.numGroups) || (cellStarts[0] != 0) || (cellStarts[header.numSeqs] != header.numCells)) { return false; }
+        for (unsigned long long i = 0; i < header.numSeqs; i++) {
+            if (cellStarts[i] > cellStarts[i+1]) { return false; }
+            for (unsigned long long j = cellStarts[i]; j < cellStarts[i+1]; j++) { //sorted, in range and not zero, as the text read stores them
+                if ((cells[j].group < 0) || (cells[j].group >= (int)header.numGroups) || (cells[j].abund == 0)) { return false; }
+                if ((j != cellStarts[i]) && (cells[j].group <= cells[j-1].group)) { return false; }
+            }
+        }
+
+        clearTable();
+        hasGroups = (readGroups && (header.numGroups != 0));
+        groups = binGroups;
+        totalGroups.resize(groups.size(), 0);
+        for (int i = 0; i < groups.size(); i++) {  indexGroupMap[groups[i]] = i; }
+        m->setAllGroups(groups);
+
+        uniques = 0;
+        total = 0;
+        indexNameMap.reserve(header.numSeqs);
+        seqNames.reserve(header.numSeqs); counts.reserve(header.numSeqs); totals.reserve(header.numSeqs);
+
+        vector<GroupCount> noCounts;
+        size_t nameStart = 0;
+        for (unsigned long long i = 0; i < header.numSeqs; i++) {
+            size_t nameEnd = nameBlock.find('\0', nameStart);
+            if (nameEnd == string::npos) { clearTable(); return false; }
+
+            if (hasGroups) {
+                vector<GroupCount> thisCounts(cells.begin()+cellStarts[i], cells.begin()+cellStarts[i+1]);
+                for (int j = 0; j < thisCounts.size(); j++) { totalGroups[thisCounts[j].group] += thisCounts[j].abund; }
+                if (addSeq(nameBlock.substr(nameStart, nameEnd-nameStart), binTotals[i], thisCounts) == -1) { clearTable(); return false; }
+            }else if (addSeq(nameBlock.substr(nameStart, nameEnd-nameStart), binTotals[i], noCounts) == -1) { clearTable(); return false; }
+
+            total += binTotals[i];
+            nameStart = nameEnd+1;
+        }
+
+        return true;
+#else
+        return false;
+#endif
+    }
+	catch(exception& e) {
+		m->errorOut(e, "CountTable", "readBinaryTable");
+		exit(1);
+	}
+}
+/************************************************************/
+//saves the table just read from file to file.bin so the next read can skip parsing, only worth it for large files.
+//It is written under a temporary name and renamed into place, so a crash or another mothur reading the same file
+//never leaves a partial file.bin behind.
+void CountTable::writeBinaryTable(string file, bool hasZeroTotals) {
+    try {
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+        struct stat textInfo;
+        if (stat(file.c_str(), &textInfo) != 0) { return; }
+        if (textInfo.st_size < countTableBinaryMinSize) { return; }
+        if (textInfo.st_mtime >= (time(NULL) - 1)) { return; } //still being written maybe, a later change could keep the same time
+
+        string groupBlock = "";
+        for (int i = 0; i < groups.size(); i++) { if (i != 0) { groupBlock += '\n'; } groupBlock += groups[i]; }
+        string nameBlock = "";
+        vector<unsigned long long> cellStarts(totals.size()+1, 0);
+        for (int i = 0; i < totals.size(); i++) {
+            nameBlock += *seqNames[i]; nameBlock += '\0';
+            cellStarts[i+1] = cellStarts[i] + counts[i].size();
+        }
+
+        string binName = getBinaryName(file);
+        string tempName = binName + "." + toString(getpid()) + ".temp";
+        ofstream out(tempName.c_str(), ios::binary | ios::trunc);
+        if (!out) { return; } //the table is still fine, it will just be parsed again next time
+
+        //output version, then pad so the header lines up
+        string versionLine = "#" + m->getVersion() + "\n";
+        out.write(versionLine.c_str(), versionLine.length());
+        for (int i = versionLine.length(); (i % 8) != 0; i++) { out.put('\0'); }
+
+        BinaryHeader header;
+        memset(&header, 0, sizeof(BinaryHeader));
+        memcpy(header.magic, countTableMagic, 8);
+        header.version = countTableVersion;
+        header.numGroups = groups.size();
+        header.numSeqs = totals.size();
+        header.numCells = cellStarts[totals.size()];
+        header.groupBytes = groupBlock.length();
+        header.nameBytes = nameBlock.length();
+        header.textSize = textInfo.st_size;
+        header.textModified = textInfo.st_mtime;
+        header.textModifiedNsec = getModifiedNsec(textInfo);
+        header.hasZeroTotals = hasZeroTotals;
+        out.write((char*)&header, sizeof(BinaryHeader));
+
+        out.write(groupBlock.c_str(), groupBlock.length());
+        out.write(nameBlock.c_str(), nameBlock.length());
+        if (totals.size() != 0) { out.write((char*)&totals[0], totals.size() * sizeof(int)); }
+        out.write((char*)&cellStarts[0], cellStarts.size() * sizeof(unsigned long long));
+        for (int i = 0; i < counts.size(); i++) { if (counts[i].size() != 0) { out.write((char*)&counts[i][0], counts[i].size() * sizeof(GroupCount)); } }
+        out.close();
+
+        if (!out || (rename(tempName.c_str(), binName.c_str()) != 0)) { m->mothurRemove(tempName); }
+        else { m->mothurOut("Saved " + binName + " so later reads of " + m->getSimpleName(file) + " are faster.\n"); }
+#endif
+    }
+	catch(exception& e) {
+		m->errorOut(e, "CountTable", "writeBinaryTable");
+		exit(1);
+	}
+}
 /************************************************************/
 
 
@@ -39,12 +39,24 @@
 #include "mothurout.h"
 #include "listvector.hpp"
 #include "groupmap.h"
+#include <unordered_map>
+
+//Names are kept once, as the keys of indexNameMap, and seqNames points back at them by sequence index. Group counts
+//are sparse: each sequence stores only the groups it is in, sorted by group index. With set.dir(countcache=T) tables
+//read from large files are saved to <file>.bin, in set.dir's output directory if there is one, which later reads use
+//instead of parsing the text while the text file is unchanged.
 
 class CountTable {
     
+#ifdef UNIT_TEST
+    friend class TestCountTable;
+#endif
+    
     public:
     
-        CountTable() { m = MothurOut::getInstance(); hasGroups = false; total = 0; uniques = 0; }
+        CountTable() { m = MothurOut::getInstance(); hasGroups = false; total = 0; uniques = 0; sortedValid = false; }
+        CountTable(const CountTable& other) { *this = other; }
+        CountTable& operator=(const CountTable&);
         ~CountTable() {}
     
         //reads and creates smart enough to eliminate groups with zero counts 
@@ -92,16 +104,43 @@ class CountTable {
         map<string, int> getNameMap();  //sequenceName -> total number of sequences it represents
     
     private:
+        struct GroupCount {
+            int group, abund;
+            GroupCount() : group(0), abund(0) {}
+            GroupCount(int g, int a) : group(g), abund(a) {}
+            bool operator<(const GroupCount& rhs) const { return group < rhs.group; }
+        };
+    
+        struct BinaryHeader {
+            char magic[8];
+            unsigned int version, numGroups;
+            unsigned long long numSeqs, numCells, groupBytes, nameBytes, textSize;
+            long long textModified, textModifiedNsec;
+            unsigned int hasZeroTotals, padding;
+        };
+    
         string filename;
         MothurOut* m;
         bool hasGroups;
         int total, uniques;
         vector<string> groups;
-        vector< vector<int> > counts;
+        vector< vector<GroupCount> > counts; //sequence index -> groups it is in, sorted by group
         vector<int> totals;
         vector<int> totalGroups;
-        map<string, int> indexNameMap;
-        map<string, int> indexGroupMap;
+        unordered_map<string, int> indexNameMap;
+        unordered_map<string, int> indexGroupMap;
+        vector<const string*> seqNames;      //sequence index -> its key in indexNameMap, NULL once removed or merged
+        vector<int> sortedSeqs;              //sequence indexes in name order, rebuilt when names change
+        bool sortedValid;
+    
+        void clearTable();
+        int addSeq(const string&, int, const vector<GroupCount>&); //returns the new index, -1 if the name is already used
+        int getAbund(int, int);
+        void setCount(int, int, int);
+        void sortSeqs();
+        bool readBinaryTable(string, bool, bool);
+        void writeBinaryTable(string, bool);
+        string getBinaryName(string);
     
 };
 
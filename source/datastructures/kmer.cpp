@@ -67,7 +67,7 @@ vector< map<int, int> > Kmer::getKmerCounts(string sequence){	//	Calculate kmer
 	
 /**************************************************************************************************/
 
-int Kmer::getKmerNumber(string sequence, int index){
+int Kmer::getKmerNumber(const string& sequence, int index){
 	
 //	Here we convert a kmer to a number between 0 and maxKmer.  For example, AAAA would equal 0 and TTTT would equal 255.
 //	If there's an N in the kmer, it is set to 256 (if we are looking at 4mers).  The largest we can look at are 8mers,
@@ -96,6 +96,40 @@ int Kmer::getKmerNumber(string sequence, int index){
 	}
 	return kmer;	
 }
+/**************************************************************************************************/
+//	Same numbers as getKmerNumber, but each kmer is made from the last one by shifting in the next base, so the
+//	sequence is read once instead of kmerSize times.  A kmer with an N in it is set to 4^kmerSize.
+
+int Kmer::getKmerNumbers(const string& sequence, vector<int>& kmerNumbers){
+	
+	int length = sequence.length();
+	int nKmers = length - kmerSize + 1;
+	if (nKmers < 1) { kmerNumbers.clear(); return 0; }
+	kmerNumbers.resize(nKmers);
+	
+	int nKmer = maxKmer - 1;			//	4^kmerSize
+	int mask = nKmer - 1;				//	keeps the last kmerSize bases
+	int lastN = -kmerSize;				//	position of the last N
+	int kmer = 0;
+	
+	for(int i=0;i<length;i++){
+		char base = toupper(sequence[i]);
+		int number = 0;
+		if(base == 'C')							{	number = 1;	}
+		else if(base == 'G')					{	number = 2;	}
+		else if((base == 'T') || (base == 'U'))	{	number = 3;	}
+		else if(base == 'N')					{	lastN = i;	}
+		
+		kmer = ((kmer << 2) | number) & mask;
+		
+		if(i >= kmerSize-1){
+			if((i - lastN) < kmerSize)	{	kmerNumbers[i-kmerSize+1] = nKmer;	}
+			else						{	kmerNumbers[i-kmerSize+1] = kmer;	}
+		}
+	}
+	
+	return nKmers;
+}
 	
 /**************************************************************************************************/
 	
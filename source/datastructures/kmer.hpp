@@ -20,7 +20,8 @@ public:
 	Kmer(int);
     ~Kmer() {}
 	string getKmerString(string);
-	int getKmerNumber(string, int);
+	int getKmerNumber(const string&, int);
+	int getKmerNumbers(const string&, vector<int>&);  //fills in the kmer number at each position, returns the number of kmers
 	string getKmerBases(int);
 	int getReverseKmerNumber(int);
 	vector< map<int, int> > getKmerCounts(string sequence);  //for use in chimeraCheck
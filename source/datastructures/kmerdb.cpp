@@ -7,8 +7,8 @@
  *
  *	This class is a child class of the Database class, which stores the template sequences as a kmer table and provides
  *	a method of searching the kmer table for the sequence with the most kmers in common with a query sequence.
- *	kmerLocations is the primary storage variable that is a two-dimensional vector where each row represents the
- *	different number of kmers and each column contains the index to sequences that use that kmer.
+ *	addSequence fills kmerLocations, a list of sequence indexes for each kmer number. setNumSeqs packs the lists into
+ *	one array of sequence indexes, kmerSeqs, with kmerStarts[k] to kmerStarts[k+1] holding the sequences with kmer k.
  *
  *	Construction of an object of this type will first look for an appropriately named database file and if it is found
  *	then will read in the database file (readKmerDB), otherwise it will generate one and store the data in memory
@@ -27,6 +27,16 @@
 #include "database.hpp"
 #include "kmerdb.hpp"
 
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+static const char kmerDBMagic[8] = { 'M', 'O', 'T', 'H', 'U', 'R', 'K', 'M' };
+static const unsigned int kmerDBVersion = 1;
+
 /**************************************************************************************************/
 
 KmerDB::KmerDB(string fastaFileName, int kSize) : Database(), kmerSize(kSize) {
@@ -38,8 +48,9 @@ KmerDB::KmerDB(string fastaFileName, int kSize) : Database(), kmerSize(kSize) {
 		count = 0;
 		
 		maxKmer = power4s[kmerSize];
-		kmerLocations.resize(maxKmer+1);
 		
+		packedStarts = NULL; packedSeqs = NULL;
+		mapData = NULL; mapSize = 0; mapped = false;
 	}
 	catch(exception& e) {
 		m->errorOut(e, "KmerDB", "KmerDB");
@@ -48,10 +59,10 @@ KmerDB::KmerDB(string fastaFileName, int kSize) : Database(), kmerSize(kSize) {
 
 }
 /**************************************************************************************************/
-KmerDB::KmerDB() : Database() {}
+KmerDB::KmerDB() : Database() { packedStarts = NULL; packedSeqs = NULL; mapData = NULL; mapSize = 0; mapped = false; }
 /**************************************************************************************************/
 
-KmerDB::~KmerDB(){}
+KmerDB::~KmerDB(){ unmapKmerDB(); }
 
 /**************************************************************************************************/
 
@@ -64,48 +75,57 @@ vector<int> KmerDB::findClosestSequences(Sequence* candidateSeq, int num){
 		searchScore = 0;
 		Scores.clear();
 		
-		vector<int> matches(numSeqs, 0);						//	a record of the sequences with shared kmers
-		vector<int> timesKmerFound(kmerLocations.size()+1, 0);	//	a record of the kmers that we have already found
+		if (matchCounts.size() != numSeqs)		{ matchCounts.assign(numSeqs, 0);		}	//	a record of the sequences with shared kmers
+		if (kmerSeen.size() != (maxKmer+1))	{ kmerSeen.assign(maxKmer+1, 0);		}	//	a record of the kmers that we have already found
+		touched.clear();
 		
-		int numKmers = candidateSeq->getNumBases() - kmerSize + 1;	
-	
-		for(int i=0;i<numKmers;i++){
-			int kmerNumber = kmer.getKmerNumber(candidateSeq->getUnaligned(), i);		//	go through the query sequence and get a kmer number
-			if(timesKmerFound[kmerNumber] == 0){				//	if we haven't seen it before...
-				for(int j=0;j<kmerLocations[kmerNumber].size();j++){//increase the count for each sequence that also has
-					matches[kmerLocations[kmerNumber][j]]++;	//	that kmer
+		int numKmers = candidateSeq->getNumBases() - kmerSize + 1;
+		kmer.getKmerNumbers(candidateSeq->getUnaligned(), queryKmers);
+		
+		for(int i=0;i<queryKmers.size();i++){
+			int kmerNumber = queryKmers[i];						//	go through the query sequence kmers
+			if(kmerSeen[kmerNumber] == 0){						//	if we haven't seen it before...
+				for(unsigned long long j=packedStarts[kmerNumber];j<packedStarts[kmerNumber+1];j++){//increase the count for each sequence that also has
+					int seq = packedSeqs[j];					//	that kmer
+					if (matchCounts[seq] == 0) { touched.push_back(seq); }
+					matchCounts[seq]++;
 				}
 			}
-			timesKmerFound[kmerNumber] = 1;						//	ok, we've seen the kmer now
+			kmerSeen[kmerNumber] = 1;							//	ok, we've seen the kmer now
 		}
 		
 		if (num != 1) {
-			vector<seqMatch> seqMatches; seqMatches.resize(numSeqs);
-			for(int i=0;i<numSeqs;i++){		
-				seqMatches[i].seq = i;
-				seqMatches[i].match = matches[i];
+			vector<seqMatch> seqMatches; seqMatches.reserve(touched.size());
+			for(int i=0;i<touched.size();i++){	seqMatches.push_back(seqMatch(touched[i], matchCounts[touched[i]]));	}
+			
+			//templates that share no kmers are only needed when fewer than num share any
+			for(int i=0;(i<numSeqs) && (seqMatches.size()<num);i++){
+				if (matchCounts[i] == 0) { seqMatches.push_back(seqMatch(i, 0)); }
 			}
 			
-			//sorts putting largest matches first
-			sort(seqMatches.begin(), seqMatches.end(), compareSeqMatches);
+			//puts the num largest matches first, ties go to the first template
+			int numTop = min(num, (int)seqMatches.size());
+			partial_sort(seqMatches.begin(), seqMatches.begin()+numTop, seqMatches.end(), compareSeqMatchesThenSeq);
 			
-			searchScore = seqMatches[0].match;
-			searchScore = 100 * searchScore / (float) numKmers;		//	return the Sequence object corresponding to the db
+			if (numTop > 0) {
+				searchScore = seqMatches[0].match;
+				searchScore = 100 * searchScore / (float) numKmers;		//	return the Sequence object corresponding to the db
+			}
 		
 			//save top matches
-			for (int i = 0; i < num; i++) {
+			for (int i = 0; i < numTop; i++) {
 				topMatches.push_back(seqMatches[i].seq);
 				float thisScore = 100 * seqMatches[i].match / (float) numKmers;
 				Scores.push_back(thisScore);
 			}
 		}else{
 			int bestIndex = 0;
-			int bestMatch = -1;
-			for(int i=0;i<numSeqs;i++){	
-				
-				if (matches[i] > bestMatch) {
-					bestIndex = i;
-					bestMatch = matches[i];
+			int bestMatch = 0;
+			for(int i=0;i<touched.size();i++){
+				int seq = touched[i];
+				if ((matchCounts[seq] > bestMatch) || ((matchCounts[seq] == bestMatch) && (seq < bestIndex))) {
+					bestIndex = seq;
+					bestMatch = matchCounts[seq];
 				}
 			}
 			
@@ -114,6 +134,11 @@ vector<int> KmerDB::findClosestSequences(Sequence* candidateSeq, int num){
 			topMatches.push_back(bestIndex);
 			Scores.push_back(searchScore);
 		}
+		
+		//clear the scratch for the next query
+		for(int i=0;i<touched.size();i++)		{	matchCounts[touched[i]] = 0;	}
+		for(int i=0;i<queryKmers.size();i++)	{	kmerSeen[queryKmers[i]] = 0;	}
+		
 		return topMatches;		
 	}
 	catch(exception& e) {
@@ -121,25 +146,32 @@ vector<int> KmerDB::findClosestSequences(Sequence* candidateSeq, int num){
 		exit(1);
 	}	
 }
-
 /**************************************************************************************************/
 //print shortcut file
 void KmerDB::generateDB(){
 	try {
+		packKmers();
 		
-		ofstream kmerFile;										//	once we have the kmerLocations folder print it out
-		m->openOutputFile(kmerDBName, kmerFile);					//	to a file
+		ofstream kmerFile;										//	once we have the kmer table packed print it out
+		m->openOutputFileBinary(kmerDBName, kmerFile);			//	to a file
 		
-		//output version
-		kmerFile << "#" << m->getVersion() << endl;
+		//output version, then pad so the arrays line up when the file is mapped
+		string versionLine = "#" + m->getVersion() + "\n";
+		kmerFile.write(versionLine.c_str(), versionLine.length());
+		for (int i = versionLine.length(); (i % 8) != 0; i++) { kmerFile.put('\0'); }
 		
-		for(int i=0;i<maxKmer;i++){								//	step through all of the possible kmer numbers
-			kmerFile << i << ' ' << kmerLocations[i].size();	//	print the kmer number and the number of sequences with
-			for(int j=0;j<kmerLocations[i].size();j++){			//	that kmer.  then print out the indices of the sequences
-				kmerFile << ' ' << kmerLocations[i][j];			//	with that kmer.
-			}
-			kmerFile << endl;
-		}
+		Header header;
+		memset(&header, 0, sizeof(Header));
+		memcpy(header.magic, kmerDBMagic, 8);
+		header.version = kmerDBVersion;
+		header.kmerSize = kmerSize;
+		header.numSeqs = count;
+		header.numKmers = maxKmer+1;
+		header.numPostings = packedStarts[maxKmer+1];
+		kmerFile.write((const char*)&header, sizeof(Header));
+		
+		kmerFile.write((const char*)packedStarts, (maxKmer+2) * sizeof(unsigned long long));
+		kmerFile.write((const char*)packedSeqs, header.numPostings * sizeof(unsigned int));
 		kmerFile.close();
 		
 	}
@@ -154,17 +186,19 @@ void KmerDB::addSequence(Sequence seq) {
 	try {
 		Kmer kmer(kmerSize);
 		
-		string unaligned = seq.getUnaligned();	//	...take the unaligned sequence...
-		int numKmers = unaligned.length() - kmerSize + 1;
-			
-		vector<int> seenBefore(maxKmer+1,0);
-		for(int j=0;j<numKmers;j++){						//	...step though the sequence and get each kmer...
-			int kmerNumber = kmer.getKmerNumber(unaligned, j);
-			if(seenBefore[kmerNumber] == 0){
+		if (kmerLocations.size() == 0)		{ kmerLocations.resize(maxKmer+1);	}
+		if (kmerSeen.size() != (maxKmer+1))	{ kmerSeen.assign(maxKmer+1, 0);	}
+		
+		kmer.getKmerNumbers(seq.getUnaligned(), queryKmers);	//	...take the unaligned sequence...
+		
+		for(int j=0;j<queryKmers.size();j++){				//	...step though the sequence and get each kmer...
+			int kmerNumber = queryKmers[j];
+			if(kmerSeen[kmerNumber] == 0){
 				kmerLocations[kmerNumber].push_back(count);		//	...insert the sequence index into kmerLocations for
 			}												//	the appropriate kmer number
-			seenBefore[kmerNumber] = 1;
-		}													
+			kmerSeen[kmerNumber] = 1;
+		}
+		for(int j=0;j<queryKmers.size();j++){	kmerSeen[queryKmers[j]] = 0;	}
 	
 		count++;
 	}
@@ -177,15 +211,110 @@ void KmerDB::addSequence(Sequence seq) {
 
 void KmerDB::readKmerDB(ifstream& kmerDBFile){
 	try {
-					
-		kmerDBFile.seekg(0);									//	start at the beginning of the file
+		kmerDBFile.close();
+		
+		if (mapKmerDB()) { return; }
+		if (m->control_pressed) { return; }
+		
+		ifstream textFile;
+		m->openInputFile(kmerDBName, textFile);
+		readTextKmerDB(textFile);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "KmerDB", "readKmerDB");
+		exit(1);
+	}	
+}
+/**************************************************************************************************/
+//returns false if kmerDBName is not a packed database file
+bool KmerDB::mapKmerDB(){
+	try {
+		unmapKmerDB();
+		
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+		int fd = ::open(kmerDBName.c_str(), O_RDONLY);
+		if (fd == -1) { return false; }
+		
+		struct stat info;
+		if (fstat(fd, &info) == -1) { ::close(fd); return false; }
+		mapSize = info.st_size;
+		
+		void* region = mmap(NULL, mapSize, PROT_READ, MAP_SHARED, fd, 0);
+		::close(fd);
+		if (region == MAP_FAILED) { mapSize = 0; return false; }
+		mapData = (char*)region; mapped = true;
+#else
+		ifstream in(kmerDBName.c_str(), ios::binary);
+		if (!in) { return false; }
+		in.seekg(0, ios::end);
+		mapSize = in.tellg();
+		in.seekg(0, ios::beg);
+		
+		mapData = new char[mapSize];
+		in.read(mapData, mapSize);
+		mapped = false;
+#endif
+		
+		//the header starts at the first multiple of 8 after the version line
+		const char* lineEnd = (const char*)memchr(mapData, '\n', mapSize);
+		unsigned long long headerStart = 0;
+		if (lineEnd != NULL) { headerStart = ((lineEnd - mapData) + 8) / 8 * 8; }
+		
+		Header header;
+		if ((lineEnd == NULL) || ((headerStart + sizeof(Header)) > mapSize)) { unmapKmerDB(); return false; }
+		memcpy(&header, mapData + headerStart, sizeof(Header));
+		if (memcmp(header.magic, kmerDBMagic, 8) != 0) { unmapKmerDB(); return false; }
+		
+		unsigned long long startsOffset = headerStart + sizeof(Header);
+		bool valid = (header.version == kmerDBVersion) && (header.kmerSize == kmerSize) && (header.numKmers == (maxKmer+1));
+		valid = valid && (mapSize == (startsOffset + (maxKmer+2) * sizeof(unsigned long long) + header.numPostings * sizeof(unsigned int)));
+		if (!valid) {
+			m->mothurOut("[ERROR]: " + kmerDBName + " is damaged or was made with a different kmer size, please remove it so mothur can rebuild it.\n");
+			unmapKmerDB(); m->control_pressed = true; return false;
+		}
+		
+		packedStarts = (const unsigned long long*)(mapData + startsOffset);
+		packedSeqs = (const unsigned int*)(packedStarts + (maxKmer+2));
+		count = header.numSeqs;
+		
+		return true;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "KmerDB", "mapKmerDB");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+void KmerDB::unmapKmerDB(){
+	try {
+		if (mapData != NULL) {
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+			if (mapped) { munmap(mapData, mapSize); }
+			else { delete[] mapData; }
+#else
+			delete[] mapData;
+#endif
+			packedStarts = NULL; packedSeqs = NULL;
+		}
+		mapData = NULL; mapSize = 0; mapped = false;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "KmerDB", "unmapKmerDB");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//shortcut files written before the packed format
+void KmerDB::readTextKmerDB(ifstream& kmerDBFile){
+	try {
 		
 		//read version
 		string line = m->getline(kmerDBFile); m->gobble(kmerDBFile);
 		
 		string seqName;
 		int seqNumber;
-
+		
+		kmerLocations.resize(maxKmer+1);
 		for(int i=0;i<maxKmer;i++){
 			int numValues = 0;	
 			kmerDBFile >> seqName >> numValues;
@@ -197,19 +326,64 @@ void KmerDB::readKmerDB(ifstream& kmerDBFile){
 		}
 		kmerDBFile.close();
 		
+		packKmers();
 	}
 	catch(exception& e) {
-		m->errorOut(e, "KmerDB", "readKmerDB");
+		m->errorOut(e, "KmerDB", "readTextKmerDB");
 		exit(1);
 	}	
 }
+/**************************************************************************************************/
+//sequences are numbered in the order they are added, so the new ones go after the packed ones for each kmer
+void KmerDB::packKmers(){
+	try {
+		if ((kmerLocations.size() == 0) && (packedStarts != NULL)) { return; } //nothing added since the last pack
+		
+		vector<unsigned long long> newStarts(maxKmer+2, 0);
+		vector<unsigned int> newSeqs;
+		
+		unsigned long long numPostings = 0;
+		if (packedStarts != NULL) { numPostings = packedStarts[maxKmer+1]; }
+		for (int i = 0; i < kmerLocations.size(); i++) { numPostings += kmerLocations[i].size(); }
+		newSeqs.reserve(numPostings);
+		
+		for (int i = 0; i <= maxKmer; i++) {
+			newStarts[i] = newSeqs.size();
+			if (packedStarts != NULL)		{ newSeqs.insert(newSeqs.end(), packedSeqs + packedStarts[i], packedSeqs + packedStarts[i+1]);	}
+			if (i < kmerLocations.size())	{ newSeqs.insert(newSeqs.end(), kmerLocations[i].begin(), kmerLocations[i].end());			}
+		}
+		newStarts[maxKmer+1] = newSeqs.size();
+		
+		unmapKmerDB();
+		kmerStarts.swap(newStarts);
+		kmerSeqs.swap(newSeqs);
+		packedStarts = &kmerStarts[0];
+		packedSeqs = kmerSeqs.data();
+		vector< vector<int> >().swap(kmerLocations);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "KmerDB", "packKmers");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+void KmerDB::setNumSeqs(int i) {
+	try {
+		numSeqs = i;
+		packKmers();
+	}
+	catch(exception& e) {
+		m->errorOut(e, "KmerDB", "setNumSeqs");
+		exit(1);
+	}
+}
 
 /**************************************************************************************************/
 int KmerDB::getCount(int kmer) {
 	try {
 		if (kmer < 0) { return 0; }  //if user gives negative number
 		else if (kmer > maxKmer) {	return 0;	}  //or a kmer that is bigger than maxkmer
-		else {	return kmerLocations[kmer].size();	}  // kmer is in vector range
+		else {	return packedStarts[kmer+1] - packedStarts[kmer];	}  // kmer is in vector range
 	}
 	catch(exception& e) {
 		m->errorOut(e, "KmerDB", "getCount");
@@ -238,7 +412,7 @@ vector<int> KmerDB::getSequencesWithKmer(int kmer) {
 	
 		if (kmer < 0) { }  //if user gives negative number
 		else if (kmer > maxKmer) {	}  //or a kmer that is bigger than maxkmer
-		else {	seqs = kmerLocations[kmer];	}
+		else {	seqs.assign(packedSeqs + packedStarts[kmer], packedSeqs + packedStarts[kmer+1]);	}
 		
 		return seqs;
 	}
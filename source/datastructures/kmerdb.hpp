@@ -10,12 +10,20 @@
  *
  *	This class is a child class of the Database class, which stores the template sequences as a kmer table and provides
  *	a method of searching the kmer table for the sequence with the most kmers in common with a query sequence.
- *	kmerLocations is the primary storage variable that is a two-dimensional vector where each row represents the
- *	different number of kmers and each column contains the index to sequences that use that kmer.
+ *	addSequence fills kmerLocations, a list of sequence indexes for each kmer number. setNumSeqs packs the lists into
+ *	one array of sequence indexes, kmerSeqs, with kmerStarts[k] to kmerStarts[k+1] holding the sequences with kmer k.
  *
  *	Construction of an object of this type will first look for an appropriately named database file and if it is found
  *	then will read in the database file (readKmerDB), otherwise it will generate one and store the data in memory
  *	(generateKmerDB)
+ *
+ *	The database file is the packed arrays as they are in memory, after the version line:
+ *		"#version\n", padded with zeros to a multiple of 8 bytes
+ *		header	magic, format version, kmer size, number of sequences, number of kmers, number of postings
+ *		starts	maxKmer+2 unsigned long longs
+ *		seqs	the unsigned int sequence indexes, sorted within each kmer
+ *	readKmerDB maps the file and searches it in place, so loading takes no parsing and forked processes share the pages.
+ *	Files in the older text format are still read.
 
  */
 
@@ -33,17 +41,41 @@ public:
 	void addSequence(Sequence);
 	vector<int> findClosestSequences(Sequence*, int);
 	void readKmerDB(ifstream&);
+	void setNumSeqs(int);  //called once all the sequences are added, packs the kmer table
 	int getCount(int);  //returns number of sequences with that kmer number
 	vector<int> getSequencesWithKmer(int);  //returns vector of sequences that contain kmer passed in
 	int getReversed(int);  //returns reverse compliment kmerNumber 
 	int getMaxKmer() { return maxKmer; }
 	
 private:
+	struct Header {
+		char magic[8];
+		unsigned int version, kmerSize, numSeqs, numKmers;
+		unsigned long long numPostings;
+	};
 	
 	int kmerSize;
 	int maxKmer, count;
 	string kmerDBName;
-	vector<vector<int> > kmerLocations;
+	vector<vector<int> > kmerLocations;  //sequences added since the table was last packed
+	
+	vector<unsigned long long> kmerStarts;
+	vector<unsigned int> kmerSeqs;
+	const unsigned long long* packedStarts;  //kmerStarts and kmerSeqs, or the mapped database file
+	const unsigned int* packedSeqs;
+	char* mapData;
+	unsigned long long mapSize;
+	bool mapped;
+	
+	vector<int> queryKmers;		//search scratch, kept between calls so a query allocates nothing. Threads each make their own KmerDB
+	vector<int> matchCounts;	//kmers shared with each template, only the templates in touched are nonzero
+	vector<int> touched;
+	vector<char> kmerSeen;
+	
+	void packKmers();
+	bool mapKmerDB();
+	void readTextKmerDB(ifstream&);
+	void unmapKmerDB();
 };
 
 #endif
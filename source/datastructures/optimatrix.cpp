@@ -9,6 +9,7 @@
 #include "optimatrix.h"
 #include "progress.hpp"
 #include "counttable.h"
+#include "sparsedistfile.h"
 
 /***********************************************************************/
 
@@ -69,9 +70,9 @@ ListVector* OptiMatrix::getListSingle() {
 long int OptiMatrix::print(ostream& out) {
     try {
         long int count = 0;
-        for (int i = 0; i < closeness.size(); i++) {
-            for(set<int>::iterator it = closeness[i].begin(); it != closeness[i].end(); it++){
-                out << *it << '\t';
+        for (int i = 0; i < getNumSeqs(); i++) {
+            for (long long j = closeStarts[i]; j < closeStarts[i+1]; j++) {
+                out << closeSeqs[j] << '\t';
                 count++;
             }
             out << endl;
@@ -87,7 +88,7 @@ long int OptiMatrix::print(ostream& out) {
 /***********************************************************************/
 string OptiMatrix::getName(int index) {
     try {
-        if (index > closeness.size()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->control_pressed = true; return ""; }
+        if (index > getNumSeqs()) { m->mothurOut("[ERROR]: index is not valid.\n"); m->control_pressed = true; return ""; }
         string name = nameMap[index];
         return name;
     }
@@ -99,10 +100,8 @@ string OptiMatrix::getName(int index) {
 /***********************************************************************/
 bool OptiMatrix::isClose(int i, int toFind){
     try {
-        bool found = false;
-        if (closeness[i].count(toFind) != 0) { found = true; }
-        return found;
-        
+        return binary_search(closeSeqs.begin()+closeStarts[i], closeSeqs.begin()+closeStarts[i+1], toFind);
+
     }
     catch(exception& e) {
         m->errorOut(e, "OptiMatrix", "isClose");
@@ -110,6 +109,32 @@ bool OptiMatrix::isClose(int i, int toFind){
     }
 }
 /***********************************************************************/
+//packs the lists the readers fill into closeStarts and closeSeqs, dropping repeats and self pairs. frees closeLists as it goes.
+void OptiMatrix::setCloseness(vector< vector<int> >& closeLists){
+    try {
+        long long numClose = 0;
+        for (int i = 0; i < closeLists.size(); i++) {
+            sort(closeLists[i].begin(), closeLists[i].end());
+            closeLists[i].erase(unique(closeLists[i].begin(), closeLists[i].end()), closeLists[i].end());
+            closeLists[i].erase(remove(closeLists[i].begin(), closeLists[i].end(), i), closeLists[i].end());
+            numClose += closeLists[i].size();
+        }
+        
+        closeStarts.assign(1, 0); closeStarts.reserve(closeLists.size()+1);
+        closeSeqs.clear(); closeSeqs.reserve(numClose);
+        for (int i = 0; i < closeLists.size(); i++) {
+            closeSeqs.insert(closeSeqs.end(), closeLists[i].begin(), closeLists[i].end());
+            closeStarts.push_back(closeSeqs.size());
+            vector<int>().swap(closeLists[i]);
+        }
+        closeLists.clear();
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OptiMatrix", "setCloseness");
+        exit(1);
+    }
+}
+/***********************************************************************/
 
 string OptiMatrix::findDistFormat(string distFile){
     try {
@@ -210,7 +235,7 @@ int OptiMatrix::readPhylip(){
         }
         singleton.clear();
 
-        closeness.resize(nonSingletonCount);
+        vector< vector<int> > closeLists(nonSingletonCount);
         
         map<string, string> names;
         if (namefile != "") {
@@ -255,8 +280,8 @@ int OptiMatrix::readPhylip(){
                     if(distance < cutoff){
                         int newB = singletonIndexSwap[j];
                         int newA = singletonIndexSwap[i];
-                        closeness[newA].insert(newB);
-                        closeness[newB].insert(newA);
+                        closeLists[newA].push_back(newB);
+                        closeLists[newB].push_back(newA);
                     }
                     index++; reading->update(index);
                 }
@@ -290,8 +315,8 @@ int OptiMatrix::readPhylip(){
                     if(distance < cutoff && j < i){
                         int newB = singletonIndexSwap[j];
                         int newA = singletonIndexSwap[i];
-                        closeness[newA].insert(newB);
-                        closeness[newB].insert(newA);
+                        closeLists[newA].push_back(newB);
+                        closeLists[newB].push_back(newA);
                     }
                     index++; reading->update(index);
                 }
@@ -305,6 +330,7 @@ int OptiMatrix::readPhylip(){
             }
         }
         in.close();
+        setCloseness(closeLists);
         reading->finish();
         delete reading;
 
@@ -332,6 +358,8 @@ int OptiMatrix::readColumn(){
             nameMap.push_back(it->first);
         }
         
+        if (SparseDistFile::isSparseDistFile(distFile)) { return readSparse(nameAssignment); }
+        
         string firstName, secondName;
         float distance;
         
@@ -384,7 +412,7 @@ int OptiMatrix::readColumn(){
         ifstream in;
         m->openInputFile(distFile, in);
         
-        closeness.resize(nonSingletonCount);
+        vector< vector<int> > closeLists(nonSingletonCount);
         
         map<string, string> names;
         if (namefile != "") {
@@ -419,8 +447,8 @@ int OptiMatrix::readColumn(){
                 
                 int newB = singletonIndexSwap[indexB];
                 int newA = singletonIndexSwap[indexA];
-                closeness[newA].insert(newB);
-                closeness[newB].insert(newA);
+                closeLists[newA].push_back(newB);
+                closeLists[newB].push_back(newA);
                 
                 if (namefile != "") {
                     firstName = names[firstName];  //redundant names
@@ -432,6 +460,7 @@ int OptiMatrix::readColumn(){
             }
         }
         in.close();
+        setCloseness(closeLists);
         nameAssignment.clear();
         
         return 1;
@@ -443,3 +472,92 @@ int OptiMatrix::readColumn(){
     }
 }
 /***********************************************************************/
+//same as readColumn, but the pairs come straight out of the mapped sparse file and each name is looked up once
+int OptiMatrix::readSparse(map<string, int>& nameAssignment){
+    try {
+        SparseDistFile sparse;
+        if (!sparse.open(distFile)) { m->control_pressed = true; return 0; }
+        
+        int numSparseSeqs = sparse.getNumSeqs();
+        vector<int> indexes(numSparseSeqs, -1);
+        vector<string> sparseNames(numSparseSeqs, "");
+        for (int i = 0; i < numSparseSeqs; i++) {
+            sparseNames[i] = sparse.getName(i);
+            map<string,int>::iterator it = nameAssignment.find(sparseNames[i]);
+            if(it == nameAssignment.end()){  m->mothurOut("AAError: Sequence '" + sparseNames[i] + "' was not found in the name or count file, please correct\n"); exit(1);  }
+            indexes[i] = it->second;
+        }
+        
+        ///////////////////// Read to eliminate singletons ///////////////////////
+        vector<bool> singleton; singleton.resize(nameAssignment.size(), true);
+        for (int i = 0; i < numSparseSeqs; i++) {
+            if (m->control_pressed) { return 0; }
+            
+            unsigned int size;
+            const SparseDistCell* row = sparse.getRow(i, size);
+            for (unsigned int k = 0; k < size; k++) {
+                float distance = row[k].dist;
+                if (distance == -1) { distance = 1000000; }
+                else if (sim) { distance = 1.0 - distance;  }  //user has entered a sim matrix that we need to convert.
+                
+                if(distance < cutoff){
+                    singleton[indexes[i]] = false;
+                    singleton[indexes[row[k].neighbor]] = false;
+                }
+            }
+        }
+        //////////////////////////////////////////////////////////////////////////
+        
+        vector<int> singletonIndexSwap(singleton.size(), 0);
+        int nonSingletonCount = 0;
+        for (int i = 0; i < singleton.size(); i++) {
+            if (!singleton[i]) { //if you are a singleton
+                singletonIndexSwap[i] = nonSingletonCount;
+                nonSingletonCount++;
+            }else { singletons.push_back(nameMap[i]); }
+        }
+        singleton.clear();
+        
+        vector< vector<int> > closeLists(nonSingletonCount);
+        
+        map<string, string> names;
+        if (namefile != "") {
+            m->readNames(namefile, names);
+            for (int i = 0; i < singletons.size(); i++) {
+                singletons[i] = names[singletons[i]];
+            }
+            for (int i = 0; i < numSparseSeqs; i++) { sparseNames[i] = names[sparseNames[i]]; } //redundant names
+        }
+        
+        for (int i = 0; i < numSparseSeqs; i++) {
+            if (m->control_pressed) { return 0; }
+            
+            unsigned int size;
+            const SparseDistCell* row = sparse.getRow(i, size);
+            for (unsigned int k = 0; k < size; k++) {
+                float distance = row[k].dist;
+                if (distance == -1) { distance = 1000000; }
+                else if (sim) { distance = 1.0 - distance;  }  //user has entered a sim matrix that we need to convert.
+                
+                if(distance < cutoff){
+                    int newA = singletonIndexSwap[indexes[i]];
+                    int newB = singletonIndexSwap[indexes[row[k].neighbor]];
+                    closeLists[newA].push_back(newB);
+                    closeLists[newB].push_back(newA);
+                    
+                    nameMap[newA] = sparseNames[i];
+                    nameMap[newB] = sparseNames[row[k].neighbor];
+                }
+            }
+        }
+        setCloseness(closeLists);
+        nameAssignment.clear();
+        
+        return 1;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OptiMatrix", "readSparse");
+        exit(1);
+    }
+}
+/***********************************************************************/
@@ -25,11 +25,11 @@ public:
     OptiMatrix(string, string, string, string, double, bool); //distfile, name or count, format, distformat, cutoff, sim
     ~OptiMatrix(){ }
     
-    set<int> getCloseSeqs(int i) { return closeness[i]; }
-    //int get(int i, int j) { return closeness[i][j]; }
+    //the seqs close to i are getCloseSeqs(i)[0] to getCloseSeqs(i)[getNumClose(i)-1], sorted
+    const int* getCloseSeqs(int i) { return closeSeqs.data() + closeStarts[i]; }
     bool isClose(int, int);
-    int getNumClose(int index) { return closeness[index].size(); }
-    int getNumSeqs() { return closeness.size(); }
+    int getNumClose(int index) { return closeStarts[index+1] - closeStarts[index]; }
+    int getNumSeqs() { if (closeStarts.size() == 0) { return 0; } return closeStarts.size()-1; }
     int getNumSingletons() { return singletons.size(); }
     //map<int, string> getNameMap() { return nameMap; }
     string getName(int); //name from nameMap index
@@ -39,7 +39,8 @@ public:
     
 private:
     
-    vector< set<int> > closeness;  //closeness[0] contains indexes of seqs "close" to seq 0.
+    vector<long long> closeStarts;  //seqs close to seq i are closeSeqs[closeStarts[i]] to closeSeqs[closeStarts[i+1]-1]
+    vector<int> closeSeqs;
     vector<string> singletons;
     vector<string> nameMap;
     
@@ -52,7 +53,9 @@ private:
     string findDistFormat(string distFile);
     int readPhylip();
     int readColumn();
+    int readSparse(map<string, int>&);
     map<string, int> readNames(string namefile, vector<string>&);
+    void setCloseness(vector< vector<int> >&);
     
 };
 
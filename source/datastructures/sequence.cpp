@@ -678,7 +678,7 @@ string Sequence::getName(){
 
 //********************************************************************************************************************
 
-string Sequence::getAligned(){
+const string& Sequence::getAligned() const {
 	if(isAligned == 0)	{ return unaligned; }
 	else				{  return aligned;  }
 }
@@ -55,7 +55,7 @@ public:
 	
 	string convert2ints();
 	string getName();
-	string getAligned();
+	const string& getAligned() const;
 	string getPairwise();
 	string getUnaligned();
 	string getInlineSeq();
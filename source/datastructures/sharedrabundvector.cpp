@@ -14,7 +14,7 @@
 
 
 /***********************************************************************/
-SharedRAbundVector::SharedRAbundVector() : DataVector(), maxRank(0), numBins(0), numSeqs(0) {} 
+SharedRAbundVector::SharedRAbundVector() : DataVector(), maxRank(0), numBins(0), numSeqs(0), dense(false), length(0), numNonZero(0) {} 
 /***********************************************************************/
 
 SharedRAbundVector::~SharedRAbundVector() {
@@ -24,15 +24,7 @@ SharedRAbundVector::~SharedRAbundVector() {
 
 /***********************************************************************/
 
-SharedRAbundVector::SharedRAbundVector(int n) : DataVector(), maxRank(0), numBins(n), numSeqs(0) {
-		individual newGuy;
-		//initialize data
-		for (int i=0; i< n; i++) {
-			newGuy.bin = i;
-			newGuy.abundance = 0;
-			data.push_back(newGuy);
-		}
-}
+SharedRAbundVector::SharedRAbundVector(int n) : DataVector(), maxRank(0), numBins(n), numSeqs(0), dense(false), length(n), numNonZero(0) {} //all zero, so nothing to store
 
 /***********************************************************************
 
@@ -57,7 +49,7 @@ SharedRAbundVector::SharedRAbundVector(string id, vector<individual> rav) : Data
 
 ***********************************************************************/
 //reads a shared file
-SharedRAbundVector::SharedRAbundVector(ifstream& f) : DataVector(), maxRank(0), numBins(0), numSeqs(0) {
+SharedRAbundVector::SharedRAbundVector(ifstream& f) : DataVector(), maxRank(0), numBins(0), numSeqs(0), dense(false), length(0), numNonZero(0) {
 	try {
 		m->clearAllGroups();
 		vector<string> allGroups;
@@ -191,9 +183,7 @@ SharedRAbundVector::SharedRAbundVector(ifstream& f) : DataVector(), maxRank(0),
 
 void SharedRAbundVector::set(int binNumber, int newBinSize, string groupname){
 	try {
-		int oldBinSize = data[binNumber].abundance;
-		data[binNumber].abundance = newBinSize;
-		data[binNumber].group = groupname;
+		int oldBinSize = setAbund(binNumber, newBinSize);
 	
 		if(newBinSize > maxRank)	{	maxRank = newBinSize;	}
 	
@@ -207,24 +197,39 @@ void SharedRAbundVector::set(int binNumber, int newBinSize, string groupname){
 /***********************************************************************/
 
 void SharedRAbundVector::setData(vector <individual> newData){
-	data = newData;
+	vector<int> newAbunds;
+	for (int i = 0; i < newData.size(); i++) { newAbunds.push_back(newData[i].abundance); }
+	fill(newAbunds);
 }
 
 /***********************************************************************/
 
 int SharedRAbundVector::getAbundance(int index){
-	return data[index].abundance;
+	if (index >= length) { return 0; }
+	if (dense) { return abunds[index]; }
 	
+	vector<int>::iterator it = lower_bound(bins.begin(), bins.end(), index);
+	if ((it != bins.end()) && (*it == index)) { return abunds[it - bins.begin()]; }
+	return 0;
 }
 /***********************************************************************/
 //returns vector of abundances 
 vector<int> SharedRAbundVector::getAbundances(){
-    vector<int> abunds;
-    for (int i = 0; i < data.size(); i++) {
-        abunds.push_back(data[i].abundance);
-    }
+    if (dense) { return abunds; }
+    
+    vector<int> allAbunds(length, 0);
+    for (int i = 0; i < bins.size(); i++) { allAbunds[bins[i]] = abunds[i]; }
     
-	return abunds;
+	return allAbunds;
+}
+/***********************************************************************/
+vector<int> SharedRAbundVector::getNonZeroBins(){
+    if (!dense) { return bins; }
+    
+    vector<int> nonZero; nonZero.reserve(numNonZero);
+    for (int i = 0; i < abunds.size(); i++) { if (abunds[i] != 0) { nonZero.push_back(i); } }
+    
+	return nonZero;
 }
 
 
@@ -232,27 +237,46 @@ vector<int> SharedRAbundVector::getAbundances(){
 
 int SharedRAbundVector::numNZ(){
 	int sum = 0;
-	for(int i = 1; i < numBins; i++)
-		if(data[i].abundance > 0)
-			sum++;
+	if (dense) {
+		for(int i = 1; i < numBins; i++)
+			if(abunds[i] > 0)
+				sum++;
+	}else {
+		for(int i = 0; i < bins.size(); i++)
+			if((bins[i] >= 1) && (bins[i] < numBins) && (abunds[i] > 0))
+				sum++;
+	}
 	return sum;
 }
 /***********************************************************************/
 
 void SharedRAbundVector::sortD(){
-	struct individual indObj;
-	sort(data.begin()+1, data.end(), indObj);
+	vector<int> sorted = getAbundances();
+	sort(sorted.begin()+1, sorted.end(), greater<int>());
+	fill(sorted);
 }
 /***********************************************************************/
 
 individual SharedRAbundVector::get(int index){
-	return data[index];
-	
+	individual thisGuy;
+	thisGuy.group = group;
+	thisGuy.bin = index;
+	thisGuy.abundance = getAbundance(index);
+	return thisGuy;
 }
 /***********************************************************************/
 
 vector <individual> SharedRAbundVector::getData(){
-	return data;
+	vector<individual> thisData;
+	vector<int> allAbunds = getAbundances();
+	for (int i = 0; i < allAbunds.size(); i++) {
+		individual thisGuy;
+		thisGuy.group = group;
+		thisGuy.bin = i;
+		thisGuy.abundance = allAbunds[i];
+		thisData.push_back(thisGuy);
+	}
+	return thisData;
 }
 /***********************************************************************/
 
@@ -260,7 +284,11 @@ void SharedRAbundVector::clear(){
 	numBins = 0;
 	maxRank = 0;
 	numSeqs = 0;
-	data.clear();
+	abunds.clear();
+	bins.clear();
+	dense = false;
+	length = 0;
+	numNonZero = 0;
 	for (int i = 0; i < lookup.size(); i++) {  delete lookup[i]; lookup[i] = NULL; }
 	lookup.clear();
 }
@@ -268,13 +296,12 @@ void SharedRAbundVector::clear(){
 
 void SharedRAbundVector::push_back(int binSize, string groupName){
 	try {
-		individual newGuy;
-		newGuy.abundance = binSize;
-		newGuy.group = groupName;
-		newGuy.bin = data.size();
-		
-		data.push_back(newGuy);
+		if (dense) { abunds.push_back(binSize); }
+		else if (binSize != 0) { bins.push_back(length); abunds.push_back(binSize); }
+		if (binSize != 0) { numNonZero++; }
+		length++;
 		numBins++;
+		updateStorage(); //constant time, so rows read bin by bin end up stored the right way
 	
 		if(binSize > maxRank){
 			maxRank = binSize;
@@ -292,12 +319,7 @@ void SharedRAbundVector::push_back(int binSize, string groupName){
 
 void SharedRAbundVector::insert(int binSize, int otu, string groupName){
 	try {
-		individual newGuy;
-		newGuy.abundance = binSize;
-		newGuy.group = groupName;
-		newGuy.bin = otu;
-		
-		data.insert(data.begin()+otu, newGuy);
+		insertBin(otu, binSize);
 		numBins++;
 	
 		if(binSize > maxRank){
@@ -316,12 +338,7 @@ void SharedRAbundVector::insert(int binSize, int otu, string groupName){
 
 void SharedRAbundVector::push_front(int binSize, int otu, string groupName){
 	try {
-		individual newGuy;
-		newGuy.abundance = binSize;
-		newGuy.group = groupName;
-		newGuy.bin = otu;
-		
-		data.insert(data.begin(), newGuy);
+		insertBin(0, binSize);
 		numBins++;
 	
 		if(binSize > maxRank){
@@ -338,34 +355,29 @@ void SharedRAbundVector::push_front(int binSize, int otu, string groupName){
 
 /***********************************************************************/
 void SharedRAbundVector::pop_back(){
-	numSeqs -= data[data.size()-1].abundance;
+	numSeqs -= getAbundance(length-1);
 	numBins--;
-	return data.pop_back();
-}
-
-/***********************************************************************/
-
-
-vector<individual>::reverse_iterator SharedRAbundVector::rbegin(){
-	return data.rbegin();				
-}
-
-/***********************************************************************/
-
-vector<individual>::reverse_iterator SharedRAbundVector::rend(){
-	return data.rend();					
+	resize(length-1);
 }
 
 /***********************************************************************/
 void SharedRAbundVector::resize(int size){
-	
-	data.resize(size);
+	if (dense) {
+		for (int i = size; i < abunds.size(); i++) { if (abunds[i] != 0) { numNonZero--; } }
+		abunds.resize(size, 0);
+	}else {
+		int keep = lower_bound(bins.begin(), bins.end(), size) - bins.begin();
+		numNonZero = keep;
+		bins.resize(keep); abunds.resize(keep);
+	}
+	length = size;
+	updateStorage();
 }
 
 /***********************************************************************/
 
 int SharedRAbundVector::size(){
-	return data.size();
+	return length;
 }
 
 
@@ -419,7 +431,15 @@ void SharedRAbundVector::print(ostream& output) {
 	try {
 		output << numBins;
 	
-		for(int i=0;i<data.size();i++){		output  << '\t' << data[i].abundance;		}
+		if (dense) {
+			for(int i=0;i<abunds.size();i++){		output  << '\t' << abunds[i];		}
+		}else {
+			int next = 0;
+			for(int i=0;i<length;i++){
+				if ((next < bins.size()) && (bins[next] == i)) { output  << '\t' << abunds[next]; next++; }
+				else { output << "\t0"; }
+			}
+		}
 		output << endl;
 	}
 	catch(exception& e) {
@@ -591,10 +611,9 @@ RAbundVector SharedRAbundVector::getRAbundVector() {
 	try {
 		RAbundVector rav;
 		
-		for (int i = 0; i < data.size(); i++) {
-			if(data[i].abundance != 0) {
-				rav.push_back(data[i].abundance);
-			}
+		vector<int> nonZero = getNonZeroBins();
+		for (int i = 0; i < nonZero.size(); i++) {
+			rav.push_back(getAbundance(nonZero[i]));
 		}
 		
 		rav.setLabel(label);
@@ -610,9 +629,10 @@ RAbundVector SharedRAbundVector::getRAbundVector() {
 RAbundVector SharedRAbundVector::getRAbundVector2() {
 	try {
 		RAbundVector rav;
-		for(int i = 0; i < numBins; i++)
-			if(data[i].abundance != 0)
-				rav.push_back(data[i].abundance-1);
+		vector<int> nonZero = getNonZeroBins();
+		for(int i = 0; i < nonZero.size(); i++)
+			if(nonZero[i] < numBins)
+				rav.push_back(getAbundance(nonZero[i])-1);
 		return rav;
 	}
 	catch(exception& e) {
@@ -626,8 +646,9 @@ SharedSAbundVector SharedRAbundVector::getSharedSAbundVector(){
 	try {
 		SharedSAbundVector sav(maxRank+1);
 		
-		for(int i=0;i<data.size();i++){
-			int abund = data[i].abundance;
+		vector<int> nonZero = getNonZeroBins();
+		for(int i=0;i<nonZero.size();i++){
+			int abund = getAbundance(nonZero[i]);
 			sav.set(abund, sav.getAbundance(abund) + 1, group);
 		}
 		
@@ -648,8 +669,9 @@ SAbundVector SharedRAbundVector::getSAbundVector() {
 	try {
 		SAbundVector sav(maxRank+1);
 		
-		for(int i=0;i<data.size();i++){
-			int abund = data[i].abundance;
+		vector<int> nonZero = getNonZeroBins();
+		for(int i=0;i<nonZero.size();i++){
+			int abund = getAbundance(nonZero[i]);
 			sav.set(abund, sav.get(abund) + 1);
 		}
 		sav.set(0, 0);
@@ -668,9 +690,11 @@ SharedOrderVector SharedRAbundVector::getSharedOrderVector() {
 	try {
 		SharedOrderVector ov;
 	
-		for(int i=0;i<data.size();i++){
-			for(int j=0;j<data[i].abundance;j++){
-				ov.push_back(data[i].bin, data[i].abundance, data[i].group);
+		vector<int> nonZero = getNonZeroBins();
+		for(int i=0;i<nonZero.size();i++){
+			int abund = getAbundance(nonZero[i]);
+			for(int j=0;j<abund;j++){
+				ov.push_back(nonZero[i], abund, group);
 			}
 		}
 		m->mothurRandomShuffle(ov);
@@ -690,9 +714,12 @@ SharedOrderVector SharedRAbundVector::getSharedOrderVector() {
 OrderVector SharedRAbundVector::getOrderVector(map<string,int>* nameMap = NULL) {
 	try {
 		OrderVector ov;
-		for(int i=0;i<numBins;i++){
-			for(int j=0;j<data[i].abundance;j++){
-				ov.push_back(i);
+		vector<int> nonZero = getNonZeroBins();
+		for(int i=0;i<nonZero.size();i++){
+			if (nonZero[i] >= numBins) { break; }
+			int abund = getAbundance(nonZero[i]);
+			for(int j=0;j<abund;j++){
+				ov.push_back(nonZero[i]);
 			}
 		}
 		m->mothurRandomShuffle(ov);
@@ -708,4 +735,102 @@ OrderVector SharedRAbundVector::getOrderVector(map<string,int>* nameMap = NULL)
 }
 
 /***********************************************************************/
+//returns the old abundance of the bin. Some callers size the vector by the number of filled bins, so a bin past the end grows it
+int SharedRAbundVector::setAbund(int bin, int abund) {
+	try {
+		int oldAbund = 0;
+		if (bin >= length) {
+			if (dense) { abunds.resize(bin+1, 0); }
+			length = bin+1;
+		}
+		
+		if (dense) { oldAbund = abunds[bin]; abunds[bin] = abund; }
+		else {
+			int pos = lower_bound(bins.begin(), bins.end(), bin) - bins.begin();
+			bool found = ((pos < bins.size()) && (bins[pos] == bin));
+
+			if (found) {
+				oldAbund = abunds[pos];
+				if (abund == 0) { bins.erase(bins.begin()+pos); abunds.erase(abunds.begin()+pos); }
+				else { abunds[pos] = abund; }
+			}else if (abund != 0) {
+				bins.insert(bins.begin()+pos, bin); abunds.insert(abunds.begin()+pos, abund);
+			}
+		}
+
+		if ((oldAbund == 0) && (abund != 0)) { numNonZero++; }
+		else if ((oldAbund != 0) && (abund == 0)) { numNonZero--; }
+		updateStorage();
 
+		return oldAbund;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SharedRAbundVector", "setAbund");
+		exit(1);
+	}
+}
+/***********************************************************************/
+//adds a bin at position bin, the bins after it move up one
+void SharedRAbundVector::insertBin(int bin, int abund) {
+	try {
+		if (dense) { abunds.insert(abunds.begin()+bin, abund); }
+		else {
+			int pos = lower_bound(bins.begin(), bins.end(), bin) - bins.begin();
+			for (int i = pos; i < bins.size(); i++) { bins[i]++; }
+			if (abund != 0) { bins.insert(bins.begin()+pos, bin); abunds.insert(abunds.begin()+pos, abund); }
+		}
+
+		if (abund != 0) { numNonZero++; }
+		length++;
+		updateStorage();
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SharedRAbundVector", "insertBin");
+		exit(1);
+	}
+}
+/***********************************************************************/
+//replaces the stored abundances, does not change numBins, numSeqs or maxRank
+void SharedRAbundVector::fill(vector<int>& newAbunds) {
+	try {
+		dense = true;
+		abunds = newAbunds;
+		bins.clear();
+		length = abunds.size();
+		numNonZero = 0;
+		for (int i = 0; i < abunds.size(); i++) { if (abunds[i] != 0) { numNonZero++; } }
+		updateStorage();
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SharedRAbundVector", "fill");
+		exit(1);
+	}
+}
+/***********************************************************************/
+//a bin / abundance pair takes the space of 2 dense bins. Switch to sparse below a quarter non zero and back above a half,
+//so a vector being filled does not switch back and forth
+void SharedRAbundVector::updateStorage() {
+	try {
+		if (dense) {
+			if ((length >= 64) && ((numNonZero * 4) < length)) {
+				vector<int> nonZeroAbunds; nonZeroAbunds.reserve(numNonZero);
+				bins.clear(); bins.reserve(numNonZero);
+				for (int i = 0; i < abunds.size(); i++) {
+					if (abunds[i] != 0) { bins.push_back(i); nonZeroAbunds.push_back(abunds[i]); }
+				}
+				abunds.swap(nonZeroAbunds);
+				dense = false;
+			}
+		}else if ((numNonZero * 2) > length) {
+			vector<int> allAbunds = getAbundances();
+			abunds.swap(allAbunds);
+			vector<int>().swap(bins);
+			dense = true;
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SharedRAbundVector", "updateStorage");
+		exit(1);
+	}
+}
+/***********************************************************************/
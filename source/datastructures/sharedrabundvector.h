@@ -19,19 +19,24 @@
 
 /*  DataStructure for a shared file.
 	This class is a child to datavector.  It represents OTU information at a certain distance. 
-	It is similiar to an rabundvector except each member of data knows which group it belongs to.
-	Each member of the internal container "data" is a struct of type individual. 
-	An individual which knows the OTU from which it came, 
-	the group it is in and its abundance.  */
+	It is similiar to an rabundvector except it knows which group it belongs to.
+	get and getData return the abundances as structs of type individual, 
+	which know the OTU from which they came, the group they are in and their abundance.
+	Most groups in a large shared file have only a few of the OTUs, so when less than a quarter of the 
+	OTUs are non zero only those are stored, as sorted bin / abundance pairs.  */
 
 
 class SharedRAbundVector : public DataVector {
 	
+#ifdef UNIT_TEST
+	friend class TestSharedRAbundVector;
+#endif
+	
 public:
 	SharedRAbundVector();
 	SharedRAbundVector(int);
 	//SharedRAbundVector(string, vector<int>);
-	SharedRAbundVector(const SharedRAbundVector& bv) : DataVector(bv), data(bv.data), maxRank(bv.maxRank), numBins(bv.numBins), numSeqs(bv.numSeqs), group(bv.group), index(bv.index){};
+	SharedRAbundVector(const SharedRAbundVector& bv) : DataVector(bv), maxRank(bv.maxRank), numBins(bv.numBins), numSeqs(bv.numSeqs), group(bv.group), index(bv.index), abunds(bv.abunds), bins(bv.bins), dense(bv.dense), length(bv.length), numNonZero(bv.numNonZero){};
     SharedRAbundVector(ifstream&);
 	~SharedRAbundVector();
 
@@ -51,6 +56,7 @@ public:
 	vector <individual> getData();
 	int getAbundance(int);
     vector<int> getAbundances();
+	vector<int> getNonZeroBins(); //bins with abundance != 0, in order
 	int numNZ();
 	void sortD();  //Sorts the data in descending order.
 	void push_front(int, int, string); //abundance, otu, groupname
@@ -60,8 +66,6 @@ public:
 	void resize(int);
 	int size();
 	void clear();
-	vector<individual>::reverse_iterator rbegin();
-	vector<individual>::reverse_iterator rend();
 	
 	void print(ostream&);
 	void printHeaders(ostream&);
@@ -78,7 +82,6 @@ public:
 	
 private:
     int eliminateZeroOTUS();
-	vector<individual>  data; 
 	vector<SharedRAbundVector*> lookup;
 	//GlobalData* globaldata;
 	//GroupMap* groupmap;
@@ -87,6 +90,16 @@ private:
 	int numSeqs;
 	string group;
 	int index;	
+	
+	vector<int> abunds;	//dense: abundance of every bin, sparse: abundance of each bin in bins
+	vector<int> bins;	//sparse only, the non zero bins in ascending order
+	bool dense;
+	int length, numNonZero;
+	
+	int setAbund(int, int);	//bin, abundance. returns the old abundance
+	void insertBin(int, int);	//bin, abundance. shifts the bins after it
+	void fill(vector<int>&);
+	void updateStorage();
 };
 
 
@@ -177,26 +177,16 @@ SAbundVector SharedSAbundVector::getSAbundVector(){
 
 /***********************************************************************/
 
-bool compareMembers (individual member, individual member2){
-
-  if(member.abundance < member2.abundance){
-    return true;   }   
-  else{
-	return false; 
-  }
-}
-
-/***********************************************************************/
 SharedRAbundVector SharedSAbundVector::getSharedRAbundVector(){
 	try {
 		SharedRAbundVector rav;
 		
-		for(int i=1;i<data.size();i++){		
+		//largest otus first
+		for(int i=data.size()-1;i>0;i--){		
 			for(int j=0;j<data[i].abundance;j++){
 				rav.push_back(i, data[i].group);
 			}
 		}
-		sort(rav.rbegin(), rav.rend(), compareMembers);
 	
 		rav.setLabel(label);
 		rav.setGroup(group);
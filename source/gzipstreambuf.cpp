@@ -0,0 +1,309 @@
+/*
+ *  gzipstreambuf.cpp
+ *  Mothur
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 Schloss Lab. All rights reserved.
+ *
+ */
+
+#include "gzipstreambuf.h"
+
+static const int gzipChunkSize = 65536;
+static const int gzipPutback = 16;		//bytes kept before the read position for putback and unget
+
+static const int gzipBufIndex = ios_base::xalloc();	//pword holds the stream's GzipStreamBuf, iword whether the callback is registered
+
+/**************************************************************************************************/
+//the GzipStreamBuf lives as long as its ifstream
+static void gzipStreamEvent(ios_base::event event, ios_base& stream, int index){
+#ifdef USE_BOOST
+	if (event == ios_base::erase_event)			{ delete (GzipStreamBuf*) stream.pword(index); stream.pword(index) = NULL; }
+	else if (event == ios_base::copyfmt_event)	{ stream.pword(index) = NULL; } //copyfmt copies the pointer, not the buffer
+#endif
+}
+/**************************************************************************************************/
+
+bool GzipStreamBuf::attach(ifstream& in){
+	try {
+		detach(in);
+
+	#ifdef USE_BOOST
+		filebuf* file = in.rdbuf();
+		char magic[2];
+		streamsize numRead = file->sgetn(magic, 2);
+		file->pubseekpos(0, ios_base::in);
+
+		if ((numRead != 2) || ((unsigned char) magic[0] != 0x1f) || ((unsigned char) magic[1] != 0x8b)) { return false; }
+
+		GzipStreamBuf* gzip = new GzipStreamBuf(file);
+		if (in.iword(gzipBufIndex) == 0) { in.register_callback(gzipStreamEvent, gzipBufIndex); in.iword(gzipBufIndex) = 1; }
+		in.pword(gzipBufIndex) = gzip;
+		in.basic_ios<char>::rdbuf(gzip);
+
+		return true;
+	#else
+		return false;
+	#endif
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "GzipStreamBuf", "attach");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
+void GzipStreamBuf::detach(ifstream& in){
+	try {
+	#ifdef USE_BOOST
+		GzipStreamBuf* gzip = (GzipStreamBuf*) in.pword(gzipBufIndex);
+		if (gzip == NULL) { return; }
+
+		ios_base::iostate state = in.rdstate();
+		in.basic_ios<char>::rdbuf(in.rdbuf());
+		in.clear(state);
+
+		delete gzip;
+		in.pword(gzipBufIndex) = NULL;
+	#endif
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "GzipStreamBuf", "detach");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
+bool GzipStreamBuf::isSeekable(ifstream& in){
+#ifdef USE_BOOST
+	GzipStreamBuf* gzip = (GzipStreamBuf*) in.pword(gzipBufIndex);
+	if (gzip != NULL) { return gzip->isBGZF(); }
+#endif
+	return true;
+}
+/**************************************************************************************************/
+#ifdef USE_BOOST
+
+GzipStreamBuf::GzipStreamBuf(streambuf* s) : source(s), bufferStart(0), totalSize(-1), finished(false), bgzf(false), indexed(false), sourceMoved(false), memberOpen(false) {
+	try {
+		m = MothurOut::getInstance();
+
+		compressed.resize(gzipChunkSize);
+		buffer.resize(gzipPutback + gzipChunkSize);
+
+		memset(&stream, 0, sizeof(stream));
+		inflateInit2(&stream, 16 + MAX_WBITS); //gzip header and trailer
+
+		unsigned int blockSize = 0;
+		bgzf = readBlockHeader(0, blockSize);
+
+		restart(0, 0);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "GzipStreamBuf", "GzipStreamBuf");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
+GzipStreamBuf::~GzipStreamBuf(){ inflateEnd(&stream); }
+
+/**************************************************************************************************/
+
+GzipStreamBuf::int_type GzipStreamBuf::underflow(){
+	try {
+		if (gptr() < egptr())	{ return traits_type::to_int_type(*gptr());	}
+		if (!inflateMore())		{ return traits_type::eof();				}
+		return traits_type::to_int_type(*gptr());
+	}
+	catch(exception& e) {
+		m->errorOut(e, "GzipStreamBuf", "underflow");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//inflates the next chunk after egptr, keeping the last gzipPutback bytes read in front of it
+bool GzipStreamBuf::inflateMore(){
+	try {
+		if (finished) { return false; }
+
+		size_t keep = min((size_t) (egptr() - eback()), (size_t) gzipPutback);
+		memmove(&buffer[0], egptr() - keep, keep);
+		bufferStart += (egptr() - eback()) - keep;
+
+		size_t space = buffer.size() - keep;
+		size_t produced = 0;
+		while (produced == 0) {
+			if (stream.avail_in == 0) {
+				streamsize numRead = source->sgetn(&compressed[0], compressed.size());
+				if (numRead <= 0) {
+					if (memberOpen) { m->mothurOut("[ERROR]: gzip file ends in the middle of a compressed member, it may be truncated.\n"); m->control_pressed = true; }
+					finished = true; break;
+				}
+				stream.next_in = (Bytef*) &compressed[0];
+				stream.avail_in = numRead;
+			}
+
+			stream.next_out = (Bytef*) &buffer[keep];
+			stream.avail_out = space;
+			int result = inflate(&stream, Z_NO_FLUSH);
+			produced = space - stream.avail_out;
+			memberOpen = (result != Z_STREAM_END);
+
+			if (result == Z_STREAM_END) { inflateReset(&stream); } //a gzip file can hold several members, BGZF has one per block
+			else if ((result != Z_OK) && (result != Z_BUF_ERROR)) {
+				string reason = (stream.msg != NULL) ? stream.msg : "unknown error";
+				m->mothurOut("[ERROR]: could not decompress gzip file: " + reason + ".\n"); m->control_pressed = true;
+				finished = true; break;
+			}
+		}
+
+		setg(&buffer[0], &buffer[keep], &buffer[keep + produced]);
+		if (finished) { totalSize = bufferStart + keep; }
+
+		return (produced != 0);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "GzipStreamBuf", "inflateMore");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//starts inflating at the gzip member beginning at compressedStart, whose first byte is at uncompressedStart
+void GzipStreamBuf::restart(unsigned long long compressedStart, unsigned long long uncompressedStart){
+	try {
+		source->pubseekpos(compressedStart, ios_base::in);
+		inflateReset(&stream);
+		stream.next_in = NULL; stream.avail_in = 0;
+
+		bufferStart = uncompressedStart;
+		setg(&buffer[0], &buffer[0], &buffer[0]);
+		finished = false; sourceMoved = false; memberOpen = false;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "GzipStreamBuf", "restart");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
+GzipStreamBuf::pos_type GzipStreamBuf::seekoff(off_type off, ios_base::seekdir dir, ios_base::openmode which){
+	try {
+		if ((which & ios_base::in) == 0) { return pos_type(off_type(-1)); }
+
+		long long target = off;
+		if (dir == ios_base::cur) {
+			if (off == 0) { return position(); } //tellg
+			target += position();
+		}else if (dir == ios_base::end) {
+			if (totalSize == -1) {
+				if (bgzf) { buildIndex(); }
+				if (totalSize == -1) { moveTo(numeric_limits<unsigned long long>::max()); } //inflate to the end to count
+			}
+			target += totalSize;
+		}
+
+		if ((target < 0) || !moveTo(target)) { return pos_type(off_type(-1)); }
+		return target;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "GzipStreamBuf", "seekoff");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
+GzipStreamBuf::pos_type GzipStreamBuf::seekpos(pos_type pos, ios_base::openmode which){
+	return seekoff(off_type(pos), ios_base::beg, which);
+}
+/**************************************************************************************************/
+//false if target is past the end
+bool GzipStreamBuf::moveTo(unsigned long long target){
+	try {
+		if ((totalSize != -1) && (target > totalSize)) { return false; }
+
+		if (!sourceMoved && (target >= bufferStart) && (target <= bufferStart + (egptr() - eback()))) {
+			setg(eback(), eback() + (target - bufferStart), egptr());
+			return true;
+		}
+
+		if (bgzf) {
+			buildIndex();
+			if ((totalSize != -1) && (target > totalSize)) { return false; }
+		}
+
+		if (bgzf) {
+			//jump to the block holding target, unless it is the block being inflated
+			int block = upper_bound(blockOffsets.begin(), blockOffsets.end(), target) - blockOffsets.begin() - 1;
+			unsigned long long inflated = bufferStart + (egptr() - eback());
+			if (sourceMoved || (target < bufferStart) || (blockOffsets[block] > inflated)) { restart(blockStarts[block], blockOffsets[block]); }
+		}else if (sourceMoved || (target < bufferStart)) { restart(0, 0); }
+
+		while (true) {
+			unsigned long long inflated = bufferStart + (egptr() - eback());
+			if (target <= inflated) { setg(eback(), eback() + (target - bufferStart), egptr()); return true; }
+
+			setg(eback(), egptr(), egptr());
+			if (!inflateMore()) { return false; }
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "GzipStreamBuf", "moveTo");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//true if the gzip member at offset has a BGZF "BC" extra field, blockSize is then its compressed size
+bool GzipStreamBuf::readBlockHeader(unsigned long long offset, unsigned int& blockSize){
+	try {
+		unsigned char header[18];
+		source->pubseekpos(offset, ios_base::in);
+		if (source->sgetn((char*) header, 18) != 18) { return false; }
+
+		if ((header[0] != 0x1f) || (header[1] != 0x8b) || (header[2] != 8) || ((header[3] & 4) == 0))	{ return false; }
+		if ((header[10] + (header[11] << 8)) < 6)														{ return false; }
+		if ((header[12] != 'B') || (header[13] != 'C') || (header[14] != 2) || (header[15] != 0))		{ return false; }
+
+		blockSize = header[16] + (header[17] << 8) + 1;
+		return true;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "GzipStreamBuf", "readBlockHeader");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//reads the header and size trailer of each block without inflating them. A file that turns out not to be all BGZF
+//blocks is treated as plain gzip
+void GzipStreamBuf::buildIndex(){
+	try {
+		if (indexed) { return; }
+		indexed = true; sourceMoved = true;
+
+		unsigned long long compressedSize = source->pubseekoff(0, ios_base::end, ios_base::in);
+		unsigned long long offset = 0, uncompressed = 0;
+
+		while (offset < compressedSize) {
+			unsigned int blockSize = 0;
+			if (!readBlockHeader(offset, blockSize) || (offset + blockSize > compressedSize)) { bgzf = false; break; }
+
+			unsigned char trailer[4];
+			source->pubseekpos(offset + blockSize - 4, ios_base::in);
+			if (source->sgetn((char*) trailer, 4) != 4) { bgzf = false; break; }
+
+			blockStarts.push_back(offset);
+			blockOffsets.push_back(uncompressed);
+			uncompressed += trailer[0] + (trailer[1] << 8) + (trailer[2] << 16) + ((unsigned long long) trailer[3] << 24);
+			offset += blockSize;
+		}
+
+		if (bgzf)	{ totalSize = uncompressed;							}
+		else		{ blockStarts.clear(); blockOffsets.clear();		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "GzipStreamBuf", "buildIndex");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+#endif
@@ -0,0 +1,70 @@
+#ifndef GZIPSTREAMBUF_H
+#define GZIPSTREAMBUF_H
+
+/*
+ *  gzipstreambuf.h
+ *  Mothur
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 Schloss Lab. All rights reserved.
+ *
+ *  Reads gzip compressed files through an ordinary ifstream.  MothurOut::openInputFile checks the first two bytes of
+ *  each file it opens, and for gzip files the stream reads through a GzipStreamBuf that inflates the stream's own
+ *  filebuf, so every reader sees the uncompressed text.  tellg and seekg work in uncompressed bytes.  BGZF files
+ *  (bgzip, samtools) are a series of gzip blocks of at most 64K, so a seek jumps to the block holding the position
+ *  and divideFile and setFilePosFasta can split them between processors.  Other gzip files seek by inflating from the
+ *  start.  zlib is linked with the boost libraries, so without USE_BOOST files are always read as they are.
+ *
+ */
+
+#include "mothur.h"
+#include "mothurout.h"
+
+#ifdef USE_BOOST
+#include <zlib.h>
+#endif
+
+/**************************************************************************************************/
+
+class GzipStreamBuf : public streambuf {
+
+public:
+	static bool attach(ifstream&);			//call after opening, true if the file is gzip and reads now inflate it
+	static void detach(ifstream&);			//back to reading the file as it is
+	static bool isSeekable(ifstream&);		//false for gzip files without BGZF blocks, where every seek inflates from the start
+
+#ifdef USE_BOOST
+	GzipStreamBuf(streambuf*);
+	~GzipStreamBuf();
+
+	bool isBGZF() { return bgzf; }
+
+protected:
+	int_type underflow();
+	pos_type seekoff(off_type, ios_base::seekdir, ios_base::openmode);
+	pos_type seekpos(pos_type, ios_base::openmode);
+
+private:
+	MothurOut* m;
+	streambuf* source;						//the ifstream's filebuf, owned by the ifstream
+	z_stream stream;
+	vector<char> compressed, buffer;
+	unsigned long long bufferStart;			//uncompressed offset of buffer[0]
+	long long totalSize;					//uncompressed size, -1 until the end is reached or the blocks are indexed
+	bool finished, bgzf, indexed, sourceMoved;
+	bool memberOpen;						//inside a gzip member, so the file must not end here
+
+	vector<unsigned long long> blockStarts, blockOffsets;	//compressed start and uncompressed offset of each BGZF block
+
+	bool inflateMore();
+	void restart(unsigned long long, unsigned long long);
+	bool moveTo(unsigned long long);
+	bool readBlockHeader(unsigned long long, unsigned int&);
+	void buildIndex();
+	unsigned long long position() { return bufferStart + (gptr() - eback()); }
+#endif
+};
+
+/**************************************************************************************************/
+
+#endif
@@ -10,11 +10,13 @@
 #include "mothur.h"
 #include "engine.hpp"
 #include "mothurout.h"
+#include "threadpool.h"
 
 /**************************************************************************************************/
 
 CommandFactory* CommandFactory::_uniqueInstance = 0;
 MothurOut* MothurOut::_uniqueInstance = 0;
+ThreadPool* ThreadPool::_uniqueInstance = 0;
 /***********************************************************************/
 volatile int ctrlc_pressed = 0;
 void ctrlc_handler ( int sig ) {
@@ -11,6 +11,7 @@
 #include "ordervector.hpp"
 #include "sharedordervector.h"
 #include "sharedrabundvector.h"
+#include "gzipstreambuf.h"
 
 
 //needed for testing project
@@ -820,10 +821,27 @@ string MothurOut::getline(ifstream& fileHandle) {
 	}
 }
 /***********************************************************************/
+//s.fasta.gz names its outputs like s.fasta
+string MothurOut::removeGZExtension(string longName){
+	try {
+		int length = longName.length();
+		if ((length > 3) && (longName.substr(length-3) == ".gz")) {
+			string inner = longName.substr(0, length-3);
+			if (getSimpleName(inner).find('.') != string::npos) { return inner; }
+		}
+		return longName;
+	}
+	catch(exception& e) {
+		errorOut(e, "MothurOut", "removeGZExtension");
+		exit(1);
+	}
+}
+/***********************************************************************/
+
 string MothurOut::getRootName(string longName){
 	try {
 	
-		string rootName = longName;
+		string rootName = removeGZExtension(longName);
 
 		if(rootName.find_last_of(".") != rootName.npos){
 			int pos = rootName.find_last_of('.')+1;
@@ -1202,6 +1220,7 @@ string MothurOut::hasPath(string longName){
 string MothurOut::getExtension(string longName){
 	try {
 		string extension = "";
+		longName = removeGZExtension(longName);
 		
 		if(longName.find_last_of('.') != longName.npos){
 			int pos = longName.find_last_of('.');
@@ -1399,6 +1418,7 @@ int MothurOut::openInputFile(string fileName, ifstream& fileHandle, string m){
 				//mothurOut("[ERROR]: Could not open " + completeFileName); mothurOutEndLine();
 				return 1;
 			}else {
+                GzipStreamBuf::attach(fileHandle);
 				//check for blank file
                 zapGremlins(fileHandle);
                 gobble(fileHandle);
@@ -1424,6 +1444,7 @@ int MothurOut::openInputFile(string fileName, ifstream& fileHandle){
 			return 1;
 		}
 		else {
+            GzipStreamBuf::attach(fileHandle);
 			//check for blank file
             zapGremlins(fileHandle);
             gobble(fileHandle);
@@ -1450,6 +1471,7 @@ int MothurOut::openInputFileBinary(string fileName, ifstream& fileHandle){
 			return 1;
 		}
 		else {
+            GzipStreamBuf::attach(fileHandle);
 			//check for blank file
             zapGremlins(fileHandle);
             gobble(fileHandle);
@@ -1476,6 +1498,7 @@ int MothurOut::openInputFileBinary(string fileName, ifstream& fileHandle, string
 			return 1;
 		}
 		else {
+            GzipStreamBuf::attach(fileHandle);
 			//check for blank file
             zapGremlins(fileHandle);
 			gobble(fileHandle);
@@ -1543,6 +1566,48 @@ int MothurOut::openInputFileBinary(string fileName, ifstream& file, boost::iostr
 }
 #endif
 /***********************************************************************/
+//bytes the readers see, the uncompressed size for gzip files
+unsigned long long MothurOut::getFileSize(string fileName){
+    try {
+        unsigned long long size = 0;
+        
+        ifstream in;
+        in.open(getFullPathName(fileName).c_str(), ios::binary);
+        if (!in) { perror ("Error opening file"); }
+        else {
+            GzipStreamBuf::attach(in);
+            in.seekg(0, ios::end);
+            size = in.tellg();
+            in.close();
+        }
+        
+        return size;
+    }
+    catch(exception& e) {
+        errorOut(e, "MothurOut", "getFileSize");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//false for gzip files without BGZF blocks, every seek into them inflates from the start of the file
+bool MothurOut::isSeekable(string fileName){
+    try {
+        ifstream in;
+        in.open(getFullPathName(fileName).c_str(), ios::binary);
+        if (!in) { return true; }
+        
+        GzipStreamBuf::attach(in);
+        bool seekable = GzipStreamBuf::isSeekable(in);
+        in.close();
+        
+        return seekable;
+    }
+    catch(exception& e) {
+        errorOut(e, "MothurOut", "isSeekable");
+        exit(1);
+    }
+}
+/***********************************************************************/
 //results[0] = allGZ, results[1] = allNotGZ
 vector<bool> MothurOut::allGZFiles(vector<string> & files){
     try {
@@ -1583,7 +1648,7 @@ vector<bool> MothurOut::isGZ(string filename){
         ifstream fileHandle;
         boost::iostreams::filtering_istream gzin;
         
-        if (getExtension(filename) != ".gz") { return results; } // results[0] = false; results[1] = false;
+        if ((filename.length() < 3) || (filename.substr(filename.length()-3) != ".gz")) { return results; } // results[0] = false; results[1] = false;
         
         int ableToOpen = openInputFileBinary(filename, fileHandle, gzin, ""); //no error
         
@@ -1897,6 +1962,13 @@ string MothurOut::sortFile(string distFile, string outputDir){
 	}	
 }
 /**************************************************************************************************/
+//size of a file read to the end, without opening it again - gzip files would be inflated a second time
+static unsigned long long getEndPosition(ifstream& in){
+	in.clear();
+	in.seekg(0, ios::end);
+	return in.tellg();
+}
+/**************************************************************************************************/
 vector<unsigned long long> MothurOut::setFilePosFasta(string filename, long long& num) {
 	try {
 			vector<unsigned long long> positions;
@@ -1904,6 +1976,7 @@ vector<unsigned long long> MothurOut::setFilePosFasta(string filename, long long
 			//openInputFileBinary(filename, inFASTA);
             string completeFileName = getFullPathName(filename);
             inFASTA.open(completeFileName.c_str(), ios::binary);
+            GzipStreamBuf::attach(inFASTA);
 						
 			string input;
 			unsigned long long count = 0;
@@ -1920,21 +1993,15 @@ vector<unsigned long long> MothurOut::setFilePosFasta(string filename, long long
 					if (debug) { mothurOut("[DEBUG]: numSeqs = " + toString(positions.size()) +  " count = " + toString(count) + ".\n"); }
 				}
 			}
+			unsigned long long fileEnd = getEndPosition(inFASTA);
 			inFASTA.close();
 		
 			num = positions.size();
             if (debug) { mothurOut("[DEBUG]: num = " + toString(num) + ".\n"); }
-			FILE * pFile;
 			unsigned long long size;
 		
-			//get num bytes in file
-			pFile = fopen (completeFileName.c_str(),"rb");
-			if (pFile==NULL) perror ("Error opening file");
-			else{
-				fseek (pFile, 0, SEEK_END);
-				size=ftell (pFile);
-				fclose (pFile);
-			}
+			//end of the file just read, uncompressed for gzip files
+			size = fileEnd;
 			
 			/*unsigned long long size = positions[(positions.size()-1)];
 			ifstream in;
@@ -1967,6 +2034,7 @@ vector<unsigned long long> MothurOut::setFilePosFasta(string filename, long long
         ifstream inFASTA;
         string completeFileName = getFullPathName(filename);
         inFASTA.open(completeFileName.c_str(), ios::binary);
+        GzipStreamBuf::attach(inFASTA);
         int nameLine = 2;
         if (delim == '@') { nameLine = 4; }
         else if (delim == '>') { nameLine = 2; }
@@ -1998,21 +2066,15 @@ vector<unsigned long long> MothurOut::setFilePosFasta(string filename, long long
                 }
             }
         }
+        unsigned long long fileEnd = getEndPosition(inFASTA);
         inFASTA.close();
         
         num = positions.size();
         if (debug) { mothurOut("[DEBUG]: num = " + toString(num) + ".\n"); }
-        FILE * pFile;
         unsigned long long size;
         
-        //get num bytes in file
-        pFile = fopen (completeFileName.c_str(),"rb");
-        if (pFile==NULL) perror ("Error opening file");
-        else{
-            fseek (pFile, 0, SEEK_END);
-            size=ftell (pFile);
-            fclose (pFile);
-        }
+        //end of the file just read, uncompressed for gzip files
+        size = fileEnd;
         
         if (debug) { mothurOut("[DEBUG]: size = " + toString(size) + ".\n"); }
         
@@ -2034,6 +2096,7 @@ vector<unsigned long long> MothurOut::setFilePosFasta(string filename, int& num)
         //openInputFile(filename, inFASTA);
         string completeFileName = getFullPathName(filename);
         inFASTA.open(completeFileName.c_str(), ios::binary);
+        GzipStreamBuf::attach(inFASTA);
         
         string input;
         unsigned long long count = 0;
@@ -2050,21 +2113,15 @@ vector<unsigned long long> MothurOut::setFilePosFasta(string filename, int& num)
                 if (debug) { mothurOut("[DEBUG]: numSeqs = " + toString(positions.size()) +  " count = " + toString(count) + ".\n"); }
             }
         }
+        unsigned long long fileEnd = getEndPosition(inFASTA);
         inFASTA.close();
         
         num = positions.size();
         if (debug) { mothurOut("[DEBUG]: num = " + toString(num) + ".\n"); }
-        FILE * pFile;
         unsigned long long size;
         
-        //get num bytes in file
-        pFile = fopen (completeFileName.c_str(),"rb");
-        if (pFile==NULL) perror ("Error opening file");
-        else{
-            fseek (pFile, 0, SEEK_END);
-            size=ftell (pFile);
-            fclose (pFile);
-        }
+        //end of the file just read, uncompressed for gzip files
+        size = fileEnd;
         
         /*unsigned long long size = positions[(positions.size()-1)];
          ifstream in;
@@ -2191,21 +2248,15 @@ vector<unsigned long long> MothurOut::setFilePosEachLine(string filename, int& n
 				positions.push_back(count-1);
 				//cout << count-1 << endl;
 			}
+			unsigned long long fileEnd = getEndPosition(in);
 			in.close();
 		
 			num = positions.size()-1;
 		
-			FILE * pFile;
 			unsigned long long size;
 			
-			//get num bytes in file
-			pFile = fopen (filename.c_str(),"rb");
-			if (pFile==NULL) perror ("Error opening file");
-			else{
-				fseek (pFile, 0, SEEK_END);
-				size=ftell (pFile);
-				fclose (pFile);
-			}
+			//end of the file just read, uncompressed for gzip files
+			size = fileEnd;
 		
 			positions[(positions.size()-1)] = size;
 		
@@ -2246,21 +2297,15 @@ vector<unsigned long long> MothurOut::setFilePosEachLine(string filename, unsign
             positions.push_back(count-1);
             //cout << count-1 << endl;
         }
+        unsigned long long fileEnd = getEndPosition(in);
         in.close();
         
         num = positions.size()-1;
         
-        FILE * pFile;
         unsigned long long size;
         
-        //get num bytes in file
-        pFile = fopen (filename.c_str(),"rb");
-        if (pFile==NULL) perror ("Error opening file");
-        else{
-            fseek (pFile, 0, SEEK_END);
-            size=ftell (pFile);
-            fclose (pFile);
-        }
+        //end of the file just read, uncompressed for gzip files
+        size = fileEnd;
         
         positions[(positions.size()-1)] = size;
         
@@ -2279,19 +2324,15 @@ vector<unsigned long long> MothurOut::divideFile(string filename, int& proc) {
         vector<unsigned long long> filePos;
         filePos.push_back(0);
         
-        FILE * pFile;
         unsigned long long size;
         
         filename = getFullPathName(filename);
         
-        //get num bytes in file
-        pFile = fopen (filename.c_str(),"rb");
-        if (pFile==NULL) perror ("Error opening file");
-        else{
-            fseek (pFile, 0, SEEK_END);
-            size=ftell (pFile);
-            fclose (pFile);
-        }
+        //gzip without BGZF blocks to seek to is read start to finish by one process, leave its end open instead of inflating it to size it
+        if (!isSeekable(filename)) { proc = 1; filePos.push_back(numeric_limits<unsigned long long>::max()); return filePos; }
+        
+        //get num bytes in file, uncompressed for gzip files
+        size = getFileSize(filename);
         
 #if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
         
@@ -2358,19 +2399,15 @@ vector<unsigned long long> MothurOut::divideFile(string filename, int& proc, cha
         vector<unsigned long long> filePos;
         filePos.push_back(0);
         
-        FILE * pFile;
         unsigned long long size;
         
         filename = getFullPathName(filename);
         
-        //get num bytes in file
-        pFile = fopen (filename.c_str(),"rb");
-        if (pFile==NULL) perror ("Error opening file");
-        else{
-            fseek (pFile, 0, SEEK_END);
-            size=ftell (pFile);
-            fclose (pFile);
-        }
+        //gzip without BGZF blocks to seek to is read start to finish by one process, leave its end open instead of inflating it to size it
+        if (!isSeekable(filename)) { proc = 1; filePos.push_back(numeric_limits<unsigned long long>::max()); return filePos; }
+        
+        //get num bytes in file, uncompressed for gzip files
+        size = getFileSize(filename);
         
         char secondaryDelim = '>';
         if (delimChar == '@') { secondaryDelim = '+'; }
@@ -2460,19 +2497,15 @@ vector<unsigned long long> MothurOut::divideFilePerLine(string filename, int& pr
 		vector<unsigned long long> filePos;
 		filePos.push_back(0);
 		
-		FILE * pFile;
 		unsigned long long size;
 		
 		filename = getFullPathName(filename);
         
-		//get num bytes in file
-		pFile = fopen (filename.c_str(),"rb");
-		if (pFile==NULL) perror ("Error opening file");
-		else{
-			fseek (pFile, 0, SEEK_END);
-			size=ftell (pFile);
-			fclose (pFile);
-		}
+		//gzip without BGZF blocks to seek to is read start to finish by one process, leave its end open instead of inflating it to size it
+		if (!isSeekable(filename)) { proc = 1; filePos.push_back(numeric_limits<unsigned long long>::max()); return filePos; }
+		
+		//get num bytes in file, uncompressed for gzip files
+		size = getFileSize(filename);
 		
 #if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
         
@@ -2535,7 +2568,8 @@ int MothurOut::divideFile(string filename, int& proc, vector<string>& files) {
 	try{
 		
 		vector<unsigned long long> filePos = divideFile(filename, proc);
-		
+		if (filePos.back() == numeric_limits<unsigned long long>::max()) { filePos.back() = getFileSize(filename); } //open end of a gzip file
+
 		for (int i = 0; i < (filePos.size()-1); i++) {
 			
 			//read file chunk
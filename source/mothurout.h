@@ -78,6 +78,7 @@ class MothurOut {
         vector<string> listBinLabelsInFile;
 		string saveNextLabel, mothurProgramPath, sharedHeaderMode, groupMode, testDirectory;
 		bool printedSharedHeaders, printedListHeaders, commandInputsConvertError, changedSeqNames, modifyNames;
+		bool countCache; //set.dir countcache, save large count tables read as <file>.bin
 		
 		//functions from mothur.h
 		//file operations
@@ -106,6 +107,7 @@ class MothurOut {
 		string getPathName(string);
 		string getSimpleName(string);
 		string getRootName(string);
+        string removeGZExtension(string); //drops a trailing .gz
 		bool isBlank(string);
 		int openOutputFile(string, ofstream&);
         int openOutputFileBinary(string, ofstream&);
@@ -120,6 +122,8 @@ class MothurOut {
     #endif
 		int openInputFile(string, ifstream&, string); //no error given
         vector<bool> allGZFiles(vector<string>&);
+        unsigned long long getFileSize(string); //uncompressed size for gzip files
+        bool isSeekable(string); //false for gzip files without BGZF blocks
         vector<bool> isGZ(string); //checks existence and format - will fail for either or both.
         bool fileExists(string name);
         bool checkLocations(string&, string);  //filename, inputDir. checks for file in ./, inputdir, default and mothur's exe location.  Returns false if cant be found. If found completes name with location
@@ -357,6 +361,7 @@ class MothurOut {
             groupMode = "group";
             changedSeqNames = false;
             modifyNames = true;
+            countCache = false;
             numErrors = 0;
             numWarnings = 0;
             unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
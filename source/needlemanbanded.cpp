@@ -0,0 +1,208 @@
+/*
+ *  needlemanbanded.cpp
+ *  Mothur
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 Schloss Lab. All rights reserved.
+ *
+ */
+
+#include "needlemanbanded.hpp"
+
+static const int bandKmerSize = 8;
+static const int bandWidth = 16;		//diagonals filled on each side of the voted one
+static const int minBandVotes = 5;		//fewer shared kmers than this and the whole matrix is filled
+
+/**************************************************************************************************/
+
+NeedlemanBanded::NeedlemanBanded(float gO, float f, float mm, int r) : NeedlemanSIMD(gO, f, mm, r), usedBand(false) {
+	bandLow = 0; bandHigh = 0; bandSize = 2 * bandWidth + 1;
+}
+/**************************************************************************************************/
+
+NeedlemanBanded::~NeedlemanBanded(){	/*	do nothing	*/	}
+
+/**************************************************************************************************/
+
+void NeedlemanBanded::align(string A, string B){
+	try {
+		seqA = ' ' + A;	lA = seqA.length();		//	algorithm requires a dummy space at the beginning of each string
+		seqB = ' ' + B;	lB = seqB.length();		//	algorithm requires a dummy space at the beginning of each string
+
+		usedBand = findBand(A, B);
+		if (usedBand) {
+			fillBand();
+			setOverlap();
+			if (!pathInBand()) { usedBand = false; }
+		}
+
+		if (usedBand)	{ traceBack();						}
+		else			{ NeedlemanSIMD::align(A, B);		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "NeedlemanBanded", "align");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//primers are short, so they always get the whole matrix
+void NeedlemanBanded::alignPrimer(string A, string B){
+	usedBand = false;
+	NeedlemanSIMD::alignPrimer(A, B);
+}
+/**************************************************************************************************/
+//each kmer B shares with A votes for the diagonal column - row it was found on, the band is centered on the winner
+bool NeedlemanBanded::findBand(const string& A, const string& B){
+	try {
+		if ((A.length() < bandKmerSize) || (B.length() < bandKmerSize)) { return false; }
+
+		unsigned int mask = (1 << (2 * bandKmerSize)) - 1;
+
+		vector<pair<unsigned int, int> > aKmers; aKmers.reserve(A.length());
+		unsigned int code = 0; int valid = 0;
+		for (int i = 0; i < A.length(); i++) {
+			int base = -1;
+			switch (A[i]) { case 'A': base = 0; break; case 'C': base = 1; break; case 'G': base = 2; break; case 'T': base = 3; break; }
+			if (base == -1) { valid = 0; continue; }
+			code = ((code << 2) | base) & mask; valid++;
+			if (valid >= bandKmerSize) { aKmers.push_back(make_pair(code, i - bandKmerSize + 1)); }
+		}
+		sort(aKmers.begin(), aKmers.end());
+
+		int offset = B.length();
+		vector<int> votes(A.length() + B.length(), 0);
+		code = 0; valid = 0;
+		for (int i = 0; i < B.length(); i++) {
+			int base = -1;
+			switch (B[i]) { case 'A': base = 0; break; case 'C': base = 1; break; case 'G': base = 2; break; case 'T': base = 3; break; }
+			if (base == -1) { valid = 0; continue; }
+			code = ((code << 2) | base) & mask; valid++;
+			if (valid < bandKmerSize) { continue; }
+
+			int bStart = i - bandKmerSize + 1;
+			vector<pair<unsigned int, int> >::iterator it = lower_bound(aKmers.begin(), aKmers.end(), make_pair(code, -1));
+			for (; (it != aKmers.end()) && (it->first == code); it++) { votes[it->second - bStart + offset]++; }
+		}
+
+		int best = 0;
+		for (int i = 1; i < votes.size(); i++) { if (votes[i] > votes[best]) { best = i; } }
+		if (votes[best] < minBandVotes) { return false; }
+
+		bandLow = best - offset - bandWidth;
+		bandHigh = best - offset + bandWidth;
+
+		return true;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "NeedlemanBanded", "findBand");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//row by row over the band, cell k of a row is column row + bandLow + k. previous and current have a pad cell on each
+//side, holding 0 where it is in the top row or left column and -infinity where the cell is outside the band
+void NeedlemanBanded::fillBand(){
+	try {
+		float negInf = -numeric_limits<float>::infinity();
+		directions.resize(lB * bandSize);
+		previous.assign(bandSize + 2, 0);		//top row
+		current.assign(bandSize + 2, negInf);
+		lastRow.assign(lA, negInf);
+		lastColumn.assign(lB, negInf);
+		lastRow[0] = 0; lastColumn[0] = 0;
+
+		for (int i = 1; i < lB; i++) {
+			//locals, so the compiler doesn't reload them after every store to cells
+			float* above = &previous[0];
+			float* row = &current[0];
+			const char* columns = seqA.c_str() + i + bandLow;
+			char base = seqB[i];
+			float baseScores[2] = { mismatch, match };
+			float gapScore = gap;
+
+			row[0] = negInf; row[bandSize + 1] = negInf;
+			int leftColumn = -i - bandLow;			//where column 0 falls in this row
+			if ((leftColumn >= -1) && (leftColumn <= bandSize)) { row[leftColumn + 1] = 0; }
+
+			int start = max(1, i + bandLow) - i - bandLow;
+			int end = min(lA - 1, i + bandHigh) - i - bandLow;
+			char* cells = &directions[i * bandSize];
+
+			float left = row[start] + gapScore;
+			for (int k = start; k <= end; k++) {
+				float diagonal = above[k + 1] + baseScores[base == columns[k]];
+				float up = above[k + 2] + gapScore;
+
+				//only left depends on the cell before, so it is the last max. The direction is NeedlemanOverlap's
+				//diagonal, then up, then left choice looked up from the comparisons, off the main diagonal they are
+				//too random for branches
+				float notLeft = (diagonal >= up) ? diagonal : up;
+				float score = (notLeft >= left) ? notLeft : left;
+				int fromDiagonal = (diagonal >= up) & (diagonal >= left);
+				int fromUp = (up >= left);
+				cells[k] = "ludd"[2 * fromDiagonal + fromUp];
+				row[k + 1] = score;
+				left = score + gapScore;
+			}
+
+			int lastCell = lA - 1 - i - bandLow;
+			if ((lastCell >= 0) && (lastCell < bandSize)) { lastColumn[i] = row[lastCell + 1]; }
+			previous.swap(current);
+		}
+
+		if (lB == 1) { lastRow.assign(lA, 0); }
+		else {
+			for (int k = 0; k < bandSize; k++) {
+				int column = lB - 1 + bandLow + k;
+				if ((column >= 1) && (column < lA)) { lastRow[column] = previous[k + 1]; }
+			}
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "NeedlemanBanded", "fillBand");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//false if the traceback runs along the edge of the band, where a path crossing it might have scored better. Paths
+//that never come near the band are not checked
+bool NeedlemanBanded::pathInBand(){
+	try {
+		int row = lB-1;
+		int column = lA-1;
+		char prevCell = getPrevCell(row, column);
+
+		while (prevCell != 'x') {
+			bool endGap = ((column == lA-1) && (row > overlapRow)) || ((row == lB-1) && (column > overlapColumn));
+			int diagonal = column - row;
+			if (!endGap && (row > 0) && (column > 0) && ((diagonal == bandLow) || (diagonal == bandHigh))) { return false; }
+
+			if (prevCell == 'u')		{ row--;				}
+			else if (prevCell == 'l')	{ column--;				}
+			else						{ row--; column--;		}
+			prevCell = getPrevCell(row, column);
+		}
+
+		return ((row == 0) && (column == 0));
+	}
+	catch(exception& e) {
+		m->errorOut(e, "NeedlemanBanded", "pathInBand");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
+char NeedlemanBanded::getPrevCell(int row, int column){
+	if (!usedBand)									{ return NeedlemanSIMD::getPrevCell(row, column);	}
+
+	if (row == 0)									{ return (column == 0) ? 'x' : 'l';	}
+	if (column == 0)								{ return 'u';						}
+	if ((column == lA-1) && (row > overlapRow))		{ return 'u';						}
+	if ((row == lB-1) && (column > overlapColumn))	{ return 'l';						}
+
+	int diagonal = column - row;
+	if ((diagonal < bandLow) || (diagonal > bandHigh)) { return 'x'; } //not filled, pathInBand rejects the band
+
+	return directions[row * bandSize + diagonal - bandLow];
+}
+/**************************************************************************************************/
@@ -0,0 +1,53 @@
+#ifndef NEEDLEMANBANDED_H
+#define NEEDLEMANBANDED_H
+
+/*
+ *  needlemanbanded.hpp
+ *  Mothur
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 Schloss Lab. All rights reserved.
+ *
+ *	This class is a NeedlemanSIMD child class for read pairs that overlap, like the forward and reverse reads in
+ *	make.contigs.  The diagonal the reads overlap on is found by counting the shared 8mers on each diagonal, and only
+ *	the cells within bandWidth of that diagonal are filled, with the same scores and tie breaking as NeedlemanOverlap.
+ *	If too few kmers are shared, or the best path in the band runs along its edge, the whole matrix is filled by
+ *	NeedlemanSIMD instead.  The band is a heuristic, not a bound: a better path that stays away from it, like an
+ *	overlap too full of errors to share 8mers next to a repeat that does, is not seen, so the alignment can differ
+ *	from NeedlemanOverlap's.
+ *
+ */
+
+#include "mothur.h"
+#include "needlemansimd.hpp"
+
+/**************************************************************************************************/
+
+class NeedlemanBanded : public NeedlemanSIMD {
+
+public:
+	NeedlemanBanded(float, float, float, int);
+	~NeedlemanBanded();
+	void align(string, string);
+	void alignPrimer(string, string);
+
+	bool getUsedBand() { return usedBand; }		//false if the last pair needed the whole matrix
+
+protected:
+	char getPrevCell(int, int);
+
+private:
+	bool usedBand;
+	int bandLow, bandHigh, bandSize;		//filled cells have bandLow <= column - row <= bandHigh
+
+	vector<char> directions;				//bandSize cells for each row
+	vector<float> previous, current;		//band scores of the last two rows
+
+	bool findBand(const string&, const string&);
+	void fillBand();
+	bool pathInBand();
+};
+
+/**************************************************************************************************/
+
+#endif
@@ -159,42 +159,5 @@ void NeedlemanOverlap::alignPrimer(string A, string B){
 	}
     
 }
-//********************************************************************/
-bool NeedlemanOverlap::isEquivalent(char oligo, char seq){
-	try {
-		
-        bool same = true;
-					
-        oligo = toupper(oligo);
-        seq = toupper(seq);
-        
-        if(oligo != seq){
-            if(oligo == 'A' && (seq != 'A' && seq != 'M' && seq != 'R' && seq != 'W' && seq != 'D' && seq != 'H' && seq != 'V'))       {	same = false;	}
-            else if(oligo == 'C' && (seq != 'C' && seq != 'Y' && seq != 'M' && seq != 'S' && seq != 'B' && seq != 'H' && seq != 'V'))       {	same = false;	}
-            else if(oligo == 'G' && (seq != 'G' && seq != 'R' && seq != 'K' && seq != 'S' && seq != 'B' && seq != 'D' && seq != 'V'))       {	same = false;	}
-            else if(oligo == 'T' && (seq != 'T' && seq != 'Y' && seq != 'K' && seq != 'W' && seq != 'B' && seq != 'D' && seq != 'H'))       {	same = false;	}
-            else if((oligo == '.' || oligo == '-'))           {	same = false;	}
-            else if((oligo == 'N' || oligo == 'I') && (seq == 'N'))                         {	same = false;	}
-            else if(oligo == 'R' && (seq != 'A' && seq != 'G'))                        {	same = false;	}
-            else if(oligo == 'Y' && (seq != 'C' && seq != 'T'))                        {	same = false;	}
-            else if(oligo == 'M' && (seq != 'C' && seq != 'A'))                        {	same = false;	}
-            else if(oligo == 'K' && (seq != 'T' && seq != 'G'))                        {	same = false;	}
-            else if(oligo == 'W' && (seq != 'T' && seq != 'A'))                        {	same = false;	}
-            else if(oligo == 'S' && (seq != 'C' && seq != 'G'))                        {	same = false;	}
-            else if(oligo == 'B' && (seq != 'C' && seq != 'T' && seq != 'G'))       {	same = false;	}
-            else if(oligo == 'D' && (seq != 'A' && seq != 'T' && seq != 'G'))       {	same = false;	}
-            else if(oligo == 'H' && (seq != 'A' && seq != 'T' && seq != 'C'))       {	same = false;	}
-            else if(oligo == 'V' && (seq != 'A' && seq != 'C' && seq != 'G'))       {	same = false;	}
-        }
-
-		
-		
-		return same;
-	}
-	catch(exception& e) {
-		m->errorOut(e, "TrimOligos", "countDiffs");
-		exit(1);
-	}
-}
 /**************************************************************************************************/
 
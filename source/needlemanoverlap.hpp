@@ -38,7 +38,6 @@ private:
 	float gap;
 	float match;
 	float mismatch;
-    bool isEquivalent(char, char);
 };
 
 /**************************************************************************************************/
@@ -0,0 +1,311 @@
+/*
+ *  needlemansimd.cpp
+ *  Mothur
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 Schloss Lab. All rights reserved.
+ *
+ */
+
+#include "needlemansimd.hpp"
+
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+	#define NEEDLEMANSIMD_X86
+	#include <emmintrin.h>
+#endif
+
+static const short negInf = -32768;
+
+/**************************************************************************************************/
+static bool cpuHasSSE2() {
+#ifdef NEEDLEMANSIMD_X86
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("sse2");
+#else
+	return false;
+#endif
+}
+static const bool hasSSE2 = cpuHasSSE2();
+
+/**************************************************************************************************/
+string NeedlemanSIMD::getKernelName() {
+	if (hasSSE2) { return "sse2"; }
+	return "scalar";
+}
+/**************************************************************************************************/
+
+NeedlemanSIMD::NeedlemanSIMD(float gO, float f, float mm, int r) : Alignment(), gap(gO), match(f), mismatch(mm) {
+	try {
+		nRows = r; nCols = r;		//the score columns are sized for each pair, this is just reported by getnRows
+
+		//int16 scores give the same alignment only if the float scores are whole numbers
+		wholeScores = ((gap == (int)gap) && (match == (int)match) && (mismatch == (int)mismatch));
+		useStriped = hasSSE2;
+		profileStart.resize(256, -1);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "NeedlemanSIMD", "NeedlemanSIMD");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
+NeedlemanSIMD::~NeedlemanSIMD(){	/*	do nothing	*/	}
+
+/**************************************************************************************************/
+
+void NeedlemanSIMD::resize(int A) {	nRows = A; nCols = A;	}
+
+/**************************************************************************************************/
+bool NeedlemanSIMD::setKernel(string name) {
+	if (name == "scalar")				{ useStriped = false; return true;	}
+	if ((name == "sse2") && hasSSE2)	{ useStriped = true; return true;	}
+	return false;
+}
+/**************************************************************************************************/
+
+void NeedlemanSIMD::align(string A, string B){
+	try {
+		seqA = ' ' + A;	lA = seqA.length();		//	algorithm requires a dummy space at the beginning of each string
+		seqB = ' ' + B;	lB = seqB.length();		//	algorithm requires a dummy space at the beginning of each string
+
+		fill(false);
+		traceBack();
+	}
+	catch(exception& e) {
+		m->errorOut(e, "NeedlemanSIMD", "align");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
+void NeedlemanSIMD::alignPrimer(string A, string B){
+	try {
+		seqA = ' ' + A;	lA = seqA.length();
+		seqB = ' ' + B;	lB = seqB.length();
+
+		fill(true);
+		traceBack();
+	}
+	catch(exception& e) {
+		m->errorOut(e, "NeedlemanSIMD", "alignPrimer");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//fills the traceback bits, the last row and the last column, then sets the end gaps
+void NeedlemanSIMD::fill(bool primer){
+	try {
+		int numRows = lB-1;
+
+		//every cell is within (row + column) * the largest score of zero
+		float largest = max(fabs(gap), max(fabs(match), fabs(mismatch)));
+		bool fitsShort = ((lA + lB) * largest) < 30000;
+
+		segLen = max(1, (numRows + 7) / 8);
+		trace.resize(max(0, lA-1) * segLen);
+		lastRow.assign(lA, 0);
+		lastColumn.assign(lB, 0);
+
+		if (useStriped && wholeScores && fitsShort) {
+			buildProfiles(primer);
+			fillStriped();
+		}else { fillScalar(primer); }
+
+		setOverlap();
+	}
+	catch(exception& e) {
+		m->errorOut(e, "NeedlemanSIMD", "fill");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//one striped column of scores for each distinct base in seqA, padding rows score 0
+void NeedlemanSIMD::buildProfiles(bool primer){
+	try {
+		int numRows = lB-1;
+		for (int i = 0; i < profileStart.size(); i++) { profileStart[i] = -1; }
+		profiles.clear();
+
+		for (int j = 1; j < lA; j++) {
+			unsigned char base = seqA[j];
+			if (profileStart[base] != -1) { continue; }
+
+			int start = profiles.size();
+			profileStart[base] = start;
+			profiles.resize(start + segLen * 8, 0);
+
+			for (int q = 0; q < numRows; q++) {
+				bool same = primer ? isEquivalent(seqB[q+1], seqA[j]) : (seqB[q+1] == seqA[j]);
+				profiles[start + (q % segLen) * 8 + (q / segLen)] = (short)(same ? match : mismatch);
+			}
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "NeedlemanSIMD", "buildProfiles");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+#ifdef NEEDLEMANSIMD_X86
+__attribute__((target("sse2")))
+void NeedlemanSIMD::fillStriped(){
+	try {
+		int numRows = lB-1;
+		const __m128i vGap = _mm_set1_epi16((short)gap);
+		const __m128i allOnes = _mm_set1_epi16(-1);
+
+		hLoad.assign(segLen * 8, 0);				//first column is 0
+		hStore.assign(segLen * 8, 0);
+
+		for (int j = 1; j < lA; j++) {
+			if (m->control_pressed) { break; }
+
+			const __m128i* profile = (const __m128i*)&profiles[profileStart[(unsigned char)seqA[j]]];
+			__m128i* load = (__m128i*)&hLoad[0];
+			__m128i* store = (__m128i*)&hStore[0];
+
+			//the cell above lane 0's first row is in the top row, which is 0. Other lanes take their rows from
+			//above in the second pass
+			__m128i vDiag = _mm_slli_si128(_mm_loadu_si128(load + segLen - 1), 2);
+			__m128i vF = _mm_insert_epi16(_mm_set1_epi16(negInf), (short)gap, 0);
+
+			for (int k = 0; k < segLen; k++) {
+				__m128i vLoad = _mm_loadu_si128(load + k);
+				__m128i vH = _mm_max_epi16(_mm_adds_epi16(vDiag, _mm_loadu_si128(profile + k)), _mm_adds_epi16(vLoad, vGap));
+				vH = _mm_max_epi16(vH, vF);
+				_mm_storeu_si128(store + k, vH);
+				vF = _mm_adds_epi16(vH, vGap);
+				vDiag = vLoad;
+			}
+
+			//carry the up scores across lanes until no row improves
+			vF = _mm_insert_epi16(_mm_slli_si128(vF, 2), negInf, 0);
+			int k = 0;
+			while (true) {
+				__m128i vH = _mm_loadu_si128(store + k);
+				if (_mm_movemask_epi8(_mm_cmpgt_epi16(vF, vH)) == 0) { break; }
+				vH = _mm_max_epi16(vH, vF);
+				_mm_storeu_si128(store + k, vH);
+				vF = _mm_adds_epi16(vH, vGap);
+				if (++k == segLen) { k = 0; vF = _mm_insert_epi16(_mm_slli_si128(vF, 2), negInf, 0); }
+			}
+
+			//the scores are final, so pick each cell's direction like NeedlemanOverlap: diagonal, then up, then left
+			__m128i vUp = _mm_slli_si128(_mm_loadu_si128(store + segLen - 1), 2);
+			vDiag = _mm_slli_si128(_mm_loadu_si128(load + segLen - 1), 2);
+			unsigned short* cells = &trace[(j-1) * segLen];
+			for (k = 0; k < segLen; k++) {
+				__m128i vLoad = _mm_loadu_si128(load + k);
+				__m128i vStore = _mm_loadu_si128(store + k);
+				__m128i diagonal = _mm_adds_epi16(vDiag, _mm_loadu_si128(profile + k));
+				__m128i up = _mm_adds_epi16(vUp, vGap);
+				__m128i left = _mm_adds_epi16(vLoad, vGap);
+
+				__m128i fromDiag = _mm_andnot_si128(_mm_or_si128(_mm_cmpgt_epi16(up, diagonal), _mm_cmpgt_epi16(left, diagonal)), allOnes);
+				__m128i fromUp = _mm_andnot_si128(_mm_or_si128(fromDiag, _mm_cmpgt_epi16(left, up)), allOnes);
+				cells[k] = (unsigned short)_mm_movemask_epi8(_mm_packs_epi16(fromDiag, fromUp));
+
+				vUp = vStore;
+				vDiag = vLoad;
+			}
+
+			if (numRows > 0) { lastRow[j] = hStore[((numRows-1) % segLen) * 8 + (numRows-1) / segLen]; }
+			hLoad.swap(hStore);
+		}
+
+		if (lA > 1) {
+			for (int q = 0; q < numRows; q++) { lastColumn[q+1] = hLoad[(q % segLen) * 8 + q / segLen]; }
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "NeedlemanSIMD", "fillStriped");
+		exit(1);
+	}
+}
+#else
+void NeedlemanSIMD::fillStriped(){ fillScalar(false); }
+#endif
+/**************************************************************************************************/
+//the same float arithmetic as NeedlemanOverlap, one column at a time
+void NeedlemanSIMD::fillScalar(bool primer){
+	try {
+		int numRows = lB-1;
+		vector<float> previous(lB, 0);
+		vector<float> current(lB, 0);
+
+		for (int j = 1; j < lA; j++) {
+			if (m->control_pressed) { break; }
+
+			unsigned short* cells = &trace[(j-1) * segLen];
+			for (int k = 0; k < segLen; k++) { cells[k] = 0; }
+
+			for (int i = 1; i <= numRows; i++) {
+				bool same = primer ? isEquivalent(seqB[i], seqA[j]) : (seqB[i] == seqA[j]);
+				float diagonal = previous[i-1] + (same ? match : mismatch);
+				float up = current[i-1] + gap;
+				float left = previous[i] + gap;
+
+				int q = i-1;
+				unsigned short diagBit = 1 << (q / segLen);
+				unsigned short upBit = 1 << (8 + q / segLen);
+
+				if ((diagonal >= up) && (diagonal >= left))	{ current[i] = diagonal; cells[q % segLen] |= diagBit;	}
+				else if (up >= left)						{ current[i] = up; cells[q % segLen] |= upBit;			}
+				else										{ current[i] = left;									}
+			}
+
+			lastRow[j] = current[numRows];
+			previous.swap(current);
+		}
+
+		if (lA > 1) { for (int i = 1; i <= numRows; i++) { lastColumn[i] = previous[i]; } }
+	}
+	catch(exception& e) {
+		m->errorOut(e, "NeedlemanSIMD", "fillScalar");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//same choice as Overlap::setOverlap with band 0, but kept as the rows / columns to redirect instead of editing cells
+void NeedlemanSIMD::setOverlap(){
+	try {
+		int row = lB-1;
+		int column = lA-1;
+
+		float best = -100;
+		int rowIndex = column;
+		for (int i = 0; i < lB; i++) { if (lastColumn[i] >= best) { rowIndex = i; best = lastColumn[i]; } }
+
+		best = -100;
+		int colIndex = row;
+		for (int i = 0; i < lA; i++) { if (lastRow[i] >= best) { colIndex = i; best = lastRow[i]; } }
+
+		overlapRow = lB; overlapColumn = lA;
+
+		if (colIndex == column && rowIndex == row) {}
+		else if (lastRow[colIndex] < lastColumn[rowIndex])	{ overlapRow = rowIndex;		}	//gaps in seqA at the end
+		else												{ overlapColumn = colIndex;		}	//gaps in seqB at the end
+	}
+	catch(exception& e) {
+		m->errorOut(e, "NeedlemanSIMD", "setOverlap");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
+char NeedlemanSIMD::getPrevCell(int row, int column){
+	if (row == 0)								{ return (column == 0) ? 'x' : 'l';	}
+	if (column == 0)							{ return 'u';						}
+	if ((column == lA-1) && (row > overlapRow))	{ return 'u';						}
+	if ((row == lB-1) && (column > overlapColumn))	{ return 'l';					}
+
+	int q = row-1;
+	int lane = q / segLen;
+	unsigned short cell = trace[(column-1) * segLen + (q % segLen)];
+
+	if (cell & (1 << lane))			{ return 'd';	}
+	if (cell & (1 << (8 + lane)))	{ return 'u';	}
+	return 'l';
+}
+/**************************************************************************************************/
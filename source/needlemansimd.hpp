@@ -0,0 +1,69 @@
+#ifndef NEEDLEMANSIMD_H
+#define NEEDLEMANSIMD_H
+
+/*
+ *  needlemansimd.hpp
+ *  Mothur
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 Schloss Lab. All rights reserved.
+ *
+ *	This class is an Alignment child class that gives the same alignments as NeedlemanOverlap without building a matrix of
+ *	AlignmentCells. Scores are filled one column of seqA at a time with the striped method of:
+ *
+ *	Farrar M.  2007.  Striped Smith-Waterman speeds database searches six times over other SIMD implementations.
+ *		Bioinformatics.  23:156-61.
+ *
+ *	using 8 int16 scores per SSE2 register, and only 2 bits per cell (from the diagonal, from above) are kept for the
+ *	traceback.  When the scores are not whole numbers or the sequences are long enough for int16 to overflow, the
+ *	columns are filled with the same float arithmetic as NeedlemanOverlap instead.  The end gaps are fixed with the
+ *	same rules as the Overlap class.
+ *
+ */
+
+#include "mothur.h"
+#include "alignment.hpp"
+
+/**************************************************************************************************/
+
+class NeedlemanSIMD : public Alignment {
+
+public:
+	NeedlemanSIMD(float, float, float, int);
+	~NeedlemanSIMD();
+	void align(string, string);
+	void alignPrimer(string, string);
+	void resize(int);
+
+	static string getKernelName();		//"sse2" or "scalar"
+	bool setKernel(string);				//for testing, returns false if this cpu can't run it
+
+protected:
+	char getPrevCell(int, int);
+	void setOverlap();
+
+	float gap;
+	float match;
+	float mismatch;
+	int overlapRow, overlapColumn;		//end gaps from setOverlap
+	vector<float> lastRow, lastColumn;	//scores setOverlap looks at
+
+private:
+	bool wholeScores;					//match, mismatch and gap can be stored as int16
+	bool useStriped;					//kernel picked for this object
+	int segLen;							//row q of seqB is in lane q / segLen of segment q % segLen
+
+	vector<short> profiles;				//striped match / mismatch scores of seqB against each base in seqA
+	vector<int> profileStart;			//start of each base's profile, -1 if not built
+	vector<short> hLoad, hStore;		//striped scores of the previous and current column
+	vector<unsigned short> trace;		//for each column and segment, bit lane is set for a diagonal cell, bit 8+lane for up
+
+	void fill(bool);
+	void buildProfiles(bool);
+	void fillStriped();
+	void fillScalar(bool);
+};
+
+/**************************************************************************************************/
+
+#endif
@@ -0,0 +1,242 @@
+/*
+ *  oligomatcher.cpp
+ *  Mothur
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 Schloss Lab. All rights reserved.
+ *
+ */
+
+#include "oligomatcher.h"
+
+/**************************************************************************************************/
+
+OligoMatcher::OligoMatcher() : maxLength(0), numWords(0), hasNone(false) {}
+
+/**************************************************************************************************/
+
+OligoMatcher::OligoMatcher(vector<string> o) : oligos(o), maxLength(0), hasNone(false) {
+	try {
+		const char bases[] = { 'A', 'C', 'G', 'T', 'N' };
+		int numOligos = oligos.size();
+		numWords = (numOligos + 63) / 64;
+
+		for (int i = 0; i < numOligos; i++) { if (oligos[i].length() > maxLength) { maxLength = oligos[i].length(); } }
+
+		accepting.resize(maxLength * 5, vector<unsigned long long>(numWords, 0));
+		longer.resize(maxLength + 1, vector<unsigned long long>(numWords, 0));
+		none.resize(numWords, 0);
+		peq.resize(numOligos, vector<unsigned long long>(5, 0));
+		freeGaps.resize(numOligos, 0);
+		boundable.resize(numOligos, false);
+
+		for (int i = 0; i < numOligos; i++) {
+			string oligo = oligos[i];
+			unsigned long long bit = 1ULL << (i % 64);
+			int word = i / 64;
+
+			for (int p = 0; p < maxLength; p++) {
+				for (int b = 0; b < 5; b++) {
+					if ((p >= oligo.length()) || isMatch(oligo[p], bases[b])) { accepting[p * 5 + b][word] |= bit; }
+				}
+			}
+			for (int l = 0; l < oligo.length(); l++) { longer[l][word] |= bit; }
+			if (oligo == "NONE") { none[word] |= bit; hasNone = true; }
+
+			boundable[i] = (oligo.length() <= 64);
+			if (!boundable[i]) { continue; }
+			for (int p = 0; p < oligo.length(); p++) {
+				for (int b = 0; b < 5; b++) { if (isMatch(oligo[p], bases[b])) { peq[i][b] |= 1ULL << p; } }
+				if (isMatch(oligo[p], '-')) { freeGaps[i]++; }
+			}
+		}
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "OligoMatcher", "OligoMatcher");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
+int OligoMatcher::findExact(string& read){
+	try {
+		if (oligos.size() == 0) { return -1; }
+
+		vector<unsigned long long> matches;
+		getMatches(read, matches);
+
+		vector<unsigned long long>& shorter = longer[min((int) read.length(), maxLength)];
+		for (int w = 0; w < numWords; w++) { matches[w] |= shorter[w]; }
+
+		return getFirstSet(matches);
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "OligoMatcher", "findExact");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//forward and reverse hold the two halves of the same pairs
+int OligoMatcher::findExact(OligoMatcher& forward, OligoMatcher& reverse, string& forwardRead, string& reverseRead){
+	try {
+		if (forward.oligos.size() == 0) { return -1; }
+
+		vector<unsigned long long> forwardMatches, reverseMatches;
+		forward.getMatches(forwardRead, forwardMatches);
+		reverse.getMatches(reverseRead, reverseMatches);
+
+		vector<unsigned long long>& forwardShorter = forward.longer[min((int) forwardRead.length(), forward.maxLength)];
+		vector<unsigned long long>& reverseShorter = reverse.longer[min((int) reverseRead.length(), reverse.maxLength)];
+
+		vector<unsigned long long> candidates(forward.numWords, 0);
+		for (int w = 0; w < forward.numWords; w++) {
+			unsigned long long forwardOk = forwardMatches[w] | forward.none[w];
+			unsigned long long reverseOk = reverseMatches[w] | (reverse.none[w] & ~forward.none[w]);
+			candidates[w] = forwardShorter[w] | reverseShorter[w] | (forwardOk & reverseOk);
+		}
+
+		return getFirstSet(candidates);
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "OligoMatcher", "findExact");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//oligos matching the start of the read, oligos longer than the read are only checked as far as it goes
+void OligoMatcher::getMatches(string& read, vector<unsigned long long>& matches){
+	try {
+		int numOligos = oligos.size();
+		matches.assign(numWords, ~0ULL);
+		if ((numOligos % 64) != 0) { matches[numWords - 1] = (1ULL << (numOligos % 64)) - 1; }
+
+		int length = min((int) read.length(), maxLength);
+		for (int p = 0; p < length; p++) {
+			int b = getBaseIndex(read[p]);
+			unsigned long long any = 0;
+
+			if (b != -1) {
+				vector<unsigned long long>& accepts = accepting[p * 5 + b];
+				for (int w = 0; w < numWords; w++) { matches[w] &= accepts[w]; any |= matches[w]; }
+			}else {
+				for (int i = 0; i < numOligos; i++) {
+					if ((p < oligos[i].length()) && !isMatch(oligos[i][p], read[p])) { matches[i / 64] &= ~(1ULL << (i % 64)); }
+				}
+				for (int w = 0; w < numWords; w++) { any |= matches[w]; }
+			}
+
+			if (any == 0) { break; }
+		}
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "OligoMatcher", "getMatches");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
+vector<int> OligoMatcher::getLowerBounds(string& read, int diffs){
+	try {
+		vector<int> bounds(oligos.size(), 0);
+		for (int i = 0; i < oligos.size(); i++) {
+			int windowLength = min((int) oligos[i].length() + diffs, (int) read.length());
+			bounds[i] = getBound(i, read, windowLength);
+		}
+		return bounds;
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "OligoMatcher", "getLowerBounds");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//The alignment countDiffs scores covers the whole oligo and a prefix of the window, so its diffs are at least the
+//smallest edit distance between the oligo and a prefix of the window, less the oligo bases a gap costs nothing against.
+//Myers' bit-vector algorithm with the first row fixed at 0, 1, 2... gives the distance to each prefix in turn.
+int OligoMatcher::getBound(int index, string& read, int windowLength){
+	try {
+		int length = oligos[index].length();
+		if (!boundable[index] || (length == 0) || (windowLength == 0) || (oligos[index] == "NONE")) { return 0; }
+
+		unsigned long long mask = (length == 64) ? ~0ULL : ((1ULL << length) - 1);
+		unsigned long long high = 1ULL << (length - 1);
+		unsigned long long pv = mask, mv = 0;
+		int score = length, best = length;
+
+		for (int j = 0; j < windowLength; j++) {
+			char base = read[j];
+			if (base == '-') { return 0; } //a gap in the oligo costs nothing against it
+
+			unsigned long long eq = 0;
+			int b = getBaseIndex(base);
+			if (b != -1)	{ eq = peq[index][b]; }
+			else			{ for (int p = 0; p < length; p++) { if (isMatch(oligos[index][p], base)) { eq |= 1ULL << p; } } }
+
+			unsigned long long xv = eq | mv;
+			unsigned long long xh = (((eq & pv) + pv) ^ pv) | eq;
+			unsigned long long ph = mv | ~(xh | pv);
+			unsigned long long mh = pv & xh;
+
+			if (ph & high)		{ score++; }
+			else if (mh & high)	{ score--; }
+
+			ph = (ph << 1) | 1;
+			mh = mh << 1;
+			pv = (mh | ~(xv | ph)) & mask;
+			mv = (ph & xv) & mask;
+
+			if (score < best) { best = score; }
+		}
+
+		return max(0, best - freeGaps[index]);
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "OligoMatcher", "getBound");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//same as TrimOligos::compareDNASeq for a single base
+bool OligoMatcher::isMatch(char oligo, char seq){
+	if (oligo == seq) { return true; }
+
+	switch (oligo) {
+		case 'A': case 'T': case 'G': case 'C':	return false;
+		case 'N': case 'I':						return (seq != 'N');
+		case 'R':								return ((seq == 'A') || (seq == 'G'));
+		case 'Y':								return ((seq == 'C') || (seq == 'T'));
+		case 'M':								return ((seq == 'C') || (seq == 'A'));
+		case 'K':								return ((seq == 'T') || (seq == 'G'));
+		case 'W':								return ((seq == 'T') || (seq == 'A'));
+		case 'S':								return ((seq == 'C') || (seq == 'G'));
+		case 'B':								return ((seq == 'C') || (seq == 'T') || (seq == 'G'));
+		case 'D':								return ((seq == 'A') || (seq == 'T') || (seq == 'G'));
+		case 'H':								return ((seq == 'A') || (seq == 'T') || (seq == 'C'));
+		case 'V':								return ((seq == 'A') || (seq == 'C') || (seq == 'G'));
+		default:								return true;
+	}
+}
+/**************************************************************************************************/
+
+int OligoMatcher::getBaseIndex(char base){
+	switch (base) {
+		case 'A':	return 0;
+		case 'C':	return 1;
+		case 'G':	return 2;
+		case 'T':	return 3;
+		case 'N':	return 4;
+		default:	return -1;
+	}
+}
+/**************************************************************************************************/
+
+int OligoMatcher::getFirstSet(vector<unsigned long long>& bits){
+	for (int w = 0; w < bits.size(); w++) {
+		if (bits[w] == 0) { continue; }
+		int bit = 0;
+		while (((bits[w] >> bit) & 1) == 0) { bit++; }
+		return w * 64 + bit;
+	}
+	return -1;
+}
+/**************************************************************************************************/
@@ -0,0 +1,67 @@
+#ifndef OLIGOMATCHER_H
+#define OLIGOMATCHER_H
+
+/*
+ *  oligomatcher.h
+ *  Mothur
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 Schloss Lab. All rights reserved.
+ *
+ *  Bit-parallel search of a set of barcodes or primers at the start of a read, for TrimOligos.  Each oligo is a bit
+ *  and each position of the oligos keeps the set of oligos accepting A, C, G, T or N there, with the ambiguity codes
+ *  expanded the way compareDNASeq reads them.  An exact search ANDs one set per base of the read instead of comparing
+ *  every oligo.  When diffs are allowed, a Myers bit-vector edit distance gives each oligo a lower bound on the
+ *  diffs countDiffs can find in its alignment, so TrimOligos only aligns the oligos that could still be the best.
+ *
+ */
+
+#include "mothur.h"
+#include "mothurout.h"
+
+/**************************************************************************************************/
+
+class OligoMatcher {
+
+public:
+	OligoMatcher();
+	OligoMatcher(vector<string>);	//oligos in the order TrimOligos searches them
+	~OligoMatcher() {}
+
+	int getNumOligos()			{ return oligos.size();	}
+	string getOligo(int i)		{ return oligos[i];		}
+	int getMaxLength()			{ return maxLength;		}
+	bool getHasNone()			{ return hasNone;		}
+
+	//index of the first oligo longer than the read or matching its start, where TrimOligos' exact search stops. -1 if none
+	int findExact(string&);
+	//same for forward and reverse oligo pairs, a NONE forward matches any forward read, a NONE reverse any reverse read
+	static int findExact(OligoMatcher&, OligoMatcher&, string&, string&);
+
+	//fewest diffs countDiffs can give for an alignment of each oligo to the first oligo length + diffs bases of the read
+	vector<int> getLowerBounds(string&, int);
+
+	static bool isMatch(char, char);	//oligo base, read base - compareDNASeq for one base
+
+private:
+	vector<string> oligos;
+	int maxLength, numWords;
+	bool hasNone;
+
+	vector< vector<unsigned long long> > accepting;	//[position * 5 + base], oligos accepting the base at the position
+	vector< vector<unsigned long long> > longer;	//[length], oligos longer than length
+	vector<unsigned long long> none;				//oligos that are NONE
+
+	vector< vector<unsigned long long> > peq;		//[oligo][base], positions of the oligo accepting the base
+	vector<int> freeGaps;							//bases of the oligo countDiffs does not count against a gap
+	vector<bool> boundable;							//false for oligos longer than one word
+
+	void getMatches(string&, vector<unsigned long long>&);
+	int getBound(int, string&, int);	//oligo, read, window length
+	static int getBaseIndex(char);
+	static int getFirstSet(vector<unsigned long long>&);
+};
+
+/**************************************************************************************************/
+
+#endif
@@ -7,6 +7,7 @@
 //
 
 #include "opticluster.h"
+#include "threadpool.h"
 
 /***********************************************************************/
 //randomly assign sequences to OTUs
@@ -22,6 +23,7 @@ int OptiCluster::initialize(double& value, bool randomize, string initialize) {
         
         vector<int> temp;
         bins.push_back(temp);
+        seqBin.assign(numSeqs+1, 0);
         seqBin[numSeqs] = -1;
         insertLocation = numSeqs;
         
@@ -39,12 +41,9 @@ int OptiCluster::initialize(double& value, bool randomize, string initialize) {
             if (randomize) { m->mothurRandomShuffle(randomizeSeqs); }
             
             //for each sequence (singletons removed on read)
-            for (map<int, int>::iterator it = seqBin.begin(); it != seqBin.end(); it++) {
-                if (it->second == -1) { }
-                else {
-                    long long numCloseSeqs = (matrix->getCloseSeqs(it->first)).size(); //does not include self
-                    falseNegatives += numCloseSeqs;
-                }
+            for (int i = 0; i < numSeqs; i++) {
+                long long numCloseSeqs = matrix->getNumClose(i); //does not include self
+                falseNegatives += numCloseSeqs;
             }
             falseNegatives /= 2; //square matrix
             trueNegatives = numSeqs * (numSeqs-1)/2 - (falsePositives + falseNegatives + truePositives); //since everyone is a singleton no one clusters together. True negative = num far apart
@@ -61,12 +60,9 @@ int OptiCluster::initialize(double& value, bool randomize, string initialize) {
             if (randomize) { m->mothurRandomShuffle(randomizeSeqs); }
             
             //for each sequence (singletons removed on read)
-            for (map<int, int>::iterator it = seqBin.begin(); it != seqBin.end(); it++) {
-                if (it->second == -1) { }
-                else {
-                    long long numCloseSeqs = (matrix->getCloseSeqs(it->first)).size(); //does not include self
-                    truePositives += numCloseSeqs;
-                }
+            for (int i = 0; i < numSeqs; i++) {
+                long long numCloseSeqs = matrix->getNumClose(i); //does not include self
+                truePositives += numCloseSeqs;
             }
             truePositives /= 2; //square matrix
             falsePositives = numSeqs * (numSeqs-1)/2 - (trueNegatives + falseNegatives + truePositives);
@@ -96,85 +92,118 @@ int OptiCluster::initialize(double& value, bool randomize, string initialize) {
     }
 }
 /***********************************************************************/
+//seeds the OTUs from a list file, usually one made before more sequences were added. The listed seqs keep their OTUs and update
+//only moves the new ones. Pairs of listed seqs are not expected in the distance file, so pairs that share an OTU count as true positives.
+int OptiCluster::initialize(double& value, bool randomize, ListVector* prior) {
+    try {
+        numSeqs = matrix->getNumSeqs();
+        truePositives = 0;
+        falsePositives = 0;
+        falseNegatives = 0;
+        trueNegatives = 0;
+        
+        map<string, int> priorBins; //name -> otu in the starting list
+        long long numPriorBins = prior->getNumBins();
+        for (int i = 0; i < numPriorBins; i++) {
+            string binNames = prior->get(i);
+            vector<string> names; m->splitAtComma(binNames, names);
+            for (int j = 0; j < names.size(); j++) { priorBins[names[j]] = i; }
+        }
+        
+        //a bin for every otu in the list and every new seq, plus one to insert into
+        bins.clear(); bins.resize(numPriorBins + numSeqs + 1);
+        fixedCounts.assign(bins.size(), 0);
+        fixedNames.assign(bins.size(), "");
+        newSingletons.clear();
+        seqBin.assign(numSeqs+1, 0);
+        seqBin[numSeqs] = -1;
+        randomizeSeqs.clear();
+        
+        long long numPlaced = 0;
+        for (int i = 0; i < numSeqs; i++) {
+            string names = matrix->getName(i); //redundant names follow the unique name
+            map<string, int>::iterator it = priorBins.find(names.substr(0, names.find_first_of(',')));
+            
+            if (it != priorBins.end()) { seqBin[i] = it->second; numPlaced += m->getNumNames(names); }
+            else { seqBin[i] = numPriorBins + i;  randomizeSeqs.push_back(i); }
+            bins[seqBin[i]].push_back(i);
+        }
+        
+        //listed seqs with nothing close to them were removed on read as singletons, they stay in their otu
+        ListVector* singleton = matrix->getListSingle();
+        if (singleton != NULL) {
+            for (int i = 0; i < singleton->getNumBins(); i++) {
+                string names = singleton->get(i);
+                if (names == "") { continue; }
+                
+                map<string, int>::iterator it = priorBins.find(names.substr(0, names.find_first_of(',')));
+                if (it != priorBins.end()) {
+                    if (fixedNames[it->second] == "") { fixedNames[it->second] = names; }
+                    else { fixedNames[it->second] += "," + names; }
+                    fixedCounts[it->second]++;
+                    numPlaced += m->getNumNames(names);
+                }else { newSingletons.push_back(names); }
+            }
+            delete singleton;
+        }
+        
+        if (numPlaced != priorBins.size()) {
+            m->mothurOut("[ERROR]: " + toString(priorBins.size() - numPlaced) + " sequences in your list file are not in your name or count file, please correct.\n"); m->control_pressed = true; return 0;
+        }
+        
+        insertLocation = findInsert();
+        
+        if (randomize) { m->mothurRandomShuffle(randomizeSeqs); }
+        
+        //the new seqs start as singletons, so every pair in a bin is two listed seqs
+        long long numFixed = 0;
+        for (int i = 0; i < bins.size(); i++) {
+            long long binSize = getBinSize(i);
+            truePositives += binSize * (binSize-1) / 2;
+            numFixed += fixedCounts[i];
+        }
+        
+        for (int i = 0; i < numSeqs; i++) {
+            const int* closeSeqs = matrix->getCloseSeqs(i);
+            int numClose = matrix->getNumClose(i);
+            for (int j = 0; j < numClose; j++) { if (seqBin[closeSeqs[j]] != seqBin[i]) { falseNegatives++; } }
+        }
+        falseNegatives /= 2; //square matrix
+        
+        long long totalSeqs = numSeqs + numFixed;
+        trueNegatives = totalSeqs * (totalSeqs-1)/2 - (falsePositives + falseNegatives + truePositives);
+        totalPairs = trueNegatives + truePositives + falseNegatives + falsePositives;
+        
+        value = calcScoreCurrentBin(truePositives, trueNegatives, falsePositives, falseNegatives);
+        
+        return value;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OptiCluster", "initialize");
+        exit(1);
+    }
+}
+/***********************************************************************/
 /* for each sequence with mutual information (close)
 * remove from current OTU and calculate MCC when sequence forms its own OTU or joins one of the other OTUs where there is a sequence within the `threshold` (no need to calculate MCC if the paired sequence is already in same OTU and no need to try every OTU - just those where there's a close sequence) 
  * keep or move the sequence to the OTU where the `metric` is the largest - flip a coin on ties */
 bool OptiCluster::update(double& listMetric) {
     try {
         
-        //for each sequence (singletons removed on read)
-        for (int i = 0; i < randomizeSeqs.size(); i++) {
-            
-            if (m->control_pressed) { break; }
-            
-            map<int, int>::iterator it = seqBin.find(randomizeSeqs[i]);
-            
-            int seqNumber = it->first;
-            int binNumber = it->second;
-            
-            
-            if (binNumber == -1) { }
-            else {
-                
-                long long tn, tp, fp, fn;
-                double bestMetric = -1;
-                long long bestBin, bestTp, bestTn, bestFn, bestFp;
-                tn = trueNegatives; tp = truePositives; fp = falsePositives; fn = falseNegatives;
-                
-                //this calculation is used to save time in the move and adjust function.
-                //we don't need to calculate the cost of moving out of our current bin each time we
-                //test moving into a new bin. Only calc this once per iteration.
-                long long cCount = 0;  long long fCount = 0;
-                for (int i = 0; i < bins[binNumber].size(); i++) { //how many close sequences are in the old bin?
-                    if (seqNumber == bins[binNumber][i]) {}
-                    else if (!matrix->isClose(seqNumber, bins[binNumber][i])) {  fCount++;   }
-                    else { cCount++;  }
-                }
-                
-                //metric in current bin
-                bestMetric = calcScoreCurrentBin(tp, tn, fp, fn); bestBin = binNumber; bestTp = tp; bestTn = tn; bestFp = fp; bestFn = fn;
-                
-                //if not already singleton, then calc value if singleton was created
-                if (!((bins[binNumber].size()) == 1)) {
-                    //make a singleton
-                    //move out of old bin
-                    fn+=cCount; tn+=fCount; fp-=fCount; tp-=cCount;
-                    double singleMetric = moveAdjustTFValues(binNumber, seqNumber, -1, tp, tn, fp, fn);
-                    if (singleMetric > bestMetric) {
-                        bestBin = -1; bestTp = tp; bestTn = tn; bestFp = fp; bestFn = fn;
-                        bestMetric = singleMetric;
-                    }
-                }
-                
-                set<int> binsToTry;
-                set<int> closeSeqs = matrix->getCloseSeqs(seqNumber);
-                for (set<int>::iterator itClose = closeSeqs.begin(); itClose != closeSeqs.end(); itClose++) {  binsToTry.insert(seqBin[*itClose]); }
+        if (processors > 1) { updateParallel(); }
+        else {
+            //for each sequence (singletons removed on read)
+            for (int i = 0; i < randomizeSeqs.size(); i++) {
                 
-                //merge into each "close" otu
-                for (set<int>::iterator it = binsToTry.begin(); it != binsToTry.end(); it++) {
-                    tn = trueNegatives; tp = truePositives; fp = falsePositives; fn = falseNegatives;
-                    fn+=cCount; tn+=fCount; fp-=fCount; tp-=cCount;
-                    double newMetric = moveAdjustTFValues(binNumber, seqNumber, *it, tp, tn, fp, fn);
-                    
-                    //new best
-                    if (newMetric > bestMetric) { bestMetric = newMetric; bestBin = (*it); bestTp = tp; bestTn = tn; bestFp = fp; bestFn = fn; }
-                }
+                if (m->control_pressed) { break; }
                 
-                bool usedInsert = false;
-                if (bestBin == -1) {  bestBin = insertLocation;  usedInsert = true;  }
+                int seqNumber = randomizeSeqs[i];
                 
-                if (bestBin != binNumber) {
-                    truePositives = bestTp; trueNegatives = bestTn; falsePositives = bestFp; falseNegatives = bestFn;
-            
-                    //move seq from i to j
-                    bins[bestBin].push_back(seqNumber); //add seq to bestbin
-                    bins[binNumber].erase(remove(bins[binNumber].begin(), bins[binNumber].end(), seqNumber), bins[binNumber].end()); //remove from old bin i
+                if (seqBin[seqNumber] == -1) { }
+                else {
+                    findCloseBins(seqNumber, closeBins);
+                    moveSeq(seqNumber, closeBins);
                 }
-                
-                if (usedInsert) { insertLocation = findInsert(); }
-                
-                //update seqBins
-                seqBin[seqNumber] = bestBin; //set new OTU location
             }
         }
         
@@ -202,22 +231,176 @@ bool OptiCluster::update(double& listMetric) {
     }
 }
 /***********************************************************************/
-double OptiCluster::moveAdjustTFValues(int bin, int seq, int newBin,  long long& tp,  long long& tn,  long long& fp,  long long& fn) {
+//moves seqNumber to the bin that gives the best metric, seqCloseBins are its close bins from findCloseBins. returns true if it moved.
+bool OptiCluster::moveSeq(int seqNumber, vector< pair<int, long long> >& seqCloseBins) {
     try {
+        int binNumber = seqBin[seqNumber];
+        
+        long long tn, tp, fp, fn;
+        double bestMetric = -1;
+        long long bestBin, bestTp, bestTn, bestFn, bestFp;
+        tn = trueNegatives; tp = truePositives; fp = falsePositives; fn = falseNegatives;
+        
+        //this calculation is used to save time in the move and adjust function.
+        //we don't need to calculate the cost of moving out of our current bin each time we
+        //test moving into a new bin. Only calc this once per iteration.
+        //the close seqs tell us how many close sequences are in each bin, including the old one
+        long long cCount = 0;
+        for (int j = 0; j < seqCloseBins.size(); j++) { if (seqCloseBins[j].first == binNumber) { cCount = seqCloseBins[j].second; break; } }
+        long long fCount = getBinSize(binNumber) - 1 - cCount;
+        
+        //metric in current bin
+        bestMetric = calcScoreCurrentBin(tp, tn, fp, fn); bestBin = binNumber; bestTp = tp; bestTn = tn; bestFp = fp; bestFn = fn;
+        
+        //if not already singleton, then calc value if singleton was created
+        if (!(getBinSize(binNumber) == 1)) {
+            //make a singleton
+            //move out of old bin
+            fn+=cCount; tn+=fCount; fp-=fCount; tp-=cCount;
+            double singleMetric = adjustTFValues(0, 0, tp, tn, fp, fn);
+            if (singleMetric > bestMetric) {
+                bestBin = -1; bestTp = tp; bestTn = tn; bestFp = fp; bestFn = fn;
+                bestMetric = singleMetric;
+            }
+        }
         
-        //making a singleton bin. Close but we are forcing apart.
-        if (newBin == -1) {
-        }else { //merging a bin
-            long long ncCount = 0;  long long nfCount = 0;
-            for (int i = 0; i < bins[newBin].size(); i++) { //how many close sequences are in the old bin?
-                if (seq == bins[newBin][i]) {}
-                else if (!matrix->isClose(seq, bins[newBin][i])) { nfCount++; }
-                else { ncCount++;  }
+        //merge into each "close" otu
+        for (int j = 0; j < seqCloseBins.size(); j++) {
+            int newBin = seqCloseBins[j].first;
+            long long ncCount = seqCloseBins[j].second;
+            long long nfCount = getBinSize(newBin) - ncCount;
+            if (newBin == binNumber) { nfCount--; } //don't count yourself
+            
+            tn = trueNegatives; tp = truePositives; fp = falsePositives; fn = falseNegatives;
+            fn+=cCount; tn+=fCount; fp-=fCount; tp-=cCount;
+            double newMetric = adjustTFValues(ncCount, nfCount, tp, tn, fp, fn);
+            
+            //new best
+            if (newMetric > bestMetric) { bestMetric = newMetric; bestBin = newBin; bestTp = tp; bestTn = tn; bestFp = fp; bestFn = fn; }
+        }
+        
+        bool usedInsert = false;
+        if (bestBin == -1) {  bestBin = insertLocation;  usedInsert = true;  }
+        
+        if (bestBin != binNumber) {
+            truePositives = bestTp; trueNegatives = bestTn; falsePositives = bestFp; falseNegatives = bestFn;
+        
+            //move seq from i to j
+            bins[bestBin].push_back(seqNumber); //add seq to bestbin
+            bins[binNumber].erase(remove(bins[binNumber].begin(), bins[binNumber].end(), seqNumber), bins[binNumber].end()); //remove from old bin i
+        }
+        
+        if (usedInsert) { insertLocation = findInsert(); }
+        
+        //update seqBins
+        seqBin[seqNumber] = bestBin; //set new OTU location
+
+        return (bestBin != binNumber);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OptiCluster", "moveSeq");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//the close bins of a batch of seqs are found in parallel from the current bins, then the seqs are moved one at a time in order.
+//a seq whose own bin or one of its close bins changed earlier in the batch is recounted before it moves, so the result matches processors=1.
+void OptiCluster::updateParallel() {
+    try {
+        long long batchSize = processors * 256;
+        vector< vector< pair<int, long long> > > batchCloseBins(batchSize);
+        vector<long long> changedInBatch(bins.size(), -1); //last batch that moved a seq into or out of each bin
+        
+        long long batch = 0;
+        for (long long start = 0; start < randomizeSeqs.size(); start += batchSize) {
+            
+            if (m->control_pressed) { break; }
+            
+            long long end = start + batchSize;
+            if (end > randomizeSeqs.size()) { end = randomizeSeqs.size(); }
+            
+            ThreadPool::getInstance()->parallelFor(start, end, processors, [&](long long first, long long last, int threadID) {
+                for (long long i = first; i < last; i++) { findCloseBins(randomizeSeqs[i], batchCloseBins[i-start]); }
+            }, 16);
+            
+            for (long long i = start; i < end; i++) {
+                
+                if (m->control_pressed) { break; }
+                
+                int seqNumber = randomizeSeqs[i];
+                int binNumber = seqBin[seqNumber];
+                
+                if (binNumber == -1) { }
+                else {
+                    vector< pair<int, long long> >& seqCloseBins = batchCloseBins[i-start];
+                    
+                    bool changed = (changedInBatch[binNumber] == batch);
+                    for (int j = 0; (j < seqCloseBins.size()) && !changed; j++) { if (changedInBatch[seqCloseBins[j].first] == batch) { changed = true; } }
+                    if (changed) { findCloseBins(seqNumber, seqCloseBins); }
+                    
+                    if (moveSeq(seqNumber, seqCloseBins)) { changedInBatch[binNumber] = batch; changedInBatch[seqBin[seqNumber]] = batch; }
+                }
             }
-   
-            //move into new bin
-            fn-=ncCount; tn-=nfCount;  tp+=ncCount; fp+=nfCount;
+            batch++;
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OptiCluster", "updateParallel");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//fills seqCloseBins with the bins holding seqs close to seq and how many close seqs each holds, sorted by bin. safe to call from worker threads.
+void OptiCluster::findCloseBins(int seq, vector< pair<int, long long> >& seqCloseBins) {
+    try {
+        seqCloseBins.clear();
+        
+        const int* closeSeqs = matrix->getCloseSeqs(seq);
+        int numClose = matrix->getNumClose(seq);
+        for (int i = 0; i < numClose; i++) { seqCloseBins.push_back(make_pair(seqBin[closeSeqs[i]], 1LL)); }
+        sort(seqCloseBins.begin(), seqCloseBins.end());
+        
+        //collapse repeated bins into counts
+        int numBins = 0;
+        for (int i = 0; i < seqCloseBins.size(); i++) {
+            if ((numBins != 0) && (seqCloseBins[numBins-1].first == seqCloseBins[i].first)) { seqCloseBins[numBins-1].second++; }
+            else { seqCloseBins[numBins] = seqCloseBins[i]; numBins++; }
         }
+        seqCloseBins.resize(numBins);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OptiCluster", "findCloseBins");
+        exit(1);
+    }
+}
+/***********************************************************************/
+double OptiCluster::moveAdjustTFValues(int bin, int seq, int newBin,  long long& tp,  long long& tn,  long long& fp,  long long& fn) {
+    try {
+        
+        //making a singleton bin. Close but we are forcing apart.
+        if (newBin == -1) { return adjustTFValues(0, 0, tp, tn, fp, fn); }
+        
+        //merging a bin
+        findCloseBins(seq, closeBins);
+        long long ncCount = 0;
+        for (int i = 0; i < closeBins.size(); i++) { if (closeBins[i].first == newBin) { ncCount = closeBins[i].second; break; } }
+        long long nfCount = getBinSize(newBin) - ncCount;
+        if (seqBin[seq] == newBin) { nfCount--; } //don't count yourself
+        
+        return adjustTFValues(ncCount, nfCount, tp, tn, fp, fn);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "OptiCluster", "moveAdjustTFValues");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//ncCount close and nfCount far sequences are in the bin the sequence is moving into
+double OptiCluster::adjustTFValues(long long ncCount, long long nfCount,  long long& tp,  long long& tn,  long long& fp,  long long& fn) {
+    try {
+        
+        //move into new bin
+        fn-=ncCount; tn-=nfCount;  tp+=ncCount; fp+=nfCount;
         
         double result = 0.0;
         if (metric == "mcc") {
@@ -253,7 +436,7 @@ double OptiCluster::moveAdjustTFValues(int bin, int seq, int newBin,  long long&
         return result;
     }
     catch(exception& e) {
-        m->errorOut(e, "OptiCluster", "moveAdjustTFValues");
+        m->errorOut(e, "OptiCluster", "adjustTFValues");
         exit(1);
     }
 }
@@ -561,7 +744,12 @@ vector<double> OptiCluster::getStats( long long& tp,  long long& tn,  long long&
 ListVector* OptiCluster::getList() {
     try {
         ListVector* list = new ListVector();
-        ListVector* singleton = matrix->getListSingle();
+        
+        ListVector* singleton = NULL;
+        if (fixedCounts.size() == 0) { singleton = matrix->getListSingle(); }
+        else { //started from a list, the listed seqs removed on read are in their otus
+            for (int i = 0; i < newSingletons.size(); i++) { list->push_back(newSingletons[i]); }
+        }
         
         if (singleton != NULL) { //add in any sequences above cutoff in read. Removing these saves clustering time.
             for (int i = 0; i < singleton->getNumBins(); i++) {
@@ -579,8 +767,9 @@ ListVector* OptiCluster::getList() {
                 for (int j = 1; j < bins[i].size(); j++) {
                     otu += "," + matrix->getName(bins[i][j]);
                 }
+                if ((fixedCounts.size() != 0) && (fixedCounts[i] != 0)) { otu += "," + fixedNames[i]; }
                 list->push_back(otu);
-            }
+            }else if ((fixedCounts.size() != 0) && (fixedCounts[i] != 0)) { list->push_back(fixedNames[i]); }
         }
         
         return list;
@@ -594,9 +783,10 @@ ListVector* OptiCluster::getList() {
 long long OptiCluster::getNumBins() {
     try {
         long long singletn = matrix->getNumSingletons();
+        if (fixedCounts.size() != 0) { singletn = newSingletons.size(); } //the listed singletons are in their otus
         
         for (int i = 0; i < bins.size(); i++) {
-            if (bins[i].size() != 0) {
+            if (getBinSize(i) != 0) {
                 singletn++;
             }
         }
@@ -618,7 +808,7 @@ int OptiCluster::findInsert() {
             
             if (m->control_pressed) { break; }
             
-            if (bins[i].size() == 0) { return i;  }
+            if (getBinSize(i) == 0) { return i;  }
         }
         
         return -1;
@@ -20,32 +20,40 @@ public:
     
 #ifdef UNIT_TEST
     friend class TestOptiCluster;
-    OptiCluster() : Cluster() { m = MothurOut::getInstance(); truePositives = 0; trueNegatives = 0; falseNegatives = 0; falsePositives = 0; } //for testing class
+    OptiCluster() : Cluster() { m = MothurOut::getInstance(); truePositives = 0; trueNegatives = 0; falseNegatives = 0; falsePositives = 0; processors = 1; } //for testing class
     void setVariables(OptiMatrix* mt, string met) { matrix = mt; metric = met; }
 #endif
     
     OptiCluster(OptiMatrix* mt, string met, long long ns) : Cluster() {
-        m = MothurOut::getInstance(); matrix = mt; metric = met; truePositives = 0; trueNegatives = 0; falseNegatives = 0; falsePositives = 0; numSingletons = ns;
+        m = MothurOut::getInstance(); matrix = mt; metric = met; truePositives = 0; trueNegatives = 0; falseNegatives = 0; falsePositives = 0; numSingletons = ns; processors = 1;
     }
     ~OptiCluster() {}
     bool updateDistance(PDistCell& colCell, PDistCell& rowCell) { return false; } //inheritance compliant
     string getTag() { string tag = "opti_" + metric; return tag; }
     long long getNumBins();
     int initialize(double&, bool, string);  //randomize and place in "best" OTUs
+    int initialize(double&, bool, ListVector*);  //start from the OTUs in a list, only the seqs not in it are moved
     bool update(double&); //returns whether list changed and MCC
     vector<double> getStats( long long&,  long long&,  long long&,  long long&);
     ListVector* getList();
+    void setProcessors(int p) { processors = p; } //processors > 1 finds the close bins of the seqs in parallel, the result is the same
     
 private:
     MothurOut* m;
-    map<int, int> seqBin; //sequence# -> bin#
+    vector<int> seqBin; //sequence# -> bin#, -1 at numSeqs
     OptiMatrix* matrix;
     vector<int> randomizeSeqs;
     vector< vector<int> > bins; //bin[0] -> seqs in bin[0]
+    vector< pair<int, long long> > closeBins; //bin -> number of close seqs in it, for the seq being moved
+    vector<long long> fixedCounts; //seqs from the starting list in each bin that were removed on read, they never move
+    vector<string> fixedNames;
+    vector<string> newSingletons; //seqs removed on read that are not in the starting list
     string metric;
     long long truePositives, trueNegatives, falsePositives, falseNegatives, numSeqs, insertLocation, totalPairs, numSingletons;
+    int processors;
     
     int findInsert();
+    long long getBinSize(int bin) { if (fixedCounts.size() == 0) { return bins[bin].size(); } return bins[bin].size() + fixedCounts[bin]; }
     double calcMCC(long long, long long, long long, long long);
     double calcSens( long long,  long long,  long long,  long long);
     double calcSpec( long long,  long long,  long long,  long long);
@@ -62,6 +70,10 @@ private:
     double calcFDR( long long,  long long,  long long,  long long);
     double calcScoreCurrentBin( long long tp,  long long tn,  long long fp,  long long fn);
     double moveAdjustTFValues(int bin, int seq, int newBin,  long long&,  long long&,  long long&,  long long&);
+    double adjustTFValues(long long, long long, long long&,  long long&,  long long&,  long long&);
+    void findCloseBins(int, vector< pair<int, long long> >&);
+    bool moveSeq(int, vector< pair<int, long long> >&);
+    void updateParallel();
 };
 
 #endif /* defined(__Mothur__opticluster__) */
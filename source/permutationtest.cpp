@@ -0,0 +1,85 @@
+/*
+ *  permutationtest.cpp
+ *  Mothur
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 Schloss Lab. All rights reserved.
+ *
+ */
+
+#include "permutationtest.h"
+
+#define PERMUTATION_BLOCK 1000
+#define PERMUTATION_Z 3.2905  //99.9% confidence interval
+
+/**************************************************************************************************/
+long long PermutationTest::run(Permutation permute) {
+	try {
+		numRun = 0; count = 0;
+
+		unsigned long long baseSeed = (unsigned long long) m->getRandomNumber();
+
+		while (numRun < iters) {
+			if (m->control_pressed) { break; }
+
+			int blockEnd = min(iters, numRun + PERMUTATION_BLOCK);
+
+			vector<long long> threadCounts(processors, 0);
+			ThreadPool::getInstance()->parallelFor(numRun, blockEnd, processors, [&](long long start, long long end, int threadID) {
+				for (long long i = start; i < end; i++) {
+					if (m->control_pressed) { break; }
+					mt19937_64 rng(getStreamSeed(baseSeed, i));
+					if (permute(rng)) { threadCounts[threadID]++; }
+				}
+			});
+
+			for (int i = 0; i < threadCounts.size(); i++) { count += threadCounts[i]; }
+			numRun = blockEnd;
+
+			if (isDecided()) { break; }
+		}
+
+		if ((numRun < iters) && !m->control_pressed) {
+			m->mothurOut("Stopped after " + toString(numRun) + " of " + toString(iters) + " permutations, the p-value is decided at alpha = " + toString(alpha) + ".\n");
+		}
+
+		return count;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PermutationTest", "run");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//Wilson score interval of count/numRun. Only checked at block boundaries so the stopping point is reproducible.
+bool PermutationTest::isDecided() {
+	try {
+		if ((alpha <= 0.0) || (numRun < PERMUTATION_BLOCK)) { return false; }
+
+		double n = numRun;
+		double p = count / n;
+		double z2 = PERMUTATION_Z * PERMUTATION_Z;
+
+		double center = (p + z2 / (2.0 * n)) / (1.0 + z2 / n);
+		double halfWidth = PERMUTATION_Z * sqrt(p * (1.0 - p) / n + z2 / (4.0 * n * n)) / (1.0 + z2 / n);
+
+		return ((center + halfWidth) < alpha) || ((center - halfWidth) > alpha);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PermutationTest", "isDecided");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+string PermutationTest::getPString() {
+	try {
+		double pValue = getPValue();
+		if ((numRun != 0) && (pValue < 1 / (double) numRun)) { return '<' + toString(1 / (double) numRun); }
+		return toString(pValue);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PermutationTest", "getPString");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
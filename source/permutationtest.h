@@ -0,0 +1,50 @@
+#ifndef PERMUTATIONTEST_H
+#define PERMUTATIONTEST_H
+
+/*
+ *  permutationtest.h
+ *  Mothur
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 Schloss Lab. All rights reserved.
+ *
+ *  Runs the permutations of a randomization test on the ThreadPool. Permutation i gets its own random stream,
+ *  seeded from i and one number drawn from mothur's generator, so the p-value under set.seed does not depend on
+ *  the number of processors. Permutations run in blocks and, if an alpha is set, the test stops after a block once
+ *  the confidence interval of the p-value no longer contains alpha.
+ *
+ */
+
+#include "mothurout.h"
+#include "threadpool.h"
+
+/**************************************************************************************************/
+
+class PermutationTest {
+
+public:
+	//returns true if the statistic of the permuted data is at least as extreme as the observed statistic
+	typedef function<bool(mt19937_64&)> Permutation;
+
+	PermutationTest(int i, int p) : iters(i), processors(p), numRun(0), count(0), alpha(-1.0) { m = MothurOut::getInstance(); }
+	~PermutationTest() {}
+
+	void setAlpha(double a) { alpha = a; } //allows the test to stop before iters once the p-value is decided at alpha
+	long long run(Permutation);           //returns the number of permutations at least as extreme
+
+	int getNumRun() { return numRun; }    //less than iters if the test stopped early
+	double getPValue() { if (numRun == 0) { return 0.0; } return count / (double) numRun; }
+	string getPString(); //the p-value, or "<" 1/numRun if no permutation was as extreme
+
+private:
+	MothurOut* m;
+	int iters, processors, numRun;
+	long long count;
+	double alpha;
+
+	bool isDecided();
+};
+
+/**************************************************************************************************/
+
+#endif
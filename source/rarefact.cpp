@@ -8,6 +8,7 @@
  */
 
 #include "rarefact.h"
+#include "threadpool.h"
 //#include "ordervector.hpp"
 
 /***********************************************************************/
@@ -24,28 +25,7 @@ int Rarefact::getCurve(float percentFreq = 0.01, int nIters = 1000){
 		if (percentFreq < 1.0) {  increment = numSeqs * percentFreq;  }
 		else { increment = percentFreq;  }	
 		
-		#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-				if(processors == 1){
-					driver(rcd, increment, nIters);	
-				}else{
-					vector<int> procIters;
-					
-					int numItersPerProcessor = nIters / processors;
-					
-					//divide iters between processes
-					for (int i = 0; i < processors; i++) {
-						if(i == processors - 1){
-							numItersPerProcessor = nIters - i * numItersPerProcessor;
-						}
-						procIters.push_back(numItersPerProcessor);
-					}
-					
-					createProcesses(procIters, rcd, increment, nIters);
-				}
-
-		#else
-			driver(rcd, increment, nIters);	
-		#endif
+		driver(rcd, increment, nIters);
 
 		for(int i=0;i<displays.size();i++){
 			displays[i]->close();
@@ -60,47 +40,65 @@ int Rarefact::getCurve(float percentFreq = 0.01, int nIters = 1000){
 	}
 }
 /***********************************************************************/
+//the iterations are divided among the threads. Each thread shuffles its own copy of the order with the random stream
+//of the iteration, so the curves under set.seed are the same for any number of processors. The calculators keep
+//state, so the sampled ranks are handed to the displays one at a time; RareDisplay sorts the values before output,
+//which makes the order they arrive in irrelevant.
 int Rarefact::driver(RarefactionCurveData* rcd, int increment, int nIters = 1000){
 	try {
-			
-		for(int iter=0;iter<nIters;iter++){
-		
-			for(int i=0;i<displays.size();i++){
-				displays[i]->init(label);
-			}
+		for(int i=0;i<displays.size();i++){
+			displays[i]->init(label);
+		}
 		
-			RAbundVector* lookup	= new RAbundVector(order.getNumBins());
-			SAbundVector* rank	= new SAbundVector(order.getMaxRank()+1);
-			m->mothurRandomShuffle(order);
+		unsigned long long baseSeed = m->getRandomNumber();
+		int numBins = order.getNumBins();
+		int maxRank = order.getMaxRank();
+		mutex displayLock;
 		
-			for(int i=0;i<numSeqs;i++){
-			
-				if (m->control_pressed) { delete lookup; delete rank; delete rcd; return 0;  }
-			
-				int binNumber = order.get(i);
-				int abundance = lookup->get(binNumber);
+		ThreadPool::getInstance()->parallelFor(0, nIters, processors, [&](long long start, long long end, int threadID) {
+			vector<int> sampleOrder(numSeqs);
+			for(int i=0;i<numSeqs;i++){ sampleOrder[i] = order.get(i); }
 			
-				rank->set(abundance, rank->get(abundance)-1);
-				abundance++;
-		
-				lookup->set(binNumber, abundance);
-				rank->set(abundance, rank->get(abundance)+1);
-
-				if((i == 0) || ((i+1) % increment == 0) || (ends.count(i+1) != 0)){
-					rcd->updateRankData(rank);
+			for(long long iter=start;iter<end;iter++){
+				
+				mt19937_64 rng(getStreamSeed(baseSeed, iter));
+				shuffle(sampleOrder.begin(), sampleOrder.end(), rng);
+				
+				RAbundVector lookup(numBins);
+				SAbundVector rank(maxRank+1);
+				
+				for(int i=0;i<numSeqs;i++){
+					
+					if (m->control_pressed) { return; }
+					
+					int binNumber = sampleOrder[i];
+					int abundance = lookup.get(binNumber);
+					
+					rank.set(abundance, rank.get(abundance)-1);
+					abundance++;
+					
+					lookup.set(binNumber, abundance);
+					rank.set(abundance, rank.get(abundance)+1);
+					
+					if((i == 0) || ((i+1) % increment == 0) || (ends.count(i+1) != 0)){
+						lock_guard<mutex> guard(displayLock);
+						rcd->updateRankData(&rank);
+					}
+				}
+				
+				if((numSeqs % increment != 0) || (ends.count(numSeqs) != 0)){
+					lock_guard<mutex> guard(displayLock);
+					rcd->updateRankData(&rank);
 				}
 			}
-	
-			if((numSeqs % increment != 0) || (ends.count(numSeqs) != 0)){
-				rcd->updateRankData(rank);
-			}
-
+		});
+		
+		if (m->control_pressed) { return 0; }
+		
+		for(int iter=0;iter<nIters;iter++){
 			for(int i=0;i<displays.size();i++){
 				displays[i]->reset();
 			}
-			
-			delete lookup;
-			delete rank;
 		}
 
 		return 0;
@@ -110,118 +108,6 @@ int Rarefact::driver(RarefactionCurveData* rcd, int increment, int nIters = 1000
 		exit(1);
 	}
 }
-/**************************************************************************************************/
-
-int Rarefact::createProcesses(vector<int>& procIters, RarefactionCurveData* rcd, int increment, int nIters) {
-	try {
-#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
-		int process = 1;
-		vector<int> processIDS;
-        bool recalc = false;
-		
-		EstOutput results;
-		
-		//loop through and create all the processes you want
-		while (process != processors) {
-			pid_t pid = fork();
-			
-			if (pid > 0) {
-				processIDS.push_back(pid);  //create map from line number to pid so you can append files in correct order later
-				process++;
-			}else if (pid == 0){
-				driver(rcd, increment, procIters[process]);
-			
-				//pass numSeqs to parent
-				for(int i=0;i<displays.size();i++){
-					string tempFile = m->mothurGetpid(process) + toString(i) + ".rarefact.temp";
-					displays[i]->outputTempFiles(tempFile);
-				}
-				exit(0);
-			}else { 
-                m->mothurOut("[ERROR]: unable to spawn the number of processes you requested, reducing number to " + toString(process) + "\n"); processors = process;
-                for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); }
-                //wait to die
-                for (int i=0;i<processIDS.size();i++) {
-                    int temp = processIDS[i];
-                    wait(&temp);
-                }
-                m->control_pressed = false;
-                for (int i=0;i<processIDS.size();i++) {
-                    for(int j=0;j<displays.size();j++){
-                        m->mothurRemove(toString(processIDS[i]) + toString(j) + ".rarefact.temp");
-                    }
-                }
-                recalc = true;
-                break;
-			}
-		}
-		
-        if (recalc) {
-            //test line, also set recalc to true.
-            //for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); } for (int i=0;i<processIDS.size();i++) { int temp = processIDS[i]; wait(&temp); } m->control_pressed = false;  for (int i=0;i<processIDS.size();i++) {for(int j=0;j<displays.size();j++){m->mothurRemove(toString(processIDS[i]) + toString(j) + ".rarefact.temp");}}processors=3; m->mothurOut("[ERROR]: unable to spawn the number of processes you requested, reducing number to " + toString(processors) + "\n");
-            
-            vector<int> procIters;
-            int numItersPerProcessor = nIters / processors;
-            //divide iters between processes
-            for (int i = 0; i < processors; i++) {
-                if(i == processors - 1){
-                    numItersPerProcessor = nIters - i * numItersPerProcessor;
-                }
-                procIters.push_back(numItersPerProcessor);
-            }
-
-            processIDS.resize(0);
-            process = 1;
-            
-            //loop through and create all the processes you want
-            while (process != processors) {
-                pid_t pid = fork();
-                
-                if (pid > 0) {
-                    processIDS.push_back(pid);  //create map from line number to pid so you can append files in correct order later
-                    process++;
-                }else if (pid == 0){
-                    driver(rcd, increment, procIters[process]);
-                    
-                    //pass numSeqs to parent
-                    for(int i=0;i<displays.size();i++){
-                        string tempFile = m->mothurGetpid(process) + toString(i) + ".rarefact.temp";
-                        displays[i]->outputTempFiles(tempFile);
-                    }
-                    exit(0);
-                }else { 
-                    m->mothurOut("[ERROR]: unable to spawn the necessary processes."); m->mothurOutEndLine(); 
-                    for (int i = 0; i < processIDS.size(); i++) { kill (processIDS[i], SIGINT); }
-                    exit(0);
-                }
-            }
-        }
-        
-		driver(rcd, increment, procIters[0]);
-		
-		//force parent to wait until all the processes are done
-		for (int i=0;i<(processors-1);i++) { 
-			int temp = processIDS[i];
-			wait(&temp);
-		}
-		
-		//get data created by processes
-		for (int i=0;i<(processors-1);i++) { 
-			for(int j=0;j<displays.size();j++){
-				string s = toString(processIDS[i]) + toString(j) + ".rarefact.temp";
-				displays[j]->inputTempFiles(s);
-				m->mothurRemove(s);
-			}
-		}
-		
-		return 0;
-#endif		
-	}
-	catch(exception& e) {
-		m->errorOut(e, "Rarefact", "createProcesses");
-		exit(1);
-	}
-}
 /***********************************************************************/
 
 int Rarefact::getSharedCurve(float percentFreq = 0.01, int nIters = 1000){
@@ -37,6 +37,22 @@ int ReadColumnMatrix::read(NameAssignment* nameMap){
         DMatrix->resize(nseqs);
 		list = new ListVector(nameMap->getListVector());
 	
+		if (SparseDistFile::isSparseDistFile(distFile)) {
+			fileHandle.close();
+			SparseDistFile sparse;
+			if (!sparse.open(distFile)) { m->control_pressed = true; return 0; }
+			
+			vector<int> indexes(sparse.getNumSeqs(), -1);
+			for (unsigned int i = 0; i < sparse.getNumSeqs(); i++) {
+				string name = sparse.getName(i);
+				map<string,int>::iterator it = nameMap->find(name);
+				if(it == nameMap->end()){  m->mothurOut("AAError: Sequence '" + name + "' was not found in the names file, please correct\n"); exit(1);  }
+				indexes[i] = it->second;
+			}
+			
+			return readSparse(sparse, indexes);
+		}
+
 		Progress* reading = new Progress("Reading matrix:     ", nseqs * nseqs);
 
 		int lt = 1;
@@ -162,6 +178,20 @@ int ReadColumnMatrix::read(CountTable* countTable){
         DMatrix->resize(nseqs);
 		list = new ListVector(countTable->getListVector());
         
+		if (SparseDistFile::isSparseDistFile(distFile)) {
+			fileHandle.close();
+			SparseDistFile sparse;
+			if (!sparse.open(distFile)) { m->control_pressed = true; return 0; }
+			
+			vector<int> indexes(sparse.getNumSeqs(), -1);
+			for (unsigned int i = 0; i < sparse.getNumSeqs(); i++) {
+				indexes[i] = countTable->get(sparse.getName(i));
+				if (m->control_pressed) { exit(1); }
+			}
+			
+			return readSparse(sparse, indexes);
+		}
+        
 		Progress* reading = new Progress("Reading matrix:     ", nseqs * nseqs);
         
 		int lt = 1;
@@ -273,6 +303,48 @@ int ReadColumnMatrix::read(CountTable* countTable){
 	}
 }
 
+/***********************************************************************/
+//sparse files are lower triangle with the names already numbered, so each distance is one lookup in indexes
+int ReadColumnMatrix::readSparse(SparseDistFile& sparse, vector<int>& indexes){
+	try {
+		Progress* reading = new Progress("Reading matrix:     ", sparse.getNumSeqs());
+		
+		for (unsigned int i = 0; i < sparse.getNumSeqs(); i++) {
+			if (m->control_pressed) {  delete reading; return 0; }
+			
+			unsigned int size;
+			const SparseDistCell* row = sparse.getRow(i, size);
+			
+			for (unsigned int k = 0; k < size; k++) {
+				float distance = row[k].dist;
+				
+				if (distance == -1) { distance = 1000000; }
+				else if (sim) { distance = 1.0 - distance;  }  //user has entered a sim matrix that we need to convert.
+				
+				int itA = indexes[i];
+				int itB = indexes[row[k].neighbor];
+				
+				if(distance < cutoff && itA != itB){
+					if (itA > itB)	{ PDistCell value(itA, distance); DMatrix->addCell(itB, value); }
+					else			{ PDistCell value(itB, distance); DMatrix->addCell(itA, value); }
+				}
+			}
+			
+			reading->update(i);
+		}
+		
+		reading->finish();
+		delete reading;
+		
+		list->setLabel("0");
+		
+		return 1;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ReadColumnMatrix", "readSparse");
+		exit(1);
+	}
+}
 /***********************************************************************/
 ReadColumnMatrix::~ReadColumnMatrix(){}
 /***********************************************************************/
@@ -10,6 +10,7 @@
  */
 
 #include "readmatrix.hpp"
+#include "sparsedistfile.h"
 
 /******************************************************/
 
@@ -25,6 +26,8 @@ private:
 	ifstream fileHandle;
 	string distFile;
 	
+	int readSparse(SparseDistFile&, vector<int>&);
+	
 };
 
 /******************************************************/
@@ -0,0 +1,209 @@
+/*
+ *  sparsedistfile.cpp
+ *  Mothur
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 Schloss Lab. All rights reserved.
+ *
+ */
+
+#include "sparsedistfile.h"
+
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+static const char sparseDistMagic[8] = { 'M', 'O', 'T', 'H', 'U', 'R', 'S', 'D' };
+static const unsigned int sparseDistVersion = 1;
+
+/***********************************************************************/
+SparseDistFile::SparseDistFile() {
+	m = MothurOut::getInstance();
+	data = NULL; dataSize = 0; mapped = false;
+	numSeqs = 0; numCells = 0; cutoff = 0;
+	cells = NULL; rows = NULL;
+	nextRow = 0; nextCell = 0;
+}
+/***********************************************************************/
+SparseDistFile::~SparseDistFile() { close(); }
+/***********************************************************************/
+bool SparseDistFile::isSparseDistFile(string filename) {
+	try {
+		ifstream in(filename.c_str(), ios::binary);
+		if (!in) { return false; }
+
+		char magic[8];
+		in.read(magic, 8);
+		if (in.gcount() != 8) { return false; }
+
+		return (memcmp(magic, sparseDistMagic, 8) == 0);
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "SparseDistFile", "isSparseDistFile");
+		exit(1);
+	}
+}
+/***********************************************************************/
+void SparseDistFile::writeHeader(ostream& out) {
+	try {
+		Header header;
+		memset(&header, 0, sizeof(Header));
+		out.write((const char*)&header, sizeof(Header));
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "SparseDistFile", "writeHeader");
+		exit(1);
+	}
+}
+/***********************************************************************/
+void SparseDistFile::writeTables(ostream& out, const vector<string>& seqNames, const vector<unsigned int>& rowSizes, float c) {
+	try {
+		Header header;
+		memset(&header, 0, sizeof(Header));
+		memcpy(header.magic, sparseDistMagic, 8);
+		header.version = sparseDistVersion;
+		header.numSeqs = seqNames.size();
+		header.cutoff = c;
+		header.rowsOffset = out.tellp();
+
+		unsigned long long offset = 0;
+		out.write((const char*)&offset, sizeof(unsigned long long));
+		for (int i = 0; i < rowSizes.size(); i++) {
+			offset += rowSizes[i];
+			out.write((const char*)&offset, sizeof(unsigned long long));
+		}
+		header.numCells = offset;
+
+		header.namesOffset = out.tellp();
+		for (int i = 0; i < seqNames.size(); i++) { out.write(seqNames[i].c_str(), seqNames[i].length()+1); }
+
+		out.seekp(0);
+		out.write((const char*)&header, sizeof(Header));
+		out.seekp(0, ios::end);
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "SparseDistFile", "writeTables");
+		exit(1);
+	}
+}
+/***********************************************************************/
+bool SparseDistFile::open(string filename) {
+	try {
+		close();
+
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+		int fd = ::open(filename.c_str(), O_RDONLY);
+		if (fd == -1) { m->mothurOut("[ERROR]: Could not open " + filename + "\n"); return false; }
+
+		struct stat info;
+		if ((fstat(fd, &info) == -1) || (info.st_size < sizeof(Header))) { ::close(fd); m->mothurOut("[ERROR]: " + filename + " is not a sparse distance file.\n"); return false; }
+		dataSize = info.st_size;
+
+		void* region = mmap(NULL, dataSize, PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd);
+		if (region == MAP_FAILED) { m->mothurOut("[ERROR]: Could not map " + filename + "\n"); dataSize = 0; return false; }
+		data = (char*)region; mapped = true;
+#else
+		ifstream in(filename.c_str(), ios::binary);
+		if (!in) { m->mothurOut("[ERROR]: Could not open " + filename + "\n"); return false; }
+		in.seekg(0, ios::end);
+		dataSize = in.tellg();
+		in.seekg(0, ios::beg);
+		if (dataSize < sizeof(Header)) { m->mothurOut("[ERROR]: " + filename + " is not a sparse distance file.\n"); dataSize = 0; return false; }
+
+		data = new char[dataSize];
+		in.read(data, dataSize);
+		mapped = false;
+#endif
+
+		Header header;
+		memcpy(&header, data, sizeof(Header));
+
+		//sizes are checked against the file before they are multiplied, so a damaged header can't overflow the offsets
+		bool valid = (memcmp(header.magic, sparseDistMagic, 8) == 0) && (header.version == sparseDistVersion);
+		valid = valid && (header.numCells <= ((dataSize - sizeof(Header)) / sizeof(SparseDistCell)));
+		valid = valid && (header.rowsOffset == (sizeof(Header) + header.numCells * sizeof(SparseDistCell)));
+		valid = valid && (header.numSeqs < ((dataSize - header.rowsOffset) / sizeof(unsigned long long)));
+		valid = valid && (header.namesOffset == (header.rowsOffset + (header.numSeqs+1ULL) * sizeof(unsigned long long)));
+		valid = valid && (header.namesOffset <= dataSize);
+		if (!valid) { m->mothurOut("[ERROR]: " + filename + " is not a sparse distance file or is incomplete.\n"); close(); return false; }
+
+		numSeqs = header.numSeqs;
+		numCells = header.numCells;
+		cutoff = header.cutoff;
+		cells = (const SparseDistCell*)(data + sizeof(Header));
+		rows = (const unsigned long long*)(data + header.rowsOffset);
+
+		//rows must tile the cells in order and row i may only point at sequences before i
+		valid = (rows[0] == 0) && (rows[numSeqs] == numCells);
+		for (unsigned int i = 0; (i < numSeqs) && valid; i++) {
+			if (rows[i] > rows[i+1]) { valid = false; break; }
+			for (unsigned long long j = rows[i]; j < rows[i+1]; j++) { if (cells[j].neighbor >= i) { valid = false; break; } }
+		}
+		if (!valid) { m->mothurOut("[ERROR]: " + filename + " has row offsets or neighbors that don't fit its " + toString(numSeqs) + " sequences, it is damaged.\n"); close(); return false; }
+
+		names.resize(numSeqs);
+		const char* name = data + header.namesOffset;
+		const char* dataEnd = data + dataSize;
+		for (unsigned int i = 0; i < numSeqs; i++) {
+			const char* nameEnd = (const char*)memchr(name, '\0', dataEnd - name);
+			if (nameEnd == NULL) { m->mothurOut("[ERROR]: " + filename + " is missing sequence names.\n"); close(); return false; }
+			names[i] = name;
+			name = nameEnd + 1;
+		}
+
+		nextRow = 0; nextCell = 0;
+
+		return true;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SparseDistFile", "open");
+		exit(1);
+	}
+}
+/***********************************************************************/
+void SparseDistFile::close() {
+	try {
+		if (data != NULL) {
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+			if (mapped) { munmap(data, dataSize); }
+			else { delete[] data; }
+#else
+			delete[] data;
+#endif
+		}
+		data = NULL; dataSize = 0; mapped = false;
+		numSeqs = 0; numCells = 0;
+		cells = NULL; rows = NULL;
+		names.clear();
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SparseDistFile", "close");
+		exit(1);
+	}
+}
+/***********************************************************************/
+bool SparseDistFile::getNextPair(string& seqA, string& seqB, float& dist) {
+	try {
+		if (data == NULL) { return false; }
+
+		//skip rows that are used up, row 0 never has cells
+		while ((nextRow < numSeqs) && (nextCell >= rows[nextRow+1])) { nextRow++; }
+		if (nextRow >= numSeqs) { return false; }
+
+		seqA = names[nextRow];
+		seqB = names[cells[nextCell].neighbor];
+		dist = cells[nextCell].dist;
+		nextCell++;
+
+		return true;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SparseDistFile", "getNextPair");
+		exit(1);
+	}
+}
+/***********************************************************************/
@@ -0,0 +1,93 @@
+#ifndef SPARSEDISTFILE_H
+#define SPARSEDISTFILE_H
+/*
+ *  sparsedistfile.h
+ *  Mothur
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 Schloss Lab. All rights reserved.
+ *
+ *	Binary sparse distance matrix written by dist.seqs output=sparse. cluster, cluster.split and the opti method accept
+ *	it anywhere they take a column file and map it instead of parsing text.  Sequences are numbered 0 to numSeqs-1 and
+ *	row i holds the distances from i to the sequences before it, sorted by neighbor, so each pair is stored once.
+ *
+ *		header	64 bytes - magic, version, numSeqs, numCells, offsets of the row and name tables, cutoff
+ *		cells	numCells SparseDistCells, row after row
+ *		rows	numSeqs+1 unsigned long longs, row i is cells[rows[i]] up to cells[rows[i+1]]
+ *		names	numSeqs null terminated names
+ *
+ *	Numbers are stored in the byte order of the machine that wrote the file.
+ */
+
+#include "mothurout.h"
+
+/******************************************************/
+
+struct SparseDistCell {
+	float dist;
+	unsigned int neighbor;
+};
+
+/******************************************************/
+
+class SparseDistFile {
+
+public:
+	SparseDistFile();
+	~SparseDistFile();
+
+	static bool isSparseDistFile(string);
+
+	//writers put down a header placeholder, then the cells in row order, then the tables which fill in the header
+	static void writeHeader(ostream&);
+	static void writeCell(ostream& out, unsigned int neighbor, float dist) {
+		SparseDistCell cell; cell.dist = dist; cell.neighbor = neighbor;
+		out.write((const char*)&cell, sizeof(SparseDistCell));
+	}
+	static void writeTables(ostream&, const vector<string>&, const vector<unsigned int>&, float); //names, number of cells in each row, cutoff
+
+	bool open(string);
+	void close();
+
+	unsigned int getNumSeqs()			{ return numSeqs;			}
+	unsigned long long getNumCells()	{ return numCells;			}
+	float getCutoff()					{ return cutoff;			}
+	string getName(unsigned int i)		{ return string(names[i]);	}
+
+	//row i, the distances to sequences 0 to i-1 that are in the file
+	const SparseDistCell* getRow(unsigned int i, unsigned int& size) {
+		size = rows[i+1] - rows[i];
+		return cells + rows[i];
+	}
+
+	//walks the file one pair at a time, returns false at the end
+	bool getNextPair(string&, string&, float&);
+
+private:
+	struct Header {
+		char magic[8];
+		unsigned int version, numSeqs;
+		unsigned long long numCells, rowsOffset, namesOffset;
+		float cutoff;
+		unsigned int reserved[5];
+	};
+
+	MothurOut* m;
+	char* data;
+	unsigned long long dataSize;
+	bool mapped;
+
+	unsigned int numSeqs;
+	unsigned long long numCells;
+	float cutoff;
+	const SparseDistCell* cells;
+	const unsigned long long* rows;
+	vector<const char*> names;
+
+	unsigned int nextRow;
+	unsigned long long nextCell;
+};
+
+/******************************************************/
+
+#endif
@@ -11,6 +11,7 @@
 #include "phylotree.h"
 #include "distancecommand.h"
 #include "seqsummarycommand.h"
+#include "sparsedistfile.h"
 
 /***********************************************************************/
 
@@ -242,6 +243,39 @@ int SplitMatrix::createDistanceFilesFromTax(map<string, int>& seqGroup, int numG
 	}
 }
 /***********************************************************************/
+//distFile can be a column file or a sparse distance file from dist.seqs, returns NULL for a column file which is opened in in
+SparseDistFile* SplitMatrix::openDistFile(ifstream& in){
+	try {
+		SparseDistFile* sparse = NULL;
+		
+		if (SparseDistFile::isSparseDistFile(distFile)) {
+			sparse = new SparseDistFile();
+			if (!sparse->open(distFile)) { m->control_pressed = true; }
+		}else { m->openInputFile(distFile, in); }
+		
+		return sparse;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SplitMatrix", "openDistFile");
+		exit(1);
+	}
+}
+/***********************************************************************/
+bool SplitMatrix::readNextDist(ifstream& in, SparseDistFile* sparse, string& seqA, string& seqB, float& dist){
+	try {
+		if (sparse != NULL) { return sparse->getNextPair(seqA, seqB, dist); }
+		
+		if (!in) { return false; }
+		in >> seqA >> seqB >> dist; m->gobble(in);
+		
+		return true;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SplitMatrix", "readNextDist");
+		exit(1);
+	}
+}
+/***********************************************************************/
 int SplitMatrix::splitDistanceFileByTax(map<string, int>& seqGroup, int numGroups){
 	try {
 		map<string, int>::iterator it;
@@ -249,7 +283,7 @@ int SplitMatrix::splitDistanceFileByTax(map<string, int>& seqGroup, int numGroup
 		
         ofstream outFile;
 		ifstream dFile;
-		m->openInputFile(distFile, dFile);
+		SparseDistFile* sparse = openDistFile(dFile);
 		
 		
 		for (int i = 0; i < numGroups; i++) { //remove old temp files, just in case
@@ -266,13 +300,11 @@ int SplitMatrix::splitDistanceFileByTax(map<string, int>& seqGroup, int numGroup
 		vector<bool> validDistances;   validDistances.resize(numGroups, false); 
 		
 		//for each distance
-		while(dFile){
-			string seqA, seqB;
-			float dist;
-			
-			if (m->control_pressed) { dFile.close(); for (int i = 0; i < numGroups; i++) { m->mothurRemove((distFile + "." + toString(i) + ".temp"));	} }
+		string seqA, seqB;
+		float dist;
+		while(readNextDist(dFile, sparse, seqA, seqB, dist)){
 			
-			dFile >> seqA >> seqB >> dist;  m->gobble(dFile);
+			if (m->control_pressed) { dFile.close(); if (sparse != NULL) { delete sparse; } for (int i = 0; i < numGroups; i++) { m->mothurRemove((distFile + "." + toString(i) + ".temp"));	} return 0; }
 			
 			//if both sequences are in the same group then they are within the cutoff
 			it = seqGroup.find(seqA);
@@ -295,6 +327,7 @@ int SplitMatrix::splitDistanceFileByTax(map<string, int>& seqGroup, int numGroup
 			}
 		}
 		dFile.close();
+		if (sparse != NULL) { delete sparse; }
         
         string inputFile = namefile;
         if (countfile != "") { inputFile = countfile; }
@@ -348,15 +381,13 @@ int SplitMatrix::splitDistanceLarge(){
 
 		//ofstream outFile;
 		ifstream dFile;
-		m->openInputFile(distFile, dFile);
+		SparseDistFile* sparse = openDistFile(dFile);
 	
-		while(dFile){
-			string seqA, seqB;
-			float dist;
-
-			dFile >> seqA >> seqB >> dist;
+		string seqA, seqB;
+		float dist;
+		while(readNextDist(dFile, sparse, seqA, seqB, dist)){
 			
-			if (m->control_pressed) {   dFile.close();  for(int i=0;i<numGroups;i++){	if(groups[i].size() > 0){  m->mothurRemove((distFile + "." + toString(i) + ".temp")); }  } return 0; }
+			if (m->control_pressed) {   dFile.close();  if (sparse != NULL) { delete sparse; }  for(int i=0;i<numGroups;i++){	if(groups[i].size() > 0){  m->mothurRemove((distFile + "." + toString(i) + ".temp")); }  } return 0; }
 					
 			if(dist < cutoff){
 				//cout << "in cutoff: " << dist << endl;
@@ -500,9 +531,9 @@ int SplitMatrix::splitDistanceLarge(){
 					}
 				}
 			}
-			m->gobble(dFile);
 		}
 		dFile.close();
+		if (sparse != NULL) { delete sparse; }
         
 		vector<string> tempDistFiles;
 		for (int i = 0; i < numGroups; i++) {
@@ -772,15 +803,13 @@ int SplitMatrix::splitDistanceRAM(){
 		int numGroups = 0;
 
 		ifstream dFile;
-		m->openInputFile(distFile, dFile);
-
-		while(dFile){
-			string seqA, seqB;
-			float dist;
+		SparseDistFile* sparse = openDistFile(dFile);
 
-			dFile >> seqA >> seqB >> dist;
+		string seqA, seqB;
+		float dist;
+		while(readNextDist(dFile, sparse, seqA, seqB, dist)){
 			
-			if (m->control_pressed) {   dFile.close();  for(int i=0;i<numGroups;i++){	if(groups[i].size() > 0){  m->mothurRemove((distFile + "." + toString(i) + ".temp")); }  } return 0; }
+			if (m->control_pressed) {   dFile.close();  if (sparse != NULL) { delete sparse; }  for(int i=0;i<numGroups;i++){	if(groups[i].size() > 0){  m->mothurRemove((distFile + "." + toString(i) + ".temp")); }  } return 0; }
 					
 			if(dist < cutoff){
 				//cout << "in cutoff: " << dist << endl;
@@ -855,9 +884,9 @@ int SplitMatrix::splitDistanceRAM(){
 					}
 				}
 			}
-			m->gobble(dFile);
 		}
 		dFile.close();
+		if (sparse != NULL) { delete sparse; }
 		
         vector<string> tempDistFiles;
 		for (int i = 0; i < numGroups; i++) {
@@ -13,6 +13,8 @@
 #include "mothur.h"
 #include "mothurout.h"
 
+class SparseDistFile;
+
 /******************************************************/
 
 class SplitMatrix  {
@@ -46,6 +48,8 @@ class SplitMatrix  {
         int splitNamesVsearch(map<string, int>& groups, int, vector<string>&);
 		int splitDistanceFileByTax(map<string, int>&, int);
 		int createDistanceFilesFromTax(map<string, int>&, int);
+		SparseDistFile* openDistFile(ifstream&);
+		bool readNextDist(ifstream&, SparseDistFile*, string&, string&, float&);
 };
 
 /******************************************************/
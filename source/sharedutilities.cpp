@@ -335,3 +335,36 @@ void SharedUtil::updateGroupIndex(vector<string>& userGroups, map<string, int>&
 /**************************************************************************************/
 
 
+//copies the groups in lookup keeping only the otus that are non zero in at least one of them. Returns false without copying 
+//if more than half the otus are present anyway or none are.
+bool SharedUtil::getPresentOtus(vector<SharedRAbundVector*>& lookup, vector<SharedRAbundVector*>& present) {
+	try {
+		present.clear();
+		if (lookup.size() == 0) { return false; }
+		
+		vector<int> otus = lookup[0]->getNonZeroBins();
+		for (int i = 1; i < lookup.size(); i++) {
+			vector<int> thisOtus = lookup[i]->getNonZeroBins();
+			vector<int> allOtus; allOtus.reserve(otus.size() + thisOtus.size());
+			set_union(otus.begin(), otus.end(), thisOtus.begin(), thisOtus.end(), back_inserter(allOtus));
+			otus.swap(allOtus);
+		}
+		
+		if ((otus.size() == 0) || ((otus.size() * 2) > lookup[0]->getNumBins())) { return false; }
+		
+		for (int i = 0; i < lookup.size(); i++) {
+			SharedRAbundVector* temp = new SharedRAbundVector();
+			temp->setLabel(lookup[i]->getLabel());
+			temp->setGroup(lookup[i]->getGroup());
+			for (int j = 0; j < otus.size(); j++) { temp->push_back(lookup[i]->getAbundance(otus[j]), lookup[i]->getGroup()); }
+			present.push_back(temp);
+		}
+		
+		return true;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SharedUtil", "getPresentOtus");
+		exit(1);
+	}
+}
+/**************************************************************************************/
@@ -30,6 +30,7 @@ class SharedUtil {
 		void getCombos(vector<string>&, vector<string>, int&); //groupcomb, globaldata->Groups, numcomb
 		void updateGroupIndex(vector<string>&, map<string, int>&); //globaldata->Groups, groupmap->groupIndex
 		bool isValidGroup(string, vector<string>);
+		bool getPresentOtus(vector<SharedRAbundVector*>&, vector<SharedRAbundVector*>&); //lookup, copies of lookup without the otus that are zero in all groups
 		
 	private:
 		MothurOut* m;
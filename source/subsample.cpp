@@ -30,21 +30,14 @@ Tree* SubSample::getSample(Tree* T, CountTable* ct, CountTable* newCt, int size)
                 if (thisSize >= size) {	
                     
                     vector<string> names = ct->getNamesOfSeqs(Groups[i]);
-                    vector<int> random;
-                    for (int j = 0; j < names.size(); j++) {
-                        int num = ct->getGroupCount(names[j], Groups[i]);
-                        for (int k = 0; k < num; k++) { random.push_back(j); }
-                    }
-                    m->mothurRandomShuffle(random);
+                    vector<int> abunds(names.size(), 0);
+                    for (int j = 0; j < names.size(); j++) { abunds[j] = ct->getGroupCount(names[j], Groups[i]); }
                     
-                    vector<int> sampleRandoms; sampleRandoms.resize(names.size(), 0);
-                    for (int j = 0; j < size; j++) { sampleRandoms[random[j]]++; }
+                    vector<int> sampleRandoms = getSample(abunds, size);
                     for (int j = 0; j < sampleRandoms.size(); j++) {
                         newCt->setAbund(names[j], Groups[i], sampleRandoms[j]);
+                        doNotIncludeTotals[names[j]] += (abunds[j] - sampleRandoms[j]);
                     }
-                    sampleRandoms.clear(); sampleRandoms.resize(names.size(), 0);
-                    for (int j = size; j < thisSize; j++) { sampleRandoms[random[j]]++; }
-                    for (int j = 0; j < sampleRandoms.size(); j++) {  doNotIncludeTotals[names[j]] += sampleRandoms[j]; }
                 }else {  m->mothurOut("[ERROR]: You have selected a size that is larger than "+Groups[i]+" number of sequences.\n"); m->control_pressed = true; }
             }
 
@@ -119,9 +112,12 @@ vector<string> SubSample::getSample(vector<SharedRAbundVector*>& thislookup, int
 				
 				string thisgroup = thislookup[i]->getGroup();
 				
-				OrderVector order = thislookup[i]->getOrderVector(NULL);
-                
-                m->mothurRandomShuffle(order);
+				vector<int> abunds(numBins, 0);
+				for (int j = 0; j < numBins; j++) { abunds[j] = thislookup[i]->getAbundance(j); }
+				
+				vector<int> sample = getSample(abunds, size);
+				
+				if (m->control_pressed) {  return m->currentSharedBinLabels; }
 				
 				SharedRAbundVector* temp = new SharedRAbundVector(numBins);
 				temp->setLabel(thislookup[i]->getLabel());
@@ -130,15 +126,8 @@ vector<string> SubSample::getSample(vector<SharedRAbundVector*>& thislookup, int
 				delete thislookup[i];
 				thislookup[i] = temp;
 				
-				
-				for (int j = 0; j < size; j++) {
-					
-					if (m->control_pressed) {  return m->currentSharedBinLabels; }
-					
-					int bin = order.get(j);
-					
-					int abund = thislookup[i]->getAbundance(bin);
-					thislookup[i]->set(bin, (abund+1), thisgroup);
+				for (int j = 0; j < numBins; j++) {
+					if (sample[j] != 0) { thislookup[i]->set(j, sample[j], thisgroup); }
 				}	
 			}
 		}
@@ -161,6 +150,46 @@ vector<string> SubSample::getSample(vector<SharedRAbundVector*>& thislookup, int
 	}
 }	
 //**********************************************************************************************************************
+vector<SharedRAbundVector*> SubSample::getSamplePreserve(const vector<SharedRAbundVector*>& thislookup, int size, mt19937_64& rng) {
+	try {
+		vector<SharedRAbundVector*> newLookup;
+		if (thislookup.size() == 0) { return newLookup; }
+		
+		int numBins = thislookup[0]->getNumBins();
+		vector< vector<int> > samples(thislookup.size());
+		for (int i = 0; i < thislookup.size(); i++) {
+			samples[i] = thislookup[i]->getAbundances();
+			samples[i].resize(numBins, 0);
+			if (thislookup[i]->getNumSeqs() != size) { samples[i] = getSample(samples[i], size, &rng); }
+			
+			if (m->control_pressed) { return newLookup; }
+		}
+		
+		for (int i = 0; i < thislookup.size(); i++) {
+			SharedRAbundVector* temp = new SharedRAbundVector();
+			temp->setLabel(thislookup[i]->getLabel());
+			temp->setGroup(thislookup[i]->getGroup());
+			newLookup.push_back(temp);
+		}
+		
+		//subsampling may have created some otus with no sequences in them
+		for (int j = 0; j < numBins; j++) {
+			bool allZero = true;
+			for (int i = 0; i < samples.size(); i++) { if (samples[i][j] != 0) { allZero = false; break; } }
+			
+			if (!allZero) {
+				for (int i = 0; i < samples.size(); i++) { newLookup[i]->push_back(samples[i][j], newLookup[i]->getGroup()); }
+			}
+		}
+		
+		return newLookup;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SubSample", "getSamplePreserve");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
 int SubSample::eliminateZeroOTUS(vector<SharedRAbundVector*>& thislookup) {
 	try {
 		
@@ -224,21 +253,18 @@ int SubSample::getSample(SAbundVector*& sabund, int size) {
         int numBins = sabund->getNumBins();
         int thisSize = sabund->getNumSeqs();
 
-        OrderVector order = sabund->getOrderVector();
-        
 		if (thisSize > size) {
-			m->mothurRandomShuffle(order);
+            RAbundVector original = sabund->getRAbundVector();
+            vector<int> abunds(numBins, 0);
+            for (int j = 0; j < numBins; j++) { abunds[j] = original.get(j); }
+            
+            vector<int> sample = getSample(abunds, size);
+            
+            if (m->control_pressed) { return 0; }
 			
             RAbundVector rabund(numBins);
 			rabund.setLabel(sabund->getLabel());
-
-			for (int j = 0; j < size; j++) {
-                
-				if (m->control_pressed) { return 0; }
-				
-                int abund = rabund.get(order.get(j));
-				rabund.set(order.get(j), (abund+1));
-			}
+            for (int j = 0; j < numBins; j++) { if (sample[j] != 0) { rabund.set(j, sample[j]); } }
 
             delete sabund;
             sabund = new SAbundVector();
@@ -267,31 +293,30 @@ CountTable SubSample::getSample(CountTable& ct, int size, vector<string> Groups)
             sampledCt.addGroup(Groups[i]);
             
             vector<string> names = ct.getNamesOfSeqs(Groups[i]);
-            vector<string> allNames;
+            vector<int> abunds(names.size(), 0);
+            long long groupTotal = 0;
             for (int j = 0; j < names.size(); j++) {
-                
-                if (m->control_pressed) { return sampledCt; }
-                
-                int num = ct. getGroupCount(names[j], Groups[i]);
-                for (int k = 0; k < num; k++) { allNames.push_back(names[j]); }
+                abunds[j] = ct.getGroupCount(names[j], Groups[i]);
+                groupTotal += abunds[j];
             }
             
-            m->mothurRandomShuffle(allNames);
-            
-            if (allNames.size() < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than "+Groups[i]+" number of sequences.\n"); m->control_pressed = true; }
+            if (groupTotal < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than "+Groups[i]+" number of sequences.\n"); m->control_pressed = true; }
             else{
-                for (int j = 0; j < size; j++) {
-                    
-                    if (m->control_pressed) { return sampledCt; }
+                vector<int> sample = getSample(abunds, size);
+                
+                if (m->control_pressed) { return sampledCt; }
+                
+                for (int j = 0; j < names.size(); j++) {
+                    if (sample[j] == 0) { continue; }
                     
-                    map<string, vector<int> >::iterator it = tempCount.find(allNames[j]);
+                    map<string, vector<int> >::iterator it = tempCount.find(names[j]);
                     
                     if (it == tempCount.end()) { //we have not seen this sequence at all yet
                         vector<int> tempGroups; tempGroups.resize(Groups.size(), 0);
-                        tempGroups[i]++;
-                        tempCount[allNames[j]] = tempGroups;
+                        tempGroups[i] = sample[j];
+                        tempCount[names[j]] = tempGroups;
                     }else{
-                        tempCount[allNames[j]][i]++;
+                        (it->second)[i] = sample[j];
                     }
                 }
             }
@@ -318,13 +343,15 @@ CountTable SubSample::getSample(CountTable& ct, int size, vector<string> Groups,
         
         if (ct.hasGroupInfo()) {
             map<string, vector<int> > tempCount;
-            vector<item> allNames;
+            vector<item> cells; //one per sequence and group it is in, abunds holds the sequence's count in the group
+            vector<int> abunds;
             map<string, int> groupMap;
             
             vector<string> myGroups;
             if (pickedGroups) { myGroups = Groups; }
             else {  myGroups = ct.getNamesOfGroups(); }
             
+            long long total = 0;
             for (int i = 0; i < myGroups.size(); i++) {
                 sampledCt.addGroup(myGroups[i]);
                 groupMap[myGroups[i]] = i;
@@ -335,32 +362,35 @@ CountTable SubSample::getSample(CountTable& ct, int size, vector<string> Groups,
                     if (m->control_pressed) { return sampledCt; }
                     
                     int num = ct. getGroupCount(names[j], myGroups[i]);
-                    for (int k = 0; k < num; k++) { 
-                        item temp(names[j], myGroups[i]);
-                        allNames.push_back(temp); 
-                    }
+                    if (num == 0) { continue; }
+                    
+                    item temp(names[j], myGroups[i]);
+                    cells.push_back(temp);
+                    abunds.push_back(num);
+                    total += num;
                 }
             }
             
-            m->mothurRandomShuffle(allNames);
-            
-            if (allNames.size() < size) { 
+            if (total < size) { 
                 if (pickedGroups) { m->mothurOut("[ERROR]: You have selected a size that is larger than the number of sequences.\n"); } 
                 else { m->mothurOut("[ERROR]: You have selected a size that is larger than the number of sequences in the groups you chose.\n"); }
                 m->control_pressed = true; return sampledCt; }
             else{
-                for (int j = 0; j < size; j++) {
-                    
-                    if (m->control_pressed) { return sampledCt; }
+                vector<int> sample = getSample(abunds, size);
+                
+                if (m->control_pressed) { return sampledCt; }
+                
+                for (int j = 0; j < cells.size(); j++) {
+                    if (sample[j] == 0) { continue; }
                     
-                    map<string, vector<int> >::iterator it = tempCount.find(allNames[j].name);
+                    map<string, vector<int> >::iterator it = tempCount.find(cells[j].name);
                     
                     if (it == tempCount.end()) { //we have not seen this sequence at all yet
                         vector<int> tempGroups; tempGroups.resize(myGroups.size(), 0);
-                        tempGroups[groupMap[allNames[j].group]]++;
-                        tempCount[allNames[j].name] = tempGroups;
+                        tempGroups[groupMap[cells[j].group]] = sample[j];
+                        tempCount[cells[j].name] = tempGroups;
                     }else{
-                        tempCount[allNames[j].name][groupMap[allNames[j].group]]++;
+                        (it->second)[groupMap[cells[j].group]] = sample[j];
                     }
                 }
             }
@@ -377,25 +407,22 @@ CountTable SubSample::getSample(CountTable& ct, int size, vector<string> Groups,
         }else {
             vector<string> names = ct.getNamesOfSeqs();
             map<string, int> nameMap;
-            vector<string> allNames;
+            vector<int> abunds(names.size(), 0);
+            long long total = 0;
             
             for (int i = 0; i < names.size(); i++) {
-                int num = ct.getNumSeqs(names[i]);
-                for (int j = 0; j < num; j++) { allNames.push_back(names[i]); }
+                abunds[i] = ct.getNumSeqs(names[i]);
+                total += abunds[i];
             }
             
-            if (allNames.size() < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than the number of sequences.\n"); m->control_pressed = true; return sampledCt; }
+            if (total < size) { m->mothurOut("[ERROR]: You have selected a size that is larger than the number of sequences.\n"); m->control_pressed = true; return sampledCt; }
             else {
-                m->mothurRandomShuffle(allNames);
+                vector<int> sample = getSample(abunds, size);
                 
-                for (int j = 0; j < size; j++) {
-                    if (m->control_pressed) { return sampledCt; }
-                    
-                    map<string, int>::iterator it = nameMap.find(allNames[j]);
-                    
-                    //we have not seen this sequence at all yet
-                    if (it == nameMap.end()) { nameMap[allNames[j]] = 1;  }
-                    else{  nameMap[allNames[j]]++;  }
+                if (m->control_pressed) { return sampledCt; }
+                
+                for (int j = 0; j < names.size(); j++) {
+                    if (sample[j] != 0) { nameMap[names[j]] = sample[j]; }
                 }
                 
                 //build count table
@@ -416,3 +443,85 @@ CountTable SubSample::getSample(CountTable& ct, int size, vector<string> Groups,
 //**********************************************************************************************************************
 
 
+//**********************************************************************************************************************
+//multivariate hypergeometric draw, one bin at a time: the number taken from a bin is hypergeometric given the reads
+//and draws left. This costs a few steps per bin instead of building and shuffling a vector with every read.
+vector<int> SubSample::getSample(const vector<int>& abunds, int size, mt19937_64* rng) {
+	try {
+		vector<int> sample(abunds.size(), 0);
+		
+		long long remainingReads = 0;
+		for (int i = 0; i < abunds.size(); i++) { remainingReads += abunds[i]; }
+		
+		long long remainingDraws = size;
+		if (remainingDraws > remainingReads) { remainingDraws = remainingReads; }
+		
+		for (int i = 0; i < abunds.size(); i++) {
+			if (remainingDraws == 0) { break; }
+			if (m->control_pressed) { break; }
+			
+			if (remainingDraws == remainingReads) { sample[i] = abunds[i]; }
+			else if (abunds[i] != 0) { sample[i] = getHypergeometric(remainingReads, abunds[i], remainingDraws, rng); }
+			
+			remainingReads -= abunds[i];
+			remainingDraws -= sample[i];
+		}
+		
+		return sample;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SubSample", "getSample-abunds");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
+//inversion starting at the mode, stepping down and up alternately, so the expected number of steps is about one
+//standard deviation. The mode's probability comes from lgamma and the neighbours from the ratio of successive terms.
+int SubSample::getHypergeometric(long long population, long long successes, long long draws, mt19937_64* rng) {
+	try {
+		long long failures = population - successes;
+		long long low = max(0LL, draws - failures);
+		long long high = min(draws, successes);
+		if (low == high) { return low; }
+		
+		long long mode = (long long) (((double)(draws + 1) * (double)(successes + 1)) / (double)(population + 2));
+		if (mode < low) { mode = low; }
+		if (mode > high) { mode = high; }
+		
+		double logProb = lgamma(successes + 1.0) - lgamma(mode + 1.0) - lgamma(successes - mode + 1.0)
+		               + lgamma(failures + 1.0) - lgamma(draws - mode + 1.0) - lgamma(failures - draws + mode + 1.0)
+		               - (lgamma(population + 1.0) - lgamma(draws + 1.0) - lgamma(population - draws + 1.0));
+		double modeProb = exp(logProb);
+		
+		double u = 0.0;
+		if (rng == NULL) { u = m->getRandomDouble0to1(); }
+		else { uniform_real_distribution<double> dis(0, 1); u = dis(*rng); }
+		u -= modeProb;
+		if (u <= 0) { return mode; }
+		
+		long long down = mode, up = mode;
+		double downProb = modeProb, upProb = modeProb;
+		
+		while ((down > low) || (up < high)) {
+			if (up < high) {
+				upProb *= ((double)(successes - up) * (double)(draws - up)) / ((double)(up + 1) * (double)(failures - draws + up + 1));
+				up++;
+				u -= upProb;
+				if (u <= 0) { return up; }
+			}
+			if (down > low) {
+				downProb *= ((double)down * (double)(failures - draws + down)) / ((double)(successes - down + 1) * (double)(draws - down + 1));
+				down--;
+				u -= downProb;
+				if (u <= 0) { return down; }
+			}
+		}
+		
+		return mode; //only reached through rounding in the tail sums
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SubSample", "getHypergeometric");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
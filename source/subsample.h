@@ -20,6 +20,10 @@
 
 class SubSample {
 	
+#ifdef UNIT_TEST
+	friend class TestSubSample;
+#endif
+	
     public:
     
         SubSample() { m = MothurOut::getInstance(); }
@@ -30,11 +34,14 @@ class SubSample {
         int getSample(SAbundVector*&, int); //destroys sabundvector passed in, so copy it if you need it
         CountTable getSample(CountTable&, int, vector<string>); //subsample a countTable bygroup(same number sampled from each group, returns subsampled countTable 
         CountTable getSample(CountTable&, int, vector<string>, bool); //subsample a countTable. If you want to only sample from specific groups, pass in groups in the vector and set bool=true, otherwise set bool=false.   
+        vector<int> getSample(const vector<int>&, int, mt19937_64* rng=NULL); //returns how many of the size reads drawn without replacement come from each bin, the reads themselves are never listed. Draws from mothur's random numbers if rng is NULL.
+        vector<SharedRAbundVector*> getSamplePreserve(const vector<SharedRAbundVector*>&, int, mt19937_64&); //returns a subsampled copy, the caller deletes it. Leaves the lookup and mothurOut's binlabels alone, so threads can subsample the same lookup at once.
     
     private:
     
         MothurOut* m;
         int eliminateZeroOTUS(vector<SharedRAbundVector*>&);
+        int getHypergeometric(long long, long long, long long, mt19937_64*); //population, successes in population, draws, rng
          map<string, string> deconvolute(map<string, string> wholeSet, vector<string>& subsampleWanted); //returns new nameMap containing only subsampled names, and removes redundants from subsampled wanted because it makes the new nameMap.
 
 
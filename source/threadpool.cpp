@@ -0,0 +1,272 @@
+/*
+ *  threadpool.cpp
+ *  Mothur
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 Schloss Lab. All rights reserved.
+ *
+ */
+
+#include "threadpool.h"
+
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+	#include <pthread.h>
+#endif
+
+//needed for testing project
+//ThreadPool* ThreadPool::_uniqueInstance;
+
+//set while a thread is running a pool task, so nested parallel calls run inline instead of deadlocking
+static thread_local bool insidePoolTask = false;
+
+/**************************************************************************************************/
+void OrderedOutput::commit(long long start, long long end, const string& output) {
+	try {
+		lock_guard<mutex> guard(lock);
+
+		pending[start] = make_pair(end, output);
+
+		//write everything that is now contiguous with what has already been written
+		map<long long, pair<long long, string> >::iterator it = pending.begin();
+		while ((it != pending.end()) && (it->first == next)) {
+			out << it->second.second;
+			next = it->second.first;
+			pending.erase(it++);
+		}
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "OrderedOutput", "commit");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+ThreadPool* ThreadPool::getInstance() {
+	if( _uniqueInstance == 0) {
+#if defined (__APPLE__) || (__MACH__) || (linux) || (__linux) || (__linux__) || (__unix__) || (__unix)
+		static bool registered = false; //a forked child inherits this, so it is only registered once
+		if (!registered) { pthread_atfork(NULL, NULL, &ThreadPool::resetInChild); registered = true; }
+#endif
+		_uniqueInstance = new ThreadPool();
+	}
+	return _uniqueInstance;
+}
+/**************************************************************************************************/
+//A forked child gets a copy of the pool but none of its worker threads, and its locks and condition variables may
+//still count the parent's waiters. The copy is left alone, never used or destroyed, and the child's first parallel
+//call builds a pool of its own.
+void ThreadPool::resetInChild() {
+	_uniqueInstance = 0;
+}
+/**************************************************************************************************/
+ThreadPool::ThreadPool() {
+	m = MothurOut::getInstance();
+	jobThreads = 0; jobRemaining = 0; generation = 0; shutdown = false;
+}
+/**************************************************************************************************/
+ThreadPool::~ThreadPool() {
+	{
+		lock_guard<mutex> guard(stateLock);
+		shutdown = true;
+	}
+	jobReady.notify_all();
+	for (int i = 0; i < workers.size(); i++) { workers[i].join(); }
+}
+/**************************************************************************************************/
+//workers are created the first time a command asks for them and reused by every command after that
+void ThreadPool::addWorkers(int numThreads) {
+	try {
+		while ((workers.size()+1) < numThreads) {
+			int workerID = workers.size()+1;
+			workers.push_back(thread(&ThreadPool::workerLoop, this, workerID));
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ThreadPool", "addWorkers");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+void ThreadPool::workerLoop(int workerID) {
+	try {
+		unsigned long long seen = 0;
+		insidePoolTask = true;
+
+		while (true) {
+			function<void(int)> task;
+			{
+				unique_lock<mutex> guard(stateLock);
+				while (!shutdown && ((generation == seen) || (workerID >= jobThreads))) {
+					if (generation != seen) { seen = generation; } //job does not need this worker
+					else { jobReady.wait(guard); }
+				}
+				if (shutdown) { return; }
+				seen = generation;
+				task = job;
+			}
+
+			task(workerID);
+
+			{
+				lock_guard<mutex> guard(stateLock);
+				jobRemaining--;
+				if (jobRemaining == 0) { jobDone.notify_all(); }
+			}
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ThreadPool", "workerLoop");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+void ThreadPool::runOnEach(int numThreads, function<void(int)> task) {
+	try {
+		if (numThreads < 1) { numThreads = 1; }
+
+		//nested call from inside a task or nothing to share, run it here
+		if ((numThreads == 1) || insidePoolTask) {
+			for (int i = 0; i < numThreads; i++) { task(i); }
+			return;
+		}
+
+		lock_guard<mutex> oneJob(jobLock);
+
+		addWorkers(numThreads);
+
+		{
+			lock_guard<mutex> guard(stateLock);
+			job = task;
+			jobThreads = numThreads;
+			jobRemaining = numThreads-1;
+			generation++;
+		}
+		jobReady.notify_all();
+
+		//calling thread does its part
+		insidePoolTask = true;
+		task(0);
+		insidePoolTask = false;
+
+		unique_lock<mutex> guard(stateLock);
+		while (jobRemaining != 0) { jobDone.wait(guard); }
+		job = nullptr;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ThreadPool", "runOnEach");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//takes the back half of the fullest slice, returns false when there is nothing left to take
+bool ThreadPool::stealWork(vector<Slice*>& slices, int thief) {
+	try {
+		while (true) {
+			int victim = -1; long long most = 0;
+			for (int i = 0; i < slices.size(); i++) {
+				if (i == thief) { continue; }
+				long long remaining = slices[i]->end - slices[i]->next; //unlocked peek, confirmed below
+				if (remaining > most) { most = remaining; victim = i; }
+			}
+			if (victim == -1) { return false; }
+
+			long long stolenStart, stolenEnd;
+			{
+				lock_guard<mutex> guard(slices[victim]->lock);
+				long long remaining = slices[victim]->end - slices[victim]->next;
+				if (remaining <= 0) { continue; } //someone beat us to it
+				stolenEnd = slices[victim]->end.load();
+				stolenStart = slices[victim]->next.load() + (remaining / 2);
+				slices[victim]->end = stolenStart;
+			}
+
+			lock_guard<mutex> guard(slices[thief]->lock);
+			slices[thief]->next = stolenStart;
+			slices[thief]->end = stolenEnd;
+			return true;
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ThreadPool", "stealWork");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+void ThreadPool::parallelFor(long long start, long long end, int numThreads, RangeTask task, long long grain) {
+	try {
+		if (end <= start) { return; }
+		if (grain < 1) { grain = 1; }
+		if (numThreads < 1) { numThreads = 1; }
+		if (numThreads > (end-start)) { numThreads = end-start; }
+
+		if ((numThreads == 1) || insidePoolTask) {
+			for (long long i = start; i < end; i += grain) { task(i, min(i+grain, end), 0); }
+			return;
+		}
+
+		vector<Slice*> slices;
+		for (int i = 0; i < numThreads; i++) {
+			Slice* slice = new Slice();
+			slice->next = start + ((end-start) * i) / numThreads;
+			slice->end = start + ((end-start) * (i+1)) / numThreads;
+			slices.push_back(slice);
+		}
+
+		runOnEach(numThreads, [&](int threadID) {
+			Slice* mine = slices[threadID];
+			while (true) {
+				long long chunkStart, chunkEnd;
+				{
+					lock_guard<mutex> guard(mine->lock);
+					chunkStart = mine->next;
+					chunkEnd = min(chunkStart+grain, mine->end.load());
+					mine->next = chunkEnd;
+				}
+
+				if (chunkStart < chunkEnd) { task(chunkStart, chunkEnd, threadID); }
+				else if (!stealWork(slices, threadID)) { break; }
+			}
+		});
+
+		for (int i = 0; i < slices.size(); i++) { delete slices[i]; }
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ThreadPool", "parallelFor");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+void ThreadPool::parallelForOrdered(long long start, long long end, int numThreads, RangeTask task, long long grain) {
+	try {
+		if (end <= start) { return; }
+		if (grain < 1) { grain = 1; }
+		if (numThreads < 1) { numThreads = 1; }
+
+		if ((numThreads == 1) || insidePoolTask) {
+			for (long long i = start; i < end; i += grain) { task(i, min(i+grain, end), 0); }
+			return;
+		}
+
+		mutex cursorLock;
+		long long cursor = start;
+
+		runOnEach(numThreads, [&](int threadID) {
+			while (true) {
+				long long chunkStart, chunkEnd;
+				{
+					lock_guard<mutex> guard(cursorLock);
+					chunkStart = cursor;
+					chunkEnd = min(cursor+grain, end);
+					cursor = chunkEnd;
+				}
+
+				if (chunkStart >= chunkEnd) { break; }
+				task(chunkStart, chunkEnd, threadID);
+			}
+		});
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ThreadPool", "parallelForOrdered");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
@@ -0,0 +1,107 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+/*
+ *  threadpool.h
+ *  Mothur
+ *
+ *  Created by agent on 10/18/26.
+ *  Copyright 2026 Schloss Lab. All rights reserved.
+ *
+ *  Shared in-process worker pool.  Commands hand it an index range and a task, the pool splits the range across
+ *  the workers and the calling thread, and the results are merged in memory by the command. This replaces the
+ *  fork() / <pid>.temp / appendFiles pattern so large reference data is shared instead of copied per process.
+ *
+ */
+
+#include "mothur.h"
+#include "mothurout.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+
+/**************************************************************************************************/
+//seed for the random stream of task number "stream" (splitmix64), so each task draws the same numbers however the range is split
+inline unsigned long long getStreamSeed(unsigned long long base, long long stream) {
+	unsigned long long x = base + (unsigned long long) stream + 0x9E3779B97F4A7C15ULL;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+	return x ^ (x >> 31);
+}
+/**************************************************************************************************/
+//task(chunkStart, chunkEnd, threadID) - threadID is 0 to numThreads-1, 0 is always the calling thread
+typedef function<void(long long, long long, int)> RangeTask;
+
+/**************************************************************************************************/
+//collects blocks of output produced by the workers and writes them to the stream in index order
+class OrderedOutput {
+
+public:
+	OrderedOutput(ostream& o, long long s) : out(o), next(s) {}
+	~OrderedOutput() {}
+
+	void commit(long long, long long, const string&);  //start, end, output for [start, end)
+	long long getNext() { return next; }
+
+private:
+	ostream& out;
+	long long next;
+	map<long long, pair<long long, string> > pending;
+	mutex lock;
+};
+
+/**************************************************************************************************/
+
+class ThreadPool {
+
+public:
+	static ThreadPool* getInstance();
+
+	//work-stealing: each worker starts with an even slice of [start, end) and idle workers steal half of the largest remaining slice.
+	//use when the results are reduced per thread and order does not matter.
+	void parallelFor(long long, long long, int, RangeTask, long long grain=1);
+
+	//chunks are handed out in index order from a shared cursor, so an OrderedOutput only ever buffers about numThreads chunks.
+	void parallelForOrdered(long long, long long, int, RangeTask, long long grain=1);
+
+	//runs task(threadID) once on each of numThreads threads
+	void runOnEach(int, function<void(int)>);
+
+	int getNumWorkers() { return workers.size()+1; }
+
+private:
+	static ThreadPool* _uniqueInstance;
+	ThreadPool( const ThreadPool& ); // Disable copy constructor
+	void operator=( const ThreadPool& ); // Disable assignment operator
+	ThreadPool();
+	~ThreadPool();
+	static void resetInChild();
+
+	struct Slice {
+		atomic<long long> next, end; //written under lock, read without it when picking a victim
+		mutex lock;
+		Slice() : next(0), end(0) {}
+	};
+
+	void addWorkers(int);
+	void workerLoop(int);
+	bool stealWork(vector<Slice*>&, int);
+
+	MothurOut* m;
+	vector<thread> workers;
+
+	mutex jobLock;      //one job at a time
+	mutex stateLock;    //guards the fields below
+	condition_variable jobReady, jobDone;
+	function<void(int)> job;
+	int jobThreads, jobRemaining;
+	unsigned long long generation;
+	bool shutdown;
+};
+
+/**************************************************************************************************/
+
+#endif
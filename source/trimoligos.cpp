@@ -58,6 +58,8 @@ TrimOligos::TrimOligos(int p, int b, int l, int s, map<string, int> pr, map<stri
                 maxSpacerLength = spacer[i].length();
             }
         }
+        
+        setMatchers();
     }
     catch(exception& e) {
         m->errorOut(e, "TrimOligos", "TrimOligos");
@@ -132,6 +134,8 @@ TrimOligos::TrimOligos(int p, int b, int l, int s, map<int, oligosPair> pr, map<
         
         ipbarcodes = br;
         ipprimers = pr;
+        
+        setMatchers();
     }
     catch(exception& e) {
         m->errorOut(e, "TrimOligos", "TrimOligos");
@@ -171,6 +175,8 @@ TrimOligos::TrimOligos(int p, int rd, int b, map<string, int> pr, map<string, in
             }
         }
         maxRPrimerLength = maxFPrimerLength;
+        
+        setMatchers();
     }
     catch(exception& e) {
         m->errorOut(e, "TrimOligos", "TrimOligos");
@@ -180,6 +186,79 @@ TrimOligos::TrimOligos(int p, int rd, int b, map<string, int> pr, map<string, in
 /********************************************************************/
 TrimOligos::~TrimOligos() {}
 //********************************************************************/
+void TrimOligos::setMatchers(){
+    try {
+        vector<string> oligos;
+        for(map<string,int>::iterator it=barcodes.begin();it!=barcodes.end();it++){ oligos.push_back(it->first); }
+        barcodeMatcher = OligoMatcher(oligos);
+
+        oligos.clear();
+        for(map<string,int>::iterator it=primers.begin();it!=primers.end();it++){ oligos.push_back(it->first); }
+        primerMatcher = OligoMatcher(oligos);
+
+        oligos.clear();
+        for(map<string, vector<int> >::iterator it=ifbarcodes.begin();it!=ifbarcodes.end();it++){ oligos.push_back(it->first); }
+        ifbarcodeMatcher = OligoMatcher(oligos);
+
+        oligos.clear();
+        for(map<string, vector<int> >::iterator it=irbarcodes.begin();it!=irbarcodes.end();it++){ oligos.push_back(it->first); }
+        irbarcodeMatcher = OligoMatcher(oligos);
+
+        oligos.clear();
+        for(map<string, vector<int> >::iterator it=ifprimers.begin();it!=ifprimers.end();it++){ oligos.push_back(it->first); }
+        ifprimerMatcher = OligoMatcher(oligos);
+
+        oligos.clear();
+        for(map<string, vector<int> >::iterator it=irprimers.begin();it!=irprimers.end();it++){ oligos.push_back(it->first); }
+        irprimerMatcher = OligoMatcher(oligos);
+
+        vector<string> roligos;
+        oligos.clear();
+        for(map<int,oligosPair>::iterator it=ipbarcodes.begin();it!=ipbarcodes.end();it++){ oligos.push_back(it->second.forward); roligos.push_back(it->second.reverse); }
+        ipfbarcodeMatcher = OligoMatcher(oligos);
+        iprbarcodeMatcher = OligoMatcher(roligos);
+
+        oligos.clear(); roligos.clear();
+        for(map<int,oligosPair>::iterator it=ipprimers.begin();it!=ipprimers.end();it++){ oligos.push_back(it->second.forward); roligos.push_back(it->second.reverse); }
+        ipfprimerMatcher = OligoMatcher(oligos);
+        iprprimerMatcher = OligoMatcher(roligos);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "TrimOligos", "setMatchers");
+        exit(1);
+    }
+}
+//********************************************************************/
+//lower bound on the diffs of each oligo, in map order. The oligo with the lowest bound is aligned, and oligos bounded
+//above its diffs can't be the best match, so their bounds are raised past 1e6 for the alignment loops to skip them.
+//A NONE oligo matches without clearing the groups found before it, so then only the bounds are returned.
+vector<int> TrimOligos::getDiffsBounds(OligoMatcher& matcher, Alignment* alignment, string& rawSequence, int diffs){
+    try {
+        vector<int> bounds = matcher.getLowerBounds(rawSequence, diffs);
+        if ((bounds.size() == 0) || matcher.getHasNone() || (rawSequence.length() < matcher.getMaxLength())) { return bounds; }
+
+        int best = min_element(bounds.begin(), bounds.end()) - bounds.begin();
+        string oligo = matcher.getOligo(best);
+
+        alignment->alignPrimer(oligo, rawSequence.substr(0,oligo.length()+diffs));
+        oligo = alignment->getSeqAAln();
+        string temp = alignment->getSeqBAln();
+
+        int alnLength = oligo.length();
+        for(int i=oligo.length()-1;i>=0;i--){ if(oligo[i] != '-'){	alnLength = i+1;	break;	} }
+        if (alnLength == 0) { return bounds; }
+
+        int bestDiffs = countDiffs(oligo.substr(0,alnLength), temp.substr(0,alnLength));
+        for (int i = 0; i < bounds.size(); i++) { if (bounds[i] > bestDiffs) { bounds[i] = 1e6 + 1; } }
+
+        return bounds;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "TrimOligos", "getDiffsBounds");
+        exit(1);
+    }
+}
+//********************************************************************/
 vector<int> TrimOligos::findForward(Sequence& seq, int& primerStart, int& primerEnd){
     try {
         
@@ -413,7 +492,10 @@ vector<int> TrimOligos::stripBarcode(Sequence& seq, QualityScores& qual, int& gr
         success.push_back(1e6); //no matches found
         
         //can you find the barcode
-        for(map<string,int>::iterator it=barcodes.begin();it!=barcodes.end();it++){
+        map<string,int>::iterator it = barcodes.end();
+        int index = barcodeMatcher.findExact(rawSequence); //the barcode the search below stops at
+        if (index != -1) { it = barcodes.begin(); advance(it, index); }
+        for(;it!=barcodes.end();it++){
             string oligo = it->first;
             if(rawSequence.length() < oligo.length()){	//let's just assume that the barcodes are the same length
                 success[0] = rawSequence.length();
@@ -449,8 +531,11 @@ vector<int> TrimOligos::stripBarcode(Sequence& seq, QualityScores& qual, int& gr
             int minGroup = -1;
             int minPos = 0;
             
+            vector<int> bounds = getDiffsBounds(barcodeMatcher, alignment, rawSequence, bdiffs);
+            int oligoIndex = -1;
             for(map<string,int>::iterator it=barcodes.begin();it!=barcodes.end();it++){
                 string oligo = it->first;
+                oligoIndex++;
                 // int length = oligo.length();
                 
                 if(rawSequence.length() < maxFBarcodeLength){	//let's just assume that the barcodes are the same length
@@ -459,6 +544,8 @@ vector<int> TrimOligos::stripBarcode(Sequence& seq, QualityScores& qual, int& gr
                     break;
                 }
                 
+                if (bounds[oligoIndex] > minDiff) { continue; } //can't beat the best match so far
+                
                 //use needleman to align first barcode.length()+numdiffs of sequence to each barcode
                 alignment->alignPrimer(oligo, rawSequence.substr(0,oligo.length()+bdiffs));
                 oligo = alignment->getSeqAAln();
@@ -529,7 +616,10 @@ vector<int> TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq,
         success.push_back(1e6);
         
         //can you find the forward barcode
-        for(map<int,oligosPair>::iterator it=ipbarcodes.begin();it!=ipbarcodes.end();it++){
+        map<int,oligosPair>::iterator it = ipbarcodes.end();
+        int index = OligoMatcher::findExact(ipfbarcodeMatcher, iprbarcodeMatcher, rawFSequence, rawRSequence); //the pair the search below stops at
+        if (index != -1) { it = ipbarcodes.begin(); advance(it, index); }
+        for(;it!=ipbarcodes.end();it++){
             string foligo = it->second.forward;
             string roligo = it->second.reverse;
             
@@ -594,8 +684,11 @@ vector<int> TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq,
              but if best match forward = 4, and reverse = 1, we want to count as a valid match because forward 1 and forward 4 are the same. so both barcodes map to same group.
              */
             //cout << endl << forwardSeq.getName() << endl;
+            vector<int> bounds = getDiffsBounds(ifbarcodeMatcher, alignment, rawFSequence, bdiffs);
+            int oligoIndex = -1;
             for(map<string, vector<int> >::iterator it=ifbarcodes.begin();it!=ifbarcodes.end();it++){
                 string oligo = it->first;
+                oligoIndex++;
                 
                 if(rawFSequence.length() < maxFBarcodeLength){	//let's just assume that the barcodes are the same length
                     success[0] = rawFSequence.length();
@@ -604,6 +697,7 @@ vector<int> TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq,
                 }
                 
                 if (oligo != "NONE") {
+                    if (bounds[oligoIndex] > minDiff) { continue; } //can't beat the best match so far
                     //cout << "before = " << oligo << '\t' << rawFSequence.substr(0,oligo.length()+bdiffs) << endl;
                     //use needleman to align first barcode.length()+numdiffs of sequence to each barcode
                     alignment->alignPrimer(oligo, rawFSequence.substr(0,oligo.length()+bdiffs));
@@ -669,8 +763,11 @@ vector<int> TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq,
                 vector< vector<int> > minRGroup;
                 vector<int> minRPos;
                 
+                vector<int> bounds = getDiffsBounds(irbarcodeMatcher, alignment, rawRSequence, bdiffs);
+                int oligoIndex = -1;
                 for(map<string, vector<int> >::iterator it=irbarcodes.begin();it!=irbarcodes.end();it++){
                     string oligo = it->first;
+                    oligoIndex++;
                     //cout << "before = " << oligo << '\t' << rawRSequence.substr(0,oligo.length()+bdiffs) << endl;
                     if(rawRSequence.length() < maxRBarcodeLength){	//let's just assume that the barcodes are the same length
                         success[2] = rawRSequence.length();
@@ -679,6 +776,7 @@ vector<int> TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq,
                     }
                     
                     if (oligo != "NONE") {
+                        if (bounds[oligoIndex] > minDiff) { continue; } //can't beat the best match so far
                         //use needleman to align first barcode.length()+numdiffs of sequence to each barcode
                         alignment->alignPrimer(oligo, rawRSequence.substr(0,oligo.length()+bdiffs));
                         oligo = alignment->getSeqAAln();
@@ -781,7 +879,10 @@ vector<int> TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq,
         success.push_back(1e6);
         
         //can you find the forward barcode
-        for(map<int,oligosPair>::iterator it=ipbarcodes.begin();it!=ipbarcodes.end();it++){
+        map<int,oligosPair>::iterator it = ipbarcodes.end();
+        int index = OligoMatcher::findExact(ipfbarcodeMatcher, iprbarcodeMatcher, rawFSequence, rawRSequence); //the pair the search below stops at
+        if (index != -1) { it = ipbarcodes.begin(); advance(it, index); }
+        for(;it!=ipbarcodes.end();it++){
             string foligo = it->second.forward;
             string roligo = it->second.reverse;
             
@@ -858,8 +959,11 @@ vector<int> TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq,
              but if best match forward = 4, and reverse = 1, we want to count as a valid match because forward 1 and forward 4 are the same. so both barcodes map to same group.
              */
             //cout << endl << forwardSeq.getName() << endl;
+            vector<int> bounds = getDiffsBounds(ifbarcodeMatcher, alignment, rawFSequence, bdiffs);
+            int oligoIndex = -1;
             for(map<string, vector<int> >::iterator it=ifbarcodes.begin();it!=ifbarcodes.end();it++){
                 string oligo = it->first;
+                oligoIndex++;
                 
                 if(rawFSequence.length() < maxFBarcodeLength){	//let's just assume that the barcodes are the same length
                     success[0] = rawFSequence.length();
@@ -867,6 +971,7 @@ vector<int> TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq,
                     break;
                 }
                 if (oligo != "NONE") {
+                    if (bounds[oligoIndex] > minDiff) { continue; } //can't beat the best match so far
                     //cout << "before = " << oligo << '\t' << rawFSequence.substr(0,oligo.length()+bdiffs) << endl;
                     //use needleman to align first barcode.length()+numdiffs of sequence to each barcode
                     alignment->alignPrimer(oligo, rawFSequence.substr(0,oligo.length()+bdiffs));
@@ -930,8 +1035,11 @@ vector<int> TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq,
                 vector< vector<int> > minRGroup;
                 vector<int> minRPos;
                 
+                vector<int> bounds = getDiffsBounds(irbarcodeMatcher, alignment, rawRSequence, bdiffs);
+                int oligoIndex = -1;
                 for(map<string, vector<int> >::iterator it=irbarcodes.begin();it!=irbarcodes.end();it++){
                     string oligo = it->first;
+                    oligoIndex++;
                     //cout << "before = " << oligo << '\t' << rawRSequence.substr(0,oligo.length()+bdiffs) << endl;
                     if(rawRSequence.length() < maxRBarcodeLength){	//let's just assume that the barcodes are the same length
                         success[2] = rawRSequence.length();
@@ -940,6 +1048,7 @@ vector<int> TrimOligos::stripBarcode(Sequence& forwardSeq, Sequence& reverseSeq,
                     }
                     
                     if (oligo != "NONE") {
+                        if (bounds[oligoIndex] > minDiff) { continue; } //can't beat the best match so far
                         //use needleman to align first barcode.length()+numdiffs of sequence to each barcode
                         alignment->alignPrimer(oligo, rawRSequence.substr(0,oligo.length()+bdiffs));
                         oligo = alignment->getSeqAAln();
@@ -1623,7 +1732,10 @@ vector<int> TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq,
         success.push_back(1e6);
         
         //can you find the forward barcode
-        for(map<int,oligosPair>::iterator it=ipprimers.begin();it!=ipprimers.end();it++){
+        map<int,oligosPair>::iterator it = ipprimers.end();
+        int index = OligoMatcher::findExact(ipfprimerMatcher, iprprimerMatcher, rawFSequence, rawRSequence); //the pair the search below stops at
+        if (index != -1) { it = ipprimers.begin(); advance(it, index); }
+        for(;it!=ipprimers.end();it++){
             string foligo = it->second.forward;
             string roligo = it->second.reverse;
             
@@ -1692,8 +1804,11 @@ vector<int> TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq,
              but if best match forward = 4, and reverse = 1, we want to count as a valid match because forward 1 and forward 4 are the same. so both barcodes map to same group.
              */
             //cout << endl << forwardSeq.getName() << endl;
+            vector<int> bounds = getDiffsBounds(ifprimerMatcher, alignment, rawFSequence, pdiffs);
+            int oligoIndex = -1;
             for(map<string, vector<int> >::iterator it=ifprimers.begin();it!=ifprimers.end();it++){
                 string oligo = it->first;
+                oligoIndex++;
                 
                 if(rawFSequence.length() < maxFPrimerLength){	//let's just assume that the barcodes are the same length
                     success[0] = rawFSequence.length();
@@ -1702,6 +1817,7 @@ vector<int> TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq,
                 }
                 //cout << "before = " << oligo << '\t' << rawFSequence.substr(0,oligo.length()+pdiffs) << endl;
                 if (oligo != "NONE") {
+                    if (bounds[oligoIndex] > minDiff) { continue; } //can't beat the best match so far
                     //use needleman to align first barcode.length()+numdiffs of sequence to each barcode
                     alignment->alignPrimer(oligo, rawFSequence.substr(0,oligo.length()+pdiffs));
                     oligo = alignment->getSeqAAln();
@@ -1766,8 +1882,11 @@ vector<int> TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq,
                 vector< vector<int> > minRGroup;
                 vector<int> minRPos;
                 
+                vector<int> bounds = getDiffsBounds(irprimerMatcher, alignment, rawRSequence, pdiffs);
+                int oligoIndex = -1;
                 for(map<string, vector<int> >::iterator it=irprimers.begin();it!=irprimers.end();it++){
                     string oligo = it->first;
+                    oligoIndex++;
                     //cout << "before = " << oligo << '\t' << rawRSequence.substr(0,oligo.length()+pdiffs) << endl;
                     if(rawRSequence.length() < maxRPrimerLength){	//let's just assume that the barcodes are the same length
                         success[2] = rawRSequence.length();
@@ -1776,6 +1895,7 @@ vector<int> TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq,
                     }
                     
                     if (oligo != "NONE") {
+                        if (bounds[oligoIndex] > minDiff) { continue; } //can't beat the best match so far
                         //use needleman to align first barcode.length()+numdiffs of sequence to each barcode
                         alignment->alignPrimer(oligo, rawRSequence.substr(0,oligo.length()+pdiffs));
                         oligo = alignment->getSeqAAln();
@@ -1880,7 +2000,10 @@ vector<int> TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq,
         success.push_back(1e6);
         
         //can you find the forward barcode
-        for(map<int,oligosPair>::iterator it=ipprimers.begin();it!=ipprimers.end();it++){
+        map<int,oligosPair>::iterator it = ipprimers.end();
+        int index = OligoMatcher::findExact(ipfprimerMatcher, iprprimerMatcher, rawFSequence, rawRSequence); //the pair the search below stops at
+        if (index != -1) { it = ipprimers.begin(); advance(it, index); }
+        for(;it!=ipprimers.end();it++){
             string foligo = it->second.forward;
             string roligo = it->second.reverse;
             
@@ -1945,8 +2068,11 @@ vector<int> TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq,
              but if best match forward = 4, and reverse = 1, we want to count as a valid match because forward 1 and forward 4 are the same. so both barcodes map to same group.
              */
             //cout << endl << forwardSeq.getName() << endl;
+            vector<int> bounds = getDiffsBounds(ifprimerMatcher, alignment, rawFSequence, pdiffs);
+            int oligoIndex = -1;
             for(map<string, vector<int> >::iterator it=ifprimers.begin();it!=ifprimers.end();it++){
                 string oligo = it->first;
+                oligoIndex++;
                 
                 if(rawFSequence.length() < maxFPrimerLength){	//let's just assume that the barcodes are the same length
                     success[0] = rawFSequence.length();
@@ -1955,6 +2081,7 @@ vector<int> TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq,
                 }
                 //cout << "before = " << oligo << '\t' << rawFSequence.substr(0,oligo.length()+pdiffs) << endl;
                 if (oligo != "NONE") {
+                    if (bounds[oligoIndex] > minDiff) { continue; } //can't beat the best match so far
                     //use needleman to align first barcode.length()+numdiffs of sequence to each barcode
                     alignment->alignPrimer(oligo, rawFSequence.substr(0,oligo.length()+pdiffs));
                     oligo = alignment->getSeqAAln();
@@ -2019,8 +2146,11 @@ vector<int> TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq,
                 vector< vector<int> > minRGroup;
                 vector<int> minRPos;
                 
+                vector<int> bounds = getDiffsBounds(irprimerMatcher, alignment, rawRSequence, pdiffs);
+                int oligoIndex = -1;
                 for(map<string, vector<int> >::iterator it=irprimers.begin();it!=irprimers.end();it++){
                     string oligo = it->first;
+                    oligoIndex++;
                     //cout << "before = " << oligo << '\t' << rawRSequence.substr(0,oligo.length()+pdiffs) << endl;
                     if(rawRSequence.length() < maxRPrimerLength){	//let's just assume that the barcodes are the same length
                         success[2] = rawRSequence.length();
@@ -2029,6 +2159,7 @@ vector<int> TrimOligos::stripForward(Sequence& forwardSeq, Sequence& reverseSeq,
                     }
                     
                     if (oligo != "NONE") {
+                        if (bounds[oligoIndex] > minDiff) { continue; } //can't beat the best match so far
                         //use needleman to align first barcode.length()+numdiffs of sequence to each barcode
                         alignment->alignPrimer(oligo, rawRSequence.substr(0,oligo.length()+pdiffs));
                         oligo = alignment->getSeqAAln();
@@ -2129,7 +2260,10 @@ vector<int> TrimOligos::stripBarcode(Sequence& seq, int& group){
         success.push_back(1e6);
         
         //can you find the barcode
-        for(map<string,int>::iterator it=barcodes.begin();it!=barcodes.end();it++){
+        map<string,int>::iterator it = barcodes.end();
+        int index = barcodeMatcher.findExact(rawSequence); //the barcode the search below stops at
+        if (index != -1) { it = barcodes.begin(); advance(it, index); }
+        for(;it!=barcodes.end();it++){
             string oligo = it->first;
             if(rawSequence.length() < oligo.length()){	//let's just assume that the barcodes are the same length
                 success[0] = rawSequence.length();
@@ -2159,8 +2293,11 @@ vector<int> TrimOligos::stripBarcode(Sequence& seq, int& group){
             int minGroup = -1;
             int minPos = 0;
             
+            vector<int> bounds = getDiffsBounds(barcodeMatcher, alignment, rawSequence, bdiffs);
+            int oligoIndex = -1;
             for(map<string,int>::iterator it=barcodes.begin();it!=barcodes.end();it++){
                 string oligo = it->first;
+                oligoIndex++;
                 // int length = oligo.length();
                 
                 if(rawSequence.length() < maxFBarcodeLength){	//let's just assume that the barcodes are the same length
@@ -2169,6 +2306,8 @@ vector<int> TrimOligos::stripBarcode(Sequence& seq, int& group){
                     break;
                 }
                 
+                if (bounds[oligoIndex] > minDiff) { continue; } //can't beat the best match so far
+                
                 //use needleman to align first barcode.length()+numdiffs of sequence to each barcode
                 alignment->alignPrimer(oligo, rawSequence.substr(0,oligo.length()+bdiffs));
                 oligo = alignment->getSeqAAln();
@@ -2234,7 +2373,10 @@ vector<int> TrimOligos::stripForward(Sequence& seq, int& group){
         success.push_back(1e6);
         
         //can you find the primer
-        for(map<string,int>::iterator it=primers.begin();it!=primers.end();it++){
+        map<string,int>::iterator it = primers.end();
+        int index = primerMatcher.findExact(rawSequence); //the primer the search below stops at
+        if (index != -1) { it = primers.begin(); advance(it, index); }
+        for(;it!=primers.end();it++){
             string oligo = it->first;
             if(rawSequence.length() < oligo.length()){	//let's just assume that the primers are the same length
                 success[0] = rawSequence.length();
@@ -2264,8 +2406,11 @@ vector<int> TrimOligos::stripForward(Sequence& seq, int& group){
             int minGroup = -1;
             int minPos = 0;
             
+            vector<int> bounds = getDiffsBounds(primerMatcher, alignment, rawSequence, pdiffs);
+            int oligoIndex = -1;
             for(map<string,int>::iterator it=primers.begin();it!=primers.end();it++){
                 string oligo = it->first;
+                oligoIndex++;
                 // int length = oligo.length();
                 
                 if(rawSequence.length() < maxFPrimerLength){
@@ -2274,6 +2419,8 @@ vector<int> TrimOligos::stripForward(Sequence& seq, int& group){
                     break;
                 }
                 
+                if (bounds[oligoIndex] > minDiff) { continue; } //can't beat the best match so far
+                
                 //use needleman to align first barcode.length()+numdiffs of sequence to each barcode
                 alignment->alignPrimer(oligo, rawSequence.substr(0,oligo.length()+pdiffs));
                 oligo = alignment->getSeqAAln();
@@ -2342,7 +2489,10 @@ vector<int> TrimOligos::stripForward(Sequence& seq, QualityScores& qual, int& gr
         string rawSequence = seq.getUnaligned();
         
         //can you find the primer
-        for(map<string,int>::iterator it=primers.begin();it!=primers.end();it++){
+        map<string,int>::iterator it = primers.end();
+        int index = primerMatcher.findExact(rawSequence); //the primer the search below stops at
+        if (index != -1) { it = primers.begin(); advance(it, index); }
+        for(;it!=primers.end();it++){
             string oligo = it->first;
             if(rawSequence.length() < oligo.length()){	//let's just assume that the primers are the same length
                 success[0] = rawSequence.length();
@@ -2375,8 +2525,11 @@ vector<int> TrimOligos::stripForward(Sequence& seq, QualityScores& qual, int& gr
             int minGroup = -1;
             int minPos = 0;
             
+            vector<int> bounds = getDiffsBounds(primerMatcher, alignment, rawSequence, pdiffs);
+            int oligoIndex = -1;
             for(map<string,int>::iterator it=primers.begin();it!=primers.end();it++){
                 string oligo = it->first;
+                oligoIndex++;
                 // int length = oligo.length();
                 
                 if(rawSequence.length() < maxFPrimerLength){
@@ -2385,6 +2538,8 @@ vector<int> TrimOligos::stripForward(Sequence& seq, QualityScores& qual, int& gr
                     break;
                 }
                 
+                if (bounds[oligoIndex] > minDiff) { continue; } //can't beat the best match so far
+                
                 //use needleman to align first barcode.length()+numdiffs of sequence to each barcode
                 alignment->alignPrimer(oligo, rawSequence.substr(0,oligo.length()+pdiffs));
                 oligo = alignment->getSeqAAln();
@@ -14,6 +14,9 @@
 #include "mothurout.h"
 #include "sequence.hpp"
 #include "qualityscores.h"
+#include "oligomatcher.h"
+
+class Alignment;
 
 
 class TrimOligos {
@@ -76,12 +79,19 @@ class TrimOligos {
         map<int, oligosPair> ipbarcodes;
         map<int, oligosPair> ipprimers;
     
+        //same oligos in the same order as the maps above, ipbarcodes and ipprimers split into forward and reverse
+        OligoMatcher barcodeMatcher, primerMatcher;
+        OligoMatcher ifbarcodeMatcher, irbarcodeMatcher, ifprimerMatcher, irprimerMatcher;
+        OligoMatcher ipfbarcodeMatcher, iprbarcodeMatcher, ipfprimerMatcher, iprprimerMatcher;
+    
         int maxFBarcodeLength, maxRBarcodeLength, maxFPrimerLength, maxRPrimerLength, maxLinkerLength, maxSpacerLength;
 	
 		MothurOut* m;
 	
 		bool compareDNASeq(string, string);				
 		int countDiffs(string, string);
+        void setMatchers();
+        vector<int> getDiffsBounds(OligoMatcher&, Alignment*, string&, int);
         
         vector<int> stripPairedBarcode(Sequence& seq, QualityScores& qual, int& group);
         vector<int> stripPairedPrimers(Sequence& seq, QualityScores& qual, int& group, bool);